@@ -0,0 +1,279 @@
+#include "ArtifactCache.h"
+
+#include <filesystem>
+#include <system_error>
+
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QRandomGenerator>
+#include <QStandardPaths>
+
+ArtifactCache::ArtifactCache(const QString& directory, qint64 maxBytes)
+    : m_dir(directory.isEmpty() ? defaultDirectory() : directory)
+    , m_maxBytes(maxBytes)
+{
+}
+
+QString ArtifactCache::defaultDirectory()
+{
+    return QStandardPaths::writableLocation(QStandardPaths::CacheLocation)
+         + QStringLiteral("/artifacts");
+}
+
+void ArtifactCache::setMaxBytes(qint64 maxBytes)
+{
+    m_maxBytes = maxBytes;
+    ensureLoaded();
+    evictToFit(0);
+}
+
+QString ArtifactCache::keyFor(const QString& rootHash)
+{
+    return QString::fromLatin1(
+        QCryptographicHash::hash(rootHash.toUtf8(), QCryptographicHash::Sha256).toHex());
+}
+
+QByteArray ArtifactCache::sha256Of(const QString& path)
+{
+    QFile f(path);
+    if (!f.open(QIODevice::ReadOnly)) return {};
+    QCryptographicHash h(QCryptographicHash::Sha256);
+    if (!h.addData(&f)) return {};
+    return h.result().toHex();
+}
+
+QString ArtifactCache::artifactPath(const QString& key) const
+{
+    return m_dir + QLatin1Char('/') + key + QStringLiteral(".lgx");
+}
+
+QString ArtifactCache::sidecarPath(const QString& key) const
+{
+    return m_dir + QLatin1Char('/') + key + QStringLiteral(".sha256");
+}
+
+void ArtifactCache::ensureLoaded()
+{
+    if (m_loaded) return;
+    m_loaded = true;
+
+    QDir dir(m_dir);
+    if (!dir.exists()) return;
+    const QFileInfoList files = dir.entryInfoList({QStringLiteral("*.lgx")}, QDir::Files);
+    for (const QFileInfo& fi : files) {
+        const QString key = fi.completeBaseName();
+        // An artifact without its sidecar is a store() that didn't finish.
+        if (!QFileInfo::exists(sidecarPath(key))) {
+            QFile::remove(fi.absoluteFilePath());
+            continue;
+        }
+        Entry e;
+        e.size     = fi.size();
+        e.lastUsed = fi.lastModified().toMSecsSinceEpoch();
+        m_entries.insert(key, e);
+        m_totalBytes += e.size;
+    }
+    // Orphaned sidecars / temp files from an interrupted store().
+    const QFileInfoList leftovers =
+        dir.entryInfoList({QStringLiteral("*.sha256"), QStringLiteral("*.tmp")}, QDir::Files);
+    for (const QFileInfo& fi : leftovers) {
+        if (fi.suffix() == QLatin1String("tmp") || !m_entries.contains(fi.completeBaseName()))
+            QFile::remove(fi.absoluteFilePath());
+    }
+    evictToFit(0);
+}
+
+void ArtifactCache::touch(const QString& key, Entry& e)
+{
+    e.lastUsed = QDateTime::currentMSecsSinceEpoch();
+    QFile f(artifactPath(key));
+    if (f.open(QIODevice::ReadWrite))
+        f.setFileTime(QDateTime::fromMSecsSinceEpoch(e.lastUsed),
+                      QFileDevice::FileModificationTime);
+}
+
+void ArtifactCache::dropKey(const QString& key)
+{
+    auto it = m_entries.find(key);
+    if (it != m_entries.end()) {
+        m_totalBytes -= it->size;
+        m_entries.erase(it);
+    }
+    QFile::remove(artifactPath(key));
+    QFile::remove(sidecarPath(key));
+}
+
+void ArtifactCache::evictToFit(qint64 incoming)
+{
+    // Linear scan for the oldest entry: the cache holds hundreds of
+    // artifacts at most, and eviction only runs on store().
+    while (!m_entries.isEmpty() && m_totalBytes + incoming > m_maxBytes) {
+        auto oldest = m_entries.constBegin();
+        for (auto it = m_entries.constBegin(); it != m_entries.constEnd(); ++it) {
+            if (it->lastUsed < oldest->lastUsed) oldest = it;
+        }
+        dropKey(oldest.key());
+    }
+}
+
+bool ArtifactCache::contains(const QString& rootHash)
+{
+    if (rootHash.isEmpty()) return false;
+    ensureLoaded();
+    return m_entries.contains(keyFor(rootHash));
+}
+
+ArtifactCache::Candidate ArtifactCache::find(const QString& rootHash)
+{
+    Candidate c;
+    c.rootHash = rootHash;
+    if (rootHash.isEmpty()) return c;
+    ensureLoaded();
+    const QString key = keyFor(rootHash);
+    auto it = m_entries.find(key);
+    if (it == m_entries.end()) return c;
+
+    // Sidecar: "<rootHash>\n<sha256 hex>\n".
+    QFile sidecar(sidecarPath(key));
+    const QList<QByteArray> lines = sidecar.open(QIODevice::ReadOnly)
+        ? sidecar.readAll().split('\n') : QList<QByteArray>();
+    if (lines.size() < 2 || QString::fromUtf8(lines.at(0)) != rootHash
+        || lines.at(1).trimmed().isEmpty()
+        || QFileInfo(artifactPath(key)).size() != it->size) {
+        qWarning() << "ArtifactCache: dropping entry whose sidecar doesn't match" << rootHash;
+        dropKey(key);
+        return c;
+    }
+    c.path   = artifactPath(key);
+    c.digest = lines.at(1).trimmed();
+    c.size   = it->size;
+    return c;
+}
+
+bool ArtifactCache::verify(const Candidate& candidate)
+{
+    return !candidate.path.isEmpty() && !candidate.digest.isEmpty()
+        && QFileInfo(candidate.path).size() == candidate.size
+        && sha256Of(candidate.path) == candidate.digest;
+}
+
+void ArtifactCache::markUsed(const QString& rootHash)
+{
+    if (rootHash.isEmpty()) return;
+    ensureLoaded();
+    const QString key = keyFor(rootHash);
+    auto it = m_entries.find(key);
+    if (it != m_entries.end()) touch(key, it.value());
+}
+
+ArtifactCache::Staged ArtifactCache::stage(const QString& rootHash,
+                                           const QString& sourcePath) const
+{
+    Staged out;
+    out.rootHash = rootHash;
+    if (rootHash.isEmpty() || sourcePath.isEmpty()) return out;
+    const QFileInfo src(sourcePath);
+    if (!src.isFile() || src.size() > m_maxBytes) return out;
+    if (!QDir().mkpath(m_dir)) return out;
+
+    // Stage under a unique temp name (two results for one rootHash can
+    // be staged at once) and let commit() rename it into place, so a
+    // crash mid-store leaves only a *.tmp that the next scan deletes.
+    const QString tmp = artifactPath(keyFor(rootHash)) + QLatin1Char('.')
+        + QString::number(QRandomGenerator::global()->generate64(), 16)
+        + QStringLiteral(".tmp");
+    std::error_code ec;
+    std::filesystem::create_hard_link(src.absoluteFilePath().toStdString(),
+                                      tmp.toStdString(), ec);
+    if (ec && !QFile::copy(sourcePath, tmp)) {
+        qWarning() << "ArtifactCache: cannot store" << sourcePath;
+        return out;
+    }
+    const QByteArray digest = sha256Of(tmp);
+    if (digest.isEmpty()) {
+        QFile::remove(tmp);
+        return out;
+    }
+    out.tmpPath = tmp;
+    out.digest  = digest;
+    out.size    = QFileInfo(tmp).size();
+    return out;
+}
+
+QString ArtifactCache::commit(const Staged& staged)
+{
+    if (staged.rootHash.isEmpty() || staged.tmpPath.isEmpty()) return {};
+    ensureLoaded();
+    const QString key = keyFor(staged.rootHash);
+    auto existing = m_entries.find(key);
+    if (existing != m_entries.end()) {
+        QFile::remove(staged.tmpPath);
+        touch(key, existing.value());
+        return artifactPath(key);
+    }
+
+    evictToFit(staged.size);
+    QFile sidecar(sidecarPath(key));
+    if (!sidecar.open(QIODevice::WriteOnly | QIODevice::Truncate)
+        || sidecar.write(staged.rootHash.toUtf8() + '\n' + staged.digest + '\n') < 0) {
+        QFile::remove(staged.tmpPath);
+        return {};
+    }
+    sidecar.close();
+    QFile::remove(artifactPath(key));
+    if (!QFile::rename(staged.tmpPath, artifactPath(key))) {
+        QFile::remove(staged.tmpPath);
+        QFile::remove(sidecarPath(key));
+        return {};
+    }
+
+    Entry e;
+    e.size = staged.size;
+    m_entries.insert(key, e);
+    m_totalBytes += e.size;
+    touch(key, m_entries[key]);
+    return artifactPath(key);
+}
+
+QString ArtifactCache::lookup(const QString& rootHash)
+{
+    const Candidate c = find(rootHash);
+    if (c.path.isEmpty()) return {};
+    if (!verify(c)) {
+        qWarning() << "ArtifactCache: dropping corrupt entry for" << rootHash;
+        remove(rootHash);
+        return {};
+    }
+    markUsed(rootHash);
+    return c.path;
+}
+
+QString ArtifactCache::store(const QString& rootHash, const QString& sourcePath)
+{
+    // Load first: the scan's temp-file sweep would take the staged copy.
+    ensureLoaded();
+    return commit(stage(rootHash, sourcePath));
+}
+
+void ArtifactCache::remove(const QString& rootHash)
+{
+    if (rootHash.isEmpty()) return;
+    ensureLoaded();
+    dropKey(keyFor(rootHash));
+}
+
+int ArtifactCache::count()
+{
+    ensureLoaded();
+    return static_cast<int>(m_entries.size());
+}
+
+qint64 ArtifactCache::totalBytes()
+{
+    ensureLoaded();
+    return m_totalBytes;
+}
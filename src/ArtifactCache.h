@@ -0,0 +1,124 @@
+#pragma once
+
+#include <QByteArray>
+#include <QHash>
+#include <QString>
+
+// Content-addressed store of downloaded .lgx artifacts, keyed by the
+// catalog's rootHash, so Reinstall, a downgrade-then-upgrade and Retry
+// install from disk instead of downloading the same bytes again.
+//
+// Layout under directory(): one `<key>.lgx` per artifact plus a
+// `<key>.sha256` sidecar holding the rootHash it was stored under and
+// the hex SHA-256 of the file as stored. `<key>` is the SHA-256 of the
+// rootHash string, so any rootHash spelling is a safe file name. There's
+// no separate index: the directory is scanned on first use and each
+// file's mtime doubles as its last-used time, so LRU order survives
+// restarts.
+//
+// Integrity: rootHash itself can't be recomputed here — that needs
+// liblgx, which the plugin deliberately doesn't link — so the chain is:
+// package_downloader checked the bytes against rootHash when it
+// delivered them, only a downloader result is ever stored under that
+// rootHash, and the sidecar pins those exact bytes. A hit is accepted
+// when the sidecar names the requested rootHash and the file still
+// hashes to the pinned digest; anything else (truncated copy, disk
+// corruption, a file edited in place, a sidecar from another entry)
+// drops the entry and reports a miss.
+//
+// Hashing a whole artifact is too slow for the GUI thread, so the work
+// is split: stage() (copy + digest) and verify() (re-hash) touch no
+// cache state and run on a worker; load(), commit(), find(), markUsed()
+// and remove() update the index and stay on the owning thread. store()
+// and lookup() are the blocking compositions of the two halves.
+//
+// Eviction: commit() evicts least-recently-used entries until the new
+// artifact fits under maxBytes(). An artifact larger than the whole cap
+// isn't cached at all.
+class ArtifactCache {
+public:
+    static constexpr qint64 kDefaultMaxBytes = 2LL * 1024 * 1024 * 1024;
+
+    // Empty `directory` = defaultDirectory().
+    explicit ArtifactCache(const QString& directory = QString(),
+                           qint64 maxBytes = kDefaultMaxBytes);
+
+    // <QStandardPaths::CacheLocation>/artifacts
+    static QString defaultDirectory();
+
+    QString directory() const { return m_dir; }
+    qint64  maxBytes() const { return m_maxBytes; }
+    void    setMaxBytes(qint64 maxBytes);
+
+    // Scan directory() into the index (implicit on first use of any
+    // index call). Call it before handing stage() to a worker: the scan
+    // sweeps leftover temp files and mustn't race a stage in progress.
+    void load() { ensureLoaded(); }
+
+    // Cheap membership test against the index — no hashing.
+    bool contains(const QString& rootHash);
+
+    // A cached artifact as the index knows it, before verification.
+    struct Candidate {
+        QString    rootHash;
+        QString    path;       // empty = not cached
+        QByteArray digest;     // pinned at store time
+        qint64     size = 0;
+    };
+    // Index + sidecar read only. The sidecar must name `rootHash`; an
+    // entry whose sidecar doesn't is dropped and reported as a miss.
+    Candidate find(const QString& rootHash);
+    // Worker-safe: does the file still hash to the pinned digest?
+    static bool verify(const Candidate& candidate);
+    // A verified hit: mark the entry most recently used.
+    void markUsed(const QString& rootHash);
+
+    // A downloader result copied (hard-linked when the cache is on the
+    // same filesystem) into a temp file next to the cache and hashed.
+    struct Staged {
+        QString    rootHash;
+        QString    tmpPath;    // empty = nothing staged
+        QByteArray digest;
+        qint64     size = 0;
+    };
+    // Worker-safe: reads only directory() and maxBytes(). Stages nothing
+    // for an unreadable source or one over the cap.
+    Staged  stage(const QString& rootHash, const QString& sourcePath) const;
+    // Move a staged file into place and index it. Returns the cached
+    // path, or empty on failure. Committing a rootHash that's already
+    // cached discards the staged copy and just refreshes recency.
+    QString commit(const Staged& staged);
+
+    // Blocking: verify() + markUsed(). Verified path of the cached
+    // artifact, or empty on a miss / a failed integrity check.
+    QString lookup(const QString& rootHash);
+    // Blocking: stage() + commit().
+    QString store(const QString& rootHash, const QString& sourcePath);
+
+    void remove(const QString& rootHash);
+
+    int    count();
+    qint64 totalBytes();
+
+private:
+    struct Entry {
+        qint64 size     = 0;
+        qint64 lastUsed = 0;   // ms since epoch
+    };
+
+    static QString keyFor(const QString& rootHash);
+    static QByteArray sha256Of(const QString& path);
+    QString artifactPath(const QString& key) const;
+    QString sidecarPath(const QString& key) const;
+
+    void ensureLoaded();
+    void touch(const QString& key, Entry& e);
+    void dropKey(const QString& key);
+    void evictToFit(qint64 incoming);
+
+    QString m_dir;
+    qint64  m_maxBytes;
+    bool    m_loaded = false;
+    QHash<QString, Entry> m_entries;   // by key
+    qint64  m_totalBytes = 0;
+};
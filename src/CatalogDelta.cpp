@@ -0,0 +1,74 @@
+#include "CatalogDelta.h"
+
+#include <utility>
+
+#include <QHash>
+#include <QSet>
+#include <QStringList>
+
+namespace catalogdelta {
+
+QString rowKey(const QVariantMap& row)
+{
+    return row.value(QStringLiteral("repositoryUrl")).toString() + QLatin1Char('\n')
+         + row.value(QStringLiteral("name")).toString();
+}
+
+QVariantList apply(const QVariantList& catalog, const QVariantMap& delta)
+{
+    QSet<QString> removed;
+    for (const QVariant& v : delta.value(QStringLiteral("removed")).toList())
+        removed.insert(rowKey(v.toMap()));
+
+    // Upserts by key, in delta order; `changed` after `added` so a row
+    // listed in both ends up with its changed form.
+    QHash<QString, QVariantMap> upserts;
+    QStringList upsertOrder;
+    for (const char* list : {"added", "changed"}) {
+        for (const QVariant& v : delta.value(QLatin1String(list)).toList()) {
+            const QVariantMap row = v.toMap();
+            const QString key = rowKey(row);
+            if (!upserts.contains(key)) upsertOrder.append(key);
+            upserts.insert(key, row);
+        }
+    }
+
+    QVariantList out;
+    out.reserve(catalog.size() + upserts.size());
+    for (const QVariant& v : catalog) {
+        const QString key = rowKey(v.toMap());
+        if (removed.contains(key)) continue;
+        const auto it = upserts.constFind(key);
+        if (it == upserts.constEnd()) {
+            out.append(v);
+        } else {
+            out.append(*it);
+            upserts.remove(key);
+        }
+    }
+    for (const QString& key : std::as_const(upsertOrder)) {
+        const auto it = upserts.constFind(key);
+        if (it != upserts.constEnd() && !removed.contains(key)) out.append(*it);
+    }
+    return out;
+}
+
+QSet<QString> names(const QVariantMap& delta)
+{
+    QSet<QString> out;
+    for (const char* list : {"added", "changed", "removed"}) {
+        for (const QVariant& v : delta.value(QLatin1String(list)).toList())
+            out.insert(v.toMap().value(QStringLiteral("name")).toString());
+    }
+    out.remove(QString());
+    return out;
+}
+
+int size(const QVariantMap& delta)
+{
+    return delta.value(QStringLiteral("added")).toList().size()
+         + delta.value(QStringLiteral("changed")).toList().size()
+         + delta.value(QStringLiteral("removed")).toList().size();
+}
+
+} // namespace catalogdelta
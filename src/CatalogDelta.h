@@ -0,0 +1,36 @@
+#pragma once
+
+#include <QSet>
+#include <QString>
+#include <QVariantList>
+#include <QVariantMap>
+
+// package_downloader.getCatalogDelta's reply, applied to a cached
+// getCatalog() list. A delta describes the catalog rows (one per package
+// per repository, all of its versions) that changed since a generation
+// the caller remembers:
+//
+//   { generation: <int>,          the catalog's generation now
+//     full:       <bool>,         true = can't say; fetch the whole catalog
+//     added:      [<row>, …],     rows new since then
+//     changed:    [<row>, …],     rows whose fields or versions moved
+//     removed:    [{repositoryUrl, name}, …] }
+//
+// Applying is idempotent — rows are upserted and removed by key — so a
+// delta that overlaps changes already in the cache is harmless.
+namespace catalogdelta {
+
+// Row identity across repositories: repositoryUrl + "\n" + name.
+QString rowKey(const QVariantMap& row);
+
+// Rows changed in place keep their position; added rows are appended in
+// the delta's order.
+QVariantList apply(const QVariantList& catalog, const QVariantMap& delta);
+
+// Package names the delta touches, across all three lists.
+QSet<QString> names(const QVariantMap& delta);
+
+// Rows the delta touches (added + changed + removed).
+int size(const QVariantMap& delta);
+
+} // namespace catalogdelta
@@ -0,0 +1,200 @@
+#include "CatalogInterner.h"
+
+#include <QHashFunctions>
+#include <QStringList>
+#include <QVariantMap>
+
+namespace {
+
+// Keys whose value, and everything under it, is hash-consed. Rows and
+// version entries themselves are unique per (repository, name,
+// version); looking them up would only cost.
+bool sharesChildren(const QString& key)
+{
+    return key == QLatin1String("manifest") || key == QLatin1String("dependencies");
+}
+
+// Held only by the pool. Containers are checked through the QMap /
+// QList inside the QVariant; a copy of it would count as a reference.
+bool poolOnly(const QVariant& v)
+{
+    if (v.typeId() == QMetaType::QVariantMap)
+        return static_cast<const QVariantMap*>(v.constData())->isDetached();
+    if (v.typeId() == QMetaType::QVariantList)
+        return static_cast<const QVariantList*>(v.constData())->isDetached();
+    return false;
+}
+
+bool samePooled(const QString& a, const QString& b)
+{
+    return a.constData() == b.constData() || (a.isEmpty() && b.isEmpty());
+}
+
+// Whether two containers built by node() under a shared key hold the
+// same children. Those children are already pooled — strings are the
+// pool's copy, maps and lists the pool's instance — so equal children
+// are the same object and one level of identity checks decides it,
+// where QVariant::operator== would walk the whole subtree on every hit.
+bool sameChild(const QVariant& a, const QVariant& b)
+{
+    if (a.typeId() != b.typeId()) return false;
+    switch (a.typeId()) {
+    case QMetaType::QVariantMap:
+        return static_cast<const QVariantMap*>(a.constData())
+            ->isSharedWith(*static_cast<const QVariantMap*>(b.constData()));
+    case QMetaType::QVariantList: {
+        const auto* la = static_cast<const QVariantList*>(a.constData());
+        const auto* lb = static_cast<const QVariantList*>(b.constData());
+        return la->isSharedWith(*lb) || (la->isEmpty() && lb->isEmpty());
+    }
+    case QMetaType::QString:
+        return samePooled(*static_cast<const QString*>(a.constData()),
+                          *static_cast<const QString*>(b.constData()));
+    default:
+        return a == b;
+    }
+}
+
+bool sameContainer(const QVariant& a, const QVariant& b)
+{
+    if (a.typeId() != b.typeId()) return false;
+    if (a.typeId() == QMetaType::QVariantMap) {
+        const auto* ma = static_cast<const QVariantMap*>(a.constData());
+        const auto* mb = static_cast<const QVariantMap*>(b.constData());
+        if (ma->size() != mb->size()) return false;
+        for (auto ia = ma->cbegin(), ib = mb->cbegin(); ia != ma->cend(); ++ia, ++ib) {
+            if (!samePooled(ia.key(), ib.key()) || !sameChild(*ia, *ib))
+                return false;
+        }
+        return true;
+    }
+    const auto* la = static_cast<const QVariantList*>(a.constData());
+    const auto* lb = static_cast<const QVariantList*>(b.constData());
+    if (la->size() != lb->size()) return false;
+    for (qsizetype i = 0; i < la->size(); ++i) {
+        if (!sameChild(la->at(i), lb->at(i))) return false;
+    }
+    return true;
+}
+
+} // namespace
+
+QVariantList CatalogInterner::intern(const QVariantList& catalog)
+{
+    QVariantList out;
+    out.reserve(catalog.size());
+    size_t unused = 0;
+    for (const QVariant& row : catalog) out.append(node(row, false, &unused));
+    return out;
+}
+
+QString CatalogInterner::string(const QString& s)
+{
+    if (s.isEmpty()) return s;
+    const auto it = m_strings.constFind(s);
+    if (it != m_strings.constEnd()) {
+        ++m_hits;
+        return *it;
+    }
+    m_strings.insert(s);
+    return s;
+}
+
+QVariant CatalogInterner::node(const QVariant& v, bool share, size_t* hash)
+{
+    switch (v.typeId()) {
+    case QMetaType::QVariantMap: {
+        const QVariantMap in = v.toMap();
+        QVariantMap out;
+        size_t h = qHash(int(QMetaType::QVariantMap));
+        for (auto it = in.cbegin(); it != in.cend(); ++it) {
+            const QString key = string(it.key());
+            size_t child = 0;
+            out.insert(out.cend(), key, node(it.value(), share || sharesChildren(key), &child));
+            h = qHashMulti(h, key, child);
+        }
+        *hash = h;
+        return share ? shared(out, h) : QVariant(out);
+    }
+    case QMetaType::QVariantList: {
+        const QVariantList in = v.toList();
+        QVariantList out;
+        out.reserve(in.size());
+        size_t h = qHash(int(QMetaType::QVariantList));
+        for (const QVariant& e : in) {
+            size_t child = 0;
+            out.append(node(e, share, &child));
+            h = qHashMulti(h, child);
+        }
+        *hash = h;
+        return share ? shared(out, h) : QVariant(out);
+    }
+    case QMetaType::QStringList: {
+        QStringList out = v.toStringList();
+        size_t h = qHash(int(QMetaType::QStringList));
+        for (QString& e : out) {
+            e = string(e);
+            h = qHashMulti(h, e);
+        }
+        *hash = h;
+        return out;
+    }
+    case QMetaType::QString: {
+        const QString s = string(v.toString());
+        *hash = qHash(s);
+        return s;
+    }
+    case QMetaType::Bool:
+        *hash = qHash(v.toBool());
+        return v;
+    case QMetaType::Int:
+    case QMetaType::LongLong:
+    case QMetaType::UInt:
+    case QMetaType::ULongLong:
+        *hash = qHash(v.toLongLong());
+        return v;
+    case QMetaType::Double:
+    case QMetaType::Float:
+        *hash = qHash(v.toDouble());
+        return v;
+    default:
+        *hash = qHash(v.typeId());
+        return v;
+    }
+}
+
+QVariant CatalogInterner::shared(const QVariant& v, size_t hash)
+{
+    const auto [first, last] = m_containers.equal_range(hash);
+    for (auto it = first; it != last; ++it) {
+        if (sameContainer(*it, v)) {
+            ++m_hits;
+            return *it;
+        }
+    }
+    m_containers.insert(hash, v);
+    return v;
+}
+
+void CatalogInterner::prune()
+{
+    // A container's children are referenced by the container, so they
+    // only become pool-only once it's gone: repeat until nothing drops.
+    for (bool dropped = true; dropped;) {
+        dropped = false;
+        for (auto it = m_containers.begin(); it != m_containers.end();) {
+            if (poolOnly(*it)) {
+                it = m_containers.erase(it);
+                dropped = true;
+            } else {
+                ++it;
+            }
+        }
+    }
+    for (auto it = m_strings.begin(); it != m_strings.end();) {
+        if (it->isDetached())
+            it = m_strings.erase(it);
+        else
+            ++it;
+    }
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <QMultiHash>
+#include <QSet>
+#include <QString>
+#include <QVariant>
+#include <QVariantList>
+
+// Shared storage for catalog strings and manifests.
+//
+// Every catalog row carries a manifest per version, and most of what's
+// in one repeats across versions and across repositories that mirror
+// each other: descriptions, categories, `main` variant keys, dependency
+// lists — every map key. Off the wire each of those is its own
+// allocation. intern() returns the same catalog with
+//   * every string replaced by one pooled copy, and
+//   * every map or list at or under a `manifest` (and a row's own
+//     `dependencies`) hash-consed: equal ones are the same container.
+// Qt's implicit sharing is the reference: rows built from an interned
+// catalog, the model and the details path all point into the pool
+// rather than holding copies.
+//
+// Containers are built bottom-up, so by the time one is looked up its
+// children are pool instances: a hit is decided by comparing those one
+// level deep by identity, not by a deep ==.
+//
+// The pool only grows; prune() drops what nothing outside it references
+// any more, after the rows built from an older catalog are gone.
+class CatalogInterner {
+public:
+    QVariantList intern(const QVariantList& catalog);
+    QString      string(const QString& s);
+
+    // Drop pooled strings and containers nothing else holds.
+    void prune();
+
+    int    stringCount() const { return int(m_strings.size()); }
+    int    containerCount() const { return int(m_containers.size()); }
+    // intern() lookups answered from the pool, strings and containers.
+    qint64 hits() const { return m_hits; }
+
+private:
+    QVariant node(const QVariant& v, bool share, size_t* hash);
+    QVariant shared(const QVariant& v, size_t hash);
+
+    QSet<QString>                m_strings;
+    QMultiHash<size_t, QVariant> m_containers;   // content hash → map / list
+    qint64                       m_hits = 0;
+};
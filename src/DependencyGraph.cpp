@@ -0,0 +1,354 @@
+#include "DependencyGraph.h"
+
+#include <algorithm>
+#include <QSet>
+#include <QVariantMap>
+
+#include "RowActionResolver.h"
+
+namespace {
+
+QString nodeKey(const QString& name, const QString& version)
+{
+    return name + QChar(0x01) + version;
+}
+
+QString installedNameOf(const QVariantMap& m)
+{
+    const QString moduleName = m.value("moduleName").toString();
+    return moduleName.isEmpty() ? m.value("name").toString() : moduleName;
+}
+
+// The moduleName a catalog row installs as, same fallback as
+// buildPackageRow; empty when the row doesn't say.
+QString catalogModuleNameOf(const QVariantMap& row)
+{
+    QString moduleName = row.value("moduleName").toString();
+    if (moduleName.isEmpty()) {
+        const QVariantList versions = row.value("versions").toList();
+        if (!versions.isEmpty())
+            moduleName = versions.first().toMap().value("manifest").toMap()
+                             .value("name").toString();
+    }
+    return moduleName;
+}
+
+QVariantList installedDependenciesOf(const QVariantMap& m)
+{
+    QVariantList deps = m.value("dependencies").toList();
+    if (deps.isEmpty()) deps = m.value("manifest").toMap().value("dependencies").toList();
+    return deps;
+}
+
+QHash<QString, QString> installedVersionsOf(const QVariantList& installed)
+{
+    QHash<QString, QString> versionByName;
+    for (const QVariant& v : installed) {
+        const QVariantMap m = v.toMap();
+        const QString name = installedNameOf(m);
+        const QString version = m.value("version").toString();
+        if (!name.isEmpty() && !version.isEmpty()) versionByName.insert(name, version);
+    }
+    return versionByName;
+}
+
+} // namespace
+
+int DependencyGraph::internName(const QString& name)
+{
+    auto it = m_nameIds.constFind(name);
+    if (it != m_nameIds.constEnd()) return it.value();
+    const int id = m_names.size();
+    m_names.append(name);
+    m_nameIds.insert(name, id);
+    m_versionsByName.append(QList<int>());
+    m_dependentNodes.append(QList<int>());
+    m_installedNode.append(kNotInstalled);
+    return id;
+}
+
+QString DependencyGraph::canonicalName(const QString& name) const
+{
+    return m_moduleAliases.value(name, name);
+}
+
+QString DependencyGraph::moduleName(const QString& name) const
+{
+    return m_moduleNames.value(name, name);
+}
+
+int DependencyGraph::nodeFor(int nameId, const QString& version) const
+{
+    if (nameId < 0) return -1;
+    if (version.isEmpty()) return stepNode(nameId);
+    return m_nodeByKey.value(nodeKey(m_names.at(nameId), version), -1);
+}
+
+int DependencyGraph::stepNode(int nameId) const
+{
+    if (nameId < 0) return -1;
+    const int installed = m_installedNode.at(nameId);
+    if (installed >= 0) return installed;
+    if (installed == kUnknownVersion) return -1;
+    const QList<int>& versions = m_versionsByName.at(nameId);
+    return versions.isEmpty() ? -1 : versions.first();
+}
+
+void DependencyGraph::addDependencies(int nodeId, const QVariantList& deps)
+{
+    // Same two entry shapes buildPackageRow renders: a bare name, or
+    // { name, version, signer } under the newer manifest schema.
+    for (const QVariant& dep : deps) {
+        QString name;
+        if (dep.canConvert<QVariantMap>() && dep.toString().isEmpty()) {
+            name = dep.toMap().value("name").toString();
+        } else {
+            name = dep.toString().trimmed();
+        }
+        if (name.isEmpty()) continue;
+        const int target = internName(canonicalName(name));
+        // internName may grow m_nodes' sibling lists but never m_nodes.
+        Node& node = m_nodes[nodeId];
+        if (node.deps.contains(target)) continue;
+        node.deps.append(target);
+        m_dependentNodes[target].append(nodeId);
+    }
+}
+
+void DependencyGraph::ensureNode(const QString& name, const QString& version,
+                                 const QVariantList& deps)
+{
+    // One node per distinct (name, version). The same version listed by
+    // two repositories is one node: its manifest — and so its edges — is
+    // the same package either way.
+    const QString key = nodeKey(name, version);
+    if (m_nodeByKey.contains(key)) return;
+    const int nameId = internName(name);
+    const int nodeId = m_nodes.size();
+    Node node;
+    node.nameId  = nameId;
+    node.version = version;
+    m_nodes.append(node);
+    m_nodeByKey.insert(key, nodeId);
+    m_versionsByName[nameId].append(nodeId);
+    addDependencies(nodeId, deps);
+}
+
+void DependencyGraph::addRowNodes(const QVariantMap& row)
+{
+    const QString name = row.value("name").toString();
+    if (name.isEmpty()) return;
+    for (const QVariant& vv : row.value("versions").toList()) {
+        const QVariantMap manifest = vv.toMap().value("manifest").toMap();
+        const QString version = manifest.value("version").toString();
+        if (version.isEmpty()) continue;
+        ensureNode(name, version, manifest.value("dependencies").toList());
+    }
+}
+
+void DependencyGraph::sortVersions(int nameId)
+{
+    QList<int>& versions = m_versionsByName[nameId];
+    std::sort(versions.begin(), versions.end(), [this](int a, int b) {
+        return rowaction::versionCmp(m_nodes.at(a).version, m_nodes.at(b).version) > 0;
+    });
+}
+
+void DependencyGraph::build(const QVariantList& catalog, const QVariantList& installed)
+{
+    m_names.clear();
+    m_nameIds.clear();
+    m_nodes.clear();
+    m_nodeByKey.clear();
+    m_versionsByName.clear();
+    m_dependentNodes.clear();
+    m_installedNode.clear();
+    m_moduleAliases.clear();
+    m_moduleNames.clear();
+    m_deadNodes = 0;
+
+    // Installed entries — and some manifests' dependency lists — use the
+    // moduleName; map each back to its catalog name first so both
+    // spellings land on one name id.
+    for (const QVariant& rowVar : catalog) {
+        const QVariantMap row = rowVar.toMap();
+        const QString name = row.value("name").toString();
+        const QString moduleName = catalogModuleNameOf(row);
+        if (!name.isEmpty() && !moduleName.isEmpty() && moduleName != name) {
+            m_moduleAliases.insert(moduleName, name);
+            m_moduleNames.insert(name, moduleName);
+        }
+    }
+
+    for (const QVariant& rowVar : catalog) addRowNodes(rowVar.toMap());
+
+    // Installed copies the catalog doesn't list (sideloaded .lgx, a
+    // version since pulled from its repo) — only useful if the entry
+    // brought its own dependency list.
+    for (const QVariant& v : installed) {
+        const QVariantMap m = v.toMap();
+        const QString name = canonicalName(installedNameOf(m));
+        const QString version = m.value("version").toString();
+        if (name.isEmpty() || version.isEmpty()) continue;
+        const QVariantList deps = installedDependenciesOf(m);
+        if (deps.isEmpty()) continue;
+        ensureNode(name, version, deps);
+    }
+
+    for (int nameId = 0; nameId < m_versionsByName.size(); ++nameId) sortVersions(nameId);
+
+    setInstalledVersions(installedVersionsOf(installed));
+}
+
+bool DependencyGraph::update(const QVariantList& catalog, const QVariantList& installed,
+                             const QSet<QString>& names)
+{
+    if (names.isEmpty()) return true;
+    // Nothing to patch, or more retired node slots than live ones.
+    if (m_nodes.isEmpty() || m_deadNodes * 2 > m_nodes.size()) return false;
+
+    // The touched names' rows as the catalog has them now. Their
+    // moduleName aliases have to be the ones the graph was built with:
+    // edges elsewhere were interned through them.
+    QList<QVariantMap> rows;
+    QHash<QString, QString> aliases;
+    for (const QVariant& rowVar : catalog) {
+        const QVariantMap row = rowVar.toMap();
+        const QString name = row.value("name").toString();
+        if (!names.contains(name)) continue;
+        rows.append(row);
+        const QString moduleName = catalogModuleNameOf(row);
+        if (!moduleName.isEmpty() && moduleName != name) aliases.insert(moduleName, name);
+    }
+    for (auto it = m_moduleAliases.constBegin(); it != m_moduleAliases.constEnd(); ++it) {
+        if (names.contains(it.value()) && aliases.value(it.key()) != it.value()) return false;
+    }
+    for (auto it = aliases.constBegin(); it != aliases.constEnd(); ++it) {
+        if (m_moduleAliases.value(it.key()) != it.value()) return false;
+    }
+
+    // Retire the touched names' nodes: unhook their edges and drop them
+    // from the lookups. The slots stay in m_nodes until the next build.
+    QList<int> touchedIds;
+    for (const QString& name : names) {
+        const int nameId = internName(name);
+        touchedIds.append(nameId);
+        for (int nodeId : std::as_const(m_versionsByName[nameId])) {
+            Node& node = m_nodes[nodeId];
+            for (int target : std::as_const(node.deps)) m_dependentNodes[target].removeOne(nodeId);
+            m_nodeByKey.remove(nodeKey(name, node.version));
+            node.deps.clear();
+            ++m_deadNodes;
+        }
+        m_versionsByName[nameId].clear();
+    }
+
+    for (const QVariantMap& row : std::as_const(rows)) addRowNodes(row);
+    for (const QVariant& v : installed) {
+        const QVariantMap m = v.toMap();
+        const QString name = canonicalName(installedNameOf(m));
+        const QString version = m.value("version").toString();
+        if (!names.contains(name) || version.isEmpty()) continue;
+        const QVariantList deps = installedDependenciesOf(m);
+        if (deps.isEmpty()) continue;
+        ensureNode(name, version, deps);
+    }
+    for (int nameId : std::as_const(touchedIds)) sortVersions(nameId);
+
+    setInstalledVersions(installedVersionsOf(installed));
+    return true;
+}
+
+void DependencyGraph::setInstalledVersions(const QHash<QString, QString>& versionByName)
+{
+    std::fill(m_installedNode.begin(), m_installedNode.end(), kNotInstalled);
+    for (auto it = versionByName.constBegin(); it != versionByName.constEnd(); ++it) {
+        const QString name = canonicalName(it.key());
+        const int nameId = m_nameIds.value(name, -1);
+        if (nameId < 0) continue;
+        m_installedNode[nameId] = m_nodeByKey.value(nodeKey(name, it.value()), kUnknownVersion);
+    }
+}
+
+bool DependencyGraph::isInstalledVersionUnknown(const QString& name) const
+{
+    const int nameId = m_nameIds.value(canonicalName(name), -1);
+    return nameId >= 0 && m_installedNode.at(nameId) == kUnknownVersion;
+}
+
+QStringList DependencyGraph::dependencies(const QString& name, const QString& version) const
+{
+    QStringList out;
+    const int nodeId = nodeFor(m_nameIds.value(canonicalName(name), -1), version);
+    if (nodeId < 0) return out;
+    for (int target : m_nodes.at(nodeId).deps) out.append(m_names.at(target));
+    return out;
+}
+
+QStringList DependencyGraph::dependents(const QString& name, bool installedOnly) const
+{
+    QStringList out;
+    const int nameId = m_nameIds.value(canonicalName(name), -1);
+    if (nameId < 0) return out;
+    QSet<int> seen;
+    for (int nodeId : m_dependentNodes.at(nameId)) {
+        const int dependent = m_nodes.at(nodeId).nameId;
+        if (seen.contains(dependent)) continue;
+        if (installedOnly && m_installedNode.at(dependent) != nodeId) continue;
+        seen.insert(dependent);
+        out.append(m_names.at(dependent));
+    }
+    std::sort(out.begin(), out.end());
+    return out;
+}
+
+QStringList DependencyGraph::dependencyClosure(const QString& name, const QString& version,
+                                               QStringList* unknown) const
+{
+    QStringList out;
+    const int rootName = m_nameIds.value(canonicalName(name), -1);
+    const int root = nodeFor(rootName, version);
+    if (root < 0) {
+        if (unknown && version.isEmpty() && rootName >= 0
+            && m_installedNode.at(rootName) == kUnknownVersion)
+            unknown->append(m_names.at(rootName));
+        return out;
+    }
+
+    QSet<int> seen{rootName};
+    QList<int> queue{root};
+    for (int head = 0; head < queue.size(); ++head) {
+        for (int target : m_nodes.at(queue.at(head)).deps) {
+            if (seen.contains(target)) continue;
+            seen.insert(target);
+            out.append(m_names.at(target));
+            const int next = stepNode(target);
+            if (next >= 0)
+                queue.append(next);
+            else if (unknown && m_installedNode.at(target) == kUnknownVersion)
+                unknown->append(m_names.at(target));
+        }
+    }
+    return out;
+}
+
+QStringList DependencyGraph::dependentClosure(const QString& name) const
+{
+    QStringList out;
+    const int rootName = m_nameIds.value(canonicalName(name), -1);
+    if (rootName < 0) return out;
+
+    QSet<int> seen{rootName};
+    QList<int> queue{rootName};
+    for (int head = 0; head < queue.size(); ++head) {
+        for (int nodeId : m_dependentNodes.at(queue.at(head))) {
+            const int dependent = m_nodes.at(nodeId).nameId;
+            if (seen.contains(dependent)) continue;
+            if (m_installedNode.at(dependent) != nodeId) continue;
+            seen.insert(dependent);
+            out.append(m_names.at(dependent));
+            queue.append(dependent);
+        }
+    }
+    return out;
+}
@@ -0,0 +1,118 @@
+#pragma once
+
+#include <QHash>
+#include <QList>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+#include <QVariantList>
+#include <QVariantMap>
+
+// Local dependency graph over every catalog version plus the installed
+// set, so "what does X pull in" / "what depends on X" is answered in
+// process instead of via a package_downloader round trip.
+//
+// Package names and (name, version) nodes are interned to ints on build;
+// every query walks int adjacency lists.
+//
+//   * forward  — node → the package names its manifest depends on.
+//                Declared ranges are NOT solved here — that stays
+//                package_downloader's job.
+//   * reverse  — package name → every node whose manifest depends on it.
+//
+// Queries accept either the catalog `name` or the installed moduleName.
+//
+// A dependency edge targets a NAME, not a version: when a walk needs to
+// step through it, it uses the installed version of that package, or
+// for a package that isn't installed the newest catalog version — what
+// an install of it would land on in the common case. A package that IS
+// installed, at a version the graph has no node for, is unknown: the
+// walk stops there and reports it, rather than guess from a version
+// that isn't on disk.
+class DependencyGraph {
+public:
+    // `catalog` is package_downloader.getCatalog() (one row per
+    // (repo, package), each with `versions[].manifest`); `installed` is
+    // package_manager.getInstalledPackages(). Installed entries whose
+    // version is not in the catalog still become nodes when the entry
+    // carries its own `dependencies` (or `manifest.dependencies`).
+    void build(const QVariantList& catalog, const QVariantList& installed);
+
+    // Rebuild only the nodes of the catalog `names` a catalog delta
+    // touched, against the catalog as it is after the delta; the rest of
+    // the graph stays. Returns false, having changed nothing, when a
+    // full build() is needed instead: the delta moves a moduleName alias
+    // (other names' edges were interned through it) or retired nodes
+    // would outnumber live ones.
+    bool update(const QVariantList& catalog, const QVariantList& installed,
+                const QSet<QString>& names);
+
+    // Re-point the installed markers without rebuilding the adjacency —
+    // for the install / uninstall events between refreshes.
+    void setInstalledVersions(const QHash<QString, QString>& versionByName);
+
+    bool isEmpty() const { return m_nodes.isEmpty(); }
+
+    // Installed at a version the graph has no node for: its edges are
+    // unknown, and the queries below don't walk through it.
+    bool isInstalledVersionUnknown(const QString& name) const;
+
+    // Direct dependencies of `name` at `version` (installed, else
+    // newest, when `version` is empty). Declared order, de-duplicated.
+    // Empty for an unknown installed version.
+    QStringList dependencies(const QString& name, const QString& version = {}) const;
+
+    // Packages with at least one version depending directly on `name`.
+    // With `installedOnly`, only installed packages whose INSTALLED
+    // version depends on it — the set an uninstall of `name` breaks.
+    QStringList dependents(const QString& name, bool installedOnly) const;
+
+    // Everything `name` pulls in, transitively, in breadth-first order
+    // (nearest first). Excludes `name` itself; cycles are tolerated.
+    // Packages reached at an unknown installed version are listed but
+    // not walked through; `unknown` (when given) collects them, and
+    // `name` itself when it's the unknown one.
+    QStringList dependencyClosure(const QString& name, const QString& version = {},
+                                  QStringList* unknown = nullptr) const;
+
+    // Every installed package that transitively depends on `name`,
+    // nearest first — the full cascade of an uninstall.
+    QStringList dependentClosure(const QString& name) const;
+
+    // The catalog name a moduleName (or catalog name) is indexed under.
+    QString canonicalName(const QString& name) const;
+
+    // The moduleName a catalog `name` installs as — the key the installed
+    // set uses. `name` itself when the catalog row doesn't rename it.
+    QString moduleName(const QString& name) const;
+
+private:
+    struct Node {
+        int     nameId = -1;
+        QString version;
+        QList<int> deps;         // target name ids, de-duplicated
+    };
+
+    int  internName(const QString& name);
+    int  nodeFor(int nameId, const QString& version) const;
+    int  stepNode(int nameId) const;   // installed node, newest if not installed, else -1
+    void addDependencies(int nodeId, const QVariantList& deps);
+    void ensureNode(const QString& name, const QString& version, const QVariantList& deps);
+    void addRowNodes(const QVariantMap& row);
+    void sortVersions(int nameId);
+
+    QStringList         m_names;
+    QHash<QString, int> m_nameIds;
+    QList<Node>         m_nodes;
+    QHash<QString, int> m_nodeByKey;        // name + '\x01' + version → node
+    QList<QList<int>>   m_versionsByName;   // name id → node ids, newest first
+    QList<QList<int>>   m_dependentNodes;   // name id → nodes depending on it
+    // name id → installed node id, kNotInstalled, or kUnknownVersion
+    // (installed at a version with no node).
+    static constexpr int kNotInstalled   = -1;
+    static constexpr int kUnknownVersion = -2;
+    QList<int>          m_installedNode;
+    QHash<QString, QString> m_moduleAliases; // moduleName → catalog name, where they differ
+    QHash<QString, QString> m_moduleNames;   // the reverse: catalog name → moduleName
+    int                 m_deadNodes = 0;    // slots update() retired, reclaimed by build()
+};
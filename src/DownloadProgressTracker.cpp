@@ -0,0 +1,99 @@
+#include "DownloadProgressTracker.h"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+void DownloadProgressTracker::update(const QString& artifact, qint64 bytesDone,
+                                     qint64 bytesTotal, qint64 nowMs)
+{
+    if (artifact.isEmpty()) return;
+    bytesDone = std::max<qint64>(0, bytesDone);
+
+    auto it = m_artifacts.find(artifact);
+    if (it == m_artifacts.end()) {
+        it = m_artifacts.insert(artifact, Artifact{});
+        ++m_unknownTotals;
+    }
+    Artifact& a = it.value();
+
+    // Keep the running sums incremental: take this artifact's old
+    // contribution out, put the new one in.
+    if (a.total <= 0 && bytesTotal > 0) {
+        --m_unknownTotals;
+        a.total = bytesTotal;
+        m_knownTotal += bytesTotal;
+    } else if (a.total > 0 && bytesTotal > 0 && bytesTotal != a.total) {
+        m_knownTotal += bytesTotal - a.total;
+        a.total = bytesTotal;
+    }
+    m_bytesDone += bytesDone - a.done;
+    a.done = bytesDone;
+
+    if (m_sampleAtMs < 0) {
+        m_sampleAtMs  = nowMs;
+        m_sampleBytes = m_bytesDone;
+        return;
+    }
+    const qint64 dt = nowMs - m_sampleAtMs;
+    if (dt < kSampleIntervalMs) return;
+
+    // A retry can shrink bytesDone; treat that window as no progress
+    // rather than a negative rate.
+    const double sample = std::max<qint64>(0, m_bytesDone - m_sampleBytes) * 1000.0 / dt;
+    m_rate = m_haveRate ? kSmoothing * sample + (1.0 - kSmoothing) * m_rate : sample;
+    m_haveRate    = true;
+    m_sampleAtMs  = nowMs;
+    m_sampleBytes = m_bytesDone;
+}
+
+bool DownloadProgressTracker::applyEvent(const QJsonObject& event, qint64 nowMs)
+{
+    const QJsonValue done = event.value(QStringLiteral("bytesDone"));
+    const QJsonValue total = event.value(QStringLiteral("bytesTotal"));
+    if (!done.isDouble() || !(total.isDouble() || total.isUndefined()))
+        return false;
+
+    QString artifact = event.value(QStringLiteral("rootHash")).toString();
+    if (artifact.isEmpty()) {
+        const QString name = event.value(QStringLiteral("name")).toString();
+        if (name.isEmpty()) return false;
+        artifact = name + QLatin1Char('@') + event.value(QStringLiteral("version")).toString();
+    }
+    update(artifact, done.toInteger(), total.toInteger(), nowMs);
+    return true;
+}
+
+void DownloadProgressTracker::clear()
+{
+    *this = DownloadProgressTracker();
+}
+
+qint64 DownloadProgressTracker::bytesTotal() const
+{
+    return m_unknownTotals > 0 ? 0 : m_knownTotal;
+}
+
+qint64 DownloadProgressTracker::etaSeconds() const
+{
+    const qint64 total = bytesTotal();
+    if (total <= 0 || !m_haveRate || m_rate < 1.0) return -1;
+    const qint64 left = std::max<qint64>(0, total - m_bytesDone);
+    return static_cast<qint64>(std::ceil(left / m_rate));
+}
+
+QVariantMap DownloadProgressTracker::toVariant() const
+{
+    int completed = 0;
+    for (const Artifact& a : std::as_const(m_artifacts))
+        if (a.total > 0 && a.done >= a.total) ++completed;
+    return QVariantMap{
+        {QStringLiteral("active"),         !m_artifacts.isEmpty()},
+        {QStringLiteral("bytesDone"),      m_bytesDone},
+        {QStringLiteral("bytesTotal"),     bytesTotal()},
+        {QStringLiteral("bytesPerSecond"), m_rate},
+        {QStringLiteral("etaSeconds"),     etaSeconds()},
+        {QStringLiteral("artifactCount"),  static_cast<int>(m_artifacts.size())},
+        {QStringLiteral("completedCount"), completed},
+    };
+}
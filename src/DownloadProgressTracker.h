@@ -0,0 +1,67 @@
+#pragma once
+
+#include <QHash>
+#include <QJsonObject>
+#include <QString>
+#include <QVariantMap>
+
+// Aggregates package_downloader's per-artifact byte progress into one
+// figure for the UI: bytes done / total across every artifact of the
+// running download(s), a smoothed throughput and an ETA.
+//
+// Throughput is an exponentially weighted moving average of the byte
+// rate, sampled at most every kSampleIntervalMs, so a burst of small
+// chunks (or one late, large one) doesn't make the ETA jump around.
+// Time is passed in by the caller (milliseconds on any monotonic
+// clock) so the maths is testable without sleeping.
+//
+// The downloadProgress event is not part of package_downloader's
+// declared interface (its published methods and the `catalogChanged` /
+// install-result events are; this is not). applyEvent() therefore
+// accepts only the shape we expect — { name, version, rootHash,
+// bytesDone, bytesTotal }, the same one StandInModuleGateway emits —
+// and drops anything else. With a downloader that never sends it the
+// tracker stays empty, `active` stays false and the byte-level panel
+// never appears; installs still show the isInstalling state.
+class DownloadProgressTracker {
+public:
+    static constexpr qint64 kSampleIntervalMs = 250;
+    static constexpr double kSmoothing        = 0.3;   // weight of the newest sample
+
+    // Record the latest progress for one artifact. `bytesTotal` <= 0
+    // means the size isn't known yet (a later update can fill it in).
+    // A smaller bytesDone than last time (a retry) simply replaces it.
+    void update(const QString& artifact, qint64 bytesDone, qint64 bytesTotal, qint64 nowMs);
+    // One decoded downloadProgress payload. Needs an identity (rootHash,
+    // else name@version) and a numeric bytesDone; bytesTotal may be
+    // absent. Returns false, leaving the tracker untouched, otherwise.
+    bool applyEvent(const QJsonObject& event, qint64 nowMs);
+    void clear();
+
+    bool   isEmpty() const { return m_artifacts.isEmpty(); }
+    qint64 bytesDone() const { return m_bytesDone; }
+    // 0 while any artifact's size is still unknown.
+    qint64 bytesTotal() const;
+    double bytesPerSecond() const { return m_rate; }
+    // Seconds left at the current rate; -1 when it can't be estimated yet.
+    qint64 etaSeconds() const;
+
+    // { active, bytesDone, bytesTotal, bytesPerSecond, etaSeconds,
+    //   artifactCount, completedCount } — the downloadProgress PROP shape.
+    QVariantMap toVariant() const;
+
+private:
+    struct Artifact {
+        qint64 done  = 0;
+        qint64 total = 0;
+    };
+    QHash<QString, Artifact> m_artifacts;
+    qint64 m_bytesDone      = 0;
+    int    m_unknownTotals  = 0;
+    qint64 m_knownTotal     = 0;
+
+    qint64 m_sampleAtMs     = -1;
+    qint64 m_sampleBytes    = 0;
+    double m_rate           = 0.0;
+    bool   m_haveRate       = false;
+};
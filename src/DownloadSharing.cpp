@@ -0,0 +1,200 @@
+#include "DownloadSharing.h"
+
+#include <QPair>
+#include <QVariantMap>
+
+DownloadSharing::Attached DownloadSharing::attach(const QList<Part>& parts,
+                                                  const QStringList& topLevelNames,
+                                                  Callback onResults)
+{
+    Attached out;
+    out.ticket = m_nextTicket++;
+    Request req;
+    req.topLevelNames = topLevelNames;
+    req.onResults     = std::move(onResults);
+
+    for (int i = 0; i < parts.size(); ++i) {
+        const Part& part = parts.at(i);
+        const int open = part.key.isEmpty() ? 0 : m_openByKey.value(part.key);
+        if (open == 0) {
+            out.unshared.append(i);
+            continue;
+        }
+        if (!req.partsByCall.contains(open)) req.callOrder.append(open);
+        req.partsByCall[open].append(part);
+    }
+
+    // Whatever isn't in flight yet goes out as one call. A request with
+    // no parts at all still gets a call, so it is answered.
+    if (!out.unshared.isEmpty() || req.callOrder.isEmpty()) {
+        out.call    = m_nextCall++;
+        out.newCall = true;
+        Call& call = m_calls[out.call];
+        QList<Part>& own = req.partsByCall[out.call];
+        for (int i : std::as_const(out.unshared)) {
+            const Part& part = parts.at(i);
+            own.append(part);
+            if (part.key.isEmpty()) continue;
+            call.keys.insert(part.key);
+            m_openByKey.insert(part.key, out.call);
+        }
+        req.ownCall = out.call;
+        req.callOrder.append(out.call);
+    }
+
+    for (int id : std::as_const(req.callOrder)) {
+        Call& call = m_calls[id];
+        if (call.requesters.isEmpty()) ++out.woken;
+        call.requesters.insert(out.ticket);
+    }
+    m_requests.insert(out.ticket, std::move(req));
+    return out;
+}
+
+DownloadSharing::Attached DownloadSharing::attach(const QString& key,
+                                                  const QStringList& topLevelNames,
+                                                  Callback onResults)
+{
+    return attach(QList<Part>{Part{key, topLevelNames.value(0), topLevelNames}},
+                  topLevelNames, std::move(onResults));
+}
+
+QVariantList DownloadSharing::sliceFor(const Request& req, int callId, const Call& call,
+                                       const QVariantList& results) const
+{
+    if (callId == req.ownCall) return results;
+
+    // Everything the call was sent for is ours too: take it whole.
+    const QList<Part> parts = req.partsByCall.value(callId);
+    QSet<QString> ourKeys;
+    QSet<QString> names;
+    for (const Part& part : parts) {
+        ourKeys.insert(part.key);
+        names.insert(part.topLevelName);
+        for (const QString& n : part.names) names.insert(n);
+    }
+    bool whole = true;
+    for (const QString& key : call.keys) {
+        if (!ourKeys.contains(key)) { whole = false; break; }
+    }
+    if (whole) return results;
+
+    QVariantList out;
+    QSet<QString> present;
+    for (const QVariant& v : results) {
+        QVariantMap m = v.toMap();
+        const QString name = m.value(QStringLiteral("name")).toString();
+        if (!names.contains(name)) continue;
+        m.insert(QStringLiteral("topLevel"), req.topLevelNames.contains(name));
+        present.insert(name);
+        out.append(m);
+    }
+    for (const Part& part : parts) {
+        if (present.contains(part.topLevelName)) continue;
+        present.insert(part.topLevelName);
+        out.append(QVariantMap{
+            {QStringLiteral("name"),     part.topLevelName},
+            {QStringLiteral("topLevel"), true},
+            {QStringLiteral("error"),
+             QStringLiteral("No download result for %1").arg(part.topLevelName)},
+        });
+    }
+    return out;
+}
+
+bool DownloadSharing::finish(int callId, const QVariantList& results)
+{
+    auto it = m_calls.find(callId);
+    if (it == m_calls.end()) return false;
+    const Call call = *it;
+    m_calls.erase(it);
+    for (const QString& key : call.keys) {
+        if (m_openByKey.value(key) == callId) m_openByKey.remove(key);
+    }
+
+    // Take every finished request out before calling back: a callback
+    // may start the next download, which attaches here.
+    QList<QPair<Callback, QVariantList>> ready;
+    for (quint64 ticket : call.requesters) {
+        auto r = m_requests.find(ticket);
+        if (r == m_requests.end()) continue;
+        r->slices.insert(callId, sliceFor(*r, callId, call, results));
+        if (r->slices.size() < r->callOrder.size()) continue;
+
+        const Request req = m_requests.take(ticket);
+        QVariantList merged;
+        if (req.callOrder.size() == 1) {
+            merged = req.slices.value(callId);
+        } else {
+            QSet<QString> seen;
+            for (int id : req.callOrder) {
+                for (const QVariant& v : req.slices.value(id)) {
+                    const QString name = v.toMap().value(QStringLiteral("name")).toString();
+                    if (seen.contains(name)) continue;
+                    seen.insert(name);
+                    merged.append(v);
+                }
+            }
+        }
+        if (req.onResults) ready.append({req.onResults, merged});
+    }
+    for (const auto& [cb, merged] : std::as_const(ready)) cb(merged);
+    return !call.requesters.isEmpty();
+}
+
+int DownloadSharing::cancel(quint64 ticket, const QString& reason)
+{
+    auto it = m_requests.find(ticket);
+    if (it == m_requests.end()) return 0;
+    const Request req = *it;
+    m_requests.erase(it);
+
+    int emptied = 0;
+    for (int id : req.callOrder) {
+        if (req.slices.contains(id)) continue;   // already answered
+        auto call = m_calls.find(id);
+        if (call != m_calls.end() && call->requesters.remove(ticket) && call->requesters.isEmpty())
+            ++emptied;
+    }
+
+    QVariantList out;
+    for (const QString& name : req.topLevelNames) {
+        out.append(QVariantMap{
+            {QStringLiteral("name"),     name},
+            {QStringLiteral("topLevel"), true},
+            {QStringLiteral("error"),    reason},
+        });
+    }
+    if (req.onResults) req.onResults(out);
+    return emptied;
+}
+
+QList<quint64> DownloadSharing::ticketsFor(const QString& topLevelName) const
+{
+    QList<quint64> tickets;
+    for (auto it = m_requests.cbegin(); it != m_requests.cend(); ++it) {
+        if (it->topLevelNames.contains(topLevelName)) tickets.append(it.key());
+    }
+    return tickets;
+}
+
+QStringList DownloadSharing::waitingNames() const
+{
+    QStringList names;
+    QSet<QString> seen;
+    for (const Request& req : m_requests) {
+        for (const QString& name : req.topLevelNames) {
+            if (!seen.contains(name)) {
+                seen.insert(name);
+                names.append(name);
+            }
+        }
+    }
+    return names;
+}
+
+int DownloadSharing::requesterCount(int callId) const
+{
+    auto it = m_calls.constFind(callId);
+    return it == m_calls.cend() ? 0 : static_cast<int>(it->requesters.size());
+}
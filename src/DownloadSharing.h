@@ -0,0 +1,99 @@
+#pragma once
+
+#include <functional>
+
+#include <QHash>
+#include <QList>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+#include <QVariantList>
+
+// Who is waiting on which package_downloader download call.
+//
+// A request is split into parts, one per top-level artifact. A part
+// whose key is already on an open call attaches to that call instead of
+// being fetched again; the rest go out together as one new call. The
+// backend keys a part by name@version/rootHash plus the installed-
+// snapshot fingerprint, and leaves the key empty when it can't pin the
+// artifact — such a part is never shared.
+//
+// A requester on someone else's call takes only its parts' packages
+// from that reply (the part's `names`: itself and its deps), re-flagged
+// topLevel for its own request; a part whose top-level is missing from
+// the reply gets an error entry. Its own call's reply is taken whole.
+// Once every call it waits on is back, the requester gets the slices
+// concatenated in attach order — shared slices first, each already
+// deps-first — with later duplicates of a name dropped.
+//
+// Each requester holds a ticket. cancel() answers that one requester
+// straight away and leaves the others on their calls; a call that loses
+// every requester stays open, since the IPC can't be aborted, and a
+// later request for the same artifact re-attaches to it. finish() hands
+// the reply to everyone still attached.
+//
+// No IPC and no Qt event loop in here — the backend sends the calls and
+// feeds their replies in — so the sharing rules are unit-testable.
+class DownloadSharing {
+public:
+    using Callback = std::function<void(const QVariantList&)>;
+
+    struct Part {
+        QString     key;            // empty = never shared
+        QString     topLevelName;
+        QStringList names;          // packages a sharer takes from the reply
+    };
+
+    struct Attached {
+        quint64    ticket  = 0;
+        int        call    = 0;       // the new call, 0 when every part is shared
+        bool       newCall = false;   // caller must send `call`
+        QList<int> unshared;          // indices of the parts `call` carries
+        int        woken   = 0;       // calls that had nobody waiting before
+    };
+    Attached attach(const QList<Part>& parts, const QStringList& topLevelNames, Callback onResults);
+    // One part covering the whole request: shared only with a request
+    // of the same key.
+    Attached attach(const QString& key, const QStringList& topLevelNames, Callback onResults);
+
+    // The call's reply. Every requester still attached gets its slice,
+    // and those with nothing else outstanding are called back; the call
+    // closes. Returns whether anyone was attached.
+    bool finish(int call, const QVariantList& results);
+
+    // Detach one requester; its callback fires now with one `reason`
+    // error entry per top-level name. Returns how many calls that left
+    // with nobody waiting.
+    int cancel(quint64 ticket, const QString& reason);
+
+    // Tickets whose request named `topLevelName`.
+    QList<quint64> ticketsFor(const QString& topLevelName) const;
+    // Top-level names of every requester still waiting, de-duplicated.
+    QStringList waitingNames() const;
+
+    bool isOpen(int call) const { return m_calls.contains(call); }
+    int  requesterCount(int call) const;
+
+private:
+    struct Call {
+        QSet<QString> keys;
+        QSet<quint64> requesters;
+    };
+    struct Request {
+        QStringList              topLevelNames;
+        int                      ownCall = 0;
+        QList<int>               callOrder;     // shared calls first, own call last
+        QHash<int, QList<Part>>  partsByCall;
+        QHash<int, QVariantList> slices;        // replies received so far
+        Callback                 onResults;
+    };
+
+    QVariantList sliceFor(const Request& req, int callId, const Call& call,
+                          const QVariantList& results) const;
+
+    QHash<int, Call>        m_calls;
+    QHash<quint64, Request> m_requests;
+    QHash<QString, int>     m_openByKey;
+    int     m_nextCall   = 1;
+    quint64 m_nextTicket = 1;
+};
@@ -0,0 +1,155 @@
+#include "InstallJournal.h"
+
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <QUuid>
+
+InstallJournal::InstallJournal(const QString& path)
+    : m_path(path.isEmpty() ? defaultPath() : path)
+{
+}
+
+QString InstallJournal::defaultPath()
+{
+    return QStandardPaths::writableLocation(QStandardPaths::AppDataLocation)
+         + QStringLiteral("/install-journal.json");
+}
+
+QString InstallJournal::begin(const QList<Step>& steps)
+{
+    load();
+    Transaction t;
+    t.id        = QUuid::createUuid().toString(QUuid::WithoutBraces);
+    t.startedAt = QDateTime::currentDateTimeUtc();
+    t.steps     = steps;
+    m_txns.append(t);
+    save();
+    return t.id;
+}
+
+void InstallJournal::setState(const QString& txn, const QString& name, Step::State state)
+{
+    load();
+    for (Transaction& t : m_txns) {
+        if (t.id != txn) continue;
+        for (Step& s : t.steps) {
+            if (s.name == name) {
+                s.state = state;
+                save();
+                return;
+            }
+        }
+        return;
+    }
+}
+
+void InstallJournal::finish(const QString& txn)
+{
+    load();
+    for (int i = 0; i < m_txns.size(); ++i) {
+        if (m_txns.at(i).id == txn) {
+            m_txns.removeAt(i);
+            save();
+            return;
+        }
+    }
+}
+
+const InstallJournal::Transaction* InstallJournal::find(const QString& txn) const
+{
+    load();
+    for (const Transaction& t : m_txns) {
+        if (t.id == txn) return &t;
+    }
+    return nullptr;
+}
+
+QList<InstallJournal::Transaction> InstallJournal::transactions() const
+{
+    load();
+    return m_txns;
+}
+
+QList<InstallJournal::Step> InstallJournal::rollbackPlan(const Transaction& txn)
+{
+    QList<Step> plan;
+    for (auto it = txn.steps.crbegin(); it != txn.steps.crend(); ++it) {
+        if (it->state == Step::Applied
+            || (it->state == Step::Failed && it->priorRemoved))
+            plan.append(*it);
+    }
+    return plan;
+}
+
+void InstallJournal::load() const
+{
+    if (m_loaded) return;
+    m_loaded = true;
+
+    QFile f(m_path);
+    if (!f.open(QIODevice::ReadOnly)) return;
+    const QJsonArray txns = QJsonDocument::fromJson(f.readAll()).object()
+                                .value(QStringLiteral("transactions")).toArray();
+    for (const QJsonValue& tv : txns) {
+        const QJsonObject to = tv.toObject();
+        Transaction t;
+        t.id        = to.value(QStringLiteral("id")).toString();
+        t.startedAt = QDateTime::fromString(to.value(QStringLiteral("startedAt")).toString(),
+                                            Qt::ISODate);
+        for (const QJsonValue& sv : to.value(QStringLiteral("steps")).toArray()) {
+            const QJsonObject so = sv.toObject();
+            Step s;
+            s.name         = so.value(QStringLiteral("name")).toString();
+            s.moduleName   = so.value(QStringLiteral("moduleName")).toString();
+            s.fromVersion  = so.value(QStringLiteral("fromVersion")).toString();
+            s.fromRootHash = so.value(QStringLiteral("fromRootHash")).toString();
+            s.toVersion    = so.value(QStringLiteral("toVersion")).toString();
+            s.toRootHash   = so.value(QStringLiteral("toRootHash")).toString();
+            s.priorRemoved = so.value(QStringLiteral("priorRemoved")).toBool();
+            s.state        = static_cast<Step::State>(so.value(QStringLiteral("state")).toInt());
+            if (!s.name.isEmpty()) t.steps.append(s);
+        }
+        if (!t.id.isEmpty()) m_txns.append(t);
+    }
+}
+
+void InstallJournal::save() const
+{
+    QJsonArray txns;
+    for (const Transaction& t : m_txns) {
+        QJsonArray steps;
+        for (const Step& s : t.steps) {
+            steps.append(QJsonObject{
+                {QStringLiteral("name"),         s.name},
+                {QStringLiteral("moduleName"),   s.moduleName},
+                {QStringLiteral("fromVersion"),  s.fromVersion},
+                {QStringLiteral("fromRootHash"), s.fromRootHash},
+                {QStringLiteral("toVersion"),    s.toVersion},
+                {QStringLiteral("toRootHash"),   s.toRootHash},
+                {QStringLiteral("priorRemoved"), s.priorRemoved},
+                {QStringLiteral("state"),        static_cast<int>(s.state)},
+            });
+        }
+        txns.append(QJsonObject{
+            {QStringLiteral("id"),        t.id},
+            {QStringLiteral("startedAt"), t.startedAt.toString(Qt::ISODate)},
+            {QStringLiteral("steps"),     steps},
+        });
+    }
+
+    QDir().mkpath(QFileInfo(m_path).absolutePath());
+    QSaveFile f(m_path);
+    if (!f.open(QIODevice::WriteOnly)
+        || f.write(QJsonDocument(QJsonObject{{QStringLiteral("transactions"), txns}})
+                       .toJson(QJsonDocument::Compact)) < 0
+        || !f.commit()) {
+        qWarning() << "InstallJournal: cannot write" << m_path;
+    }
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <QDateTime>
+#include <QList>
+#include <QString>
+
+// Write-ahead journal for multi-package installs. A transaction lists
+// every package an install chain is about to touch with what was there
+// before (version + rootHash, or nothing) and what's going in. Steps
+// move Pending → Applied / Failed as the chain runs; a failure is
+// undone from the journal (a crash, found at the next startup, once the
+// user agrees): applied steps are reverted newest first, reinstalling
+// the prior artifact from the local artifact cache or removing a
+// package that wasn't there before.
+//
+// The journal lives in one small JSON file and is rewritten (atomically,
+// via QSaveFile) on every state change, so what's on disk is never more
+// than one step behind. A transaction is dropped once it commits or its
+// rollback finishes; anything still in the file at startup was
+// interrupted.
+class InstallJournal {
+public:
+    struct Step {
+        enum State { Pending = 0, Applied = 1, Failed = 2, RolledBack = 3 };
+
+        QString name;
+        // Runtime module id, which the installed set and the host gates
+        // key on; differs from the catalog `name` for some packages.
+        // Empty in journals written before it was recorded — use name.
+        QString moduleName;
+        QString fromVersion;     // empty = not installed before
+        QString fromRootHash;
+        QString toVersion;
+        QString toRootHash;
+        // The prior copy was already removed before this step ran (the
+        // upgrade gate uninstalls first), so even a Failed step needs
+        // its prior restored.
+        bool    priorRemoved = false;
+        State   state = Pending;
+    };
+    struct Transaction {
+        QString     id;
+        QDateTime   startedAt;
+        QList<Step> steps;
+    };
+
+    // Empty `path` = defaultPath().
+    explicit InstallJournal(const QString& path = QString());
+
+    // <QStandardPaths::AppDataLocation>/install-journal.json
+    static QString defaultPath();
+
+    QString path() const { return m_path; }
+
+    // Record a new transaction; returns its id.
+    QString begin(const QList<Step>& steps);
+    void    setState(const QString& txn, const QString& name, Step::State state);
+    // Commit or rollback done: forget the transaction.
+    void    finish(const QString& txn);
+
+    // nullptr when unknown. Invalidated by the next mutation.
+    const Transaction* find(const QString& txn) const;
+    // Open transactions — at startup, the ones a crash interrupted.
+    QList<Transaction> transactions() const;
+
+    // What undoing `txn` means, in order: applied steps newest first,
+    // plus failed steps whose prior copy had already been removed.
+    static QList<Step> rollbackPlan(const Transaction& txn);
+
+private:
+    // Lazy: the file is read on first use, not at construction.
+    void load() const;
+    void save() const;
+
+    QString m_path;
+    mutable bool               m_loaded = false;
+    mutable QList<Transaction> m_txns;
+};
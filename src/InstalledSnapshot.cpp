@@ -0,0 +1,97 @@
+#include "InstalledSnapshot.h"
+
+#include <QCryptographicHash>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QVariantMap>
+
+InstalledSnapshot::Ptr InstalledSnapshot::build(const QVariantList& installedPackages)
+{
+    // package_manager.getInstalledPackages returns entries shaped like
+    //   { name, moduleName, version, hashes: { root }, installType, ... }
+    // The resolver only needs (name, version) for its range check; we
+    // also pass rootHash for parity with the rest of the install plumbing
+    // even though the current short-circuit doesn't read it.
+    QList<Entry> entries;
+    entries.reserve(installedPackages.size());
+    QHash<QString, int> seen;
+    for (const QVariant& v : installedPackages) {
+        const QVariantMap m = v.toMap();
+        Entry e;
+        e.name = m.value("moduleName").toString().isEmpty()
+                 ? m.value("name").toString()
+                 : m.value("moduleName").toString();
+        e.version  = m.value("version").toString();
+        e.rootHash = m.value("hashes").toMap().value("root").toString();
+        if (e.name.isEmpty() || e.version.isEmpty()) continue;
+        // A name reported twice (embedded + user copy) keeps the last
+        // report, matching the old QHash::insert-based index.
+        auto it = seen.constFind(e.name);
+        if (it != seen.constEnd()) {
+            entries[it.value()] = e;
+            continue;
+        }
+        seen.insert(e.name, entries.size());
+        entries.append(e);
+    }
+    return fromEntries(std::move(entries));
+}
+
+InstalledSnapshot::Ptr InstalledSnapshot::empty()
+{
+    static const Ptr kEmpty = fromEntries({});
+    return kEmpty;
+}
+
+InstalledSnapshot::Ptr InstalledSnapshot::withInstalled(const QString& name,
+                                                        const QString& version,
+                                                        const QString& rootHash) const
+{
+    if (name.isEmpty() || version.isEmpty()) return fromEntries(m_entries);
+    QList<Entry> entries = m_entries;
+    const Entry e{name, version, rootHash};
+    auto it = m_indexByName.constFind(name);
+    if (it != m_indexByName.constEnd()) entries[it.value()] = e;
+    else                                entries.append(e);
+    return fromEntries(std::move(entries));
+}
+
+InstalledSnapshot::Ptr InstalledSnapshot::without(const QString& name) const
+{
+    QList<Entry> entries = m_entries;
+    auto it = m_indexByName.constFind(name);
+    if (it != m_indexByName.constEnd()) entries.removeAt(it.value());
+    return fromEntries(std::move(entries));
+}
+
+QString InstalledSnapshot::rootHashFor(const QString& name) const
+{
+    auto it = m_indexByName.constFind(name);
+    return it != m_indexByName.constEnd() ? m_entries.at(it.value()).rootHash : QString();
+}
+
+InstalledSnapshot::Ptr InstalledSnapshot::fromEntries(QList<Entry> entries)
+{
+    // Not make_shared: the constructor is private.
+    QSharedPointer<InstalledSnapshot> s(new InstalledSnapshot);
+    s->m_entries = std::move(entries);
+    s->m_indexByName.reserve(s->m_entries.size());
+    s->m_versionByName.reserve(s->m_entries.size());
+
+    QJsonArray arr;
+    for (int i = 0; i < s->m_entries.size(); ++i) {
+        const Entry& e = s->m_entries.at(i);
+        s->m_indexByName.insert(e.name, i);
+        s->m_versionByName.insert(e.name, e.version);
+        QJsonObject o;
+        o.insert(QStringLiteral("name"), e.name);
+        o.insert(QStringLiteral("version"), e.version);
+        if (!e.rootHash.isEmpty()) o.insert(QStringLiteral("rootHash"), e.rootHash);
+        arr.append(o);
+    }
+    const QByteArray bytes = QJsonDocument(arr).toJson(QJsonDocument::Compact);
+    s->m_json = QString::fromUtf8(bytes);
+    s->m_fingerprint = QCryptographicHash::hash(bytes, QCryptographicHash::Sha1).toHex();
+    return s;
+}
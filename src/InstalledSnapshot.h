@@ -0,0 +1,73 @@
+#pragma once
+
+#include <QByteArray>
+#include <QHash>
+#include <QList>
+#include <QSharedPointer>
+#include <QString>
+#include <QVariantList>
+
+// Immutable, shareable view of package_manager.getInstalledPackages in the
+// shapes the dependency-resolver paths consume:
+//
+//   * json()          — the compact [{name, version, rootHash}] array
+//                       package_downloader.resolveDependencies /
+//                       downloadResolvedDependencies take as
+//                       `installedPackagesJson`, serialised once.
+//   * fingerprint()   — SHA-1 of json(); the installed-state part of the
+//                       resolve-cache key.
+//   * versionByName() — moduleName → version, the from-version index
+//                       computeDepChanges reads.
+//
+// Built once per refresh (build()); mutation events derive a NEW snapshot
+// via withInstalled() / without() rather than editing in place, so any
+// holder of a Ptr — a lambda waiting on a resolver reply, the
+// pre-resolver's current pass — keeps reading exactly the state it
+// started from. Holders borrow through the shared pointer; nothing is
+// copied. The hash index is a Qt implicitly-shared container, so copying
+// it out of a snapshot into a lambda capture is a refcount bump too.
+class InstalledSnapshot {
+public:
+    using Ptr = QSharedPointer<const InstalledSnapshot>;
+
+    // Index getInstalledPackages() rows by moduleName (falling back to
+    // name). Rows with no name or no version are skipped — the resolver
+    // can't range-check them anyway.
+    static Ptr build(const QVariantList& installedPackages);
+
+    // An empty snapshot ("[]"). Never null, so callers needn't check.
+    static Ptr empty();
+
+    // Copy-on-write patches for the install / uninstall events. Both keep
+    // the original entry order so json() stays stable across patches that
+    // don't change the set, and re-serialise only the small entry list —
+    // no QVariant walk.
+    Ptr withInstalled(const QString& name,
+                      const QString& version,
+                      const QString& rootHash) const;
+    Ptr without(const QString& name) const;
+
+    const QString&    json() const        { return m_json; }
+    const QByteArray& fingerprint() const { return m_fingerprint; }
+    const QHash<QString, QString>& versionByName() const { return m_versionByName; }
+
+    bool contains(const QString& name) const { return m_indexByName.contains(name); }
+    QString rootHashFor(const QString& name) const;
+    int size() const { return m_entries.size(); }
+
+private:
+    struct Entry {
+        QString name;
+        QString version;
+        QString rootHash;
+    };
+
+    InstalledSnapshot() = default;
+    static Ptr fromEntries(QList<Entry> entries);
+
+    QList<Entry>            m_entries;
+    QHash<QString, int>     m_indexByName;
+    QHash<QString, QString> m_versionByName;
+    QString                 m_json;
+    QByteArray              m_fingerprint;
+};
@@ -0,0 +1,212 @@
+#include "LocalDependencyResolver.h"
+
+#include <algorithm>
+#include <exception>
+#include <string>
+#include <QSet>
+#include <QVariantMap>
+
+#include <semver/semver.hpp>
+
+#include "RowActionResolver.h"
+
+namespace {
+
+QVariantMap errorEntry(const QString& name, const QString& message)
+{
+    QVariantMap e;
+    e.insert(QStringLiteral("name"), name);
+    e.insert(QStringLiteral("error"), message);
+    return e;
+}
+
+} // namespace
+
+bool LocalDependencyResolver::satisfies(const QString& version, const QString& range)
+{
+    const auto v = semver::from_string_noexcept(version.trimmed().toStdString());
+    if (!v) return false;
+
+    const QString r = range.trimmed();
+    const std::string text = r.isEmpty() ? std::string(">=0.0.0") : r.toStdString();
+    try {
+        return semver::range::satisfies(*v, text);
+    } catch (const std::exception&) {
+        return false;   // unparseable range
+    }
+}
+
+bool LocalDependencyResolver::hasErrors(const QVariantList& resolved)
+{
+    for (const QVariant& v : resolved) {
+        if (v.toMap().contains(QStringLiteral("error"))) return true;
+    }
+    return false;
+}
+
+void LocalDependencyResolver::setCatalog(const QVariantList& catalog)
+{
+    m_byName.clear();
+    indexRows(catalog, nullptr);
+}
+
+void LocalDependencyResolver::updateNames(const QVariantList& catalog, const QSet<QString>& names)
+{
+    if (names.isEmpty()) return;
+    for (const QString& name : names) m_byName.remove(name);
+    indexRows(catalog, &names);
+}
+
+void LocalDependencyResolver::indexRows(const QVariantList& catalog, const QSet<QString>* only)
+{
+    // `order` counts every version of every row, indexed or not, so a
+    // name re-indexed alone gets the positions a full pass gives it.
+    QSet<QString> seen;
+    QSet<QString> indexed;
+    int order = 0;
+    for (const QVariant& rowVar : catalog) {
+        const QVariantMap row = rowVar.toMap();
+        const QString name = row.value("name").toString();
+        if (name.isEmpty()) continue;
+        if (only && !only->contains(name)) {
+            order += row.value("versions").toList().size();
+            continue;
+        }
+        indexed.insert(name);
+        const QString repoUrl = row.value("repositoryUrl").toString();
+        const QString rowModuleName = row.value("moduleName").toString();
+        for (const QVariant& vv : row.value("versions").toList()) {
+            const QVariantMap vm = vv.toMap();
+            const QVariantMap manifest = vm.value("manifest").toMap();
+            Candidate c;
+            // Same fallback chain as buildPackageRow.
+            c.moduleName    = !rowModuleName.isEmpty() ? rowModuleName
+                            : !manifest.value("name").toString().isEmpty()
+                                  ? manifest.value("name").toString() : name;
+            c.version       = manifest.value("version").toString();
+            c.repositoryUrl = repoUrl;
+            c.rootHash      = vm.value("rootHash").toString();
+            c.releasedAt    = vm.value("releasedAt").toString();
+            c.order         = order++;
+            if (c.version.isEmpty()) continue;
+            const QString key = repoUrl + QChar(0x01) + name + QChar(0x01) + c.version;
+            if (seen.contains(key)) continue;
+            seen.insert(key);
+
+            // Same two entry shapes buildPackageRow renders.
+            for (const QVariant& dep : manifest.value("dependencies").toList()) {
+                Dep d;
+                if (dep.canConvert<QVariantMap>() && dep.toString().isEmpty()) {
+                    const QVariantMap dm = dep.toMap();
+                    d.name  = dm.value("name").toString();
+                    d.range = dm.value("version").toString();
+                } else {
+                    d.name = dep.toString().trimmed();
+                }
+                if (!d.name.isEmpty()) c.deps.append(d);
+            }
+            m_byName[name].append(c);
+        }
+    }
+
+    for (const QString& name : std::as_const(indexed)) {
+        const auto it = m_byName.find(name);
+        if (it == m_byName.end()) continue;
+        QList<Candidate>& candidates = *it;
+        std::stable_sort(candidates.begin(), candidates.end(),
+            [](const Candidate& a, const Candidate& b) {
+                const int cmp = rowaction::versionCmp(a.version, b.version);
+                if (cmp != 0) return cmp > 0;
+                // ISO-8601 timestamps order lexicographically.
+                if (a.releasedAt != b.releasedAt) return a.releasedAt > b.releasedAt;
+                return a.order < b.order;
+            });
+    }
+}
+
+const QList<LocalDependencyResolver::Candidate>&
+LocalDependencyResolver::candidatesFor(const QString& name) const
+{
+    static const QList<Candidate> kNone;
+    auto it = m_byName.constFind(name);
+    return it != m_byName.constEnd() ? it.value() : kNone;
+}
+
+QVariantList LocalDependencyResolver::resolve(const QList<PackageInstallSpec>& specs,
+                                              const QHash<QString, QString>& installedByName) const
+{
+    QVariantList out;
+    QHash<QString, int> picked;                 // name → index into `out`
+    QList<const Candidate*> queue;
+
+    auto entryFor = [](const QString& name, const Candidate& c, bool topLevel) {
+        QVariantMap e;
+        e.insert(QStringLiteral("name"),          name);
+        e.insert(QStringLiteral("version"),       c.version);
+        e.insert(QStringLiteral("repositoryUrl"), c.repositoryUrl);
+        e.insert(QStringLiteral("rootHash"),      c.rootHash);
+        e.insert(QStringLiteral("topLevel"),      topLevel);
+        return e;
+    };
+
+    for (const PackageInstallSpec& spec : specs) {
+        if (spec.name.isEmpty() || picked.contains(spec.name)) continue;
+        const Candidate* choice = nullptr;
+        for (const Candidate& c : candidatesFor(spec.name)) {
+            if (!spec.repositoryUrl.isEmpty() && c.repositoryUrl != spec.repositoryUrl) continue;
+            if (!spec.version.isEmpty() && rowaction::versionCmp(c.version, spec.version) != 0) continue;
+            choice = &c;
+            break;
+        }
+        picked.insert(spec.name, out.size());
+        if (!choice) {
+            out.append(errorEntry(spec.name,
+                QStringLiteral("No catalog entry for %1%2%3")
+                    .arg(spec.name,
+                         spec.version.isEmpty() ? QString() : QStringLiteral(" ") + spec.version,
+                         spec.repositoryUrl.isEmpty() ? QString()
+                                                      : QStringLiteral(" in ") + spec.repositoryUrl)));
+            continue;
+        }
+        out.append(entryFor(spec.name, *choice, true));
+        queue.append(choice);
+    }
+
+    // m_byName's lists are not touched while resolving, so the queued
+    // pointers stay valid for the whole walk.
+    QSet<QString> conflicted;
+    for (int head = 0; head < queue.size(); ++head) {
+        for (const Dep& dep : queue.at(head)->deps) {
+            auto already = picked.constFind(dep.name);
+            if (already != picked.constEnd()) {
+                const QVariantMap prior = out.at(already.value()).toMap();
+                if (prior.contains(QStringLiteral("error")) || conflicted.contains(dep.name)) continue;
+                const QString version = prior.value(QStringLiteral("version")).toString();
+                if (!satisfies(version, dep.range)) {
+                    conflicted.insert(dep.name);
+                    out.append(errorEntry(dep.name,
+                        QStringLiteral("%1 %2 does not satisfy %3")
+                            .arg(dep.name, version, dep.range)));
+                }
+                continue;
+            }
+
+            const QString installed = installedByName.value(dep.name);
+            if (!installed.isEmpty() && satisfies(installed, dep.range)) continue;
+
+            const Candidate* choice = nullptr;
+            for (const Candidate& c : candidatesFor(dep.name)) {
+                if (satisfies(c.version, dep.range)) { choice = &c; break; }
+            }
+            picked.insert(dep.name, out.size());
+            if (!choice) {
+                out.append(errorEntry(dep.name,
+                    QStringLiteral("No version of %1 satisfies '%2'").arg(dep.name, dep.range)));
+                continue;
+            }
+            out.append(entryFor(dep.name, *choice, false));
+            queue.append(choice);
+        }
+    }
+    return out;
+}
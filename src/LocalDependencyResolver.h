@@ -0,0 +1,94 @@
+#pragma once
+
+#include <QHash>
+#include <QList>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+#include <QVariantList>
+
+#include "PackageListModel.h"   // PackageInstallSpec
+
+// In-process counterpart of package_downloader.resolveDependencies, run
+// against the catalog PMU already holds. Drives the dependency PREVIEW
+// only: the host-gate change list can be built the moment the user
+// clicks, with no IPC. The download path still goes through
+// downloadResolvedDependencies, so package_downloader stays the
+// authority for what actually gets installed.
+//
+// Output has the resolver's shape, one map per package, so it drops
+// straight into computeDepChanges:
+//   { name, version, repositoryUrl, rootHash, topLevel }
+//   { name, error }                 — unsatisfiable pin / range / conflict
+//
+// Semantics:
+//   * Top-level specs follow PackageInstallSpec: a non-empty
+//     repositoryUrl restricts candidates to that repo, a non-empty
+//     version to that exact version; otherwise the newest version wins
+//     across all repos (tie → newest releasedAt, then catalog order).
+//     Top-level entries are always emitted, installed or not.
+//   * Transitive deps come from each picked version's
+//     manifest.dependencies ({name, version: <range>} or a bare name).
+//     An installed version satisfying the range short-circuits the dep
+//     (no entry, no descent). Otherwise the newest satisfying version
+//     across all repos is picked and its own deps are walked.
+//   * A name picked twice must satisfy every range that reaches it;
+//     greedy first pick, no backtracking — a clash is an error entry.
+//
+// Ranges are evaluated by the vendored semver/semver.hpp — the range
+// implementation package_downloader uses — so preview and installer
+// agree on caret / tilde / hyphen forms and on prereleases. Candidate
+// ordering is logos::semver::compare (via rowaction::versionCmp).
+class LocalDependencyResolver {
+public:
+    // Index package_downloader.getCatalog() rows. Catalog order is the
+    // source priority order; later duplicates of (repo, name, version)
+    // are ignored.
+    void setCatalog(const QVariantList& catalog);
+    // Re-index just the catalog `names` a catalog delta touched, from the
+    // catalog as it is after the delta. The lists come out as
+    // setCatalog would order them, as long as the untouched rows kept
+    // their relative order (catalogdelta::apply does).
+    void updateNames(const QVariantList& catalog, const QSet<QString>& names);
+    bool isEmpty() const { return m_byName.isEmpty(); }
+
+    QVariantList resolve(const QList<PackageInstallSpec>& specs,
+                         const QHash<QString, QString>& installedByName) const;
+
+    // True iff `version` satisfies `range`. An empty range matches any
+    // release; an unparseable version or range matches nothing.
+    static bool satisfies(const QString& version, const QString& range);
+
+    // True iff any error entry is present — callers treat such a result
+    // as "ask the real resolver".
+    static bool hasErrors(const QVariantList& resolved);
+
+    struct Dep {
+        QString name;
+        QString range;
+    };
+    struct Candidate {
+        QString    moduleName;  // runtime identity, as installed packages report it
+        QString    version;
+        QString    repositoryUrl;
+        QString    rootHash;
+        QString    releasedAt;
+        int        order = 0;   // catalog position, for stable ties
+        QList<Dep> deps;
+    };
+
+    // Read-only view of the index, for planners that walk the whole
+    // catalog (UpgradePlanner). Lists are newest first.
+    const QHash<QString, QList<Candidate>>& index() const { return m_byName; }
+
+    // Empty list when `name` is unknown. Returned by reference: callers
+    // may hold element pointers while the index is unchanged.
+    const QList<Candidate>& candidatesFor(const QString& name) const;
+
+private:
+    // Index the catalog's rows, or only those named in `only`.
+    void indexRows(const QVariantList& catalog, const QSet<QString>* only);
+
+    // Newest first, ties broken as documented above.
+    QHash<QString, QList<Candidate>> m_byName;
+};
@@ -0,0 +1,144 @@
+#include "LocalInstallBatch.h"
+
+#include <QDebug>
+
+#include "RowActionResolver.h"   // versionCmp
+
+void LocalInstallBatch::reset(int generation, const QStringList& files)
+{
+    *this = LocalInstallBatch();
+    m_generation = generation;
+    m_files      = files;
+    m_inspecting = static_cast<int>(files.size());
+}
+
+bool LocalInstallBatch::inspected(const Entry* e)
+{
+    if (e && !e->name.isEmpty()) {
+        const auto prev = m_entries.constFind(e->name);
+        if (prev == m_entries.constEnd() || rowaction::versionCmp(e->version, prev->version) > 0)
+            m_entries.insert(e->name, *e);
+    }
+    return m_inspecting > 0 && --m_inspecting == 0;
+}
+
+const LocalInstallBatch::Entry* LocalInstallBatch::entry(const QString& name) const
+{
+    auto it = m_entries.constFind(name);
+    return it == m_entries.cend() ? nullptr : &it.value();
+}
+
+void LocalInstallBatch::plan()
+{
+    m_order.clear();
+    m_waitsFor.clear();
+
+    QStringList byFile;
+    for (const QString& f : std::as_const(m_files)) {
+        for (auto it = m_entries.cbegin(); it != m_entries.cend(); ++it) {
+            if (it->file == f) { byFile.append(it.key()); break; }
+        }
+    }
+    QHash<QString, int> unmet;
+    for (const QString& n : std::as_const(byFile)) {
+        int count = 0;
+        for (const QString& d : m_entries.value(n).deps)
+            if (d != n && m_entries.contains(d)) ++count;
+        unmet.insert(n, count);
+    }
+    QSet<QString> placed;
+    while (m_order.size() < byFile.size()) {
+        QString next;
+        for (const QString& n : std::as_const(byFile)) {
+            if (!placed.contains(n) && unmet.value(n) == 0) { next = n; break; }
+        }
+        if (next.isEmpty()) {   // cycle: break it in file order
+            for (const QString& n : std::as_const(byFile))
+                if (!placed.contains(n)) { next = n; break; }
+            qWarning() << "installLocalPackages: dependency cycle involving" << next;
+        }
+        QStringList waits;
+        for (const QString& d : m_entries.value(next).deps)
+            if (d != next && placed.contains(d) && !waits.contains(d)) waits.append(d);
+        m_waitsFor.insert(next, waits);
+        m_order.append(next);
+        placed.insert(next);
+        for (const QString& n : std::as_const(byFile)) {
+            if (m_entries.value(n).deps.contains(next)) unmet[n] = unmet.value(n) - 1;
+        }
+    }
+}
+
+bool LocalInstallBatch::approve(const QString& name)
+{
+    if (!m_entries.contains(name)) return false;
+    m_answered.insert(name);
+    if (m_settled.contains(name)) return false;
+    m_approved.insert(name);
+    return true;
+}
+
+QStringList LocalInstallBatch::waitsForClosure(const QString& name) const
+{
+    QSet<QString> reached{name};
+    QStringList pending = m_waitsFor.value(name);
+    while (!pending.isEmpty()) {
+        const QString dep = pending.takeFirst();
+        if (reached.contains(dep)) continue;
+        reached.insert(dep);
+        pending += m_waitsFor.value(dep);
+    }
+    QStringList out;
+    for (const QString& n : m_order)
+        if (reached.contains(n)) out.append(n);
+    return out;
+}
+
+QStringList LocalInstallBatch::takeReady(int maxRunning)
+{
+    QStringList ready;
+    for (const QString& n : std::as_const(m_order)) {
+        if (m_running >= maxRunning) break;
+        if (!m_approved.contains(n) || m_started.contains(n) || m_settled.contains(n))
+            continue;
+        bool depsIn = true;
+        for (const QString& d : m_waitsFor.value(n)) {
+            if (!m_installed.contains(d)) { depsIn = false; break; }
+        }
+        if (!depsIn) continue;
+        m_started.insert(n);
+        ++m_running;
+        ready.append(n);
+    }
+    return ready;
+}
+
+QStringList LocalInstallBatch::settle(const QString& name, bool success)
+{
+    if (!m_entries.contains(name)) return {};
+    m_answered.insert(name);
+    if (m_settled.contains(name)) return {};   // a skipped entry's gate came back
+    if (m_started.contains(name)) --m_running;
+    m_settled.insert(name);
+    if (success) {
+        m_installed.insert(name);
+        return {};
+    }
+
+    // Everything placed after `name` that waits on a failed entry, in
+    // one pass since waits only ever point backwards.
+    QSet<QString> failed{name};
+    QStringList skipped;
+    for (const QString& n : std::as_const(m_order)) {
+        if (m_settled.contains(n)) continue;
+        for (const QString& d : m_waitsFor.value(n)) {
+            if (failed.contains(d)) {
+                failed.insert(n);
+                m_settled.insert(n);
+                skipped.append(n);
+                break;
+            }
+        }
+    }
+    return skipped;
+}
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <QHash>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+
+// Planning and bookkeeping for a batch of local .lgx installs
+// (installLocalPackages). The backend feeds in what inspectPackage
+// reported for each file, then drives the batch from gate approvals and
+// install results; everything about WHICH entry may run WHEN lives here
+// so it can be tested without package_manager.
+//
+// Order: deps first over the dependencies the manifests declare among
+// the batch itself (Kahn; ties keep file order). A cycle is broken in
+// file order, and an entry only ever waits for the in-batch
+// dependencies placed before it, so a cycle can't stall the batch.
+//
+// Running: an approved entry is ready once every dependency it waits
+// for has installed. When an entry fails (install error, rejected gate)
+// every entry still waiting on it, directly or through another waiting
+// entry, is settled as skipped instead of being installed against a
+// dependency that isn't there.
+class LocalInstallBatch {
+public:
+    struct Entry {
+        QString     file;
+        QString     name;
+        QString     version;
+        bool        alreadyInstalled = false;
+        QString     installedVersion;
+        QStringList deps;
+    };
+
+    // Start over with `files` (as given, for stable ordering), all of
+    // them still to be inspected.
+    void reset(int generation, const QStringList& files);
+    int  generation() const { return m_generation; }
+
+    // One inspect reply: a readable entry, or a failure (nullptr).
+    // Returns true when that was the last outstanding reply. Two files
+    // for one package: the newer version wins.
+    bool inspected(const Entry* entry);
+
+    // Order the entries read so far; call once inspecting is over.
+    void plan();
+    const QStringList& order() const { return m_order; }
+    const Entry* entry(const QString& name) const;
+    // The in-batch dependencies `name` waits for.
+    QStringList waitsFor(const QString& name) const { return m_waitsFor.value(name); }
+    // `name` and everything it waits for, directly or transitively, in
+    // batch order — the entries its gate dialog has to list.
+    QStringList waitsForClosure(const QString& name) const;
+
+    bool active() const { return m_inspecting > 0 || !m_order.isEmpty(); }
+    bool contains(const QString& name) const { return m_entries.contains(name); }
+    bool isSettled(const QString& name) const { return m_settled.contains(name); }
+    int  settledCount() const { return static_cast<int>(m_settled.size()); }
+    // Every entry settled AND every gate answered: a skipped entry's
+    // gate request is still out until the host approves or rejects it.
+    bool isDone() const
+    {
+        return !m_order.isEmpty() && m_settled.size() == m_order.size()
+            && m_answered.size() == m_order.size();
+    }
+    int  running() const { return m_running; }
+
+    // The host approved `name`'s gate. False when it's settled already
+    // (skipped) and must not be installed.
+    bool approve(const QString& name);
+
+    // Approved entries whose dependencies have installed, in batch
+    // order, up to `maxRunning` running at once; each is marked running.
+    QStringList takeReady(int maxRunning);
+
+    // `name` finished, or its gate was rejected / cancelled. On failure,
+    // returns the entries skipped because of it, in batch order; each
+    // is settled too (their gates stay open until answered).
+    QStringList settle(const QString& name, bool success);
+
+private:
+    int                   m_generation = 0;
+    int                   m_inspecting = 0;
+    QStringList           m_files;
+    QHash<QString, Entry> m_entries;    // by package name
+    QStringList           m_order;
+    QHash<QString, QStringList> m_waitsFor;
+    QSet<QString>         m_approved;
+    QSet<QString>         m_started;
+    QSet<QString>         m_settled;    // installed, failed or skipped
+    QSet<QString>         m_installed;
+    QSet<QString>         m_answered;   // gate approved, rejected or cancelled
+    int                   m_running = 0;
+};
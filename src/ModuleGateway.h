@@ -0,0 +1,82 @@
+#pragma once
+
+#include <functional>
+
+#include <QString>
+#include <QStringList>
+#include <QVariant>
+#include <QVariantList>
+#include <QVariantMap>
+
+// Every call PackageManagerBackend makes into its two dependency
+// modules, package_downloader and package_manager, behind one interface.
+// Two implementations:
+//   * SdkModuleGateway       — the real thing: forwards to the typed
+//                              wrappers from modules() (LogosModules).
+//   * StandInModuleGateway   — in-process fakes with a synthetic catalog,
+//                              configurable latency, failure injection and
+//                              the events a host would send; lets the
+//                              backend run headlessly (tests, profiling).
+//                              Built into the plugin only with
+//                              -DPMU_WITH_STANDIN_MODULES=ON.
+//
+// Shapes are the modules' own: callbacks receive exactly what the typed
+// wrappers hand over, events carry the same QVariantList payloads. Calls
+// are always asynchronous — a callback never runs inside the call that
+// registered it.
+class ModuleGateway {
+public:
+    using MapCallback     = std::function<void(QVariantMap)>;
+    using ListCallback    = std::function<void(QVariantList)>;
+    using VariantCallback = std::function<void(QVariant)>;
+    using EventHandler    = std::function<void(const QVariantList&)>;
+
+    // installPlugin's reply with the transport outcome kept apart from
+    // the provider's answer: on a timeout or a dropped connection `ok` is
+    // false and `value` is empty (see installOnePackage).
+    struct InstallReply {
+        bool        ok = true;
+        QString     errorCode;
+        QString     errorMessage;
+        QVariantMap value;
+    };
+    using InstallCallback = std::function<void(InstallReply)>;
+
+    virtual ~ModuleGateway() = default;
+
+    // Context wired and `moduleName`'s client connected.
+    virtual bool isReady(const char* moduleName) const = 0;
+
+    // ── package_downloader ──────────────────────────────────────────
+    virtual void refreshCatalog(MapCallback onDone) = 0;
+    // Re-fetch one repository's metadata and index (by its
+    // repositoryUrl); the next getCatalog reflects it.
+    virtual void refreshRepository(const QString& repositoryUrl, MapCallback onDone) = 0;
+    virtual void getCatalog(ListCallback onDone) = 0;
+    // Catalog rows added / changed / removed since `sinceGeneration`, in
+    // the shape catalogdelta::apply takes. `full` is set when that
+    // generation is too old (or unknown, -1) to describe as a delta.
+    virtual void getCatalogDelta(qint64 sinceGeneration, MapCallback onDone) = 0;
+    virtual void listRepositories(ListCallback onDone) = 0;
+    virtual void resolveDependencies(const QString& depsJson, const QString& installedJson,
+                                     ListCallback onDone) = 0;
+    virtual void downloadResolvedDependencies(const QString& depsJson,
+                                              const QString& installedJson,
+                                              ListCallback onDone, int timeoutMs) = 0;
+    virtual void onDownloaderEvent(const QString& event, EventHandler handler) = 0;
+
+    // ── package_manager ─────────────────────────────────────────────
+    virtual void getInstalledPackages(ListCallback onDone) = 0;
+    virtual void getValidVariants(VariantCallback onDone) = 0;
+    virtual void inspectPackage(const QString& filePath, MapCallback onDone) = 0;
+    virtual void installPlugin(const QString& filePath, InstallCallback onDone,
+                               int timeoutMs) = 0;
+    virtual void requestInstall(const QString& name, const QString& version,
+                                const QString& repositoryUrl, const QString& changesJson,
+                                MapCallback onDone) = 0;
+    virtual void requestUpgrade(const QString& name, const QString& version, int mode,
+                                const QString& changesJson, MapCallback onDone) = 0;
+    virtual void requestUninstall(const QString& name, MapCallback onDone) = 0;
+    virtual void requestMultiUninstall(const QStringList& names, MapCallback onDone) = 0;
+    virtual void onManagerEvent(const QString& event, EventHandler handler) = 0;
+};
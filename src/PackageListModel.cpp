@@ -53,6 +53,12 @@ QVariant PackageListModel::data(const QModelIndex& index, int role) const
         case RowActionRole:              return package.value("rowAction",
                                                   static_cast<int>(PackageTypes::NoOp));
         case UpdateAvailableRole:        return package.value("updateAvailable", false);
+        case VersionLabelsRole:          return package.value("versionLabels");
+        case HasDuplicateVersionsRole:   return package.value("hasDuplicateVersions", false);
+        case IsGroupPlaceholderRole:     return package.value("isGroupPlaceholder", false);
+        case GroupRowCountRole:          return package.value("groupRowCount", 0);
+        case GroupInstalledCountRole:    return package.value("groupInstalledCount", 0);
+        case GroupMembersRole:           return package.value("groupMembers");
 
         default:                     return QVariant();
     }
@@ -88,6 +94,12 @@ QHash<int, QByteArray> PackageListModel::roleNames() const
         {IsFirstOfSourceRole,         "isFirstOfSource"},
         {RowActionRole,               "rowAction"},
         {UpdateAvailableRole,         "updateAvailable"},
+        {VersionLabelsRole,           "versionLabels"},
+        {HasDuplicateVersionsRole,    "hasDuplicateVersions"},
+        {IsGroupPlaceholderRole,      "isGroupPlaceholder"},
+        {GroupRowCountRole,           "groupRowCount"},
+        {GroupInstalledCountRole,     "groupInstalledCount"},
+        {GroupMembersRole,            "groupMembers"},
     };
 }
 
@@ -201,29 +213,13 @@ static std::pair<int, int> mutateMatchingRows(QList<QVariantMap>& rows, Pred pre
 
 void PackageListModel::setPackages(const QList<QVariantMap>& packages)
 {
-    // Save selected rows by composite (repo, name) key before reset.
-    // Using bare names would mark the WRONG row when two repos publish
-    // the same package name.
-    QSet<QString> previouslySelectedKeys;
-    for (const QVariantMap& pkg : m_packages) {
-        if (pkg.value("isSelected").toBool()) previouslySelectedKeys.insert(rowKey(pkg));
-    }
-    // Snapshot per-row selectedVersionIndex so the user's pick survives a
-    // category filter pass or a debounced post-install refresh.
-    QHash<QString, int> selectedVersionByKey;
-    for (const QVariantMap& pkg : m_packages) {
-        const int idx = pkg.value("selectedVersionIndex", 0).toInt();
-        if (idx != 0) selectedVersionByKey.insert(rowKey(pkg), idx);
-    }
-
-    beginResetModel();
-    m_packages = packages;
+    QList<QVariantMap> incoming = packages;
 
     // Walk incoming rows. For each row:
     //   * Restore selection (only when the row has an available variant)
-    //     using the composite (repo, name) key so two repos' "foo" rows
-    //     don't share selection state.
-    //   * Restore per-row selectedVersionIndex from the snapshot, clamped
+    //     from m_choices, keyed by the composite (repo, name) so two
+    //     repos' "foo" rows don't share selection state.
+    //   * Restore per-row selectedVersionIndex from m_choices, clamped
     //     to the new availableVersions length.
     //   * If the row came in as NotInstalled AND m_failedByKey has an
     //     entry for its key/moduleName, inject Failed + errorMessage so
@@ -231,16 +227,21 @@ void PackageListModel::setPackages(const QList<QVariantMap>& packages)
     //     post-install refreshes.
     //   * Otherwise drop the cache entry so Failed doesn't resurrect
     //     on a later flip back to NotInstalled.
-    for (QVariantMap& row : m_packages) {
+    for (QVariantMap& row : incoming) {
         const QString moduleName = row.value("moduleName").toString();
         const QString key = rowKey(row);
         const bool available = row.value("isVariantAvailable", false).toBool();
-        row["isSelected"] = available && previouslySelectedKeys.contains(key);
+        const auto choice = m_choices.constFind(key);
+        const bool hasChoice = choice != m_choices.constEnd();
+        // Rows arrive unselected and mostly shared with the row cache;
+        // writing only the selected ones keeps the rest shared.
+        if (available && hasChoice && choice->selected) row["isSelected"] = true;
+        else if (row.contains("isSelected")) row.remove("isSelected");
 
         bool dropdownRestored = false;
-        if (selectedVersionByKey.contains(key)) {
+        if (hasChoice && choice->versionIndex != 0) {
             const QVariantList avail = row.value("availableVersions").toList();
-            int idx = selectedVersionByKey.value(key);
+            int idx = choice->versionIndex;
             if (idx < 0 || idx >= avail.size()) idx = 0;
             row["selectedVersionIndex"] = idx;
             // Mirror the picked entry's version/hash into the row's
@@ -289,15 +290,107 @@ void PackageListModel::setPackages(const QList<QVariantMap>& packages)
         if (dropdownRestored || failedBackFilled)
             recomputeRowAction(row);
     }
+    syncChoices(incoming);
 
-    endResetModel();
+    applyPackages(std::move(incoming));
     emit hasSelectionChanged();
 }
 
+void PackageListModel::rememberChoice(const QVariantMap& row)
+{
+    const QString key = rowKey(row);
+    const bool selected = row.value("isSelected").toBool();
+    const int versionIndex = row.value("selectedVersionIndex", 0).toInt();
+    if (!selected && versionIndex == 0) {
+        m_choices.remove(key);
+        return;
+    }
+    m_choices.insert(key, {selected, versionIndex,
+                           row.value("name").toString(),
+                           row.value("moduleName").toString(),
+                           row.value("repositoryUrl").toString()});
+}
+
+void PackageListModel::syncChoices(const QList<QVariantMap>& rows)
+{
+    // A collapsed group arrives as one placeholder row carrying the
+    // group's repositoryUrl; the picks for its hidden rows are kept so
+    // they come back on expand. Picks for rows that are neither present
+    // nor hidden (the package left the catalog) are dropped.
+    QSet<QString> present;
+    QSet<QString> collapsedUrls;
+    present.reserve(rows.size());
+    for (const QVariantMap& row : rows) {
+        if (row.value("isGroupPlaceholder").toBool()) {
+            collapsedUrls.insert(row.value("repositoryUrl").toString());
+            continue;
+        }
+        present.insert(rowKey(row));
+        rememberChoice(row);
+    }
+    for (auto it = m_choices.begin(); it != m_choices.end();) {
+        if (present.contains(it.key()) || collapsedUrls.contains(it->repositoryUrl)) ++it;
+        else it = m_choices.erase(it);
+    }
+}
+
+void PackageListModel::applyPackages(QList<QVariantMap> incoming)
+{
+    // Rows are grouped by repository and a refresh usually changes few
+    // of them (often one repository's run), so trim the rows that are
+    // identical at both ends and only replace the middle. Views and
+    // proxies then see a dataChanged or a remove + insert for that
+    // range instead of a reset.
+    const int oldCount = m_packages.size();
+    const int newCount = incoming.size();
+    int head = 0;
+    while (head < oldCount && head < newCount && m_packages.at(head) == incoming.at(head))
+        ++head;
+    int tail = 0;
+    while (tail < oldCount - head && tail < newCount - head
+           && m_packages.at(oldCount - 1 - tail) == incoming.at(newCount - 1 - tail))
+        ++tail;
+
+    const int oldMid = oldCount - head - tail;
+    const int newMid = newCount - head - tail;
+    if (oldMid == 0 && newMid == 0) return;
+
+    if (head == 0 && tail == 0) {
+        beginResetModel();
+        m_packages = std::move(incoming);
+        endResetModel();
+        return;
+    }
+
+    // Same rows in the same places, only their fields changed.
+    bool sameKeys = oldMid == newMid;
+    for (int i = head; sameKeys && i < head + oldMid; ++i)
+        sameKeys = rowKey(m_packages.at(i)) == rowKey(incoming.at(i));
+    if (sameKeys) {
+        for (int i = head; i < head + newMid; ++i) m_packages[i] = incoming.at(i);
+        emit dataChanged(createIndex(head, 0), createIndex(head + newMid - 1, 0));
+        return;
+    }
+
+    if (oldMid > 0) {
+        beginRemoveRows(QModelIndex(), head, head + oldMid - 1);
+        m_packages.remove(head, oldMid);
+        endRemoveRows();
+    }
+    if (newMid > 0) {
+        beginInsertRows(QModelIndex(), head, head + newMid - 1);
+        for (int i = 0; i < newMid; ++i)
+            m_packages.insert(head + i, incoming.at(head + i));
+        endInsertRows();
+    }
+}
+
 void PackageListModel::updatePackageSelection(int index, bool isSelected)
 {
     if (index < 0 || index >= m_packages.size()) return;
-    m_packages[index]["isSelected"] = isSelected;
+    if (isSelected) m_packages[index]["isSelected"] = true;
+    else            m_packages[index].remove("isSelected");
+    rememberChoice(m_packages.at(index));
 
     const QModelIndex modelIndex = createIndex(index, 0);
     emit dataChanged(modelIndex, modelIndex, {IsSelectedRole});
@@ -365,6 +458,7 @@ void PackageListModel::setRowVersion(int index, int versionIndex)
     const int currentIdx = m_packages[index].value("selectedVersionIndex", 0).toInt();
     if (currentIdx == versionIndex) return;
     m_packages[index]["selectedVersionIndex"] = versionIndex;
+    rememberChoice(m_packages.at(index));
 
     // Surface the chosen version's `version` / `rootHash` in the existing
     // VersionRole / HashRole so the rest of the QML (status comparison,
@@ -419,6 +513,14 @@ int PackageListModel::getSelectedCount() const
     return n;
 }
 
+QList<int> PackageListModel::getSelectedRows() const
+{
+    QList<int> rows;
+    for (int i = 0; i < m_packages.size(); ++i)
+        if (m_packages.at(i).value("isSelected").toBool()) rows.append(i);
+    return rows;
+}
+
 int PackageListModel::getInstallableSelectedCount() const
 {
     return countSelectedMatching(m_packages, isInstallableRow);
@@ -482,15 +584,23 @@ void PackageListModel::clearSelectionsByModuleNames(const QStringList& moduleNam
 
 void PackageListModel::clearSelectionsBy(const QStringList& keys, const char* field)
 {
-    if (keys.isEmpty() || m_packages.isEmpty()) return;
+    if (keys.isEmpty()) return;
     const QSet<QString> keySet(keys.begin(), keys.end());
 
+    // Rows of a collapsed group aren't in m_packages; their picks are.
+    const bool byName = qstrcmp(field, "name") == 0;
+    for (auto it = m_choices.begin(); it != m_choices.end();) {
+        if (keySet.contains(byName ? it->name : it->moduleName)) it->selected = false;
+        if (!it->selected && it->versionIndex == 0) it = m_choices.erase(it);
+        else ++it;
+    }
+
     auto [first, last] = mutateMatchingRows(m_packages,
         [&](const QVariantMap& p) {
             return p.value("isSelected").toBool()
                 && keySet.contains(p.value(field).toString());
         },
-        [](QVariantMap& p) { p["isSelected"] = false; });
+        [](QVariantMap& p) { p.remove("isSelected"); });
 
     if (first < 0) return;
     emit dataChanged(createIndex(first, 0), createIndex(last, 0), {IsSelectedRole});
@@ -499,9 +609,15 @@ void PackageListModel::clearSelectionsBy(const QStringList& keys, const char* fi
 
 void PackageListModel::clearAllSelections()
 {
+    for (auto it = m_choices.begin(); it != m_choices.end();) {
+        it->selected = false;
+        if (it->versionIndex == 0) it = m_choices.erase(it);
+        else ++it;
+    }
+
     auto [first, last] = mutateMatchingRows(m_packages,
         [](const QVariantMap& p) { return p.value("isSelected").toBool(); },
-        [](QVariantMap& p) { p["isSelected"] = false; });
+        [](QVariantMap& p) { p.remove("isSelected"); });
 
     if (first < 0) return;
     emit dataChanged(createIndex(first, 0), createIndex(last, 0), {IsSelectedRole});
@@ -127,13 +127,10 @@ public:
         SelectedVersionIndexRole,
 
         // True for the first row of each source group when the model is
-        // sorted by (sourcePriority, sourceName, name). The QML uses it
-        // to render a section header above the row instead of repeating
-        // the source label on every row. Computed by
-        // PackageManagerBackend::setPackagesFromVariantList after its
-        // group-ordered sort. Filter-proxy reslicing can stale the
-        // value when the first row of a source gets filtered out, but
-        // the default unfiltered view is always correct.
+        // sorted by (sourcePriority, sourceName, name). Tagged here by
+        // packagerows::buildPackageRows for the unfiltered order;
+        // PackagesFilterProxy answers this role itself from its group
+        // index, so what the view sees stays right after filtering.
         IsFirstOfSourceRole,
 
         // The row's primary action (PackageTypes::RowAction enum int),
@@ -148,7 +145,24 @@ public:
         // `availableVersions`, regardless of the user's dropdown pick.
         // Drives the small marker on the Version cell. Computed once
         // per buildPackageRow (no dropdown coupling).
-        UpdateAvailableRole
+        UpdateAvailableRole,
+
+        // The version dropdown's items (QStringList), one per
+        // `availableVersions` entry that carries a version string, and
+        // whether any version string repeats — in which case each label
+        // is "version · date · short hash". Built once per
+        // buildPackageRow so delegates bind them as-is.
+        VersionLabelsRole,
+        HasDuplicateVersionsRole,
+
+        // A collapsed source group's single stand-in row (see
+        // packagerows::buildGroupPlaceholderRow): the group's package
+        // count, how many of those are installed, and the fields the
+        // filter proxy matches each of them on.
+        IsGroupPlaceholderRole,
+        GroupRowCountRole,
+        GroupInstalledCountRole,
+        GroupMembersRole
     };
 
     explicit PackageListModel(QObject* parent = nullptr);
@@ -158,6 +172,9 @@ public:
     QVariant data(const QModelIndex& index, int role) const override;
     QHash<int, QByteArray> roleNames() const override;
 
+    // Replace the rows, carrying selection, dropdown picks and Failed
+    // marks over by (repo, name). Only the changed range is signalled —
+    // see applyPackages.
     void setPackages(const QList<QVariantMap>& packages);
     void updatePackageSelection(int index, bool isSelected);
     void updatePackageInstallation(const QString& packageName, int status,
@@ -173,6 +190,8 @@ public:
 
     QStringList getSelectedPackageNames() const;
     int getSelectedCount() const;
+    // Model row indices of every selected row, in model order.
+    QList<int> getSelectedRows() const;
 
     int getInstallableSelectedCount() const;
     int getUninstallableSelectedCount() const;
@@ -205,10 +224,32 @@ signals:
 
 private:
     void clearSelectionsBy(const QStringList& keys, const char* field);
+    // Swap in `incoming`, signalling the smallest single range that
+    // differs: nothing, a dataChanged, a remove + insert, or a reset when
+    // not even the first or last row survives.
+    void applyPackages(QList<QVariantMap> incoming);
+    // Record (or forget, once it's back to unselected + newest) the
+    // row's selection and dropdown pick in m_choices.
+    void rememberChoice(const QVariantMap& row);
+    // Re-record the choices of the rows just applied and drop the ones
+    // whose row is gone for good (not merely inside a collapsed group).
+    void syncChoices(const QList<QVariantMap>& rows);
 
     struct FailedEntry { QString errorMessage; };
     
     QHash<QString, FailedEntry> m_failedByKey;
 
+    // User choices by composite (repo, name) key, held outside the rows
+    // so they outlive the rows of a collapsed source group. setPackages
+    // restores rows from here rather than from the rows it replaces.
+    struct RowChoice {
+        bool    selected     = false;
+        int     versionIndex = 0;
+        QString name;
+        QString moduleName;
+        QString repositoryUrl;   // what collapse keys on
+    };
+    QHash<QString, RowChoice> m_choices;
+
     QList<QVariantMap> m_packages;
 };
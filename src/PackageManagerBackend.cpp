@@ -1,18 +1,31 @@
 #include "PackageManagerBackend.h"
 #include <algorithm>
 #include <QDebug>
+#include <QDir>
+#include <QDirIterator>
 #include <QFileInfo>
+#include <QFuture>
 #include <QHash>
 #include <QJsonArray>
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QJsonParseError>
 #include <QPointer>
+#include <QPromise>
 #include <QSet>
+#include <QThreadPool>
 #include <QTimer>
 #include <QVariant>
 #include "logos_sdk.h"
+#include "CatalogDelta.h"
+#include "PackageRowBuilder.h"
 #include "RowActionResolver.h"   // versionCmp + resolveRowAction (shared with PackageListModel)
+#include "SdkModuleGateway.h"
+#ifdef PMU_WITH_STANDIN_MODULES
+#include "StandInModuleGateway.h"
+#endif
+#include "TimedModuleGateway.h"
+#include "UpgradePlanner.h"
 
 constexpr int DOWNLOAD_TIMEOUT_MS = 300000; // 5 minutes
 
@@ -41,11 +54,44 @@ QString PackageManagerBackend::buildDepsJson(const QList<PackageInstallSpec>& sp
 }
 
 PackageManagerBackend::PackageManagerBackend(QObject* parent)
+    : PackageManagerBackend(nullptr, parent)
+{
+}
+
+PackageManagerBackend::PackageManagerBackend(std::unique_ptr<ModuleGateway> modules,
+                                             QObject* parent)
     : PackageManagerUiSimpleSource(parent)
     , m_packageModel(new PackageListModel(this))
     , m_packagesFilterProxy(new PackagesFilterProxy(this))
     , m_packagesPagingProxy(new PackagesPagingProxy(this))
+    , m_modules(std::move(modules))
 {
+#ifdef PMU_WITH_STANDIN_MODULES
+    if (!m_modules && StandInModuleGateway::enabledByEnvironment()) {
+        qWarning() << "PackageManagerBackend: PMU_STANDIN_MODULES is set — running against"
+                      " in-process stand-ins, not the real modules";
+        m_modules = std::make_unique<StandInModuleGateway>(
+            StandInModuleGateway::Config::fromEnvironment());
+    }
+#else
+    if (!m_modules && qEnvironmentVariableIsSet("PMU_STANDIN_MODULES"))
+        qWarning() << "PackageManagerBackend: PMU_STANDIN_MODULES ignored — this build has no"
+                      " stand-ins (configure with -DPMU_WITH_STANDIN_MODULES=ON)";
+#endif
+    const bool hostless = static_cast<bool>(m_modules);
+    if (!m_modules) {
+        m_modules = std::make_unique<SdkModuleGateway>([this]() -> LogosModules* {
+            // modules() is only valid once the generated glue has wired it.
+            return isContextReady() ? &modules() : nullptr;
+        });
+    }
+    m_perf.reset(PerfStats::fromEnvironment());
+    m_firstRowsBegan = m_perf->begin();
+    m_internCatalog = qEnvironmentVariableIsSet("PMU_CATALOG_INTERN")
+                   && qEnvironmentVariable("PMU_CATALOG_INTERN") != QLatin1String("0");
+    if (m_perf->enabled())
+        m_modules = std::make_unique<TimedModuleGateway>(std::move(m_modules), m_perf);
+
     // Initialise base-class properties to sane defaults.
     setSelectedCategoryIndex(0);
     setRunnableActionCount(0);
@@ -65,14 +111,7 @@ PackageManagerBackend::PackageManagerBackend(QObject* parent)
     setSortOrder(Qt::AscendingOrder);
     setTotalCount(0);
     setRepositoryCount(0);
-
-    {
-        QVariantMap ids;
-        const auto rn = m_packageModel->roleNames();
-        for (auto it = rn.cbegin(); it != rn.cend(); ++it)
-            ids.insert(QString::fromUtf8(it.value()), int(it.key()));
-        setPackageRoleIds(ids);
-    }
+    setPerfStats(QVariantMap{});
 
     // Stack: raw model → filter+sort proxy → paging proxy. ui-host's
     // dynamic remoting scans backend Q_PROPERTYs of QAbstractItemModel*
@@ -83,6 +122,26 @@ PackageManagerBackend::PackageManagerBackend(QObject* parent)
     m_packagesFilterProxy->setSourceModel(m_packageModel);
     m_packagesPagingProxy->setSourceModel(m_packagesFilterProxy);
 
+    // Read off the top of the stack: the filter proxy adds roles of its
+    // own (sourceGroupCount).
+    {
+        QVariantMap ids;
+        const auto rn = m_packagesPagingProxy->roleNames();
+        for (auto it = rn.cbegin(); it != rn.cend(); ++it)
+            ids.insert(QString::fromUtf8(it.value()), int(it.key()));
+        setPackageRoleIds(ids);
+    }
+
+    setSourceGroupCounts(QVariantMap{});
+    setCollapsedSources(QStringList{});
+    m_sourceGroupCountsTimer = new QTimer(this);
+    m_sourceGroupCountsTimer->setSingleShot(true);
+    m_sourceGroupCountsTimer->setInterval(0);
+    connect(m_sourceGroupCountsTimer, &QTimer::timeout,
+            this, &PackageManagerBackend::publishSourceGroupCounts);
+    connect(m_packagesFilterProxy, &PackagesFilterProxy::sourceGroupsChanged,
+            m_sourceGroupCountsTimer, qOverload<>(&QTimer::start));
+
     // One-shot wiring: every selection / install-status mutation on the
     // model emits hasSelectionChanged, which rebuilds the bulk action
     // plan and pushes the `runnableActionCount` / `actionSummary` .rep
@@ -97,13 +156,25 @@ PackageManagerBackend::PackageManagerBackend(QObject* parent)
     // when its source's row set changes (i.e. filter / sort flip), so
     // the backend doesn't have to coordinate that interaction.
     connect(this, &PackageManagerUiSimpleSource::searchTextChanged,
-            this, [this]() { m_packagesFilterProxy->setSearchText(searchText()); });
+            this, [this]() {
+                const auto t = m_perf->scope("filter.search");
+                m_packagesFilterProxy->setSearchText(searchText());
+            });
     connect(this, &PackageManagerUiSimpleSource::installStateFilterChanged,
-            this, [this]() { m_packagesFilterProxy->setInstallStateFilter(installStateFilter()); });
+            this, [this]() {
+                const auto t = m_perf->scope("filter.installState");
+                m_packagesFilterProxy->setInstallStateFilter(installStateFilter());
+            });
     connect(this, &PackageManagerUiSimpleSource::sortRoleChanged,
-            this, [this]() { m_packagesFilterProxy->setSortRoleByName(sortRole()); });
+            this, [this]() {
+                const auto t = m_perf->scope("sort");
+                m_packagesFilterProxy->setSortRoleByName(sortRole());
+            });
     connect(this, &PackageManagerUiSimpleSource::sortOrderChanged,
-            this, [this]() { m_packagesFilterProxy->setSortOrderInt(sortOrder()); });
+            this, [this]() {
+                const auto t = m_perf->scope("sort");
+                m_packagesFilterProxy->setSortOrderInt(sortOrder());
+            });
     connect(this, &PackageManagerUiSimpleSource::pageSizeChanged,
             this, [this]() { m_packagesPagingProxy->setPageSize(pageSize()); });
     connect(this, &PackageManagerUiSimpleSource::currentPageChanged,
@@ -144,6 +215,13 @@ PackageManagerBackend::PackageManagerBackend(QObject* parent)
     connect(m_refreshDebounceTimer, &QTimer::timeout,
             this, &PackageManagerBackend::refreshPackages);
 
+    // Catalog edits upstream (catalogChanged) take the delta path instead.
+    m_catalogDeltaTimer = new QTimer(this);
+    m_catalogDeltaTimer->setSingleShot(true);
+    m_catalogDeltaTimer->setInterval(150);
+    connect(m_catalogDeltaTimer, &QTimer::timeout,
+            this, &PackageManagerBackend::pullCatalogDelta);
+
     // Filter-apply debounce — see header comment. 30ms is short enough to
     // feel instant for a single click but long enough to coalesce the
     // bursts that arrive when the user clicks several categories / types
@@ -161,6 +239,42 @@ PackageManagerBackend::PackageManagerBackend(QObject* parent)
         if (catPending)  applyCategoryFilter();
         if (typePending) applyTypeFilter();
     });
+
+    // Speculative pre-resolve — see header comment. Armed whenever the
+    // visible page or the selection settles; 400ms of quiet keeps it off
+    // the wire while the user is still paging / typing a search.
+    m_preResolveTimer = new QTimer(this);
+    m_preResolveTimer->setSingleShot(true);
+    m_preResolveTimer->setInterval(400);
+    connect(m_preResolveTimer, &QTimer::timeout,
+            this, &PackageManagerBackend::runPreResolvePass);
+    connect(m_packagesPagingProxy, &QAbstractItemModel::modelReset,
+            this, &PackageManagerBackend::schedulePreResolve);
+    connect(m_packageModel, &PackageListModel::hasSelectionChanged,
+            this, &PackageManagerBackend::schedulePreResolve);
+
+    // Byte-progress throttle — see header comment. Deliberately NOT
+    // restarted per event: it fires at a steady cadence while chunks keep
+    // arriving, instead of waiting for a quiet gap that never comes.
+    m_downloadProgressTimer = new QTimer(this);
+    m_downloadProgressTimer->setSingleShot(true);
+    m_downloadProgressTimer->setInterval(kDownloadProgressPublishMs);
+    connect(m_downloadProgressTimer, &QTimer::timeout, this, [this]() {
+        publishDownloadProgress();
+    });
+
+    if (m_perf->enabled()) {
+        m_perfPublishTimer = new QTimer(this);
+        m_perfPublishTimer->setInterval(kPerfPublishMs);
+        connect(m_perfPublishTimer, &QTimer::timeout, this, [this]() {
+            if (m_perf->takeDirty()) setPerfStats(m_perf->toVariant());
+        });
+        m_perfPublishTimer->start();
+    }
+
+    // No host will call onContextReady() for stand-in modules.
+    if (hostless)
+        QTimer::singleShot(0, this, [this]() { finishInitialSetup(0); });
 }
 
 void PackageManagerBackend::onContextReady()
@@ -199,12 +313,6 @@ void PackageManagerBackend::finishInitialSetup(int attempt)
 
 // ─────────────────────────── file-local helpers ───────────────────────────
 
-// Use the shared dotted-numeric comparator from RowActionResolver.h —
-// PackageListModel::setRowVersion needs the same logic to recompute the
-// per-row Action when the user moves the dropdown, so keeping versionCmp
-// file-local here would force a copy. Bring it into the TU via a using.
-using rowaction::versionCmp;
-
 // Decode a package_manager event payload (a single JSON-encoded string in
 // `data.first()`) into a QJsonObject. Returns an empty object on any failure
 // (no payload, parse error, or non-object root) — callers test isEmpty().
@@ -218,293 +326,11 @@ static QJsonObject parseEventPayload(const QVariantList& data)
     return doc.object();
 }
 
-// Split a variant string into (base, flavor). Variants are formatted as
-// "<os>-<arch>" (release build, no flavor suffix) or "<os>-<arch>-<flavor>"
-// where <flavor> is one of a known set ("dev", "portable")
-static std::pair<QString, QString> splitVariant(const QString& v)
-{
-    static const QSet<QString> kKnownFlavors = {
-        QStringLiteral("dev"), QStringLiteral("portable")
-    };
-    const int lastDash = v.lastIndexOf(QLatin1Char('-'));
-    if (lastDash <= 0) return {v, QString()};
-    const QString trailing = v.mid(lastDash + 1);
-    if (kKnownFlavors.contains(trailing)) {
-        return {v.left(lastDash), trailing};
-    }
-    return {v, QString()};
-}
-
-// Classify why a package's offered variants don't intersect the platform's
-// valid variants. The QML side (ActionPill, when rowAction==NotAvailable)
-// maps the enum to user-facing copy via its tooltip.
-//   - NoVariantsPublished: nothing offered — nothing to install anywhere.
-//   - BuildFlavorMismatch: platform IS offered, wrong flavor (dev/portable/
-//     release). User can switch basecamp build flavor to recover.
-//   - PlatformMismatch: OS/arch not offered. User can't recover.
-static PackageTypes::NotAvailableReason classifyNotAvailable(
-    const QStringList& offeredVariants, const QStringList& validVariants)
-{
-    if (offeredVariants.isEmpty()) return PackageTypes::NoVariantsPublished;
-
-    QSet<QString> userBases;
-    for (const QString& v : validVariants) userBases.insert(splitVariant(v).first);
-    for (const QString& v : offeredVariants) {
-        if (userBases.contains(splitVariant(v).first))
-            return PackageTypes::BuildFlavorMismatch;
-    }
-    return PackageTypes::PlatformMismatch;
-}
-
-// Build one model row from one raw catalog row + the installed-by-name index +
-// the valid-variants list for this platform. Pure transform; no instance state.
-//
-// Each catalog row has the multi-repo `index.json` shape produced by
-// `package_downloader.getCatalog()`: a `versions[]` array (sorted newest-
-// first) where every entry carries the embedded `manifest` for that
-// version, plus a small set of header fields (`name`, `description`,
-// `type`, `category`, `repositoryUrl`, `repositoryName`, …) that
-// `getCatalogJson` lifts from `versions[0].manifest` for convenience.
-// We pick `versions[0]` as the selected version (newest); a future
-// per-row picker can swap the index without changing this transform.
-static QVariantMap buildPackageRow(const QVariantMap& obj,
-                                   const QHash<QString, QVariantMap>& installedByName,
-                                   const QStringList& validVariants)
-{
-    QVariantMap pkg;
-    const QString name = obj.value("name").toString();
-
-    const QVariantList rawVersions = obj.value("versions").toList();
-    QVariantMap selectedVersion;
-    if (!rawVersions.isEmpty()) selectedVersion = rawVersions.first().toMap();
-
-    // Manifest of the selected (newest) version — every per-row field
-    // not surfaced at the catalog-row top level is read from here.
-    const QVariantMap manifest = selectedVersion.value("manifest").toMap();
-
-    QString moduleName = obj.value("moduleName").toString();
-    if (moduleName.isEmpty()) moduleName = manifest.value("name").toString();
-    if (moduleName.isEmpty()) moduleName = name;
-
-    QString displayName = obj.value("displayName").toString();
-    if (displayName.isEmpty()) displayName = manifest.value("display_name").toString();
-    if (displayName.isEmpty()) displayName = moduleName;
-
-    pkg["name"] = name;
-    pkg["moduleName"] = moduleName;
-    pkg["displayName"] = displayName;
-    // Header fields: prefer the catalog-row's lifted copy (which
-    // getCatalogJson sets from versions[0].manifest), fall back to the
-    // manifest itself if the catalog row didn't surface the field.
-    pkg["description"] = obj.value("description").toString().isEmpty()
-                         ? manifest.value("description").toString()
-                         : obj.value("description").toString();
-    pkg["type"] = obj.value("type").toString().isEmpty()
-                  ? manifest.value("type").toString()
-                  : obj.value("type").toString();
-    pkg["category"] = obj.value("category").toString().isEmpty()
-                      ? manifest.value("category").toString()
-                      : obj.value("category").toString();
-
-    pkg["repositoryUrl"]         = obj.value("repositoryUrl").toString();
-    pkg["repositoryName"]        = obj.value("repositoryName").toString();
-    pkg["repositoryDisplayName"] = obj.value("repositoryDisplayName").toString();
-
-    // Trim each entry of versions[] into a model-friendly shape.
-    QVariantList availableVersions;
-    for (const QVariant& vv : rawVersions) {
-        const QVariantMap vm = vv.toMap();
-        const QVariantMap vManifest = vm.value("manifest").toMap();
-        QVariantMap entry;
-        entry["version"]      = vManifest.value("version").toString();
-        entry["rootHash"]     = vm.value("rootHash").toString();
-        entry["releasedAt"]   = vm.value("releasedAt").toString();
-        entry["size"]         = vm.value("size");
-        entry["publisherRef"] = vm.value("publisherRef").toString();
-        entry["url"]          = vm.value("url").toString();
-        entry["signed"]       = vm.contains("signature");
-        entry["signerDid"]    = vm.value("signature").toMap().value("did").toString();
-        entry["manifest"]     = vManifest;
-        availableVersions.append(entry);
-    }
-    pkg["availableVersions"]    = availableVersions;
-    pkg["selectedVersionIndex"] = 0;
-
-    // Release version comes from the selected version's manifest; root
-    // hash comes from the catalog row's `rootHash` (set per version by
-    // the index builder — authoritative over any hash inside the
-    // manifest itself).
-    const QString releaseVersion = manifest.value("version").toString();
-    const QString releaseHash = selectedVersion.value("rootHash").toString();
-    pkg["version"] = releaseVersion;
-    pkg["hash"] = releaseHash;
-
-    // Cross-reference against the on-disk install state.
-    QString installedVersion;
-    QString installedHash;
-    QString installType;
-    const bool isInstalled = installedByName.contains(moduleName);
-    if (isInstalled) {
-        const QVariantMap& inst = installedByName[moduleName];
-        installedVersion = inst.value("version").toString();
-        installedHash = inst.value("hashes").toMap().value("root").toString();
-        // "embedded" or "user" — QML gates Uninstall on installType === "user".
-        installType = inst.value("installType").toString();
-    }
-    pkg["installedVersion"] = installedVersion;
-    pkg["installedHash"] = installedHash;
-    pkg["installType"] = installType;
-    rowaction::applyPickedSizeAndDate(pkg, 0);
-
-    // Resolve install status. Embedded vs user doesn't change the status itself —
-    // the QML side gates the Uninstall button on installType separately.
-    int status = static_cast<int>(PackageTypes::NotInstalled);
-    if (isInstalled) {
-        if (releaseVersion.isEmpty() || installedVersion.isEmpty()) {
-            // No version info to compare — assume same.
-            status = static_cast<int>(PackageTypes::Installed);
-        } else {
-            const int cmp = versionCmp(installedVersion, releaseVersion);
-            if (cmp < 0)      status = static_cast<int>(PackageTypes::UpgradeAvailable);
-            else if (cmp > 0) status = static_cast<int>(PackageTypes::DowngradeAvailable);
-            else if (!releaseHash.isEmpty() && !installedHash.isEmpty()
-                     && releaseHash != installedHash)
-                              status = static_cast<int>(PackageTypes::DifferentHash);
-            else              status = static_cast<int>(PackageTypes::Installed);
-        }
-    }
-    pkg["installStatus"] = status;
-    pkg["errorMessage"] = QString();
-
-    // Variant availability — true iff any of the package's offered
-    // variants intersects this platform's valid-variants list. Variants
-    // are the keys of the manifest's `main` map (`{variant: entry_path}`).
-    QStringList offeredVariants;
-    {
-        const QVariantMap mainMap = manifest.value("main").toMap();
-        for (auto it = mainMap.constBegin(); it != mainMap.constEnd(); ++it) {
-            const QString s = it.key();
-            if (!s.isEmpty()) offeredVariants.append(s);
-        }
-    }
-    bool variantAvailable = false;
-    for (const QString& s : offeredVariants) {
-        if (validVariants.contains(s)) { variantAvailable = true; break; }
-    }
-    // QML-only ui_qml packages can have an empty `main` map (no backend
-    // plugin); they install on every platform.
-    if (!variantAvailable && offeredVariants.isEmpty()
-        && manifest.value("type").toString() == QLatin1String("ui_qml")) {
-        variantAvailable = true;
-    }
-    pkg["isVariantAvailable"] = variantAvailable;
-    pkg["notAvailableReason"] = static_cast<int>(
-        variantAvailable ? PackageTypes::Available
-                         : classifyNotAvailable(offeredVariants, validVariants));
-
-    // ── Action-column inputs ────────────────────────────────────────
-    // `rowAction` is the per-row primary action, resolved against the
-    // INITIAL selected version (newest, i.e. versions[0]). It will be
-    // recomputed by PackageListModel::setRowVersion() whenever the
-    // user moves the dropdown — same helper, same inputs, fresh values.
-    //
-    // `updateAvailable` is a separate signal that stays put even as the
-    // dropdown moves: it reflects "a strictly-newer-than-installed
-    // version exists in the catalog", and drives the small marker on
-    // the Version cell. Computed once here.
-    pkg["rowAction"] = rowaction::resolveRowAction(
-        isInstalled, variantAvailable, status,
-        installedVersion, installedHash,
-        /*selectedVersion=*/releaseVersion,
-        /*selectedHash=*/releaseHash);
-    pkg["updateAvailable"] = rowaction::hasUpdateAvailable(
-        isInstalled, installedVersion, /*newestCatalogVersion=*/releaseVersion);
-
-    // dependencies may be a flat array of names (legacy) or a list mixing
-    // plain-string and object entries (new manifest schema). The QML side
-    // displays them as a string list; render objects as "name version
-    // [signer=…]" so the user can see the constraint.
-    QStringList deps;
-    QVariantList depsArray = obj.value("dependencies").toList();
-    if (depsArray.isEmpty()) depsArray = manifest.value("dependencies").toList();
-    for (const QVariant& dep : depsArray) {
-        if (dep.canConvert<QVariantMap>() && !dep.toString().size()) {
-            const QVariantMap dm = dep.toMap();
-            QString s = dm.value("name").toString();
-            if (dm.contains("version")) s += QStringLiteral(" ") + dm.value("version").toString();
-            if (dm.contains("signer"))
-                s += QStringLiteral(" [signer=") + dm.value("signer").toString() + QStringLiteral("]");
-            deps.append(s);
-        } else {
-            deps.append(dep.toString());
-        }
-    }
-    pkg["dependencies"] = deps;
-
-    return pkg;
-}
-
-// Build a "Local" row for an installed package that has no catalog entry.
-// Rendered under a synthetic "Local" section that sits below all real repos
-// in the grouped list. No versions/rowAction — the row exists only to show
-// that the module is present on disk; upgrades reappear when a repo publishes
-// it.
-static QVariantMap buildLocalPackageRow(const QVariantMap& installed)
-{
-    QVariantMap pkg;
-    const QString name = installed.value("name").toString();
-    QString moduleName = installed.value("moduleName").toString();
-    if (moduleName.isEmpty()) moduleName = name;
-
-    QString displayName = installed.value("displayName").toString();
-    if (displayName.isEmpty()) displayName = moduleName;
-
-    pkg["name"]        = name;
-    pkg["moduleName"]  = moduleName;
-    pkg["displayName"] = displayName;
-    pkg["description"] = installed.value("description").toString();
-    pkg["type"]        = installed.value("type").toString();
-    // Preserve the module's own category (Networking / Chat / …). "Local" is
-    // a repo-slot label, not a category — the Categories sidebar reflects
-    // real values, not this synthetic bucket.
-    pkg["category"]    = installed.value("category").toString();
-    pkg["size"]        = 0;
-    pkg["dateUpdated"] = QString();
-
-    pkg["repositoryUrl"]         = QString();
-    pkg["repositoryName"]        = QStringLiteral("local");
-    pkg["repositoryDisplayName"] = QStringLiteral("local");
-
-    pkg["availableVersions"]    = QVariantList{};
-    pkg["selectedVersionIndex"] = 0;
-
-    const QString installedVersion = installed.value("version").toString();
-    const QString installedHash    = installed.value("hashes").toMap().value("root").toString();
-    pkg["version"]          = installedVersion;
-    pkg["hash"]             = installedHash;
-    pkg["installedVersion"] = installedVersion;
-    pkg["installedHash"]    = installedHash;
-    pkg["installType"]      = installed.value("installType").toString();
-    pkg["installStatus"]    = static_cast<int>(PackageTypes::Installed);
-    pkg["errorMessage"]     = QString();
-    pkg["isVariantAvailable"]   = true;
-    pkg["notAvailableReason"]   = static_cast<int>(PackageTypes::Available);
-    pkg["rowAction"]        = static_cast<int>(PackageTypes::NoOp);
-    pkg["updateAvailable"]  = false;
-    pkg["dependencies"]     = QStringList{};
-    return pkg;
-}
-
 // ──────────────────── connection-readiness predicates ────────────────────
 
 bool PackageManagerBackend::clientReady(const char* moduleName) const
 {
-    // Guard on the context: modules() is only valid once the generated glue
-    // has wired it (isContextReady()), and `api` is the LogosAPI the glue
-    // built the typed wrappers from — the same one their clients live on.
-    if (!isContextReady()) return false;
-    LogosAPIClient* c = modules().api->getClient(moduleName);
-    return c && c->isConnected();
+    return m_modules->isReady(moduleName);
 }
 
 bool PackageManagerBackend::bothClientsReady() const
@@ -601,9 +427,8 @@ void PackageManagerBackend::refreshCatalog()
     // reported result. (The debounced file-event path deliberately
     // still calls refreshPackages() directly — a local file mutation
     // doesn't warrant a network round-trip.)
-    LogosModules& logos = modules();
     QPointer<PackageManagerBackend> self(this);
-    logos.package_downloader.refreshCatalogAsync([self](QVariantMap r) {
+    m_modules->refreshCatalog([self](QVariantMap r) {
         if (!self) return;
         const QString err = r.value(QStringLiteral("error")).toString();
         if (!err.isEmpty())
@@ -612,6 +437,27 @@ void PackageManagerBackend::refreshCatalog()
     });
 }
 
+void PackageManagerBackend::refreshRepository(QString repositoryUrl)
+{
+    if (!bothClientsReady()) {
+        qDebug() << "package_downloader or package_manager not connected, cannot refresh repository";
+        return;
+    }
+
+    setIsLoading(true);
+    QPointer<PackageManagerBackend> self(this);
+    m_modules->refreshRepository(repositoryUrl, [self, repositoryUrl](QVariantMap r) {
+        if (!self) return;
+        const QString err = r.value(QStringLiteral("error")).toString();
+        if (!err.isEmpty())
+            qWarning() << "package_downloader.refreshRepository" << repositoryUrl
+                       << "reported:" << err;
+        // A full catalog fetch still, but setPackagesFromVariantList
+        // only rebuilds the repositories whose fingerprint moved.
+        self->refreshPackages();
+    });
+}
+
 void PackageManagerBackend::installLocalPackage(QUrl fileUrl)
 {
     if (!fileUrl.isValid() || !fileUrl.isLocalFile()) {
@@ -639,9 +485,8 @@ void PackageManagerBackend::installLocalPackage(QUrl fileUrl)
     // what tells a fresh install apart from an install over an existing copy,
     // which decides WHICH gate to open below.
     const QString fileLabel = fi.fileName();
-    LogosModules& logos = modules();
     QPointer<PackageManagerBackend> self(this);
-    logos.package_manager.inspectPackageAsync(filePath,
+    m_modules->inspectPackage(filePath,
         [self, filePath, fileLabel](QVariantMap info) {
             if (!self) return;
 
@@ -658,50 +503,290 @@ void PackageManagerBackend::installLocalPackage(QUrl fileUrl)
                 return;
             }
 
-            const QString version = info.value(QStringLiteral("version")).toString();
-            const bool alreadyInstalled =
-                info.value(QStringLiteral("isAlreadyInstalled")).toBool();
-
             self->m_pendingLocalInstalls.insert(name, filePath);
-            const QString noDepChanges = QStringLiteral("[]");
-
-            LogosModules& logos = self->modules();
-            if (!alreadyInstalled) {
-                logos.package_manager.requestInstallAsync(name, version, QString(), noDepChanges,
-                    [self, name](QVariantMap result) {
-                        if (!self) return;
-                        if (!result.value(QStringLiteral("success"), false).toBool()) {
-                            self->m_pendingLocalInstalls.remove(name);
-                            emit self->errorOccurred(
-                                static_cast<int>(PackageTypes::InstallationAlreadyInProgress));
-                        }
-                    });
-                return;
+            self->requestLocalInstallGate(
+                name, info.value(QStringLiteral("version")).toString(),
+                info.value(QStringLiteral("isAlreadyInstalled")).toBool(),
+                info.value(QStringLiteral("installedVersion")).toString(),
+                QStringLiteral("[]"));
+        });
+}
+
+void PackageManagerBackend::requestLocalInstallGate(const QString& name,
+                                                    const QString& version,
+                                                    bool alreadyInstalled,
+                                                    const QString& installedVersion,
+                                                    const QString& changesJson)
+{
+    QPointer<PackageManagerBackend> self(this);
+    if (!alreadyInstalled) {
+        m_modules->requestInstall(name, version, QString(), changesJson,
+            [self, name](QVariantMap result) {
+                if (!self) return;
+                if (!result.value(QStringLiteral("success"), false).toBool()) {
+                    self->m_pendingLocalInstalls.remove(name);
+                    self->finishLocalBatchEntry(name, false, QStringLiteral("Install request rejected"));
+                    emit self->errorOccurred(
+                        static_cast<int>(PackageTypes::InstallationAlreadyInProgress));
+                }
+            });
+        return;
+    }
+
+    // mode mirrors the per-row dispatch: 0 upgrade / 1 downgrade /
+    // 2 sidegrade (same version — i.e. a reinstall from disk).
+    const int cmp  = rowaction::versionCmp(version, installedVersion);
+    const int mode = (cmp > 0) ? 0 : (cmp < 0) ? 1 : 2;
+
+    PendingUpgradeMeta meta;
+    meta.repositoryUrl = QString();   // local file — no repo to pin
+    meta.includeDeps   = true;
+    meta.fromVersion   = installedVersion;
+    meta.fromRootHash  = m_installedSnapshot->rootHashFor(name);
+    m_pendingUpgradeByModule.insert(name, meta);
+
+    m_modules->requestUpgrade(name, version, mode, changesJson,
+        [self, name](QVariantMap result) {
+            if (!self) return;
+            if (!result.value(QStringLiteral("success"), false).toBool()) {
+                self->m_pendingLocalInstalls.remove(name);
+                self->m_pendingUpgradeByModule.remove(name);
+                self->finishLocalBatchEntry(name, false, QStringLiteral("Upgrade request rejected"));
+                emit self->errorOccurred(
+                    static_cast<int>(PackageTypes::UninstallFailed));
             }
+        });
+}
 
-            // mode mirrors the per-row dispatch: 0 upgrade / 1 downgrade /
-            // 2 sidegrade (same version — i.e. a reinstall from disk).
-            const QString installedVersion =
-                info.value(QStringLiteral("installedVersion")).toString();
-            const int cmp  = rowaction::versionCmp(version, installedVersion);
-            const int mode = (cmp > 0) ? 0 : (cmp < 0) ? 1 : 2;
+// Manifest dependency names from an inspectPackage reply: entries are
+// either bare names or { name, version } maps, as in the catalog.
+static QStringList manifestDependencyNames(const QVariantMap& info)
+{
+    QVariant deps = info.value(QStringLiteral("dependencies"));
+    if (!deps.isValid())
+        deps = info.value(QStringLiteral("manifest")).toMap().value(QStringLiteral("dependencies"));
+    QStringList names;
+    for (const QVariant& d : deps.toList()) {
+        const QString n = d.typeId() == QMetaType::QString
+            ? d.toString() : d.toMap().value(QStringLiteral("name")).toString();
+        if (!n.isEmpty()) names.append(n);
+    }
+    return names;
+}
 
-            PendingUpgradeMeta meta;
-            meta.repositoryUrl = QString();   // local file — no repo to pin
-            meta.includeDeps   = true;
-            self->m_pendingUpgradeByModule.insert(name, meta);
+void PackageManagerBackend::installLocalPackages(QVariantList fileUrls)
+{
+    if (!packageManagerReady()) {
+        emit errorOccurred(static_cast<int>(PackageTypes::PackageManagerNotConnected));
+        return;
+    }
+    if (m_localBatch.active() || isInstalling()) {
+        emit errorOccurred(static_cast<int>(PackageTypes::InstallationAlreadyInProgress));
+        return;
+    }
 
-            logos.package_manager.requestUpgradeAsync(name, version, mode, noDepChanges,
-                [self, name](QVariantMap result) {
-                    if (!self) return;
-                    if (!result.value(QStringLiteral("success"), false).toBool()) {
-                        self->m_pendingLocalInstalls.remove(name);
-                        self->m_pendingUpgradeByModule.remove(name);
-                        emit self->errorOccurred(
-                            static_cast<int>(PackageTypes::UninstallFailed));
-                    }
-                });
+    // Files as given; directories contribute every .lgx beneath them.
+    QStringList files;
+    for (const QVariant& v : fileUrls) {
+        const QUrl url = v.toUrl().isValid() ? v.toUrl() : QUrl(v.toString());
+        if (!url.isLocalFile()) continue;
+        const QFileInfo fi(url.toLocalFile());
+        if (fi.isDir()) {
+            QDirIterator it(fi.absoluteFilePath(), {QStringLiteral("*.lgx")},
+                            QDir::Files, QDirIterator::Subdirectories);
+            QStringList found;
+            while (it.hasNext()) found.append(it.next());
+            found.sort();
+            files.append(found);
+        } else if (fi.isFile()
+                   && fi.suffix().compare(QStringLiteral("lgx"), Qt::CaseInsensitive) == 0) {
+            files.append(fi.absoluteFilePath());
+        }
+    }
+    files.removeDuplicates();
+    if (files.isEmpty()) {
+        qWarning() << "installLocalPackages: no .lgx files in" << fileUrls;
+        emit errorOccurred(static_cast<int>(PackageTypes::LocalPackageInvalid));
+        return;
+    }
+    if (files.size() == 1) {
+        installLocalPackage(QUrl::fromLocalFile(files.first()));
+        return;
+    }
+
+    // Inspect every file at once — each is an independent round trip —
+    // and plan when the last reply lands.
+    m_localBatch.reset(++m_localBatchGeneration, files);
+    setIsInstalling(true);
+    emit installationProgressUpdated(
+        static_cast<int>(PackageTypes::Started), QString(), 0, files.size(), true,
+        QStringLiteral("Inspecting %1 local packages…").arg(files.size()));
+
+    QPointer<PackageManagerBackend> self(this);
+    const int generation = m_localBatch.generation();
+    for (const QString& file : std::as_const(files)) {
+        m_modules->inspectPackage(file,
+            [self, file, generation](QVariantMap info) {
+                if (!self || self->m_localBatch.generation() != generation) return;
+                self->onLocalBatchInspected(file, info);
+            });
+    }
+}
+
+void PackageManagerBackend::onLocalBatchInspected(const QString& file, const QVariantMap& info)
+{
+    const QString err  = info.value(QStringLiteral("error")).toString();
+    const QString name = info.value(QStringLiteral("name")).toString();
+    bool last = false;
+    if (!err.isEmpty() || name.isEmpty()) {
+        const QString label = QFileInfo(file).fileName();
+        const QString msg = !err.isEmpty()
+            ? err : QStringLiteral("Could not read a package name from %1").arg(label);
+        qWarning() << "installLocalPackages: inspect failed for" << file << ":" << msg;
+        emit installationProgressUpdated(
+            static_cast<int>(PackageTypes::ProgressFailed), label, 0, 0, false, msg);
+        last = m_localBatch.inspected(nullptr);
+    } else {
+        LocalInstallBatch::Entry e;
+        e.file             = file;
+        e.name             = name;
+        e.version          = info.value(QStringLiteral("version")).toString();
+        e.alreadyInstalled = info.value(QStringLiteral("isAlreadyInstalled")).toBool();
+        e.installedVersion = info.value(QStringLiteral("installedVersion")).toString();
+        e.deps             = manifestDependencyNames(info);
+        last = m_localBatch.inspected(&e);
+    }
+    if (last) planLocalBatch();
+}
+
+void PackageManagerBackend::planLocalBatch()
+{
+    LocalInstallBatch& b = m_localBatch;
+    b.plan();
+    if (b.order().isEmpty()) {
+        // Nothing readable: close the Started event rather than leave
+        // the batch hanging open.
+        b.reset(0, {});
+        setIsInstalling(false);
+        emit installationProgressUpdated(
+            static_cast<int>(PackageTypes::Completed), QString(), 0, 0, false,
+            QStringLiteral("None of the selected files could be read as a package"));
+        return;
+    }
+
+    // package_manager's gate is per module, so every entry gets its own
+    // host dialog, and each dialog lists that entry's change plus the
+    // in-batch dependencies it waits for (transitively) — declining one
+    // dialog must not leave another approving changes it never showed.
+    QHash<QString, QJsonObject> changeByName;
+    for (const QString& n : b.order()) {
+        const LocalInstallBatch::Entry& e = *b.entry(n);
+        const int cmp = e.alreadyInstalled ? rowaction::versionCmp(e.version, e.installedVersion) : 1;
+        changeByName.insert(n, QJsonObject{
+            {QStringLiteral("name"),        n},
+            {QStringLiteral("fromVersion"), e.alreadyInstalled ? e.installedVersion : QString()},
+            {QStringLiteral("toVersion"),   e.version},
+            {QStringLiteral("repository"),  QFileInfo(e.file).fileName()},
+            {QStringLiteral("action"),      !e.alreadyInstalled ? QStringLiteral("install")
+                                            : cmp > 0 ? QStringLiteral("upgrade")
+                                            : cmp < 0 ? QStringLiteral("downgrade")
+                                                      : QStringLiteral("reinstall")},
+        });
+    }
+
+    for (const QString& n : b.order()) {
+        QJsonArray changes;
+        for (const QString& m : b.waitsForClosure(n)) changes.append(changeByName.value(m));
+
+        const LocalInstallBatch::Entry& e = *b.entry(n);
+        m_pendingLocalInstalls.insert(e.name, e.file);
+        requestLocalInstallGate(e.name, e.version, e.alreadyInstalled, e.installedVersion,
+                                QString::fromUtf8(QJsonDocument(changes).toJson(QJsonDocument::Compact)));
+    }
+}
+
+bool PackageManagerBackend::approveLocalBatchEntry(const QString& name)
+{
+    if (!m_localBatch.contains(name)) return false;
+    if (!m_localBatch.approve(name)) {
+        // Skipped after a dependency failed; the host's approval came in
+        // anyway. Nothing to install — just close the batch if this was
+        // the last gate outstanding.
+        m_pendingLocalInstalls.remove(name);
+        m_pendingUpgradeByModule.remove(name);
+        qWarning() << "installLocalPackages: not installing" << name
+                   << "— an in-batch dependency failed";
+        if (m_localBatch.isDone()) closeLocalBatch();
+        return true;
+    }
+    m_packageModel->updatePackageInstallation(name, static_cast<int>(PackageTypes::Installing));
+    pumpLocalBatch();
+    return true;
+}
+
+void PackageManagerBackend::pumpLocalBatch()
+{
+    // Everything approved whose in-batch dependencies have installed
+    // goes out at once, up to kMaxParallelLocalInstalls.
+    const QStringList ready = m_localBatch.takeReady(kMaxParallelLocalInstalls);
+    for (const QString& next : ready) {
+        m_pendingUpgradeByModule.remove(next);
+        const QVariantMap entry{
+            {QStringLiteral("name"), next},
+            {QStringLiteral("path"), m_pendingLocalInstalls.take(next)},
+        };
+        QPointer<PackageManagerBackend> self(this);
+        const int generation = m_localBatch.generation();
+        installOnePackage(entry, [self, next, generation](bool success, const QString& err) {
+            if (!self || self->m_localBatch.generation() != generation) return;
+            self->finishLocalBatchEntry(next, success, err);
         });
+    }
+}
+
+void PackageManagerBackend::finishLocalBatchEntry(const QString& name, bool success,
+                                                  const QString& error)
+{
+    LocalInstallBatch& b = m_localBatch;
+    if (!b.contains(name)) return;
+    const bool wasSettled = b.isSettled(name);
+    const QStringList skipped = b.settle(name, success);
+    if (!wasSettled) {
+        m_packageModel->updatePackageInstallation(
+            name, success ? static_cast<int>(PackageTypes::Installed)
+                          : static_cast<int>(PackageTypes::Failed),
+            success ? QString() : error);
+        emit installationProgressUpdated(
+            static_cast<int>(success ? PackageTypes::InProgress : PackageTypes::ProgressFailed),
+            name, b.settledCount() - skipped.size(), b.order().size(), success,
+            success ? QString() : error);
+    }
+
+    // Dependents of a failed entry aren't installed against a missing
+    // dependency; each is reported on its own row.
+    for (const QString& dependent : skipped) {
+        const QString why = QStringLiteral("Not installed: depends on %1, which failed").arg(name);
+        m_packageModel->updatePackageInstallation(
+            dependent, static_cast<int>(PackageTypes::Failed), why);
+        emit installationProgressUpdated(
+            static_cast<int>(PackageTypes::ProgressFailed),
+            dependent, b.settledCount(), b.order().size(), false, why);
+    }
+
+    if (b.isDone()) {
+        closeLocalBatch();
+        return;
+    }
+    pumpLocalBatch();
+}
+
+void PackageManagerBackend::closeLocalBatch()
+{
+    const int total = m_localBatch.order().size();
+    m_localBatch.reset(0, {});
+    setIsInstalling(false);
+    emit installationProgressUpdated(
+        static_cast<int>(PackageTypes::Completed), QString(), total, total, true, QString());
 }
 
 void PackageManagerBackend::refreshPackages()
@@ -714,64 +799,169 @@ void PackageManagerBackend::refreshPackages()
 
     ++m_reloadGeneration;
     const int currentGeneration = m_reloadGeneration;
+    const qint64 refreshBegan = m_perf->begin();
     setIsLoading(true);
 
     // One round-trip for the catalog (union across every enabled
     // repository); category list is derived from it client-side so
     // subsequent category clicks only update the proxy filter — no
     // network round-trip and no model rebuild.
-    LogosModules& logos = modules();
     QPointer<PackageManagerBackend> self(this);
-    logos.package_downloader.getCatalogAsync([self, currentGeneration](QVariantList packagesArray) {
+    m_modules->getCatalog([self, currentGeneration, refreshBegan](QVariantList packagesArray) {
         if (!self || self->m_reloadGeneration != currentGeneration) return;
 
-        // Derive categories from the catalog: "All" + sorted distinct
-        // (capitalised) values of each package's `category` field.
-        QStringList categoryList;
-        categoryList << QStringLiteral("All");
-        QStringList seen;
-        for (const QVariant& v : packagesArray) {
-            QString c = v.toMap().value(QStringLiteral("category")).toString();
-            if (c.isEmpty()) continue;
-            c[0] = c[0].toUpper();
-            if (!seen.contains(c)) seen.append(c);
-        }
-        std::sort(seen.begin(), seen.end());
-        categoryList.append(seen);
-        self->setCategories(categoryList);
+        self->recomputeCategories(packagesArray);
 
-        LogosModules& logos2 = self->modules();
-        logos2.package_manager.getInstalledPackagesAsync([self, currentGeneration, packagesArray](QVariantList installedPackages) {
+        self->m_modules->getInstalledPackages([self, currentGeneration, refreshBegan, packagesArray](QVariantList installedPackages) {
             if (!self || self->m_reloadGeneration != currentGeneration) return;
 
-            LogosModules& logos3 = self->modules();
-            logos3.package_manager.getValidVariantsAsync([self, currentGeneration, packagesArray, installedPackages](QVariant result) {
+            self->m_modules->getValidVariants([self, currentGeneration, refreshBegan, packagesArray, installedPackages](QVariant result) {
                 if (!self || self->m_reloadGeneration != currentGeneration) return;
                 QStringList validVariants = result.toStringList();
-                self->m_allPackagesCache = packagesArray;
+                if (self->m_internCatalog) {
+                    const auto t = self->m_perf->scope("catalog.intern");
+                    self->m_allPackagesCache = self->m_interner.intern(packagesArray);
+                } else {
+                    self->m_allPackagesCache = packagesArray;
+                }
+                ++self->m_catalogGeneration;
+                self->m_resolveCache.clear();
                 self->m_installedPackagesCache = installedPackages;
+                self->m_depGraph.build(self->m_allPackagesCache, installedPackages);
+                self->m_localResolver.setCatalog(self->m_allPackagesCache);
+                self->setInstalledSnapshot(InstalledSnapshot::build(installedPackages));
+                self->rebuildRepoUrlToNameIndex();
                 self->m_validVariantsCache = validVariants;
                 self->setPackagesFromVariantList(self->m_allPackagesCache,
                                                  self->m_installedPackagesCache,
                                                  self->m_validVariantsCache);
                 self->recomputeAvailableTypes();
                 self->applyCategoryFilter();
+                self->pruneInterner();
+                // Interrupted transactions are resolved once, against the
+                // first installed set we see after startup.
+                if (!self->m_installJournalRecovered) {
+                    self->m_installJournalRecovered = true;
+                    self->recoverInstallJournal();
+                }
 
-                LogosModules& logos4 = self->modules();
-                logos4.package_downloader.listRepositoriesAsync(
-                    [self, currentGeneration](QVariantList repos) {
+                self->m_modules->listRepositories(
+                    [self, currentGeneration, refreshBegan](QVariantList repos) {
                         if (!self || self->m_reloadGeneration != currentGeneration) return;
                         self->setRepositoryCount(repos.size());
                         self->setIsLoading(false);
+                        self->m_perf->end("refresh.total", refreshBegan);
                     });
             });
         });
     });
 }
 
+void PackageManagerBackend::pullCatalogDelta()
+{
+    if (!bothClientsReady()) return;
+
+    // A full refresh already queued (a package_manager event burst)
+    // fetches after this announcement too, so it covers the delta.
+    if (m_refreshDebounceTimer->isActive()) {
+        m_catalogDeltaGeneration = m_catalogAnnouncedGeneration;
+        return;
+    }
+
+    const qint64 since = m_catalogDeltaGeneration;
+    if (since >= 0 && m_catalogAnnouncedGeneration - since > kMaxCatalogDeltaGap) {
+        // Too far behind for a delta to be worth it. The full fetch
+        // starts after the announcement, so it covers that generation.
+        m_catalogDeltaGeneration = m_catalogAnnouncedGeneration;
+        m_refreshDebounceTimer->start();
+        return;
+    }
+
+    const int reloadGeneration = m_reloadGeneration;
+    QPointer<PackageManagerBackend> self(this);
+    m_modules->getCatalogDelta(since, [self, since, reloadGeneration](QVariantMap delta) {
+        if (!self) return;
+        const qint64 generation = delta.value(QStringLiteral("generation"), -1).toLongLong();
+        const bool full = since < 0 || generation < since
+                       || delta.value(QStringLiteral("full")).toBool()
+                       || delta.contains(QStringLiteral("error"));
+        // "full" with no generation: the module doesn't version its
+        // catalog, so no later pull can do better.
+        if (generation < 0 && delta.value(QStringLiteral("full")).toBool())
+            self->m_catalogDeltaSupported = false;
+        self->m_catalogDeltaGeneration = generation;
+        // A refresh started meanwhile replaces the cache this delta
+        // would patch; fetch again rather than apply to a moving target.
+        // Through the debounce, so it folds into any refresh that
+        // package_manager events have queued meanwhile.
+        if (full || self->m_reloadGeneration != reloadGeneration) {
+            self->m_refreshDebounceTimer->start();
+            return;
+        }
+        self->applyCatalogDelta(delta);
+    });
+}
+
+void PackageManagerBackend::applyCatalogDelta(const QVariantMap& delta)
+{
+    if (catalogdelta::size(delta) == 0) return;
+    const auto t = m_perf->scope("catalog.delta");
+
+    // The catalog half of refreshPackages' adopt step; the installed set
+    // and variants are unchanged, so only repositories the delta touches
+    // are rebuilt (m_rowCache) and the model gets a ranged update.
+    QVariantMap interned = delta;
+    if (m_internCatalog) {
+        for (const char* key : {"added", "changed"})
+            interned[QLatin1String(key)] =
+                m_interner.intern(delta.value(QLatin1String(key)).toList());
+    }
+    m_allPackagesCache = catalogdelta::apply(m_allPackagesCache, interned);
+    ++m_catalogGeneration;
+    m_resolveCache.clear();
+    // Only the packages the delta names get new nodes / candidates.
+    const QSet<QString> touched = catalogdelta::names(delta);
+    if (!m_depGraph.update(m_allPackagesCache, m_installedPackagesCache, touched))
+        m_depGraph.build(m_allPackagesCache, m_installedPackagesCache);
+    setInstalledSnapshot(m_installedSnapshot);
+    m_localResolver.updateNames(m_allPackagesCache, touched);
+    rebuildRepoUrlToNameIndex();
+    recomputeCategories(m_allPackagesCache);
+    setPackagesFromVariantList(m_allPackagesCache, m_installedPackagesCache,
+                               m_validVariantsCache);
+    recomputeAvailableTypes();
+    applyCategoryFilter();
+    pruneInterner();
+}
+
+void PackageManagerBackend::pruneInterner()
+{
+    if (!m_internCatalog) return;
+    m_interner.prune();
+}
+
+void PackageManagerBackend::recomputeCategories(const QVariantList& packagesArray)
+{
+    // Derive categories from the catalog: "All" + sorted distinct
+    // (capitalised) values of each package's `category` field.
+    QStringList categoryList;
+    categoryList << QStringLiteral("All");
+    QStringList seen;
+    for (const QVariant& v : packagesArray) {
+        QString c = v.toMap().value(QStringLiteral("category")).toString();
+        if (c.isEmpty()) continue;
+        c[0] = c[0].toUpper();
+        if (!seen.contains(c)) seen.append(c);
+    }
+    std::sort(seen.begin(), seen.end());
+    categoryList.append(seen);
+    setCategories(categoryList);
+}
+
 void PackageManagerBackend::applyCategoryFilter()
 {
     if (!m_packagesFilterProxy) return;
+    const auto t = m_perf->scope("filter.category");
     const QString selected =
         categories().value(selectedCategoryIndex(), QStringLiteral("All"));
     QString categoryFilter;
@@ -831,6 +1021,7 @@ void PackageManagerBackend::recomputeAvailableTypes()
 void PackageManagerBackend::applyTypeFilter()
 {
     if (!m_packagesFilterProxy) return;
+    const auto t = m_perf->scope("filter.type");
     const QStringList types = availableTypes();
     const int idx = selectedTypeIndex();
     QString typeFilter;
@@ -850,99 +1041,32 @@ void PackageManagerBackend::setPackagesFromVariantList(const QVariantList& packa
                                                         const QVariantList& installedPackages,
                                                         const QStringList& validVariants)
 {
-    // Index installed packages by moduleName for O(1) lookup in buildPackageRow.
-    QHash<QString, QVariantMap> installedByName;
-    for (const QVariant& val : installedPackages) {
-        const QVariantMap obj = val.toMap();
-        const QString installedName = obj.value("name").toString();
-        if (!installedName.isEmpty()) installedByName.insert(installedName, obj);
-    }
-
-    QList<QVariantMap> packages;
-    packages.reserve(packagesArray.size() + installedPackages.size());
-    QSet<QString> catalogModuleNames;
-    catalogModuleNames.reserve(packagesArray.size());
-    for (const QVariant& value : packagesArray) {
-        const QVariantMap row = buildPackageRow(value.toMap(), installedByName, validVariants);
-        catalogModuleNames.insert(row.value("moduleName").toString());
-        packages.append(row);
-    }
-
-    // Any USER-installed package the catalog doesn't publish gets a
-    // synthetic "Local"-repo row so it still shows up in the grouped list.
-    // Embedded packages ship inside the app bundle — they're already
-    // discoverable through the built-in module surface, so listing them
-    // under Local would double-count and mislead.
-    for (const QVariant& val : installedPackages) {
-        const QVariantMap inst = val.toMap();
-        const QString name = inst.value("name").toString();
-        if (name.isEmpty()) continue;
-        if (inst.value("installType").toString() != QLatin1String("user")) continue;
-        QString moduleName = inst.value("moduleName").toString();
-        if (moduleName.isEmpty()) moduleName = name;
-        if (catalogModuleNames.contains(moduleName)) continue;
-        packages.append(buildLocalPackageRow(inst));
-    }
-
-    // Group rows by source: the hardcoded default repository always
-    // comes first (priority 0), then any user-added repos sorted by
-    // their canonical name (priority 1), and the synthetic "local"
-    // bucket last (priority 2). Within each source rows sort by
-    // package name. The QML uses `isFirstOfSource` (tagged below) to
-    // draw a section header above the first row of each group instead
-    // of a per-row Source column.
-    //
-    // Default-repo identification is by `repositoryName` matching the
-    // canonical "logos-modules-official" string baked into logos-repo.json
-    // — avoids pulling in package_downloader_lib.h just for the URL
-    // constant. If the canonical name ever moves, the constant in the
-    // lib AND this match string need to update together.
-    auto sourcePriority = [](const QVariantMap& row) -> int {
-        const QString n = row.value("repositoryName").toString();
-        if (n == QLatin1String("logos-modules-official")) return 0;
-        if (n == QLatin1String("local")) return 2;
-        return 1;
-    };
-    auto sourceKey = [](const QVariantMap& row) -> QString {
-        // Use displayName when present (human label like "Logos Official"),
-        // canonical name otherwise, falling back to URL so two unresolved
-        // repos still sort stably.
-        const QString dn = row.value("repositoryDisplayName").toString();
-        if (!dn.isEmpty()) return dn;
-        const QString n = row.value("repositoryName").toString();
-        if (!n.isEmpty()) return n;
-        return row.value("repositoryUrl").toString();
-    };
-    std::stable_sort(packages.begin(), packages.end(),
-        [&](const QVariantMap& a, const QVariantMap& b) {
-            const int pa = sourcePriority(a);
-            const int pb = sourcePriority(b);
-            if (pa != pb) return pa < pb;
-            const QString ka = sourceKey(a);
-            const QString kb = sourceKey(b);
-            const int c = ka.compare(kb, Qt::CaseInsensitive);
-            if (c != 0) return c < 0;
-            return a.value("name").toString().compare(
-                b.value("name").toString(), Qt::CaseInsensitive) < 0;
-        });
-
-    // Tag each row's `isFirstOfSource` — true when the row's
-    // (priority, sourceKey) tuple differs from the previous row's.
-    // The QML rowDelegate reads this to render a section header.
-    int prevPriority = -1;
-    QString prevKey;
-    for (QVariantMap& row : packages) {
-        const int p = sourcePriority(row);
-        const QString k = sourceKey(row);
-        row["isFirstOfSource"] = (p != prevPriority) || (k != prevKey);
-        prevPriority = p;
-        prevKey = k;
-    }
-
     // setPackages emits hasSelectionChanged; the connected slot
     // (refreshActionSummary) rebuilds the bulk action plan and pushes
     // `runnableActionCount` + `actionSummary` to the .rep PROPs.
-    m_packageModel->setPackages(packages);
+    QList<QVariantMap> rows;
+    {
+        const auto t = m_perf->scope("rows.build");
+        rows = packagerows::buildPackageRows(packagesArray, installedPackages, validVariants,
+                                             m_collapsedRepoUrls, &m_rowCache);
+    }
+    // The section labels the collapsed repositories currently show under.
+    QStringList collapsedSections;
+    if (!m_collapsedRepoUrls.isEmpty()) {
+        for (const QVariantMap& row : std::as_const(rows)) {
+            if (!row.value("isGroupPlaceholder").toBool()) continue;
+            const QString section = row.value("repositoryDisplayName").toString();
+            if (!collapsedSections.contains(section)) collapsedSections.append(section);
+        }
+        collapsedSections.sort();
+    }
+    setCollapsedSources(collapsedSections);
+    const auto t = m_perf->scope("model.setPackages");
+    m_packageModel->setPackages(rows);
+    if (m_firstRowsBegan >= 0 && !rows.isEmpty()) {
+        m_perf->end("startup.firstRows", m_firstRowsBegan);
+        m_firstRowsBegan = -1;
+    }
 }
 
 void PackageManagerBackend::processDownloadResults(const QVariantList& results)
@@ -973,7 +1097,6 @@ void PackageManagerBackend::installOnePackage(const QVariantMap& dl,
     }
 
     qDebug() << "Download complete for" << packageName << "at" << filePath << "— installing...";
-    LogosModules& logos = modules();
     QPointer<PackageManagerBackend> self(this);
     // Installing was left on the default 20 s IPC deadline while DOWNLOADING
     // gets five minutes -- backwards. Downloading is network-bound and can be
@@ -983,23 +1106,18 @@ void PackageManagerBackend::installOnePackage(const QVariantMap& dl,
     // still install and only the reply is abandoned, so the user is told the
     // install failed when it did not.
     constexpr int kInstallIpcDeadlineMs = 5 * 60 * 1000;
-    // `installPluginAsyncResult`, not `installPluginAsync`: the plain async
-    // wrapper hands the callback a bare QVariantMap, so a transport failure is
-    // indistinguishable from a provider that legitimately returned an empty
-    // one. AsyncResult<T> carries the value and the error together.
-    logos.package_manager.installPluginAsyncResult(filePath, false,
-        [self, packageName, onDone](logos::AsyncResult<QVariantMap> r) {
+    m_modules->installPlugin(filePath,
+        [self, packageName, dl, onDone](ModuleGateway::InstallReply r) {
             if (!self) return;
             // Transport-level failure FIRST. On a timeout `value` is
             // default-constructed, so reading it as an install verdict is the
             // exact mistake this channel removes -- and the honest thing to
             // tell the user is that the deadline expired, not that the install
             // failed: blowing it cancels nothing that was already underway.
-            if (!r.ok()) {
+            if (!r.ok) {
                 qWarning() << "installPlugin failed for" << packageName << ":"
-                           << QString::fromStdString(r.error.code)
-                           << QString::fromStdString(r.error.message);
-                const QString detail = QString::fromStdString(r.error.message);
+                           << r.errorCode << r.errorMessage;
+                const QString detail = r.errorMessage;
                 if (onDone) onDone(false,
                     QStringLiteral("%1 — the package may in fact be installed; check before retrying")
                         .arg(detail.isEmpty()
@@ -1017,17 +1135,28 @@ void PackageManagerBackend::installOnePackage(const QVariantMap& dl,
             // `contains("path")` is still required so that a malformed reply
             // does not read as success: every real installPlugin reply carries
             // the key, even when its value is empty. (A DROPPED reply no longer
-            // reaches here at all — r.ok() catches it above.)
+            // reaches here at all — r.ok catches it above.)
             bool success = installResult.contains("path")
                         && !installResult.contains("error");
             QString err = installResult.value("error").toString();
+            if (success) {
+                // Patch the installed snapshot so the next resolve sees this
+                // version without waiting for the post-install refresh. The
+                // snapshot is keyed by moduleName, which the download result
+                // doesn't carry; the graph maps the catalog name to it.
+                const QString version = dl.value("version").toString();
+                if (!version.isEmpty())
+                    self->setInstalledSnapshot(self->m_installedSnapshot->withInstalled(
+                        self->m_depGraph.moduleName(packageName), version,
+                        dl.value("rootHash").toString()));
+            }
             if (onDone) onDone(success, success
                                            ? QString()
                                            : (err.isEmpty()
                                                   ? QStringLiteral("Installation failed")
                                                   : err));
         },
-        Timeout(kInstallIpcDeadlineMs));
+        kInstallIpcDeadlineMs);
 }
 
 void PackageManagerBackend::installNextPackage(const QVariantList& results, int index, int completed, int totalPackages)
@@ -1102,10 +1231,11 @@ void PackageManagerBackend::runSelectedActions()
     //      (single dependency-resolving download, sequential install
     //      under the global isInstalling flag — same path the old
     //      bulk Install button used).
-    //   2. Upgrade / Downgrade / Reinstall rows → per-row
-    //      `requestVersionChange` calls (each pins the row's currently
-    //      selected version + the matching UpgradeMode). These run
-    //      independently of `isInstalling`, matching how the per-row
+    //   2. Upgrade / Downgrade / Reinstall rows → one batched dep
+    //      preview (runBatchedDepPreview): a single resolveDependencies
+    //      call over every row's pinned (repo, version), one merged
+    //      change list, then the per-module package_manager gate. These
+    //      run independently of `isInstalling`, matching how the per-row
     //      action button works today.
     //
     // Uninstall is intentionally NEVER in the plan: destructive actions
@@ -1123,9 +1253,69 @@ void PackageManagerBackend::runSelectedActions()
     if (!plan.installSpecs.isEmpty()) {
         installSpecs(plan.installSpecs);
     }
+    // Snapshot each version-change row NOW — the resolver round-trip
+    // below can straddle a debounced refresh, and model row indices
+    // don't survive one.
+    QList<PendingDepConfirm> batch;
+    batch.reserve(plan.versionChanges.size());
     for (const auto& vc : plan.versionChanges) {
-        requestVersionChange(vc.first, static_cast<UpgradeMode>(vc.second));
+        const QVariantMap pkg = m_packageModel->packageAt(vc.first);
+        PendingDepConfirm p;
+        p.name          = pkg.value("name").toString();
+        p.moduleName    = pkg.value("moduleName").toString();
+        p.repositoryUrl = pkg.value("repositoryUrl").toString();
+        p.version       = pkg.value("version").toString();
+        p.action        = actionKindForMode(static_cast<UpgradeMode>(vc.second));
+        if (p.moduleName.isEmpty()) continue;
+        batch.append(p);
+    }
+    runBatchedDepPreview(batch);
+}
+
+void PackageManagerBackend::upgradeAll()
+{
+    if (!bothClientsReady()) {
+        emit errorOccurred(static_cast<int>(PackageTypes::PackageManagerNotConnected));
+        return;
+    }
+
+    const UpgradePlanner::Plan plan = [this] {
+        const auto t = m_perf->scope("planner.upgradeAll");
+        return UpgradePlanner::plan(m_localResolver, *m_installedSnapshot);
+    }();
+
+    if (!plan.conflicts.isEmpty()) {
+        QVariantList conflicts;
+        conflicts.reserve(plan.conflicts.size());
+        for (const UpgradePlanner::Conflict& c : plan.conflicts) {
+            conflicts.append(QVariantMap{
+                {QStringLiteral("name"),             c.name},
+                {QStringLiteral("moduleName"),       c.moduleName},
+                {QStringLiteral("installedVersion"), c.installedVersion},
+                {QStringLiteral("newestVersion"),    c.newestVersion},
+                {QStringLiteral("plannedVersion"),   c.plannedVersion},
+                {QStringLiteral("blockedBy"),        c.blockedBy},
+                {QStringLiteral("reason"),           c.reason},
+            });
+        }
+        emit upgradePlanConflicts(conflicts);
+    }
+    if (plan.upgrades.isEmpty()) return;
+
+    // Same dispatch as the bulk version-change rows: one merged preview,
+    // then package_manager's per-module upgrade gate.
+    QList<PendingDepConfirm> batch;
+    batch.reserve(plan.upgrades.size());
+    for (const UpgradePlanner::Item& item : plan.upgrades) {
+        PendingDepConfirm p;
+        p.name          = item.name;
+        p.moduleName    = item.moduleName;
+        p.repositoryUrl = item.repositoryUrl;
+        p.version       = item.toVersion;
+        p.action        = PendingDepConfirm::Upgrade;
+        batch.append(p);
     }
+    runBatchedDepPreview(batch);
 }
 
 void PackageManagerBackend::installPackage(int index)
@@ -1190,11 +1380,9 @@ void PackageManagerBackend::installSinglePackageAsync(const QString& packageName
     // restricted to a safe charset), but repo URLs are user-provided.
     PackageInstallSpec spec; spec.name = packageName;
     spec.repositoryUrl = repoUrl; spec.version = version;
-    const QString depsJson = buildDepsJson({spec});
-    LogosModules& logos = modules();
     QPointer<PackageManagerBackend> self(this);
-    logos.package_downloader.downloadResolvedDependenciesAsync(depsJson, buildInstalledPackagesJson(),
-        [self, packageName, includeDeps](QVariantList results) {
+    downloadResolved({spec},
+        [self, packageName, includeDeps](const QVariantList& results) {
             if (!self) return;
             // Filter to top-level entries when the caller asked for
             // "just the package". The resolver may still have
@@ -1228,12 +1416,13 @@ void PackageManagerBackend::installSinglePackageAsync(const QString& packageName
             // hang in Installing.
             self->markEntriesInstalling(toInstall);
             self->installResultsSequential(toInstall, packageName, 0);
-        }, Timeout(DOWNLOAD_TIMEOUT_MS));
+        });
 }
 
 void PackageManagerBackend::installResultsSequential(const QVariantList& results,
                                                      const QString& topLevelName,
-                                                     int index)
+                                                     int index,
+                                                     const QString& txn)
 {
     // Per-row install pipeline counterpart to installNextPackage. The
     // bulk path locks isInstalling and emits Completed at the end via
@@ -1243,12 +1432,19 @@ void PackageManagerBackend::installResultsSequential(const QVariantList& results
     // the one being acted on, even when the loop is iterating
     // transitive deps in between.
     if (index >= results.size()) return;
+    // Every chain runs inside a journal transaction — see
+    // beginInstallTransaction. Callers that know what the upgrade gate
+    // already removed open it themselves; everyone else gets one here.
+    const QString txnId = (index == 0 && txn.isEmpty())
+        ? beginInstallTransaction(results) : txn;
     const QVariantMap dl = results[index].toMap();
     const QString depName = dl.value("name").toString();
     QPointer<PackageManagerBackend> self(this);
     installOnePackage(dl,
-        [self, results, topLevelName, depName, index](bool success, const QString& err) {
+        [self, results, topLevelName, depName, index, txnId](bool success, const QString& err) {
             if (!self) return;
+            self->m_installJournal.setState(txnId, depName,
+                success ? InstallJournal::Step::Applied : InstallJournal::Step::Failed);
             if (success) {
                 self->m_packageModel->updatePackageInstallation(
                     depName, static_cast<int>(PackageTypes::Installed));
@@ -1277,44 +1473,332 @@ void PackageManagerBackend::installResultsSequential(const QVariantList& results
                         : static_cast<int>(PackageTypes::ProgressFailed),
                 topLevelName, index + 1, results.size(), success,
                 success ? QString() : err);
-            if (success && !isLast)
-                self->installResultsSequential(results, topLevelName, index + 1);
+            if (!success)
+                self->rollbackInstallTransaction(txnId, topLevelName);
+            else if (isLast)
+                self->m_installJournal.finish(txnId);
+            else
+                self->installResultsSequential(results, topLevelName, index + 1, txnId);
         });
 }
 
-void PackageManagerBackend::markEntriesInstalling(const QVariantList& entries)
+QHash<QString, InstallJournal::Step> PackageManagerBackend::removedPriorFor(
+    const QString& name, const QString& moduleName, const PendingUpgradeMeta& meta)
 {
-    if (!m_packageModel) return;
-    for (const QVariant& v : entries) {
+    if (meta.fromVersion.isEmpty()) return {};
+    InstallJournal::Step prior;
+    prior.name         = name;
+    prior.moduleName   = moduleName;
+    prior.fromVersion  = meta.fromVersion;
+    prior.fromRootHash = meta.fromRootHash;
+    prior.priorRemoved = true;
+    return {{name, prior}};
+}
+
+QString PackageManagerBackend::beginInstallTransaction(
+    const QVariantList& results, const QHash<QString, InstallJournal::Step>& removedPriors)
+{
+    QList<InstallJournal::Step> steps;
+    steps.reserve(results.size());
+    for (const QVariant& v : results) {
         const QVariantMap m = v.toMap();
-        // Error rows have no install to run — skip; the per-entry
-        // failure surface will pick them up via the install loop's
-        // own Failed update. Marking them Installing first would
-        // briefly flip the badge to the wrong state.
-        if (m.contains("error")) continue;
         const QString name = m.value("name").toString();
         if (name.isEmpty()) continue;
-        m_packageModel->updatePackageInstallation(
-            name, static_cast<int>(PackageTypes::Installing));
+        InstallJournal::Step step = removedPriors.value(name);
+        if (!removedPriors.contains(name)) {
+            // What's there now is what a rollback puts back.
+            QString key = m.value("moduleName").toString();
+            if (key.isEmpty() || !m_installedSnapshot->contains(key)) key = name;
+            step.fromVersion  = m_installedSnapshot->versionByName().value(key);
+            step.fromRootHash = m_installedSnapshot->rootHashFor(key);
+            step.moduleName   = key;
+        }
+        step.name       = name;
+        step.toVersion  = m.value("version").toString();
+        step.toRootHash = m.value("rootHash").toString();
+        steps.append(step);
     }
+    return m_installJournal.begin(steps);
 }
 
-void PackageManagerBackend::revertPendingEntries(const QVariantList& entries, int fromIndex)
+void PackageManagerBackend::rollbackInstallTransaction(const QString& txn,
+                                                       const QString& topLevelName)
 {
-    if (!m_packageModel) return;
-    for (int i = fromIndex; i < entries.size(); ++i) {
-        const QString name = entries[i].toMap().value("name").toString();
-        if (name.isEmpty()) continue;
-        // NotInstalled is the safe rollback target — the next catalog
-        // refresh would compute the right status from disk regardless,
-        // but until then the Action column would surface "Install"
-        // (correct: the user can retry).
-        m_packageModel->updatePackageInstallation(
-            name, static_cast<int>(PackageTypes::NotInstalled));
+    const InstallJournal::Transaction* t = m_installJournal.find(txn);
+    if (!t || m_rollbacks.contains(txn)) return;
+    const QList<InstallJournal::Step> plan = InstallJournal::rollbackPlan(*t);
+    if (plan.isEmpty()) {
+        m_installJournal.finish(txn);
+        return;
     }
-}
 
-void PackageManagerBackend::reloadPackage(int index)
+    // Steps that replaced a version go back to it from the artifact
+    // cache; steps that added a package fresh are removed again. A
+    // prior artifact that isn't cached (or fails verification) can't
+    // be restored — it's reported through installRolledBack, not
+    // guessed at.
+    RollbackRun run;
+    run.topLevelName = topLevelName;
+    m_rollbacks.insert(txn, run);
+
+    QStringList priorHashes;
+    for (const InstallJournal::Step& step : plan) {
+        if (!step.fromVersion.isEmpty()) priorHashes.append(step.fromRootHash);
+    }
+    QPointer<PackageManagerBackend> self(this);
+    verifyCachedArtifacts(priorHashes,
+        [self, txn, plan](const QHash<QString, QString>& cached) {
+            if (!self) return;
+            auto it = self->m_rollbacks.find(txn);
+            if (it == self->m_rollbacks.end()) return;
+            for (const InstallJournal::Step& step : plan) {
+                if (step.fromVersion.isEmpty()) {
+                    if (step.state == InstallJournal::Step::Applied) it->removals.append(step.name);
+                    continue;
+                }
+                const QString path = cached.value(step.fromRootHash);
+                if (path.isEmpty()) {
+                    it->notRestored.append(QVariantMap{
+                        {QStringLiteral("name"),    step.name},
+                        {QStringLiteral("version"), step.fromVersion},
+                        {QStringLiteral("reason"),  step.fromRootHash.isEmpty()
+                            ? QStringLiteral("its artifact was never identified")
+                            : QStringLiteral("not in the local artifact cache")},
+                    });
+                    continue;
+                }
+                RollbackRestore restore;
+                restore.name       = step.name;
+                restore.moduleName = step.moduleName.isEmpty() ? step.name : step.moduleName;
+                restore.path       = path;
+                restore.version    = step.fromVersion;
+                if (step.state == InstallJournal::Step::Applied)
+                    restore.replacesVersion = step.toVersion;
+                it->restores.append(restore);
+            }
+            qWarning() << "Rolling back install transaction" << txn << ":" << it->restores.size()
+                       << "restore(s)," << it->removals.size() << "removal(s),"
+                       << it->notRestored.size() << "unrecoverable";
+            emit self->installationProgressUpdated(
+                static_cast<int>(PackageTypes::InProgress), it->topLevelName, 0, plan.size(), true,
+                QStringLiteral("Rolling back %1 package(s)…").arg(plan.size()));
+            self->rollbackNext(txn);
+        });
+}
+
+void PackageManagerBackend::rollbackNext(const QString& txn)
+{
+    auto it = m_rollbacks.find(txn);
+    if (it == m_rollbacks.end()) return;
+    if (it->index < it->restores.size()) {
+        // By value: a refused gate finishes the run before this returns.
+        const RollbackRestore next = it->restores.at(it->index);
+        requestRestoreGate(txn, next);
+        return;
+    }
+
+    const RollbackRun run = m_rollbacks.take(txn);
+    if (!run.removals.isEmpty() && packageManagerReady()) {
+        // Packages the transaction added fresh leave through the host's
+        // uninstall gate, like any other removal.
+        const QStringList removals = run.removals;
+        m_modules->requestMultiUninstall(removals,
+            [removals](QVariantMap result) {
+                if (!result.value("success", false).toBool())
+                    qWarning() << "Rollback: could not request removal of" << removals
+                               << result.value("error").toString();
+            });
+    }
+    m_installJournal.finish(txn);
+    if (m_refreshDebounceTimer) m_refreshDebounceTimer->start();
+
+    QStringList lost;
+    for (const QVariant& v : run.notRestored) {
+        const QVariantMap m = v.toMap();
+        lost.append(QStringLiteral("%1 %2 (%3)").arg(m.value("name").toString(),
+                                                      m.value("version").toString(),
+                                                      m.value("reason").toString()));
+    }
+    const QString msg = lost.isEmpty()
+        ? QStringLiteral("Install failed; the packages it had changed were rolled back")
+        : QStringLiteral("Install failed; rolled back, but could not restore: %1")
+              .arg(lost.join(QStringLiteral(", ")));
+    emit installationProgressUpdated(
+        static_cast<int>(PackageTypes::ProgressFailed), run.topLevelName,
+        run.restored.size(), run.restores.size(), false, msg);
+    emit installRolledBack(QVariantMap{
+        {QStringLiteral("packageName"), run.topLevelName},
+        {QStringLiteral("restored"),    run.restored},
+        {QStringLiteral("removed"),     run.removals},
+        {QStringLiteral("notRestored"), run.notRestored},
+    });
+}
+
+void PackageManagerBackend::requestRestoreGate(const QString& txn,
+                                               const RollbackRestore& restore)
+{
+    // A restore is a version change like any other, so the host gets to
+    // unload (and confirm) it: requestInstall when nothing is installed
+    // any more, requestUpgrade over the newer copy otherwise.
+    const bool fresh = restore.replacesVersion.isEmpty();
+    const QString key = fresh ? restore.name : restore.moduleName;
+    if (!packageManagerReady()) {
+        restoreFinished(txn, false, QStringLiteral("package_manager not connected"));
+        return;
+    }
+    if (m_pendingRestores.contains(key)) {
+        restoreFinished(txn, false, QStringLiteral("another restore of it is already waiting"));
+        return;
+    }
+    m_pendingRestores.insert(key, txn);
+
+    QPointer<PackageManagerBackend> self(this);
+    auto onReply = [self, txn, key](QVariantMap result) {
+        if (!self) return;
+        if (result.value(QStringLiteral("success"), false).toBool()) return;
+        if (self->m_pendingRestores.value(key) != txn) return;
+        self->m_pendingRestores.remove(key);
+        self->restoreFinished(txn, false, QStringLiteral("restore request rejected"));
+    };
+    if (fresh) {
+        m_modules->requestInstall(key, restore.version, QString(), QStringLiteral("[]"), onReply);
+        return;
+    }
+    const int cmp  = rowaction::versionCmp(restore.version, restore.replacesVersion);
+    const int mode = (cmp > 0) ? 0 : (cmp < 0) ? 1 : 2;
+    m_modules->requestUpgrade(key, restore.version, mode, QStringLiteral("[]"), onReply);
+}
+
+void PackageManagerBackend::runRestore(const QString& txn)
+{
+    auto it = m_rollbacks.find(txn);
+    if (it == m_rollbacks.end() || it->index >= it->restores.size()) return;
+    const RollbackRestore restore = it->restores.at(it->index);
+    if (!packageManagerReady()) {
+        restoreFinished(txn, false, QStringLiteral("package_manager not connected"));
+        return;
+    }
+    const QVariantMap entry{
+        {QStringLiteral("name"),    restore.name},
+        {QStringLiteral("path"),    restore.path},
+        {QStringLiteral("version"), restore.version},
+    };
+    markEntriesInstalling({entry});
+    QPointer<PackageManagerBackend> self(this);
+    installOnePackage(entry, [self, txn](bool success, const QString& err) {
+        if (self) self->restoreFinished(txn, success, err);
+    });
+}
+
+void PackageManagerBackend::restoreFinished(const QString& txn, bool success, const QString& err)
+{
+    auto it = m_rollbacks.find(txn);
+    if (it == m_rollbacks.end() || it->index >= it->restores.size()) return;
+    const RollbackRestore restore = it->restores.at(it->index);
+    if (success) {
+        m_installJournal.setState(txn, restore.name, InstallJournal::Step::RolledBack);
+        m_packageModel->updatePackageInstallation(
+            restore.name, static_cast<int>(PackageTypes::Installed));
+        it->restored.append(QStringLiteral("%1 %2").arg(restore.name, restore.version));
+    } else {
+        it->notRestored.append(QVariantMap{
+            {QStringLiteral("name"),    restore.name},
+            {QStringLiteral("version"), restore.version},
+            {QStringLiteral("reason"),  err},
+        });
+    }
+    ++it->index;
+    rollbackNext(txn);
+}
+
+void PackageManagerBackend::recoverInstallJournal()
+{
+    QVariantList interrupted;
+    const QList<InstallJournal::Transaction> open = m_installJournal.transactions();
+    for (const InstallJournal::Transaction& t : open) {
+        // A step still Pending either landed just before the crash (the
+        // installed version says so — looked up by moduleName, which is
+        // what the snapshot is keyed on) or never will.
+        for (const InstallJournal::Step& step : t.steps) {
+            if (step.state != InstallJournal::Step::Pending || step.toVersion.isEmpty()) continue;
+            const QString key = step.moduleName.isEmpty() ? step.name : step.moduleName;
+            const bool landed = m_installedSnapshot->versionByName().value(key) == step.toVersion;
+            m_installJournal.setState(t.id, step.name, landed ? InstallJournal::Step::Applied
+                                                              : InstallJournal::Step::Failed);
+        }
+        const InstallJournal::Transaction* now = m_installJournal.find(t.id);
+        if (!now || InstallJournal::rollbackPlan(*now).isEmpty()) {
+            m_installJournal.finish(t.id);   // nothing landed, nothing removed
+            continue;
+        }
+        QVariantList packages;
+        for (const InstallJournal::Step& step : now->steps) {
+            packages.append(QVariantMap{
+                {QStringLiteral("name"),        step.name},
+                {QStringLiteral("fromVersion"), step.fromVersion},
+                {QStringLiteral("toVersion"),   step.toVersion},
+            });
+        }
+        qWarning() << "Found interrupted install transaction" << t.id
+                   << "from" << t.startedAt.toString(Qt::ISODate);
+        interrupted.append(QVariantMap{
+            {QStringLiteral("id"),        t.id},
+            {QStringLiteral("startedAt"), t.startedAt.toString(Qt::ISODate)},
+            {QStringLiteral("packages"),  packages},
+        });
+    }
+    // Undoing is itself a round of installs and removals through the
+    // host, so the user decides — resolveInterruptedInstalls.
+    setInterruptedInstalls(interrupted);
+}
+
+void PackageManagerBackend::resolveInterruptedInstalls(bool rollBack)
+{
+    const QVariantList interrupted = interruptedInstalls();
+    if (interrupted.isEmpty()) return;
+    setInterruptedInstalls({});
+    for (const QVariant& v : interrupted) {
+        const QString txn = v.toMap().value(QStringLiteral("id")).toString();
+        if (rollBack)
+            rollbackInstallTransaction(txn, QString());
+        else
+            m_installJournal.finish(txn);
+    }
+}
+
+void PackageManagerBackend::markEntriesInstalling(const QVariantList& entries)
+{
+    if (!m_packageModel) return;
+    for (const QVariant& v : entries) {
+        const QVariantMap m = v.toMap();
+        // Error rows have no install to run — skip; the per-entry
+        // failure surface will pick them up via the install loop's
+        // own Failed update. Marking them Installing first would
+        // briefly flip the badge to the wrong state.
+        if (m.contains("error")) continue;
+        const QString name = m.value("name").toString();
+        if (name.isEmpty()) continue;
+        m_packageModel->updatePackageInstallation(
+            name, static_cast<int>(PackageTypes::Installing));
+    }
+}
+
+void PackageManagerBackend::revertPendingEntries(const QVariantList& entries, int fromIndex)
+{
+    if (!m_packageModel) return;
+    for (int i = fromIndex; i < entries.size(); ++i) {
+        const QString name = entries[i].toMap().value("name").toString();
+        if (name.isEmpty()) continue;
+        // NotInstalled is the safe rollback target — the next catalog
+        // refresh would compute the right status from disk regardless,
+        // but until then the Action column would surface "Install"
+        // (correct: the user can retry).
+        m_packageModel->updatePackageInstallation(
+            name, static_cast<int>(PackageTypes::NotInstalled));
+    }
+}
+
+void PackageManagerBackend::reloadPackage(int index)
 {
     // TODO: load/unload the plugin via logoscore.
     Q_UNUSED(index);
@@ -1340,6 +1824,7 @@ void PackageManagerBackend::installSpecs(const QList<PackageInstallSpec>& specs,
     }
 
     setIsInstalling(true);
+    stopPreResolve();
 
     emit installationProgressUpdated(
         static_cast<int>(PackageTypes::Started), "", 0, specs.size(), true, "");
@@ -1349,19 +1834,17 @@ void PackageManagerBackend::installSpecs(const QList<PackageInstallSpec>& specs,
             spec.name, static_cast<int>(PackageTypes::Installing));
     }
 
-    // Pack the specs into the JSON-array shape expected by
-    // `downloadResolvedDependenciesAsync`. The downloader resolves
+    // downloadResolved hands the specs to
+    // `downloadResolvedDependenciesAsync` (or serves them from the
+    // artifact cache). The downloader resolves
     // transitive deps from the catalog, pins each, and downloads in
     // deps-first order. `includeDeps` (default true) feeds the result
     // straight into processDownloadResults; false filters out non-
     // topLevel entries before installation so the user gets "just the
     // packages I selected" semantics.
-    const QString depsJson = buildDepsJson(specs);
-
-    LogosModules& logos = modules();
     QPointer<PackageManagerBackend> self(this);
-    logos.package_downloader.downloadResolvedDependenciesAsync(depsJson, buildInstalledPackagesJson(),
-        [self, includeDeps](QVariantList results) {
+    downloadResolved(specs,
+        [self, includeDeps](const QVariantList& results) {
             if (!self) return;
             if (!includeDeps) {
                 QVariantList filtered;
@@ -1374,7 +1857,7 @@ void PackageManagerBackend::installSpecs(const QList<PackageInstallSpec>& specs,
             } else {
                 self->processDownloadResults(results);
             }
-        }, Timeout(DOWNLOAD_TIMEOUT_MS));
+        });
 }
 
 void PackageManagerBackend::installNamed(const QStringList& packageNames)
@@ -1390,29 +1873,201 @@ void PackageManagerBackend::installNamed(const QStringList& packageNames)
     installSpecs(specs);
 }
 
-QString PackageManagerBackend::buildInstalledPackagesJson() const
+void PackageManagerBackend::setInstalledSnapshot(InstalledSnapshot::Ptr snapshot)
 {
-    // package_manager.getInstalledPackages returns entries shaped like
-    //   { name, moduleName, version, hashes: { root }, installType, ... }
-    // The resolver only needs (name, version) for its range check; we
-    // also pass rootHash for parity with the rest of the install plumbing
-    // even though the current short-circuit doesn't read it.
-    QJsonArray arr;
-    for (const QVariant& v : m_installedPackagesCache) {
+    m_installedSnapshot = snapshot ? snapshot : InstalledSnapshot::empty();
+    m_depGraph.setInstalledVersions(m_installedSnapshot->versionByName());
+}
+
+void PackageManagerBackend::rebuildRepoUrlToNameIndex()
+{
+    // repoUrl → repositoryDisplayName so the dialog's "from repo X" line
+    // is the human label the rest of the UI uses.
+    QHash<QString, QString> repoUrlToName;
+    for (const QVariant& v : m_allPackagesCache) {
         const QVariantMap m = v.toMap();
-        const QString name = m.value("moduleName").toString().isEmpty()
-                             ? m.value("name").toString()
-                             : m.value("moduleName").toString();
-        const QString version = m.value("version").toString();
-        if (name.isEmpty() || version.isEmpty()) continue;
-        QJsonObject o;
-        o.insert(QStringLiteral("name"), name);
-        o.insert(QStringLiteral("version"), version);
-        const QString rootHash = m.value("hashes").toMap().value("root").toString();
-        if (!rootHash.isEmpty()) o.insert(QStringLiteral("rootHash"), rootHash);
-        arr.append(o);
+        const QString u = m.value("repositoryUrl").toString();
+        const QString n = m.value("repositoryDisplayName").toString();
+        if (!u.isEmpty() && !n.isEmpty() && !repoUrlToName.contains(u))
+            repoUrlToName.insert(u, n);
+    }
+    m_repoUrlToName = repoUrlToName;
+}
+
+QString PackageManagerBackend::resolveCacheKey(const QString& depsJson,
+                                               const InstalledSnapshot& installed) const
+{
+    // The installed snapshot can run to hundreds of entries — key on its
+    // precomputed digest instead of embedding it. depsJson is already
+    // canonical (QJsonDocument writes object keys sorted).
+    return depsJson + QChar(0x01)
+         + QString::fromLatin1(installed.fingerprint()) + QChar(0x01)
+         + QString::number(m_catalogGeneration);
+}
+
+void PackageManagerBackend::resolveDependenciesCached(
+    const QString& depsJson,
+    const InstalledSnapshot::Ptr& installed,
+    std::function<void(const QVariantList&)> onResolved,
+    bool speculative)
+{
+    // A real action: the pre-resolver stands down, and on a miss stays
+    // off the wire until this resolution is back.
+    if (!speculative) stopPreResolve();
+
+    const QString key = resolveCacheKey(depsJson, *installed);
+    if (const QVariantList* hit = m_resolveCache.object(key)) {
+        // Copy out before calling back: the callback may dispatch work
+        // that inserts into the cache and evicts `hit`.
+        const QVariantList resolved = *hit;
+        if (onResolved) onResolved(resolved);
+        return;
+    }
+
+    QPointer<PackageManagerBackend> self(this);
+    std::function<void(const QVariantList&)> waiter = onResolved;
+    if (!speculative) {
+        ++m_realResolvesInFlight;
+        waiter = [self, onResolved](const QVariantList& resolved) {
+            if (!self) return;
+            --self->m_realResolvesInFlight;
+            if (onResolved) onResolved(resolved);
+        };
+    }
+
+    // Same request already on the wire (typically a speculative one the
+    // user just clicked) — ride along instead of asking twice.
+    auto inFlight = m_resolveWaiters.find(key);
+    if (inFlight != m_resolveWaiters.end()) {
+        if (waiter) inFlight->append(waiter);
+        return;
+    }
+    QList<std::function<void(const QVariantList&)>> waiters;
+    if (waiter) waiters.append(waiter);
+    m_resolveWaiters.insert(key, waiters);
+    if (speculative) ++m_preResolveInFlight;
+
+    const quint64 generation = m_catalogGeneration;
+    m_modules->resolveDependencies(depsJson, installed->json(),
+        [self, key, generation, speculative](QVariantList resolved) {
+            if (!self) return;
+            if (speculative) --self->m_preResolveInFlight;
+            bool cacheable = !resolved.isEmpty()
+                          && generation == self->m_catalogGeneration;
+            for (const QVariant& v : resolved) {
+                if (v.toMap().contains("error")) { cacheable = false; break; }
+            }
+            if (cacheable) self->m_resolveCache.insert(key, new QVariantList(resolved));
+            const auto waiters = self->m_resolveWaiters.take(key);
+            for (const auto& w : waiters) {
+                if (!self) return;
+                w(resolved);
+            }
+            if (self) self->pumpPreResolveQueue();
+        });
+}
+
+void PackageManagerBackend::resolveForPreview(
+    const QList<PackageInstallSpec>& specs,
+    const InstalledSnapshot::Ptr& installed,
+    std::function<void(const QVariantList&)> onResolved)
+{
+    const QString depsJson = buildDepsJson(specs);
+    if (!m_resolveCache.contains(resolveCacheKey(depsJson, *installed))
+        && !m_localResolver.isEmpty()) {
+        const QVariantList local = m_localResolver.resolve(specs, installed->versionByName());
+        if (!LocalDependencyResolver::hasErrors(local)) {
+            // Still a real action: the pre-resolver stands down.
+            stopPreResolve();
+            if (onResolved) onResolved(local);
+            return;
+        }
+    }
+    resolveDependenciesCached(depsJson, installed, std::move(onResolved));
+}
+
+void PackageManagerBackend::schedulePreResolve()
+{
+    if (m_preResolveTimer) m_preResolveTimer->start();
+}
+
+void PackageManagerBackend::stopPreResolve()
+{
+    // Queued candidates are dropped, not deferred: by the time the real
+    // action finishes the page (and the installed set) has usually
+    // moved, and the next settle re-arms a fresh pass anyway. Calls
+    // already on the wire finish and still populate the cache.
+    m_preResolveQueue.clear();
+    if (m_preResolveTimer) m_preResolveTimer->stop();
+}
+
+void PackageManagerBackend::runPreResolvePass()
+{
+    if (!m_packageModel || !m_packagesPagingProxy) return;
+    if (m_realResolvesInFlight > 0 || !bothClientsReady()) return;
+
+    // One installed snapshot for the whole pass. A click borrows the same
+    // snapshot, so as long as nothing was installed in between, the
+    // click's key matches the one warmed here.
+    m_preResolveInstalled = m_installedSnapshot;
+    m_preResolveQueue.clear();
+
+    QSet<QString> queuedKeys;
+    auto consider = [&](const QVariantMap& row, bool selected) {
+        if (row.isEmpty()) return;
+        const int status = row.value("installStatus").toInt();
+        if (status == static_cast<int>(PackageTypes::Installing)) return;
+        const int action = row.value("rowAction",
+                              static_cast<int>(PackageTypes::NoOp)).toInt();
+        if (action == static_cast<int>(PackageTypes::NoOp)
+            || action == static_cast<int>(PackageTypes::NotAvailable))
+            return;
+        const bool likely = selected
+                         || action == static_cast<int>(PackageTypes::Install)
+                         || row.value("updateAvailable").toBool();
+        if (!likely) return;
+
+        // Exactly the spec installPackage / requestVersionChange build, so
+        // the warmed entry is the one the click looks up.
+        PackageInstallSpec spec;
+        spec.name          = row.value("name").toString();
+        spec.repositoryUrl = row.value("repositoryUrl").toString();
+        spec.version       = row.value("version").toString();
+        if (spec.name.isEmpty()) return;
+        // A row the local resolver answers cleanly never reaches the
+        // wire on click — nothing to warm.
+        if (!m_localResolver.isEmpty()
+            && !LocalDependencyResolver::hasErrors(
+                   m_localResolver.resolve({spec}, m_preResolveInstalled->versionByName())))
+            return;
+        const QString depsJson = buildDepsJson({spec});
+        const QString key = resolveCacheKey(depsJson, *m_preResolveInstalled);
+        if (queuedKeys.contains(key) || m_resolveCache.contains(key)
+            || m_resolveWaiters.contains(key))
+            return;
+        queuedKeys.insert(key);
+        m_preResolveQueue.append(depsJson);
+    };
+
+    // Selected rows first — they're one "Run Actions" click away.
+    for (int row : m_packageModel->getSelectedRows())
+        consider(m_packageModel->packageAt(row), true);
+    const int visible = m_packagesPagingProxy->rowCount();
+    for (int i = 0; i < visible; ++i)
+        consider(findPackageAtProxyRow(i), false);
+
+    pumpPreResolveQueue();
+}
+
+void PackageManagerBackend::pumpPreResolveQueue()
+{
+    while (m_realResolvesInFlight == 0
+           && m_preResolveInFlight < kMaxSpeculativeResolves
+           && !m_preResolveQueue.isEmpty()) {
+        const QString depsJson = m_preResolveQueue.takeFirst();
+        resolveDependenciesCached(depsJson, m_preResolveInstalled,
+                                  nullptr, /*speculative=*/true);
     }
-    return QString::fromUtf8(QJsonDocument(arr).toJson(QJsonDocument::Compact));
 }
 
 QVariantList PackageManagerBackend::computeDepChanges(
@@ -1467,39 +2122,19 @@ void PackageManagerBackend::runDepPreviewForAction(const QString& packageName,
     spec.name = packageName;
     spec.repositoryUrl = repoUrl;
     spec.version = version;
-    const QString depsJson      = buildDepsJson({spec});
-    const QString installedJson = buildInstalledPackagesJson();
-
-    // repoUrl → repositoryDisplayName index — built once per preview
-    // from the current catalog cache so the dialog's "from repo X" line
-    // is the human label the rest of the UI uses.
-    QHash<QString, QString> repoUrlToName;
-    for (const QVariant& v : m_allPackagesCache) {
-        const QVariantMap m = v.toMap();
-        const QString u = m.value("repositoryUrl").toString();
-        const QString n = m.value("repositoryDisplayName").toString();
-        if (!u.isEmpty() && !n.isEmpty() && !repoUrlToName.contains(u))
-            repoUrlToName.insert(u, n);
-    }
-    // Installed snapshot indexed by name for from-version lookup.
-    QHash<QString, QString> installedByName;
-    for (const QVariant& v : m_installedPackagesCache) {
-        const QVariantMap m = v.toMap();
-        const QString n = m.value("moduleName").toString().isEmpty()
-                          ? m.value("name").toString()
-                          : m.value("moduleName").toString();
-        const QString ver = m.value("version").toString();
-        if (!n.isEmpty() && !ver.isEmpty()) installedByName.insert(n, ver);
-    }
-    LogosModules& logos = modules();
+    // Borrow the refresh-time snapshot and repo-label index: the lambda
+    // holds a reference on each, so an install landing mid-resolve
+    // swaps m_installedSnapshot without touching what this preview reads.
+    const InstalledSnapshot::Ptr installed = m_installedSnapshot;
+    const QHash<QString, QString> repoUrlToName = m_repoUrlToName;
     QPointer<PackageManagerBackend> self(this);
-    logos.package_downloader.resolveDependenciesAsync(depsJson, installedJson,
+    resolveForPreview({spec}, installed,
         [self, packageName, moduleName, repoUrl, version, actionKind,
-         installedByName, repoUrlToName]
-        (QVariantList resolved) {
+         installed, repoUrlToName]
+        (const QVariantList& resolved) {
             if (!self) return;
             const QVariantList changes = self->computeDepChanges(
-                resolved, installedByName, repoUrlToName);
+                resolved, installed->versionByName(), repoUrlToName);
             // Route the confirmation to the HOST (basecamp) instead of showing
             // PMU's own dialog: serialise the resolved change list and hand it
             // to the package_manager gate (requestInstall / requestUpgrade).
@@ -1518,6 +2153,94 @@ void PackageManagerBackend::runDepPreviewForAction(const QString& packageName,
         });
 }
 
+void PackageManagerBackend::runBatchedDepPreview(const QList<PendingDepConfirm>& batch)
+{
+    if (batch.isEmpty()) return;
+    if (batch.size() == 1) {
+        const PendingDepConfirm& p = batch.first();
+        runDepPreviewForAction(p.name, p.moduleName, p.repositoryUrl, p.version, p.action);
+        return;
+    }
+    if (!bothClientsReady()) {
+        emit errorOccurred(static_cast<int>(PackageTypes::PackageManagerNotConnected));
+        return;
+    }
+
+    // One spec per row, all pinned exactly like the per-row preview. The
+    // batch's own targets are excluded from the change lists below:
+    // the resolver flags them topLevel already, but a row that is also a
+    // transitive dep of another row must not be listed twice.
+    QList<PackageInstallSpec> specs;
+    specs.reserve(batch.size());
+    QSet<QString> batchNames;
+    for (const PendingDepConfirm& p : batch) {
+        PackageInstallSpec spec;
+        spec.name          = p.name;
+        spec.repositoryUrl = p.repositoryUrl;
+        spec.version       = p.version;
+        specs.append(spec);
+        batchNames.insert(p.name);
+        batchNames.insert(p.moduleName);
+    }
+    // package_manager's gate is per module, so each row still gets its
+    // own host dialog — and each dialog must list the changes that row
+    // brings in, or declining one leaves the others approving changes
+    // nobody was shown. The resolver decides WHAT changes; the local
+    // graph only attributes each change to the rows whose closure holds
+    // it. A change the graph can't attribute goes on every row's dialog.
+    QList<QSet<QString>> closures;
+    closures.reserve(batch.size());
+    for (const PendingDepConfirm& p : batch) {
+        const QStringList closure = m_depGraph.dependencyClosure(p.name, p.version);
+        closures.append(QSet<QString>(closure.cbegin(), closure.cend()));
+    }
+    const InstalledSnapshot::Ptr installed = m_installedSnapshot;
+    const QHash<QString, QString> repoUrlToName = m_repoUrlToName;
+
+    QPointer<PackageManagerBackend> self(this);
+    resolveForPreview(specs, installed,
+        [self, batch, batchNames, closures, installed, repoUrlToName]
+        (const QVariantList& resolved) {
+            if (!self) return;
+            QList<QVariantList> perRow(batch.size());
+            QSet<QString> seen;
+            const QVariantList changes = self->computeDepChanges(
+                resolved, installed->versionByName(), repoUrlToName);
+            for (const QVariant& c : changes) {
+                const QString name = c.toMap().value(QStringLiteral("name")).toString();
+                if (batchNames.contains(name) || seen.contains(name)) continue;
+                seen.insert(name);
+                const QString canonical = self->m_depGraph.canonicalName(name);
+                bool attributed = false;
+                for (int i = 0; i < batch.size(); ++i) {
+                    if (!closures.at(i).contains(canonical)) continue;
+                    perRow[i].append(c);
+                    attributed = true;
+                }
+                if (attributed) continue;
+                for (QVariantList& rowChanges : perRow) rowChanges.append(c);
+            }
+            for (int i = 0; i < batch.size(); ++i) {
+                const PendingDepConfirm& p = batch.at(i);
+                const QString changesJson = QString::fromUtf8(
+                    QJsonDocument(QJsonArray::fromVariantList(perRow.at(i)))
+                        .toJson(QJsonDocument::Compact));
+                self->dispatchPendingAction(p.name, p.moduleName, p.repositoryUrl,
+                                            p.version, p.action, changesJson);
+            }
+        });
+}
+
+int PackageManagerBackend::actionKindForMode(UpgradeMode mode)
+{
+    switch (mode) {
+    case UpgradeMode::Downgrade: return PendingDepConfirm::Downgrade;
+    case UpgradeMode::Sidegrade: return PendingDepConfirm::Sidegrade;
+    case UpgradeMode::Upgrade:   break;
+    }
+    return PendingDepConfirm::Upgrade;
+}
+
 void PackageManagerBackend::dispatchPendingAction(const QString& packageName,
                                                   const QString& moduleName,
                                                   const QString& repoUrl,
@@ -1533,11 +2256,10 @@ void PackageManagerBackend::dispatchPendingAction(const QString& packageName,
     // download+install (onInstallApproved / onUpgradeUninstallDone). Deps are
     // always included now — the host dialog is confirm-or-cancel, with no
     // "just the package" split — so PendingUpgradeMeta.includeDeps stays true.
-    LogosModules& logos = modules();
     QPointer<PackageManagerBackend> self(this);
     switch (static_cast<PendingDepConfirm::Action>(actionKind)) {
     case PendingDepConfirm::Install:
-        logos.package_manager.requestInstallAsync(packageName, version, repoUrl, depChangesJson,
+        m_modules->requestInstall(packageName, version, repoUrl, depChangesJson,
             [self](QVariantMap result) {
                 if (!self) return;
                 if (!result.value("success", false).toBool())
@@ -1552,11 +2274,13 @@ void PackageManagerBackend::dispatchPendingAction(const QString& packageName,
             PendingUpgradeMeta meta;
             meta.repositoryUrl = repoUrl;
             meta.includeDeps   = true;
+            meta.fromVersion   = m_installedSnapshot->versionByName().value(moduleName);
+            meta.fromRootHash  = m_installedSnapshot->rootHashFor(moduleName);
             m_pendingUpgradeByModule.insert(moduleName, meta);
         }
         const int mode = (actionKind == PendingDepConfirm::Downgrade) ? 1
                        : (actionKind == PendingDepConfirm::Sidegrade) ? 2 : 0;
-        logos.package_manager.requestUpgradeAsync(moduleName, version, mode, depChangesJson,
+        m_modules->requestUpgrade(moduleName, version, mode, depChangesJson,
             [self](QVariantMap result) {
                 if (!self) return;
                 if (!result.value("success", false).toBool())
@@ -1594,11 +2318,63 @@ void PackageManagerBackend::cancelInstallConfirm(QString requestKey)
 
 void PackageManagerBackend::requestPackageDetails(int index)
 {
-    const QVariantMap pkg = findPackageAtProxyRow(index);
-    if (pkg.isEmpty()) return;
+    QVariantMap pkg = findPackageAtProxyRow(index);
+    if (pkg.isEmpty() || pkg.value("isGroupPlaceholder").toBool()) return;
+    // Reverse dependencies straight from the local graph: every package
+    // with some version requiring this one, and the installed subset that
+    // an uninstall would break.
+    const QString name = pkg.value("name").toString();
+    pkg["dependents"]          = m_depGraph.dependents(name, /*installedOnly=*/false);
+    pkg["installedDependents"] = m_depGraph.dependents(name, /*installedOnly=*/true);
     emit packageDetailsLoaded(pkg);
 }
 
+void PackageManagerBackend::publishSourceGroupCounts()
+{
+    // A collapsed group's placeholder counts as the rows it stands for
+    // that pass the filters, not as one row.
+    const QStringList collapsed = collapsedSources();
+    QVariantMap counts;
+    for (const PackagesFilterProxy::SourceGroup& g : m_packagesFilterProxy->sourceGroups()) {
+        int n = g.count;
+        if (collapsed.contains(g.section)) {
+            n = 0;
+            for (int r = g.first; r < g.first + g.count; ++r)
+                n += m_packagesFilterProxy->groupMatchCount(r);
+        }
+        counts.insert(g.section, counts.value(g.section).toInt() + n);
+    }
+    setSourceGroupCounts(counts);
+}
+
+void PackageManagerBackend::setSourceCollapsed(QString section, bool collapsed)
+{
+    // The header only knows its label; the state is kept per repository
+    // so it follows a repository whose display name changes. "local" is
+    // the local rows, keyed by the empty URL.
+    QSet<QString> urls;
+    if (section == QLatin1String("local")) urls.insert(QString());
+    for (const QVariant& v : std::as_const(m_allPackagesCache)) {
+        const QVariantMap m = v.toMap();
+        if (m.value("repositoryDisplayName").toString() == section)
+            urls.insert(m.value("repositoryUrl").toString());
+    }
+    bool changed = false;
+    for (const QString& url : std::as_const(urls)) {
+        if (m_collapsedRepoUrls.contains(url) == collapsed) continue;
+        if (collapsed) m_collapsedRepoUrls.insert(url);
+        else           m_collapsedRepoUrls.remove(url);
+        changed = true;
+    }
+    if (!changed) return;
+
+    // A full rebuild, but only expanded groups get built, so collapsing
+    // the big ones is what makes it cheap. It republishes
+    // collapsedSources too.
+    setPackagesFromVariantList(m_allPackagesCache, m_installedPackagesCache,
+                               m_validVariantsCache);
+}
+
 void PackageManagerBackend::togglePackage(int index, bool checked)
 {
     // Guardrail: only runnable rows participate in the bulk
@@ -1638,9 +2414,8 @@ void PackageManagerBackend::uninstallSelected()
         return;
     }
 
-    LogosModules& logos = modules();
     QPointer<PackageManagerBackend> self(this);
-    logos.package_manager.requestMultiUninstallAsync(moduleNames,
+    m_modules->requestMultiUninstall(moduleNames,
         [self, moduleNames](QVariantMap result) {
             if (!self) return;
             if (!result.value("success", false).toBool()) {
@@ -1671,9 +2446,8 @@ void PackageManagerBackend::uninstall(int index)
         return;
     }
 
-    LogosModules& logos = modules();
     QPointer<PackageManagerBackend> self(this);
-    logos.package_manager.requestUninstallAsync(name,
+    m_modules->requestUninstall(name,
         [self](QVariantMap result) {
             if (!self) return;
             if (!result.value("success", false).toBool()) {
@@ -1739,10 +2513,8 @@ void PackageManagerBackend::requestVersionChange(int index, UpgradeMode mode)
     const QString name        = pkg.value("name").toString();
     const QString targetVersion = pkg.value("version").toString();
     const QString repoUrl     = pkg.value("repositoryUrl").toString();
-    const int actionKind = (mode == UpgradeMode::Downgrade) ? PendingDepConfirm::Downgrade
-                         : (mode == UpgradeMode::Sidegrade) ? PendingDepConfirm::Sidegrade
-                         :                                    PendingDepConfirm::Upgrade;
-    runDepPreviewForAction(name, moduleName, repoUrl, targetVersion, actionKind);
+    runDepPreviewForAction(name, moduleName, repoUrl, targetVersion,
+                           actionKindForMode(mode));
 }
 
 void PackageManagerBackend::subscribePackageManagerCancellationEvents()
@@ -1751,14 +2523,13 @@ void PackageManagerBackend::subscribePackageManagerCancellationEvents()
 
     static const QString kReasonUserCancelled = QStringLiteral("user cancelled");
 
-    LogosModules& logos = modules();
     QPointer<PackageManagerBackend> self(this);
 
     // Subscribe a cancellation event with a per-event toast formatter.
     auto subscribe = [&](const char* eventName,
                          std::function<QString(const QJsonObject&, const QString&)> format,
                          bool dropsPendingLocalInstall = false) {
-        logos.package_manager.on(eventName,
+        m_modules->onManagerEvent(QString::fromLatin1(eventName),
             [self, format, dropsPendingLocalInstall](const QVariantList& data) {
                 if (!self) return;
                 const QJsonObject obj = parseEventPayload(data);
@@ -1767,7 +2538,13 @@ void PackageManagerBackend::subscribePackageManagerCancellationEvents()
                 if (dropsPendingLocalInstall
                     && self->m_pendingLocalInstalls.remove(name) > 0) {
                     self->m_pendingUpgradeByModule.remove(name);
+                    self->finishLocalBatchEntry(name, false, QStringLiteral("Cancelled"));
                 }
+                // The same gates carry rollback restores.
+                const QString restoreTxn = dropsPendingLocalInstall
+                    ? self->m_pendingRestores.take(name) : QString();
+                if (!restoreTxn.isEmpty())
+                    self->restoreFinished(restoreTxn, false, QStringLiteral("restore cancelled"));
                 const QString reason = obj.value("reason").toString();
                 if (reason == kReasonUserCancelled) return;
                 emit self->cancellationOccurred(name, format(obj, reason));
@@ -1802,8 +2579,6 @@ void PackageManagerBackend::subscribePackageManagerRefreshEvents()
 {
     if (!packageManagerReady()) return;
 
-    LogosModules& logos = modules();
-
     QPointer<PackageManagerBackend> self(this);
     auto arm = [self](const QVariantList&) {
         if (!self || !self->m_refreshDebounceTimer) return;
@@ -1812,43 +2587,333 @@ void PackageManagerBackend::subscribePackageManagerRefreshEvents()
 
     auto deselectAndArm = [self](const QVariantList& data) {
         if (!self) return;
-        if (!data.isEmpty() && self->m_packageModel) {
+        if (!data.isEmpty()) {
             const QString moduleName = data.first().toString();
-            if (!moduleName.isEmpty())
-                self->m_packageModel->clearSelectionsByModuleNames({moduleName});
+            if (!moduleName.isEmpty()) {
+                // Drop it from the installed snapshot now rather than at the
+                // debounced refresh, so a preview in between doesn't tell
+                // the resolver the module is still there.
+                self->setInstalledSnapshot(self->m_installedSnapshot->without(moduleName));
+                if (self->m_packageModel)
+                    self->m_packageModel->clearSelectionsByModuleNames({moduleName});
+            }
         }
         if (self->m_refreshDebounceTimer) self->m_refreshDebounceTimer->start();
     };
 
-    logos.package_manager.on("corePluginFileInstalled", arm);
-    logos.package_manager.on("uiPluginFileInstalled",   arm);
-    logos.package_manager.on("corePluginUninstalled",   deselectAndArm);
-    logos.package_manager.on("uiPluginUninstalled",     deselectAndArm);
+    m_modules->onManagerEvent(QStringLiteral("corePluginFileInstalled"), arm);
+    m_modules->onManagerEvent(QStringLiteral("uiPluginFileInstalled"),   arm);
+    m_modules->onManagerEvent(QStringLiteral("corePluginUninstalled"),   deselectAndArm);
+    m_modules->onManagerEvent(QStringLiteral("uiPluginUninstalled"),     deselectAndArm);
 }
 
 void PackageManagerBackend::subscribePackageDownloaderEvents()
 {
     if (!clientReady("package_downloader")) return;
 
-    LogosModules& logos = modules();
     QPointer<PackageManagerBackend> self(this);
-    logos.package_downloader.on("catalogChanged", [self](const QVariantList&) {
+    // Payload, when the module versions its catalog: JSON { generation }.
+    m_modules->onDownloaderEvent(QStringLiteral("catalogChanged"), [self](const QVariantList& data) {
         if (!self) return;
-        if (self->m_refreshDebounceTimer) self->m_refreshDebounceTimer->start();
+        const QJsonObject obj = parseEventPayload(data);
+        const qint64 generation = obj.value("generation").toInteger(-1);
+        // No generation, or a module that said it can't do deltas: queue
+        // the full refresh directly rather than ask for a delta first.
+        if (generation < 0 || !self->m_catalogDeltaSupported) {
+            if (self->m_refreshDebounceTimer) self->m_refreshDebounceTimer->start();
+            return;
+        }
+        if (generation > self->m_catalogAnnouncedGeneration)
+            self->m_catalogAnnouncedGeneration = generation;
+        if (self->m_catalogDeltaTimer) self->m_catalogDeltaTimer->start();
+    });
+
+    // Per-artifact byte progress while downloadResolvedDependencies runs.
+    // Undeclared by the module; DownloadProgressTracker::applyEvent
+    // documents the payload we accept and drops the rest. Chunks can
+    // arrive many times a second per artifact, so this only updates the
+    // tracker — the throttle timer decides when the replica hears of it.
+    // Events outside one of our own downloads (another client driving
+    // the downloader) are ignored: we'd never see their end.
+    m_modules->onDownloaderEvent(QStringLiteral("downloadProgress"), [self](const QVariantList& data) {
+        if (!self || self->m_downloadsInFlight == 0) return;
+        if (!self->m_downloadProgress.applyEvent(parseEventPayload(data),
+                                                 self->m_downloadClock.elapsed())) {
+            static bool warned = false;
+            if (!warned) {
+                warned = true;
+                qWarning() << "package_downloader: ignoring downloadProgress event"
+                              " with an unexpected payload:" << data;
+            }
+            return;
+        }
+        if (!self->m_downloadProgressTimer->isActive())
+            self->m_downloadProgressTimer->start();
+    });
+}
+
+void PackageManagerBackend::beginDownloadTracking()
+{
+    if (m_downloadsInFlight++ > 0) return;
+    m_downloadProgress.clear();
+    m_downloadClock.start();
+    publishDownloadProgress();
+}
+
+void PackageManagerBackend::endDownloadTracking()
+{
+    if (m_downloadsInFlight == 0 || --m_downloadsInFlight > 0) return;
+    // Last download back — drop the bar right away rather than on the
+    // next throttle tick.
+    m_downloadProgressTimer->stop();
+    m_downloadProgress.clear();
+    publishDownloadProgress();
+}
+
+void PackageManagerBackend::publishDownloadProgress()
+{
+    QVariantMap progress = m_downloadProgress.toVariant();
+    progress.insert(QStringLiteral("packages"), m_downloads.waitingNames());
+    setDownloadProgress(progress);
+}
+
+quint64 PackageManagerBackend::downloadResolved(const QList<PackageInstallSpec>& specs,
+                                                std::function<void(const QVariantList&)> onResults)
+{
+    QStringList topLevelNames;
+    for (const PackageInstallSpec& spec : specs) topLevelNames.append(spec.name);
+
+    // One part per top-level artifact, keyed by what the local resolver
+    // pins it to: a spec whose artifact is already on a call in flight
+    // (same installed snapshot) rides on that call, and only the rest
+    // go to package_downloader. A spec the local resolver can't pin
+    // gets no key and is always sent.
+    const InstalledSnapshot::Ptr installed = m_installedSnapshot;
+    const QString fingerprint = QString::fromLatin1(installed->fingerprint());
+    QList<DownloadSharing::Part> parts;
+    parts.reserve(specs.size());
+    for (const PackageInstallSpec& spec : specs) {
+        DownloadSharing::Part part;
+        part.topLevelName = spec.name;
+        if (!m_localResolver.isEmpty()) {
+            const QVariantList local = m_localResolver.resolve({spec}, installed->versionByName());
+            if (!local.isEmpty() && !LocalDependencyResolver::hasErrors(local)) {
+                const QVariantMap top = local.first().toMap();
+                part.key = QStringLiteral("%1@%2/%3\n%4")
+                               .arg(spec.name, top.value("version").toString(),
+                                    top.value("rootHash").toString(), fingerprint);
+                for (const QVariant& v : local) part.names.append(v.toMap().value("name").toString());
+            }
+        }
+        parts.append(part);
+    }
+
+    const DownloadSharing::Attached a = m_downloads.attach(parts, topLevelNames, std::move(onResults));
+    // Every call that had nobody waiting — new, or re-joined after
+    // everyone cancelled — goes (back) on the progress bar.
+    for (int i = 0; i < a.woken; ++i) beginDownloadTracking();
+    if (a.newCall) {
+        QList<PackageInstallSpec> toSend;
+        toSend.reserve(a.unshared.size());
+        for (int i : a.unshared) toSend.append(specs.at(i));
+        startDownloadCall(a.call, toSend, buildDepsJson(toSend), installed);
+    }
+    publishDownloadProgress();
+    return a.ticket;
+}
+
+void PackageManagerBackend::startDownloadCall(int callId,
+                                              const QList<PackageInstallSpec>& specs,
+                                              const QString& depsJson,
+                                              const InstalledSnapshot::Ptr& installed)
+{
+    // The cache only serves artifacts the downloader itself resolved
+    // this request to. The local resolver is just a hint for skipping
+    // that round-trip: when its picks aren't all cached, a full hit is
+    // unlikely and the download goes straight out.
+    bool tryCache = m_artifactCache.count() > 0;
+    if (tryCache && !m_localResolver.isEmpty()) {
+        const QVariantList local = m_localResolver.resolve(specs, installed->versionByName());
+        for (const QVariant& v : local) {
+            const QVariantMap m = v.toMap();
+            if (m.contains("error") || !m_artifactCache.contains(m.value("rootHash").toString())) {
+                tryCache = false;
+                break;
+            }
+        }
+    }
+    if (!tryCache) {
+        sendDownloadCall(callId, depsJson, installed);
+        return;
+    }
+
+    QPointer<PackageManagerBackend> self(this);
+    resolveDependenciesCached(depsJson, installed,
+        [self, callId, depsJson, installed](const QVariantList& resolved) {
+            if (!self) return;
+            QStringList rootHashes;
+            for (const QVariant& v : resolved) {
+                const QVariantMap m = v.toMap();
+                const QString rootHash = m.value("rootHash").toString();
+                if (m.contains("error") || rootHash.isEmpty()) { rootHashes.clear(); break; }
+                rootHashes.append(rootHash);
+            }
+            if (rootHashes.isEmpty()) {
+                self->sendDownloadCall(callId, depsJson, installed);
+                return;
+            }
+            self->verifyCachedArtifacts(rootHashes,
+                [self, callId, depsJson, installed, resolved](const QHash<QString, QString>& paths) {
+                    if (!self) return;
+                    QVariantList results;
+                    results.reserve(resolved.size());
+                    for (const QVariant& v : resolved) {
+                        QVariantMap m = v.toMap();
+                        const QString path = paths.value(m.value("rootHash").toString());
+                        if (path.isEmpty()) {
+                            self->sendDownloadCall(callId, depsJson, installed);
+                            return;
+                        }
+                        m.insert(QStringLiteral("path"), path);
+                        results.append(m);
+                    }
+                    self->finishDownloadCall(callId, results);
+                });
+        });
+}
+
+void PackageManagerBackend::sendDownloadCall(int callId, const QString& depsJson,
+                                             const InstalledSnapshot::Ptr& installed)
+{
+    QPointer<PackageManagerBackend> self(this);
+    m_modules->downloadResolvedDependencies(depsJson, installed->json(),
+        [self, callId](QVariantList results) {
+            if (!self) return;
+            self->finishDownloadCall(callId, results);
+        }, DOWNLOAD_TIMEOUT_MS);
+}
+
+void PackageManagerBackend::finishDownloadCall(int callId, const QVariantList& results)
+{
+    if (m_downloads.requesterCount(callId) > 0) endDownloadTracking();
+
+    // Keep every good artifact for next time (Reinstall, Retry, flipping
+    // versions back and forth) — even from a call nobody waits on any
+    // more.
+    storeArtifacts(results);
+    m_downloads.finish(callId, results);
+    publishDownloadProgress();
+}
+
+void PackageManagerBackend::cancelDownloadRequest(quint64 ticket, const QString& reason)
+{
+    // The requester's own flow (row status, isInstalling) winds down on
+    // the error entries it gets back. A call left with nobody waiting
+    // drops off the progress bar but runs on — see DownloadSharing.
+    const int emptied = m_downloads.cancel(ticket, reason);
+    for (int i = 0; i < emptied; ++i) endDownloadTracking();
+    publishDownloadProgress();
+}
+
+void PackageManagerBackend::verifyCachedArtifacts(
+    const QStringList& rootHashes,
+    std::function<void(const QHash<QString, QString>&)> onVerified)
+{
+    QList<ArtifactCache::Candidate> candidates;
+    for (const QString& rootHash : rootHashes) {
+        ArtifactCache::Candidate c = m_artifactCache.find(rootHash);
+        if (!c.path.isEmpty()) candidates.append(c);
+    }
+    if (candidates.isEmpty()) {
+        if (onVerified) onVerified({});
+        return;
+    }
+
+    // Re-hashing whole artifacts is the slow part; the pool does it and
+    // the continuation comes back on this thread (or not at all, if the
+    // backend is gone by then).
+    auto promise = std::make_shared<QPromise<QList<bool>>>();
+    QFuture<QList<bool>> future = promise->future();
+    promise->start();
+    QThreadPool::globalInstance()->start([promise, candidates]() {
+        QList<bool> ok;
+        ok.reserve(candidates.size());
+        for (const ArtifactCache::Candidate& c : candidates) ok.append(ArtifactCache::verify(c));
+        promise->addResult(ok);
+        promise->finish();
+    });
+    future.then(this, [this, candidates, onVerified](const QList<bool>& ok) {
+        QHash<QString, QString> paths;
+        for (int i = 0; i < candidates.size(); ++i) {
+            const ArtifactCache::Candidate& c = candidates.at(i);
+            if (ok.at(i)) {
+                m_artifactCache.markUsed(c.rootHash);
+                paths.insert(c.rootHash, c.path);
+            } else {
+                qWarning() << "ArtifactCache: dropping corrupt entry for" << c.rootHash;
+                m_artifactCache.remove(c.rootHash);
+            }
+        }
+        if (onVerified) onVerified(paths);
+    });
+}
+
+void PackageManagerBackend::storeArtifacts(const QVariantList& results)
+{
+    // Only downloader results reach here, so each path holds the bytes
+    // the downloader checked against that rootHash. Entries without a
+    // rootHash can't be addressed and are skipped.
+    QList<QPair<QString, QString>> pending;   // rootHash, path
+    for (const QVariant& v : results) {
+        const QVariantMap m = v.toMap();
+        const QString rootHash = m.value("rootHash").toString();
+        const QString path = m.value("path").toString();
+        if (rootHash.isEmpty() || path.isEmpty() || m.contains("error")) continue;
+        if (m_artifactCache.contains(rootHash)) {
+            m_artifactCache.markUsed(rootHash);
+            continue;
+        }
+        pending.append({rootHash, path});
+    }
+    if (pending.isEmpty()) return;
+
+    // Copy + hash on the pool, index here. stage() only reads the
+    // directory and cap, so the worker gets a bare cache of its own
+    // rather than a reference into this object.
+    m_artifactCache.load();
+    const ArtifactCache stager(m_artifactCache.directory(), m_artifactCache.maxBytes());
+    auto promise = std::make_shared<QPromise<QList<ArtifactCache::Staged>>>();
+    QFuture<QList<ArtifactCache::Staged>> future = promise->future();
+    promise->start();
+    QThreadPool::globalInstance()->start([promise, stager, pending]() {
+        QList<ArtifactCache::Staged> staged;
+        staged.reserve(pending.size());
+        for (const auto& p : pending) staged.append(stager.stage(p.first, p.second));
+        promise->addResult(staged);
+        promise->finish();
+    });
+    future.then(this, [this](const QList<ArtifactCache::Staged>& staged) {
+        for (const ArtifactCache::Staged& s : staged) m_artifactCache.commit(s);
     });
 }
 
+void PackageManagerBackend::cancelDownload(QString packageName)
+{
+    const QList<quint64> tickets = m_downloads.ticketsFor(packageName);
+    for (quint64 ticket : tickets)
+        cancelDownloadRequest(ticket, QStringLiteral("Download cancelled"));
+}
+
 void PackageManagerBackend::subscribePackageManagerUpgradeEvents()
 {
     if (!packageManagerReady()) return;
 
-    LogosModules& logos = modules();
     QPointer<PackageManagerBackend> self(this);
 
     // upgradeUninstallDone fires after confirmUpgrade removes the old version.
     // Payload: JSON-encoded { name, releaseTag, mode }. PMU drives the
     // download+install of the new version.
-    logos.package_manager.on("upgradeUninstallDone",
+    m_modules->onManagerEvent(QStringLiteral("upgradeUninstallDone"),
         [self](const QVariantList& data) {
             if (!self) return;
             const QJsonObject obj = parseEventPayload(data);
@@ -1862,7 +2927,7 @@ void PackageManagerBackend::subscribePackageManagerUpgradeEvents()
     // through the gate. Payload: { name, releaseTag, repositoryUrl }. PMU runs
     // the actual download+install — the sibling of onUpgradeUninstallDone for
     // the no-old-version-to-remove case.
-    logos.package_manager.on("installApproved",
+    m_modules->onManagerEvent(QStringLiteral("installApproved"),
         [self](const QVariantList& data) {
             if (!self) return;
             const QJsonObject obj = parseEventPayload(data);
@@ -1877,10 +2942,18 @@ void PackageManagerBackend::onInstallApproved(const QString& name,
                                               const QString& releaseTag,
                                               const QString& repositoryUrl)
 {
+    // A rollback restoring a package the upgrade gate had removed.
+    const QString restoreTxn = m_pendingRestores.take(name);
+    if (!restoreTxn.isEmpty()) {
+        runRestore(restoreTxn);
+        return;
+    }
+
     // Local .lgx: the file is already on disk, so there's nothing to download.
     // Hand a synthetic download-result entry (the shape installOnePackage
     // reads) straight to the sequential installer.
     if (m_pendingLocalInstalls.contains(name)) {
+        if (approveLocalBatchEntry(name)) return;
         const QVariantMap entry{
             {QStringLiteral("name"), name},
             {QStringLiteral("path"), m_pendingLocalInstalls.take(name)},
@@ -1900,6 +2973,14 @@ void PackageManagerBackend::onUpgradeUninstallDone(const QString& moduleName,
                                                     const QString& releaseTag,
                                                     int mode)
 {
+    // A rollback putting the prior version back over the newer copy;
+    // the host has just removed that copy.
+    const QString restoreTxn = m_pendingRestores.take(moduleName);
+    if (!restoreTxn.isEmpty()) {
+        runRestore(restoreTxn);
+        return;
+    }
+
     const QString mapped = m_packageModel
         ? m_packageModel->displayNameForModule(moduleName) : QString();
     const QString displayName = mapped.isEmpty() ? moduleName : mapped;
@@ -1929,13 +3010,15 @@ void PackageManagerBackend::onUpgradeUninstallDone(const QString& moduleName,
     // was the whole point of routing through the upgrade gate. The replacement
     // is already on disk \u2014 install it directly, no download round-trip.
     if (m_pendingLocalInstalls.contains(moduleName)) {
-        m_pendingUpgradeByModule.remove(moduleName);
+        if (approveLocalBatchEntry(moduleName)) return;
+        const PendingUpgradeMeta localMeta = m_pendingUpgradeByModule.take(moduleName);
         const QVariantMap entry{
             {QStringLiteral("name"), moduleName},
             {QStringLiteral("path"), m_pendingLocalInstalls.take(moduleName)},
         };
         markEntriesInstalling({entry});
-        installResultsSequential({entry}, displayName, 0);
+        installResultsSequential({entry}, displayName, 0,
+            beginInstallTransaction({entry}, removedPriorFor(moduleName, moduleName, localMeta)));
         return;
     }
 
@@ -1970,13 +3053,12 @@ void PackageManagerBackend::onUpgradeUninstallDone(const QString& moduleName,
     spec.name          = displayName;
     spec.repositoryUrl = meta.repositoryUrl;  // empty = no pin (bare upgrade)
     spec.version       = releaseTag;          // empty = newest matching
-    const QString depsJson = buildDepsJson({spec});
 
-    LogosModules& logos = modules();
     QPointer<PackageManagerBackend> self(this);
-    logos.package_downloader.downloadResolvedDependenciesAsync(depsJson, buildInstalledPackagesJson(),
-        [self, displayName, mode, includeDeps = meta.includeDeps]
-        (QVariantList results) {
+    downloadResolved({spec},
+        [self, displayName, mode, includeDeps = meta.includeDeps,
+         priors = removedPriorFor(displayName, moduleName, meta)]
+        (const QVariantList& results) {
             if (!self) return;
             // Filter to top-level entries when the user opted out of
             // deps. Without this, an upgrade with a new transitive dep
@@ -1998,14 +3080,15 @@ void PackageManagerBackend::onUpgradeUninstallDone(const QString& moduleName,
             // loop, not lazy per-entry transitions the user might
             // miss if any one finishes too fast to register.
             self->markEntriesInstalling(toInstall);
-            self->installResultsSequential(toInstall, displayName, 0);
+            self->installResultsSequential(toInstall, displayName, 0,
+                                           self->beginInstallTransaction(toInstall, priors));
             // Refresh is driven by the corePluginFileInstalled event
             // package_manager emits per file, which arms the debounce
             // timer — same path the install flow uses. No explicit
             // refreshPackages() here so we don't race the sequential
             // loop's mid-flight model writes.
             Q_UNUSED(mode);
-        }, Timeout(DOWNLOAD_TIMEOUT_MS));
+        });
 }
 
 // ── Navigation ─────────────────────────────────────────────────────────────
@@ -2026,3 +3109,18 @@ QString PackageManagerBackend::displayNameForModule(QString moduleName)
     const QString display = m_packageModel->displayNameForModule(moduleName);
     return display.isEmpty() ? moduleName : display;
 }
+
+QStringList PackageManagerBackend::dependentsOf(QString name, bool installedOnly)
+{
+    return m_depGraph.dependents(name, installedOnly);
+}
+
+QStringList PackageManagerBackend::dependencyClosure(QString name, QString version)
+{
+    return m_depGraph.dependencyClosure(name, version);
+}
+
+QStringList PackageManagerBackend::dependentClosure(QString name)
+{
+    return m_depGraph.dependentClosure(name);
+}
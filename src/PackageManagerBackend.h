@@ -1,7 +1,11 @@
 #pragma once
 
 #include <functional>
+#include <memory>
+#include <QCache>
+#include <QElapsedTimer>
 #include <QObject>
+#include <QSet>
 #include <QTimer>
 #include <QVariantList>
 #include <QVariantMap>
@@ -9,10 +13,22 @@
 #include "logos_api.h"
 #include "logos_api_client.h"
 #include "logos_ui_plugin_context.h"
+#include "ArtifactCache.h"
+#include "CatalogInterner.h"
+#include "DependencyGraph.h"
+#include "DownloadProgressTracker.h"
+#include "DownloadSharing.h"
+#include "InstallJournal.h"
+#include "InstalledSnapshot.h"
+#include "LocalDependencyResolver.h"
+#include "LocalInstallBatch.h"
+#include "ModuleGateway.h"
 #include "PackageListModel.h"
+#include "PackageRowBuilder.h"
 #include "PackagesFilterProxy.h"
 #include "PackagesPagingProxy.h"
 #include "PackageTypes.h"
+#include "PerfStats.h"
 #include "rep_package_manager_ui_source.h"
 
 // Source-side implementation of the PackageManagerUi .rep interface.
@@ -24,7 +40,11 @@
 // two declared dependencies (package_manager, package_downloader) — plus the
 // onContextReady() hook. The generated view-plugin glue
 // (generated_code/package_manager_ui_ui_glue.cpp) owns the LogosAPI and wires
-// it in; this class never receives one directly.
+// it in; this class never receives one directly. Every call into those
+// modules goes through m_modules (a ModuleGateway), which is the SDK
+// wrappers in production and the in-process stand-ins when a
+// PMU_WITH_STANDIN_MODULES build runs with PMU_STANDIN_MODULES set, or a
+// test passes its own gateway.
 class PackageManagerBackend : public PackageManagerUiSimpleSource,
                               public LogosUiPluginContext {
     Q_OBJECT
@@ -32,6 +52,12 @@ class PackageManagerBackend : public PackageManagerUiSimpleSource,
 
 public:
     explicit PackageManagerBackend(QObject* parent = nullptr);
+    // Headless: drive the backend against `modules` (typically a
+    // StandInModuleGateway) with no host. Null = pick by environment, as
+    // the default constructor does. A non-SDK gateway starts the initial
+    // load itself instead of waiting for onContextReady().
+    explicit PackageManagerBackend(std::unique_ptr<ModuleGateway> modules,
+                                   QObject* parent = nullptr);
     ~PackageManagerBackend() = default;
 
     QAbstractItemModel* packages() const;
@@ -47,22 +73,31 @@ public slots:
     // Overrides of the pure-virtual slots generated from the .rep.
     // See package_manager_ui.rep for per-slot documentation.
     void refreshCatalog() override;
+    void refreshRepository(QString repositoryUrl) override;
     // Install a .lgx the user picked off disk.
     void installLocalPackage(QUrl fileUrl) override;
+    // Many .lgx files and/or directories of them, as one batch.
+    void installLocalPackages(QVariantList fileUrls) override;
     // Bulk: run each selected row's resolved primary action (the new
     // "Run Actions" header button). Subsumes the old installSelected
     // path AND adds upgrade / downgrade / reinstall to the bulk surface.
     void runSelectedActions() override;
+    // Plans with UpgradePlanner against the local catalog index and the
+    // installed snapshot, then hands the plan to runBatchedDepPreview.
+    void upgradeAll() override;
     void installSelected() override;   // kept for back-compat, unwired from UI
     void uninstallSelected() override; // kept for back-compat, unwired from UI
     void togglePackage(int index, bool checked) override;
     void installPackage(int index) override;
+    void cancelDownload(QString packageName) override;
     void reloadPackage(int index) override;
     void uninstall(int index) override;
     void upgradePackage(int index) override;
     void downgradePackage(int index) override;
     void sidegradePackage(int index) override;
     void requestPackageDetails(int index) override;
+    void setSourceCollapsed(QString section, bool collapsed) override;
+    void resolveInterruptedInstalls(bool rollBack) override;
 
     // Resolver-confirm responses. See `installDepsConfirmationRequested`
     // in the .rep for the flow. The argument is the opaque requestKey
@@ -86,6 +121,13 @@ public slots:
     // QAbstractItemModel interface that gets remoted.
     QString displayNameForModule(QString moduleName) override;
 
+    // Dependency-graph lookups answered from m_depGraph — no IPC, so QML
+    // can call them synchronously while rendering. Names may be the
+    // catalog name or the moduleName; unknown names return empty lists.
+    QStringList dependentsOf(QString name, bool installedOnly) override;
+    QStringList dependencyClosure(QString name, QString version) override;
+    QStringList dependentClosure(QString name) override;
+
     // Emits navigateToRepositoriesRequested() across the QtRO boundary so
     // basecamp's ContentViews.qml can route to Settings → Repositories.
     void navigateToRepositories() override;
@@ -97,6 +139,16 @@ private:
 
     void refreshPackages();
 
+    // catalogChanged → getCatalogDelta(m_catalogDeltaGeneration), applied
+    // to m_allPackagesCache by applyCatalogDelta; falls back to a
+    // refreshPackages() through m_refreshDebounceTimer when the module
+    // can't describe the gap as a delta, or it's over
+    // kMaxCatalogDeltaGap generations. Skipped while that timer already
+    // has a refresh queued, and not used at all for a catalogChanged
+    // without a generation or once the module has shown it keeps none.
+    void pullCatalogDelta();
+    void applyCatalogDelta(const QVariantMap& delta);
+
     // Bulk install pipeline — sequential download+install of N packages,
     // gated by the global isInstalling flag (so the bulk Install button can
     // disable itself during a batch). Each spec pins the row's repo +
@@ -131,9 +183,14 @@ private:
     // Progress signals carry `topLevelName` so the UI banner stays
     // anchored to the row the user clicked, even while transitive deps
     // are mid-install.
+    //
+    // The chain is a journal transaction (`txn`; opened on index 0 when
+    // empty): each entry is marked Applied / Failed as it lands, and the
+    // first failure rolls back what the chain had already changed.
     void installResultsSequential(const QVariantList& results,
                                   const QString& topLevelName,
-                                  int index);
+                                  int index,
+                                  const QString& txn = QString());
 
     // Bulk-mark every entry's row as Installing — fired immediately
     // after the resolver returns so the UI shows the whole in-flight
@@ -190,10 +247,43 @@ private:
                                    const QHash<QString, QString>& installedByName,
                                    const QHash<QString, QString>& repoUrlToName) const;
 
-    // Serialise m_installedPackagesCache to the
-    // [{name, version, rootHash}] shape package_downloader.resolveDependencies
-    // expects in its `installedPackagesJson` parameter.
-    QString buildInstalledPackagesJson() const;
+    // repositoryUrl → repositoryDisplayName from the catalog cache (first
+    // non-empty label wins), the repo-label table computeDepChanges reads.
+    // Rebuilt into m_repoUrlToName once per refresh; previews borrow it.
+    void rebuildRepoUrlToNameIndex();
+
+    // package_downloader.resolveDependencies behind m_resolveCache. A hit
+    // invokes `onResolved` synchronously; a miss goes over IPC and stores
+    // the reply. Keyed by (canonical depsJson, installed-snapshot hash,
+    // m_catalogGeneration) — see resolveCacheKey — so any change to the
+    // request, the installed set or the catalog misses on its own; stale
+    // entries are never consulted, only evicted. Empty replies (transport
+    // failure) and replies carrying an `error` entry are not cached, so a
+    // retry still reaches the resolver.
+    //
+    // Concurrent requests for the same key share one IPC call: later
+    // callers attach to m_resolveWaiters instead of asking again, so a
+    // click on a row the pre-resolver is already working on just waits
+    // for that reply. `speculative` marks a pre-resolver call; a
+    // non-speculative (user-driven) call stops the pre-resolver and
+    // holds it off until every real resolution has come back.
+    void resolveDependenciesCached(const QString& depsJson,
+                                   const InstalledSnapshot::Ptr& installed,
+                                   std::function<void(const QVariantList&)> onResolved,
+                                   bool speculative = false);
+    QString resolveCacheKey(const QString& depsJson,
+                            const InstalledSnapshot& installed) const;
+
+    // Dependency resolution for the host-gate preview. A cached remote
+    // reply wins; otherwise m_localResolver answers synchronously from
+    // the catalog. Only when the local pass reports an error (unknown
+    // package, unsatisfiable range, conflict) does the request go to
+    // package_downloader via resolveDependenciesCached. The download
+    // itself always re-resolves remotely, so a local preview never
+    // decides what gets installed.
+    void resolveForPreview(const QList<PackageInstallSpec>& specs,
+                           const InstalledSnapshot::Ptr& installed,
+                           std::function<void(const QVariantList&)> onResolved);
 
     void setPackagesFromVariantList(const QVariantList& packagesArray,
                                     const QVariantList& installedPackages,
@@ -203,6 +293,9 @@ private:
     // (index 0 / out-of-range / "All" → empty filter).
     void applyCategoryFilter();
 
+    // "All" + sorted distinct (capitalised) `category` values.
+    void recomputeCategories(const QVariantList& packagesArray);
+
     // Rebuild availableTypes from m_allPackagesCache ("All" + sorted distinct
     // types). Clamps selectedTypeIndex to 0 if the prior pick is gone.
     void recomputeAvailableTypes();
@@ -293,6 +386,8 @@ private:
     PackageListModel*    m_packageModel;
     PackagesFilterProxy* m_packagesFilterProxy;
     PackagesPagingProxy* m_packagesPagingProxy;
+    // package_downloader / package_manager. Never null.
+    std::unique_ptr<ModuleGateway> m_modules;
     int m_reloadGeneration = 0;
 
     // Unfiltered catalog. Category / type filters run on the proxy without a
@@ -301,6 +396,57 @@ private:
     QVariantList m_installedPackagesCache;
     QStringList  m_validVariantsCache;
 
+    // Collapsed repositories by repositoryUrl, the empty URL for the
+    // local rows. `collapsedSources` is derived from it on every rebuild.
+    QSet<QString> m_collapsedRepoUrls;
+    // Coalesces the filter proxy's sourceGroupsChanged — one per row
+    // batch it inserts or removes — into one sourceGroupCounts push per
+    // turn of the event loop.
+    QTimer* m_sourceGroupCountsTimer = nullptr;
+    void publishSourceGroupCounts();
+
+    // Catalog rows per repository, keyed by its catalog fingerprint, so
+    // a refresh rebuilds only the repositories that changed. Install
+    // state is applied on top, so an install or removal reuses them.
+    packagerows::RepositoryRowCache m_rowCache;
+
+    // Pool the adopted catalog's strings and manifests are interned into;
+    // pruned after each adopt, once the rows of the previous one are gone.
+    // Opt-in (PMU_CATALOG_INTERN=1) until package_model_bench's
+    // internCatalog shows it saving memory on a deep-history catalog.
+    CatalogInterner m_interner;
+    bool m_internCatalog = false;
+    void pruneInterner();
+
+    // m_installedPackagesCache in resolver shape — JSON, fingerprint and
+    // name index — built once per refresh and patched copy-on-write by
+    // the install / uninstall events in between, so a preview right after
+    // an install already sees it. Never null. See InstalledSnapshot.
+    InstalledSnapshot::Ptr m_installedSnapshot = InstalledSnapshot::empty();
+    QHash<QString, QString> m_repoUrlToName;
+
+    // Forward / reverse dependency index over every catalog version and
+    // the installed set. Rebuilt with the catalog; its installed markers
+    // follow m_installedSnapshot through setInstalledSnapshot().
+    DependencyGraph m_depGraph;
+
+    // Catalog index for resolveForPreview. Rebuilt with the catalog.
+    LocalDependencyResolver m_localResolver;
+    void setInstalledSnapshot(InstalledSnapshot::Ptr snapshot);
+
+    // Bumped every time m_allPackagesCache is replaced. Part of the
+    // resolve-cache key: a resolution is only valid against the catalog
+    // it was computed from.
+    quint64 m_catalogGeneration = 0;
+
+    // Bounded LRU of resolveDependencies replies, keyed by
+    // resolveCacheKey(). QCache evicts least-recently-used entries once
+    // the total cost (one per entry) exceeds kResolveCacheCapacity.
+    // Cleared outright when the catalog generation moves, since no
+    // older entry can hit again.
+    static constexpr int kResolveCacheCapacity = 64;
+    QCache<QString, QVariantList> m_resolveCache{kResolveCacheCapacity};
+
     // Per-module upgrade meta captured at requestVersionChange time.
     //   repositoryUrl: scopes the post-uninstall download to the row's
     //     source repo, so a same-named package in another repo doesn't
@@ -315,6 +461,11 @@ private:
     struct PendingUpgradeMeta {
         QString repositoryUrl;
         bool    includeDeps = true;
+        // What was installed when the upgrade was requested — the gate
+        // removes it before upgradeUninstallDone, so this is the only
+        // record a rollback can restore from.
+        QString fromVersion;
+        QString fromRootHash;
     };
     QHash<QString, PendingUpgradeMeta> m_pendingUpgradeByModule;
 
@@ -324,6 +475,89 @@ private:
     // installApproved / upgradeUninstallDone).
     QHash<QString, QString> m_pendingLocalInstalls;
 
+    // Install transactions (see InstallJournal). beginInstallTransaction
+    // journals every entry of an install chain with its prior version
+    // (from the installed snapshot, or `removedPriors` for a package the
+    // upgrade gate already uninstalled); rollbackInstallTransaction undoes
+    // the applied steps from the artifact cache; recoverInstallJournal
+    // runs once, after the first refresh, and publishes what a crash
+    // left open as interruptedInstalls for the user to resolve.
+    QString beginInstallTransaction(const QVariantList& results,
+                                    const QHash<QString, InstallJournal::Step>& removedPriors = {});
+    static QHash<QString, InstallJournal::Step> removedPriorFor(const QString& name,
+                                                                const QString& moduleName,
+                                                                const PendingUpgradeMeta& meta);
+    void rollbackInstallTransaction(const QString& txn, const QString& topLevelName);
+    void recoverInstallJournal();
+    InstallJournal m_installJournal;
+    bool           m_installJournalRecovered = false;
+
+    // A rollback in flight. Restores reinstall a prior artifact from the
+    // cache, one at a time, each through the host's gate like any other
+    // version change (rollbackNext → requestRestoreGate → the gate's
+    // approval event → runRestore → restoreFinished → rollbackNext);
+    // removals go out in one requestMultiUninstall at the end.
+    struct RollbackRestore {
+        QString name;           // catalog name (journal + model key)
+        QString moduleName;
+        QString path;           // verified cached artifact
+        QString version;
+        // The newer copy is still installed (the step applied), so the
+        // restore is a downgrade over it; otherwise the gate already
+        // removed it and the restore is a fresh install.
+        QString replacesVersion;
+    };
+    struct RollbackRun {
+        QString                topLevelName;
+        QList<RollbackRestore> restores;
+        int                    index = 0;
+        QStringList            restored;
+        QStringList            removals;
+        QVariantList           notRestored;   // { name, version, reason }
+    };
+    QHash<QString, RollbackRun> m_rollbacks;   // by transaction id
+    void rollbackNext(const QString& txn);
+    void requestRestoreGate(const QString& txn, const RollbackRestore& restore);
+    void runRestore(const QString& txn);
+    void restoreFinished(const QString& txn, bool success, const QString& err);
+
+    // Restores waiting on the host gate, keyed by the name handed to
+    // requestUpgrade (moduleName) / requestInstall (catalog name) —
+    // what upgradeUninstallDone / installApproved echo back. Value is
+    // the transaction id; the restore itself is m_rollbacks[txn]'s
+    // current one.
+    QHash<QString, QString> m_pendingRestores;
+
+    // Opens the package_manager gate for one inspected local file:
+    // requestInstall for a fresh name, requestUpgrade (with the mode
+    // derived from the installed version) over an existing copy.
+    void requestLocalInstallGate(const QString& name, const QString& version,
+                                 bool alreadyInstalled, const QString& installedVersion,
+                                 const QString& changesJson);
+
+    // Batch local install (installLocalPackages). All files are inspected
+    // concurrently; once the last reply lands m_localBatch orders the
+    // batch deps-first (see LocalInstallBatch) and every entry's gate is
+    // requested with the whole change list on the first request.
+    // Approved entries install as soon as their in-batch dependencies
+    // have installed, up to kMaxParallelLocalInstalls at a time;
+    // dependents of a failed entry are skipped and reported. The batch
+    // holds isInstalling from the first inspect until the last gate is
+    // answered. One batch at a time; the generation drops replies from a
+    // batch that was replaced.
+    static constexpr int kMaxParallelLocalInstalls = 4;
+    LocalInstallBatch m_localBatch;
+    int               m_localBatchGeneration = 0;
+
+    void onLocalBatchInspected(const QString& file, const QVariantMap& info);
+    void planLocalBatch();
+    // installApproved / upgradeUninstallDone for a batch member; false
+    // when `name` isn't part of the running batch.
+    bool approveLocalBatchEntry(const QString& name);
+    void pumpLocalBatch();
+    void finishLocalBatchEntry(const QString& name, bool success, const QString& error);
+    void closeLocalBatch();
+
     // Pending dep-confirm requests, keyed by an opaque requestKey
     // (repositoryUrl + '\n' + name — see depConfirmKey()). Populated by
     // runDepPreviewForAction when the resolver returns transitive
@@ -343,10 +577,132 @@ private:
     };
     QHash<QString, PendingDepConfirm> m_pendingDepConfirms;
 
-    // Coalesces N rapid file-install / file-uninstall events into one
-    // refreshPackages() — does NOT touch releases or selected-release state.
+    // Bulk counterpart of runDepPreviewForAction for the Upgrade /
+    // Downgrade / Reinstall rows of runSelectedActions. Resolves every
+    // entry in ONE resolveDependencies call (one installed snapshot, one
+    // pair of lookup tables), merges the transitive changes into a single
+    // de-duplicated list, then dispatches each entry through
+    // dispatchPendingAction. package_manager has no multi-module upgrade
+    // gate, so each module still gets its own requestUpgrade, carrying
+    // the changes attributed to that row (by its local dependency
+    // closure; unattributed ones go on every row) — so whichever dialogs
+    // the user declines, each approved one listed what it brings in. A
+    // one-entry batch falls through to the per-row preview unchanged.
+    void runBatchedDepPreview(const QList<PendingDepConfirm>& batch);
+
+    // UpgradeMode → PendingDepConfirm::Action. Shared by the per-row
+    // (requestVersionChange) and bulk (runSelectedActions) paths.
+    static int actionKindForMode(UpgradeMode mode);
+
+    // Coalesces N rapid file-install / file-uninstall events — and a
+    // catalog delta's full-fetch fallback — into one refreshPackages().
+    // Does NOT touch releases or selected-release state.
     QTimer* m_refreshDebounceTimer = nullptr;
 
+    // Coalesces catalogChanged events into one pullCatalogDelta().
+    QTimer* m_catalogDeltaTimer = nullptr;
+    // Catalog generation m_allPackagesCache reflects, as getCatalogDelta
+    // last reported it (-1 = unknown: the next pull fetches in full), and
+    // the newest one a catalogChanged payload announced.
+    qint64 m_catalogDeltaGeneration     = -1;
+    qint64 m_catalogAnnouncedGeneration = -1;
+    // Cleared when getCatalogDelta answers `full` without a generation;
+    // from then on catalogChanged goes straight to m_refreshDebounceTimer.
+    bool   m_catalogDeltaSupported      = true;
+    static constexpr qint64 kMaxCatalogDeltaGap = 64;
+
+    // Idle-time speculative dependency pre-resolution. After the view
+    // settles (page flip, filter change, selection change, refresh) the
+    // pre-resolver walks the visible page plus the selected rows, picks
+    // the ones a click would resolve next — Install rows, rows with
+    // `updateAvailable`, selected runnable rows — and warms
+    // m_resolveCache for each row's pinned (repo, version). The click
+    // then hits the cache and dispatches to the gate with no resolver
+    // wait. At most kMaxSpeculativeResolves calls are in flight, none
+    // are started while a user-driven resolution is pending, and the
+    // queue is dropped as soon as the user starts a real action.
+    void schedulePreResolve();
+    void runPreResolvePass();
+    void pumpPreResolveQueue();
+    void stopPreResolve();
+
+    static constexpr int kMaxSpeculativeResolves = 2;
+    QTimer*     m_preResolveTimer = nullptr;
+    QStringList m_preResolveQueue;          // depsJson per candidate row
+    InstalledSnapshot::Ptr m_preResolveInstalled;  // snapshot the pass was built against
+    int         m_preResolveInFlight   = 0;
+    int         m_realResolvesInFlight = 0;
+
+    // In-flight resolveDependencies calls by resolve-cache key → callers
+    // waiting on that reply. See resolveDependenciesCached.
+    QHash<QString, QList<std::function<void(const QVariantList&)>>> m_resolveWaiters;
+
+    // Byte-level download progress. Every downloadResolvedDependencies
+    // call is bracketed by begin/endDownloadTracking; while any are in
+    // flight, the downloader's downloadProgress events feed
+    // m_downloadProgress and m_downloadProgressTimer publishes the
+    // aggregate to the downloadProgress PROP at most once per
+    // kDownloadProgressPublishMs, however fast chunks arrive.
+    void beginDownloadTracking();
+    void endDownloadTracking();
+    // downloadProgress = the tracker's figures plus `packages`, the
+    // top-level names still waiting on a download (what cancelDownload
+    // can act on).
+    void publishDownloadProgress();
+
+    // The one way artifacts reach the installer. Each top-level spec the
+    // local resolver can pin (name@version/rootHash, same installed
+    // snapshot) that is already on a call in flight attaches to that
+    // call and takes its packages from the reply; the remaining specs go
+    // to package_downloader as one call, which resolves their deps. Before
+    // a new call goes out, one whose downloader resolution is
+    // entirely in m_artifactCache — verified off the GUI thread — is
+    // served from disk instead. The callback gets the downloader's
+    // result shape. Returns a ticket for cancelDownloadRequest.
+    quint64 downloadResolved(const QList<PackageInstallSpec>& specs,
+                             std::function<void(const QVariantList&)> onResults);
+    // Detach one requester: its callback fires now with a `reason` error
+    // per top-level; every other requester of its calls is unaffected.
+    // A call left with no requesters can't be aborted over IPC — it
+    // finishes in the background and still fills the cache.
+    void cancelDownloadRequest(quint64 ticket, const QString& reason);
+
+    void startDownloadCall(int callId, const QList<PackageInstallSpec>& specs,
+                           const QString& depsJson, const InstalledSnapshot::Ptr& installed);
+    void sendDownloadCall(int callId, const QString& depsJson,
+                          const InstalledSnapshot::Ptr& installed);
+    void finishDownloadCall(int callId, const QVariantList& results);
+    DownloadSharing m_downloads;
+
+    // ArtifactCache's slow halves on the thread pool. verifyCachedArtifacts
+    // answers, back on this thread, with rootHash → path for the entries
+    // that still match their pinned digest (the rest are evicted);
+    // storeArtifacts stages downloader results there and commits them
+    // here.
+    void verifyCachedArtifacts(const QStringList& rootHashes,
+                               std::function<void(const QHash<QString, QString>&)> onVerified);
+    void storeArtifacts(const QVariantList& results);
+
+    ArtifactCache m_artifactCache;
+
+    static constexpr int kDownloadProgressPublishMs = 250;
+    DownloadProgressTracker m_downloadProgress;
+    QElapsedTimer           m_downloadClock;
+    QTimer*                 m_downloadProgressTimer = nullptr;
+    int                     m_downloadsInFlight     = 0;
+
+    // Hot-path timing (PerfStats.h), off unless PMU_PERF_STATS /
+    // PMU_TRACE_FILE is set. Enabled, m_modules is wrapped in a
+    // TimedModuleGateway and m_perfPublishTimer pushes the percentiles
+    // to the perfStats PROP once a second when anything new was
+    // recorded. Shared with that gateway, whose replies may outlive us.
+    static constexpr int kPerfPublishMs = 1000;
+    std::shared_ptr<PerfStats> m_perf;
+    QTimer*                    m_perfPublishTimer = nullptr;
+    // Construction → first non-empty table ("startup.firstRows"); -1
+    // once recorded, or when timing is off.
+    qint64                     m_firstRowsBegan   = -1;
+
     void finishInitialSetup(int attempt = 0);
     bool m_initialSetupComplete = false;
 
@@ -0,0 +1,690 @@
+#include "PackageRowBuilder.h"
+
+#include <algorithm>
+#include <utility>
+
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QIODevice>
+#include <QSet>
+
+#include "PackageTypes.h"
+#include "RowActionResolver.h"   // versionCmp + resolveRowAction (shared with PackageListModel)
+
+namespace packagerows {
+
+namespace {
+
+// Split a variant string into (base, flavor). Variants are formatted as
+// "<os>-<arch>" (release build, no flavor suffix) or "<os>-<arch>-<flavor>"
+// where <flavor> is one of a known set ("dev", "portable")
+std::pair<QString, QString> splitVariant(const QString& v)
+{
+    static const QSet<QString> kKnownFlavors = {
+        QStringLiteral("dev"), QStringLiteral("portable")
+    };
+    const int lastDash = v.lastIndexOf(QLatin1Char('-'));
+    if (lastDash <= 0) return {v, QString()};
+    const QString trailing = v.mid(lastDash + 1);
+    if (kKnownFlavors.contains(trailing)) {
+        return {v.left(lastDash), trailing};
+    }
+    return {v, QString()};
+}
+
+// Classify why a package's offered variants don't intersect the platform's
+// valid variants. The QML side (ActionPill, when rowAction==NotAvailable)
+// maps the enum to user-facing copy via its tooltip.
+//   - NoVariantsPublished: nothing offered — nothing to install anywhere.
+//   - BuildFlavorMismatch: platform IS offered, wrong flavor (dev/portable/
+//     release). User can switch basecamp build flavor to recover.
+//   - PlatformMismatch: OS/arch not offered. User can't recover.
+PackageTypes::NotAvailableReason classifyNotAvailable(
+    const VariantMask::Bits& offered, const VariantMask& variants)
+{
+    if (!offered.offered) return PackageTypes::NoVariantsPublished;
+    if (variants.matchesBase(offered)) return PackageTypes::BuildFlavorMismatch;
+    return PackageTypes::PlatformMismatch;
+}
+
+// The module a catalog row installs as: the row's own `moduleName`, else
+// the newest version's manifest name, else the catalog `name`. Installed
+// packages are indexed by this, so lookups and the local-row dedupe
+// have to use it rather than `name`.
+QString catalogModuleName(const QVariantMap& obj, const QVariantMap& manifest)
+{
+    QString moduleName = obj.value("moduleName").toString();
+    if (moduleName.isEmpty()) moduleName = manifest.value("name").toString();
+    if (moduleName.isEmpty()) moduleName = obj.value("name").toString();
+    return moduleName;
+}
+
+QVariantMap newestManifest(const QVariantMap& obj)
+{
+    const QVariantList versions = obj.value("versions").toList();
+    if (versions.isEmpty()) return {};
+    return versions.first().toMap().value("manifest").toMap();
+}
+
+// What the filter proxy matches a collapsed group's row on (see
+// buildGroupPlaceholderRow), with buildCatalogRow's field fallbacks.
+QVariantMap groupMember(const QVariantMap& obj, const QVariantMap& manifest, bool installed)
+{
+    auto field = [&](const char* key) {
+        const QString v = obj.value(key).toString();
+        return v.isEmpty() ? manifest.value(key).toString() : v;
+    };
+    return {
+        {"name",          obj.value("name").toString()},
+        {"description",   field("description")},
+        {"type",          field("type")},
+        {"category",      field("category")},
+        {"installStatus", static_cast<int>(installed ? PackageTypes::Installed
+                                                     : PackageTypes::NotInstalled)},
+    };
+}
+
+} // namespace
+
+VariantMask::VariantMask(const QStringList& validVariants)
+{
+    for (const QString& v : validVariants) {
+        if (!m_variantBit.contains(v)) {
+            if (m_variantBit.size() < 64) m_variantBit.insert(v, int(m_variantBit.size()));
+            else                          m_extraVariants.insert(v);
+        }
+        const QString base = splitVariant(v).first;
+        if (!m_baseBit.contains(base)) {
+            if (m_baseBit.size() < 64) m_baseBit.insert(base, int(m_baseBit.size()));
+            else                       m_extraBases.insert(base);
+        }
+    }
+    for (const QString& v : validVariants) {
+        const Bits b = encodeOne(v);
+        m_valid.variants |= b.variants;
+        m_valid.bases    |= b.bases;
+    }
+}
+
+VariantMask::Bits VariantMask::encodeOne(const QString& variant) const
+{
+    const auto memo = m_memo.constFind(variant);
+    if (memo != m_memo.constEnd()) return *memo;
+
+    Bits b;
+    b.offered = true;
+    const auto vit = m_variantBit.constFind(variant);
+    if (vit != m_variantBit.constEnd()) b.variants = quint64(1) << *vit;
+    else b.extraVariant = m_extraVariants.contains(variant);
+    const QString base = splitVariant(variant).first;
+    const auto bit = m_baseBit.constFind(base);
+    if (bit != m_baseBit.constEnd()) b.bases = quint64(1) << *bit;
+    else b.extraBase = m_extraBases.contains(base);
+    m_memo.insert(variant, b);
+    return b;
+}
+
+VariantMask::Bits VariantMask::encode(const QVariantMap& mainMap) const
+{
+    Bits out;
+    for (auto it = mainMap.constBegin(); it != mainMap.constEnd(); ++it) {
+        if (it.key().isEmpty()) continue;
+        const Bits b = encodeOne(it.key());
+        out.variants |= b.variants;
+        out.bases    |= b.bases;
+        out.offered   = true;
+        out.extraVariant = out.extraVariant || b.extraVariant;
+        out.extraBase    = out.extraBase || b.extraBase;
+    }
+    return out;
+}
+
+// Cross-reference a catalog row against the on-disk install state. Reads
+// the row's newest `version` / `hash` and `isVariantAvailable`, so it
+// runs on a buildCatalogRow result, before any dropdown pick.
+void applyInstalledState(QVariantMap& pkg, const QVariantMap* installed)
+{
+    const QString releaseVersion = pkg.value("version").toString();
+    const QString releaseHash    = pkg.value("hash").toString();
+    const bool isInstalled = installed != nullptr;
+    QString installedVersion;
+    QString installedHash;
+    QString installType;
+    if (isInstalled) {
+        installedVersion = installed->value("version").toString();
+        installedHash = installed->value("hashes").toMap().value("root").toString();
+        // "embedded" or "user" — QML gates Uninstall on installType === "user".
+        installType = installed->value("installType").toString();
+    }
+    pkg["installedVersion"] = installedVersion;
+    pkg["installedHash"] = installedHash;
+    pkg["installType"] = installType;
+
+    // Resolve install status. Embedded vs user doesn't change the status itself —
+    // the QML side gates the Uninstall button on installType separately.
+    int status = static_cast<int>(PackageTypes::NotInstalled);
+    if (isInstalled) {
+        if (releaseVersion.isEmpty() || installedVersion.isEmpty()) {
+            // No version info to compare — assume same.
+            status = static_cast<int>(PackageTypes::Installed);
+        } else {
+            const int cmp = rowaction::versionCmp(installedVersion, releaseVersion);
+            if (cmp < 0)      status = static_cast<int>(PackageTypes::UpgradeAvailable);
+            else if (cmp > 0) status = static_cast<int>(PackageTypes::DowngradeAvailable);
+            else if (!releaseHash.isEmpty() && !installedHash.isEmpty()
+                     && releaseHash != installedHash)
+                              status = static_cast<int>(PackageTypes::DifferentHash);
+            else              status = static_cast<int>(PackageTypes::Installed);
+        }
+    }
+    pkg["installStatus"] = status;
+
+    // ── Action-column inputs ────────────────────────────────────────
+    // `rowAction` is the per-row primary action, resolved against the
+    // INITIAL selected version (newest, i.e. versions[0]). It will be
+    // recomputed by PackageListModel::setRowVersion() whenever the
+    // user moves the dropdown — same helper, same inputs, fresh values.
+    //
+    // `updateAvailable` is a separate signal that stays put even as the
+    // dropdown moves: it reflects "a strictly-newer-than-installed
+    // version exists in the catalog", and drives the small marker on
+    // the Version cell. Computed once here.
+    pkg["rowAction"] = rowaction::resolveRowAction(
+        isInstalled, pkg.value("isVariantAvailable").toBool(), status,
+        installedVersion, installedHash,
+        /*selectedVersion=*/releaseVersion,
+        /*selectedHash=*/releaseHash);
+    pkg["updateAvailable"] = rowaction::hasUpdateAvailable(
+        isInstalled, installedVersion, /*newestCatalogVersion=*/releaseVersion);
+}
+
+// Build one model row from one raw catalog row + the installed-by-name index +
+// the valid-variants list for this platform. Pure transform; no instance state.
+//
+// Each catalog row has the multi-repo `index.json` shape produced by
+// `package_downloader.getCatalog()`: a `versions[]` array (sorted newest-
+// first) where every entry carries the embedded `manifest` for that
+// version, plus a small set of header fields (`name`, `description`,
+// `type`, `category`, `repositoryUrl`, `repositoryName`, …) that
+// `getCatalogJson` lifts from `versions[0].manifest` for convenience.
+// We pick `versions[0]` as the selected version (newest); a future
+// per-row picker can swap the index without changing this transform.
+QVariantMap buildPackageRow(const QVariantMap& obj,
+                            const QHash<QString, QVariantMap>& installedByName,
+                            const QStringList& validVariants)
+{
+    return buildPackageRow(obj, installedByName, VariantMask(validVariants));
+}
+
+QVariantMap buildPackageRow(const QVariantMap& obj,
+                            const QHash<QString, QVariantMap>& installedByName,
+                            const VariantMask& variants)
+{
+    QVariantMap pkg = buildCatalogRow(obj, variants);
+    const auto inst = installedByName.constFind(pkg.value("moduleName").toString());
+    applyInstalledState(pkg, inst == installedByName.constEnd() ? nullptr : &*inst);
+    return pkg;
+}
+
+QVariantMap buildCatalogRow(const QVariantMap& obj, const VariantMask& variants)
+{
+    QVariantMap pkg;
+    const QString name = obj.value("name").toString();
+
+    const QVariantList rawVersions = obj.value("versions").toList();
+    QVariantMap selectedVersion;
+    if (!rawVersions.isEmpty()) selectedVersion = rawVersions.first().toMap();
+
+    // Manifest of the selected (newest) version — every per-row field
+    // not surfaced at the catalog-row top level is read from here.
+    const QVariantMap manifest = selectedVersion.value("manifest").toMap();
+
+    const QString moduleName = catalogModuleName(obj, manifest);
+
+    QString displayName = obj.value("displayName").toString();
+    if (displayName.isEmpty()) displayName = manifest.value("display_name").toString();
+    if (displayName.isEmpty()) displayName = moduleName;
+
+    pkg["name"] = name;
+    pkg["moduleName"] = moduleName;
+    pkg["displayName"] = displayName;
+    // Header fields: prefer the catalog-row's lifted copy (which
+    // getCatalogJson sets from versions[0].manifest), fall back to the
+    // manifest itself if the catalog row didn't surface the field.
+    pkg["description"] = obj.value("description").toString().isEmpty()
+                         ? manifest.value("description").toString()
+                         : obj.value("description").toString();
+    pkg["type"] = obj.value("type").toString().isEmpty()
+                  ? manifest.value("type").toString()
+                  : obj.value("type").toString();
+    pkg["category"] = obj.value("category").toString().isEmpty()
+                      ? manifest.value("category").toString()
+                      : obj.value("category").toString();
+
+    pkg["repositoryUrl"]         = obj.value("repositoryUrl").toString();
+    pkg["repositoryName"]        = obj.value("repositoryName").toString();
+    pkg["repositoryDisplayName"] = obj.value("repositoryDisplayName").toString();
+
+    // Trim each entry of versions[] into a model-friendly shape.
+    QVariantList availableVersions;
+    for (const QVariant& vv : rawVersions) {
+        const QVariantMap vm = vv.toMap();
+        const QVariantMap vManifest = vm.value("manifest").toMap();
+        QVariantMap entry;
+        entry["version"]      = vManifest.value("version").toString();
+        entry["rootHash"]     = vm.value("rootHash").toString();
+        entry["releasedAt"]   = vm.value("releasedAt").toString();
+        entry["size"]         = vm.value("size");
+        entry["publisherRef"] = vm.value("publisherRef").toString();
+        entry["url"]          = vm.value("url").toString();
+        entry["signed"]       = vm.contains("signature");
+        entry["signerDid"]    = vm.value("signature").toMap().value("did").toString();
+        entry["manifest"]     = vManifest;
+        availableVersions.append(entry);
+    }
+    pkg["availableVersions"]    = availableVersions;
+    pkg["selectedVersionIndex"] = 0;
+
+    // The version dropdown's items, ready to bind. Entries without a
+    // version string aren't offered (the cell falls back to plain text
+    // when none are left). Same-version re-releases are told apart by
+    // release date and a short root hash — in every label, so the
+    // dropdown lines up.
+    QStringList versionLabels;
+    QSet<QString> seenVersions;
+    bool hasDuplicateVersions = false;
+    for (const QVariant& ev : std::as_const(availableVersions)) {
+        const QString v = ev.toMap().value("version").toString();
+        if (v.isEmpty()) continue;
+        versionLabels.append(v);
+        if (seenVersions.contains(v)) hasDuplicateVersions = true;
+        seenVersions.insert(v);
+    }
+    if (hasDuplicateVersions) {
+        int label = 0;
+        for (const QVariant& ev : std::as_const(availableVersions)) {
+            const QVariantMap e = ev.toMap();
+            if (e.value("version").toString().isEmpty()) continue;
+            const QString hash = e.value("rootHash").toString();
+            versionLabels[label++] += QStringLiteral(" · ")
+                + e.value("releasedAt").toString().left(10) + QStringLiteral(" · ")
+                + (hash.size() > 12 ? hash.left(6) + QStringLiteral("…") : hash);
+        }
+    }
+    pkg["versionLabels"]        = versionLabels;
+    pkg["hasDuplicateVersions"] = hasDuplicateVersions;
+
+    // Release version comes from the selected version's manifest; root
+    // hash comes from the catalog row's `rootHash` (set per version by
+    // the index builder — authoritative over any hash inside the
+    // manifest itself).
+    const QString releaseVersion = manifest.value("version").toString();
+    const QString releaseHash = selectedVersion.value("rootHash").toString();
+    pkg["version"] = releaseVersion;
+    pkg["hash"] = releaseHash;
+
+    rowaction::applyPickedSizeAndDate(pkg, 0);
+
+    pkg["errorMessage"] = QString();
+
+    // Variant availability — true iff any of the package's offered
+    // variants intersects this platform's valid-variants list. Variants
+    // are the keys of the manifest's `main` map (`{variant: entry_path}`),
+    // compared as VariantMask bits.
+    const VariantMask::Bits offered = variants.encode(manifest.value("main").toMap());
+    bool variantAvailable = variants.matchesVariant(offered);
+    // QML-only ui_qml packages can have an empty `main` map (no backend
+    // plugin); they install on every platform.
+    if (!variantAvailable && !offered.offered
+        && manifest.value("type").toString() == QLatin1String("ui_qml")) {
+        variantAvailable = true;
+    }
+    pkg["isVariantAvailable"] = variantAvailable;
+    pkg["notAvailableReason"] = static_cast<int>(
+        variantAvailable ? PackageTypes::Available
+                         : classifyNotAvailable(offered, variants));
+
+    // dependencies may be a flat array of names (legacy) or a list mixing
+    // plain-string and object entries (new manifest schema). The QML side
+    // displays them as a string list; render objects as "name version
+    // [signer=…]" so the user can see the constraint.
+    QStringList deps;
+    QVariantList depsArray = obj.value("dependencies").toList();
+    if (depsArray.isEmpty()) depsArray = manifest.value("dependencies").toList();
+    for (const QVariant& dep : depsArray) {
+        if (dep.canConvert<QVariantMap>() && !dep.toString().size()) {
+            const QVariantMap dm = dep.toMap();
+            QString s = dm.value("name").toString();
+            if (dm.contains("version")) s += QStringLiteral(" ") + dm.value("version").toString();
+            if (dm.contains("signer"))
+                s += QStringLiteral(" [signer=") + dm.value("signer").toString() + QStringLiteral("]");
+            deps.append(s);
+        } else {
+            deps.append(dep.toString());
+        }
+    }
+    pkg["dependencies"] = deps;
+
+    return pkg;
+}
+
+// Build a "Local" row for an installed package that has no catalog entry.
+// Rendered under a synthetic "Local" section that sits below all real repos
+// in the grouped list. No versions/rowAction — the row exists only to show
+// that the module is present on disk; upgrades reappear when a repo publishes
+// it.
+QVariantMap buildLocalPackageRow(const QVariantMap& installed)
+{
+    QVariantMap pkg;
+    const QString name = installed.value("name").toString();
+    QString moduleName = installed.value("moduleName").toString();
+    if (moduleName.isEmpty()) moduleName = name;
+
+    QString displayName = installed.value("displayName").toString();
+    if (displayName.isEmpty()) displayName = moduleName;
+
+    pkg["name"]        = name;
+    pkg["moduleName"]  = moduleName;
+    pkg["displayName"] = displayName;
+    pkg["description"] = installed.value("description").toString();
+    pkg["type"]        = installed.value("type").toString();
+    // Preserve the module's own category (Networking / Chat / …). "Local" is
+    // a repo-slot label, not a category — the Categories sidebar reflects
+    // real values, not this synthetic bucket.
+    pkg["category"]    = installed.value("category").toString();
+    pkg["size"]        = 0;
+    pkg["dateUpdated"] = QString();
+
+    pkg["repositoryUrl"]         = QString();
+    pkg["repositoryName"]        = QStringLiteral("local");
+    pkg["repositoryDisplayName"] = QStringLiteral("local");
+
+    pkg["availableVersions"]    = QVariantList{};
+    pkg["selectedVersionIndex"] = 0;
+    pkg["versionLabels"]        = QStringList{};
+    pkg["hasDuplicateVersions"] = false;
+
+    const QString installedVersion = installed.value("version").toString();
+    const QString installedHash    = installed.value("hashes").toMap().value("root").toString();
+    pkg["version"]          = installedVersion;
+    pkg["hash"]             = installedHash;
+    pkg["installedVersion"] = installedVersion;
+    pkg["installedHash"]    = installedHash;
+    pkg["installType"]      = installed.value("installType").toString();
+    pkg["installStatus"]    = static_cast<int>(PackageTypes::Installed);
+    pkg["errorMessage"]     = QString();
+    pkg["isVariantAvailable"]   = true;
+    pkg["notAvailableReason"]   = static_cast<int>(PackageTypes::Available);
+    pkg["rowAction"]        = static_cast<int>(PackageTypes::NoOp);
+    pkg["updateAvailable"]  = false;
+    pkg["dependencies"]     = QStringList{};
+    return pkg;
+}
+
+QVariantMap buildGroupPlaceholderRow(const QString& repositoryUrl,
+                                     const QString& repositoryName,
+                                     const QString& repositoryDisplayName,
+                                     const QVariantList& members, int installedCount)
+{
+    QVariantMap pkg;
+    pkg["isGroupPlaceholder"]    = true;
+    pkg["groupRowCount"]         = int(members.size());
+    pkg["groupInstalledCount"]   = installedCount;
+    pkg["groupMembers"]          = members;
+    pkg["name"]                  = QString();
+    pkg["moduleName"]            = QString();
+    pkg["displayName"]           = QString();
+    pkg["repositoryUrl"]         = repositoryUrl;
+    pkg["repositoryName"]        = repositoryName;
+    pkg["repositoryDisplayName"] = repositoryDisplayName;
+    pkg["availableVersions"]     = QVariantList{};
+    pkg["selectedVersionIndex"]  = 0;
+    pkg["versionLabels"]         = QStringList{};
+    pkg["hasDuplicateVersions"]  = false;
+    pkg["installStatus"]         = static_cast<int>(PackageTypes::NotInstalled);
+    pkg["rowAction"]             = static_cast<int>(PackageTypes::NoOp);
+    pkg["isVariantAvailable"]    = false;
+    pkg["updateAvailable"]       = false;
+    pkg["size"]                  = 0;
+    pkg["dependencies"]          = QStringList{};
+    return pkg;
+}
+
+QByteArray repositoryFingerprint(const QVariantList& packagesArray, const QList<int>& indices)
+{
+    // QVariantMap streams in key order, so equal rows serialise equally.
+    QByteArray bytes;
+    {
+        QDataStream out(&bytes, QIODevice::WriteOnly);
+        for (int i : indices) out << packagesArray.at(i);
+    }
+    return QCryptographicHash::hash(bytes, QCryptographicHash::Sha1);
+}
+
+QList<QVariantMap> buildPackageRows(const QVariantList& packagesArray,
+                                    const QVariantList& installedPackages,
+                                    const QStringList& validVariants,
+                                    const QSet<QString>& collapsedRepositoryUrls,
+                                    RepositoryRowCache* cache)
+{
+    // Index installed packages by moduleName for O(1) lookup in buildPackageRow.
+    QHash<QString, QVariantMap> installedByName;
+    for (const QVariant& val : installedPackages) {
+        const QVariantMap obj = val.toMap();
+        const QString installedName = obj.value("name").toString();
+        if (!installedName.isEmpty()) installedByName.insert(installedName, obj);
+    }
+    const VariantMask variantMask(validVariants);
+
+    QList<QVariantMap> packages;
+    packages.reserve(packagesArray.size() + installedPackages.size());
+    QSet<QString> catalogModuleNames;
+    catalogModuleNames.reserve(packagesArray.size());
+
+    // Collapsed groups by repositoryUrl, tallied instead of built, in
+    // first-seen order.
+    struct Collapsed {
+        QString      name;
+        QString      section;
+        QVariantList members;
+        int          installed = 0;
+    };
+    QHash<QString, Collapsed> collapsed;
+    QStringList collapsedOrder;
+    auto tally = [&](const QString& url, const QString& repoName, const QString& section,
+                     QVariantMap member) {
+        auto it = collapsed.find(url);
+        if (it == collapsed.end()) {
+            it = collapsed.insert(url, {repoName, section});
+            collapsedOrder.append(url);
+        }
+        if (member.value("installStatus").toInt() != static_cast<int>(PackageTypes::NotInstalled))
+            ++it->installed;
+        it->members.append(std::move(member));
+    };
+
+    // Catalog rows by repository, in first-seen order; each repository
+    // is tallied, taken from the cache or built as a unit.
+    QHash<QString, QList<int>> indicesByRepo;
+    QStringList repoOrder;
+    for (int i = 0; i < packagesArray.size(); ++i) {
+        const QString url = packagesArray.at(i).toMap().value("repositoryUrl").toString();
+        auto it = indicesByRepo.find(url);
+        if (it == indicesByRepo.end()) {
+            it = indicesByRepo.insert(url, {});
+            repoOrder.append(url);
+        }
+        it->append(i);
+    }
+
+    if (cache) {
+        QByteArray inputs;
+        {
+            QDataStream out(&inputs, QIODevice::WriteOnly);
+            out << validVariants;
+        }
+        inputs = QCryptographicHash::hash(inputs, QCryptographicHash::Sha1);
+        if (inputs != cache->inputs) {
+            cache->inputs = inputs;
+            cache->fingerprints.clear();
+            cache->rows.clear();
+        }
+        // Repositories that left the catalog.
+        for (auto it = cache->rows.begin(); it != cache->rows.end();) {
+            if (indicesByRepo.contains(it.key())) {
+                ++it;
+            } else {
+                cache->fingerprints.remove(it.key());
+                it = cache->rows.erase(it);
+            }
+        }
+        cache->rebuilt.clear();
+    }
+
+    // Catalog rows go in as they are (shared with the cache) unless the
+    // package is installed; only those get a copy with the install state.
+    auto appendWithInstallState = [&](const QList<QVariantMap>& rows) {
+        for (const QVariantMap& row : rows) {
+            const QString moduleName = row.value("moduleName").toString();
+            catalogModuleNames.insert(moduleName);
+            const auto inst = installedByName.constFind(moduleName);
+            if (inst == installedByName.constEnd()) {
+                packages.append(row);
+                continue;
+            }
+            QVariantMap installedRow = row;
+            applyInstalledState(installedRow, &*inst);
+            packages.append(std::move(installedRow));
+        }
+    };
+
+    for (const QString& url : std::as_const(repoOrder)) {
+        const QList<int> indices = indicesByRepo.value(url);
+        const QVariantMap first = packagesArray.at(indices.first()).toMap();
+        if (collapsedRepositoryUrls.contains(url)) {
+            const QString repoName = first.value("repositoryName").toString();
+            const QString section  = first.value("repositoryDisplayName").toString();
+            for (int i : indices) {
+                const QVariantMap obj = packagesArray.at(i).toMap();
+                const QVariantMap manifest = newestManifest(obj);
+                const QString moduleName = catalogModuleName(obj, manifest);
+                catalogModuleNames.insert(moduleName);
+                tally(url, repoName, section,
+                      groupMember(obj, manifest, installedByName.contains(moduleName)));
+            }
+            continue;
+        }
+
+        if (cache) {
+            const QByteArray fingerprint = repositoryFingerprint(packagesArray, indices);
+            const auto hit = cache->rows.constFind(url);
+            if (hit != cache->rows.constEnd() && cache->fingerprints.value(url) == fingerprint) {
+                appendWithInstallState(*hit);
+                continue;
+            }
+            cache->fingerprints.insert(url, fingerprint);
+        }
+
+        QList<QVariantMap> built;
+        built.reserve(indices.size());
+        for (int i : indices) {
+            QVariantMap row = buildCatalogRow(packagesArray.at(i).toMap(), variantMask);
+            applyInstalledState(row, nullptr);
+            built.append(std::move(row));
+        }
+        appendWithInstallState(built);
+        if (cache) {
+            cache->rows.insert(url, std::move(built));
+            cache->rebuilt.append(url);
+        }
+    }
+
+    // Any USER-installed package the catalog doesn't publish gets a
+    // synthetic "Local"-repo row so it still shows up in the grouped list.
+    // Embedded packages ship inside the app bundle — they're already
+    // discoverable through the built-in module surface, so listing them
+    // under Local would double-count and mislead.
+    for (const QVariant& val : installedPackages) {
+        const QVariantMap inst = val.toMap();
+        const QString name = inst.value("name").toString();
+        if (name.isEmpty()) continue;
+        if (inst.value("installType").toString() != QLatin1String("user")) continue;
+        QString moduleName = inst.value("moduleName").toString();
+        if (moduleName.isEmpty()) moduleName = name;
+        if (catalogModuleNames.contains(moduleName)) continue;
+        if (collapsedRepositoryUrls.contains(QString())) {
+            tally(QString(), QStringLiteral("local"), QStringLiteral("local"),
+                  groupMember(inst, {}, true));
+            continue;
+        }
+        packages.append(buildLocalPackageRow(inst));
+    }
+    for (const QString& url : std::as_const(collapsedOrder)) {
+        const Collapsed& c = collapsed.value(url);
+        packages.append(buildGroupPlaceholderRow(url, c.name, c.section, c.members, c.installed));
+    }
+
+    // Group rows by source: the hardcoded default repository always
+    // comes first (priority 0), then any user-added repos sorted by
+    // their canonical name (priority 1), and the synthetic "local"
+    // bucket last (priority 2). Within each source rows sort by
+    // package name. The QML uses `isFirstOfSource` (tagged below) to
+    // draw a section header above the first row of each group instead
+    // of a per-row Source column.
+    //
+    // Default-repo identification is by `repositoryName` matching the
+    // canonical "logos-modules-official" string baked into logos-repo.json
+    // — avoids pulling in package_downloader_lib.h just for the URL
+    // constant. If the canonical name ever moves, the constant in the
+    // lib AND this match string need to update together.
+    auto sourcePriority = [](const QVariantMap& row) -> int {
+        const QString n = row.value("repositoryName").toString();
+        if (n == QLatin1String("logos-modules-official")) return 0;
+        if (n == QLatin1String("local")) return 2;
+        return 1;
+    };
+    auto sourceKey = [](const QVariantMap& row) -> QString {
+        // Use displayName when present (human label like "Logos Official"),
+        // canonical name otherwise, falling back to URL so two unresolved
+        // repos still sort stably.
+        const QString dn = row.value("repositoryDisplayName").toString();
+        if (!dn.isEmpty()) return dn;
+        const QString n = row.value("repositoryName").toString();
+        if (!n.isEmpty()) return n;
+        return row.value("repositoryUrl").toString();
+    };
+    std::stable_sort(packages.begin(), packages.end(),
+        [&](const QVariantMap& a, const QVariantMap& b) {
+            const int pa = sourcePriority(a);
+            const int pb = sourcePriority(b);
+            if (pa != pb) return pa < pb;
+            const QString ka = sourceKey(a);
+            const QString kb = sourceKey(b);
+            const int c = ka.compare(kb, Qt::CaseInsensitive);
+            if (c != 0) return c < 0;
+            return a.value("name").toString().compare(
+                b.value("name").toString(), Qt::CaseInsensitive) < 0;
+        });
+
+    // Tag each row's `isFirstOfSource` — true when the row's
+    // (priority, sourceKey) tuple differs from the previous row's.
+    // Valid for this unfiltered order only; PackagesFilterProxy
+    // recomputes it for the filtered view.
+    int prevPriority = -1;
+    QString prevKey;
+    for (QVariantMap& row : packages) {
+        const int p = sourcePriority(row);
+        const QString k = sourceKey(row);
+        // Written only where it differs from the row's default, so the
+        // other rows stay shared with the cache.
+        const bool firstOfSource = (p != prevPriority) || (k != prevKey);
+        if (row.value("isFirstOfSource", false).toBool() != firstOfSource)
+            row["isFirstOfSource"] = firstOfSource;
+        prevPriority = p;
+        prevKey = k;
+    }
+
+    return packages;
+}
+
+} // namespace packagerows
@@ -0,0 +1,130 @@
+#pragma once
+
+#include <QByteArray>
+#include <QHash>
+#include <QList>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+#include <QVariantList>
+#include <QVariantMap>
+
+// Catalog → model-row transform. Pure functions of (catalog rows,
+// installed packages, this platform's valid variants): no backend or
+// SDK state, so the benchmark suite can drive the exact code the
+// plugin runs on every refresh.
+namespace packagerows {
+
+// This platform's valid variants as bits, built once per
+// buildPackageRows: one per valid variant and one per distinct base
+// (the variant without a "-dev" / "-portable" flavor). A package's
+// offered variants — the keys of its manifest's `main` map — encode
+// against the same bits; a variant the platform doesn't list sets none.
+// Availability is then matchesVariant() (`offered.variants &
+// valid().variants`), and a build-flavor mismatch matchesBase(). Only 64
+// variants and 64 bases get a bit; the rest are kept as strings and an
+// offered variant equal to one of them sets `extraVariant` / `extraBase`
+// instead, so a long valid list still answers like the string scan.
+// Encodings are memoised per variant string, so each distinct one is
+// split once.
+class VariantMask {
+public:
+    struct Bits {
+        quint64 variants = 0;
+        quint64 bases    = 0;
+        bool    offered  = false;   // any non-empty variant, known or not
+        bool    extraVariant = false;   // matched a valid variant past the 64th
+        bool    extraBase    = false;   // matched a valid base past the 64th
+    };
+
+    explicit VariantMask(const QStringList& validVariants);
+
+    const Bits& valid() const { return m_valid; }
+    Bits encode(const QVariantMap& mainMap) const;
+
+    bool matchesVariant(const Bits& offered) const
+    {
+        return (offered.variants & m_valid.variants) != 0 || offered.extraVariant;
+    }
+    bool matchesBase(const Bits& offered) const
+    {
+        return (offered.bases & m_valid.bases) != 0 || offered.extraBase;
+    }
+
+private:
+    Bits encodeOne(const QString& variant) const;
+
+    QHash<QString, int> m_variantBit;
+    QHash<QString, int> m_baseBit;
+    QSet<QString>       m_extraVariants;
+    QSet<QString>       m_extraBases;
+    Bits                m_valid;
+    mutable QHash<QString, Bits> m_memo;
+};
+
+// One model row from one raw catalog row (multi-repo index.json shape,
+// `versions[]` newest first). `installedByName` is keyed by moduleName.
+QVariantMap buildPackageRow(const QVariantMap& obj,
+                            const QHash<QString, QVariantMap>& installedByName,
+                            const VariantMask& variants);
+// Same, encoding `validVariants` for this one row.
+QVariantMap buildPackageRow(const QVariantMap& obj,
+                            const QHash<QString, QVariantMap>& installedByName,
+                            const QStringList& validVariants);
+
+// The installed-independent part of buildPackageRow: the row as it is
+// when the package isn't installed. applyInstalledState then writes the
+// install-state fields (installedVersion / installedHash / installType,
+// installStatus, rowAction, updateAvailable) for `installed`, the
+// package's installed entry, or null.
+QVariantMap buildCatalogRow(const QVariantMap& obj, const VariantMask& variants);
+void applyInstalledState(QVariantMap& row, const QVariantMap* installed);
+
+// Synthetic "local"-repo row for a user-installed package the catalog
+// doesn't publish.
+QVariantMap buildLocalPackageRow(const QVariantMap& installed);
+
+// Stand-in for a collapsed source group: one row carrying the group's
+// repository fields (so it sorts and sections with the group) and its
+// size — `groupRowCount` packages, `groupInstalledCount` of them
+// installed — flagged `isGroupPlaceholder`. `members` holds one
+// {name, description, type, category, installStatus} map per package,
+// which PackagesFilterProxy filters the placeholder by.
+QVariantMap buildGroupPlaceholderRow(const QString& repositoryUrl,
+                                     const QString& repositoryName,
+                                     const QString& repositoryDisplayName,
+                                     const QVariantList& members, int installedCount);
+
+// buildCatalogRow results, per repository, for the next buildPackageRows
+// to reuse. A repository's rows are reused while its fingerprint holds —
+// a digest of its raw catalog rows — and the variants they were built
+// against are the same; anything else is rebuilt and replaces the entry.
+// The installed set isn't part of it: install state is applied to a copy
+// of just the installed rows, so the rest stay shared with the model.
+struct RepositoryRowCache {
+    QByteArray inputs;                          // valid variants digest
+    QHash<QString, QByteArray> fingerprints;    // repositoryUrl → catalog digest
+    QHash<QString, QList<QVariantMap>> rows;    // repositoryUrl → catalog rows
+    QStringList rebuilt;                        // repositories the last call built
+};
+
+// Digest of one repository's raw catalog rows (`indices` into
+// `packagesArray`), for RepositoryRowCache.
+QByteArray repositoryFingerprint(const QVariantList& packagesArray, const QList<int>& indices);
+
+// Every row the model shows: one per catalog row, plus local rows,
+// grouped by source (default repo, user repos by name, local) and by
+// name within a source, with `isFirstOfSource` tagged.
+//
+// Repositories whose repositoryUrl is in `collapsedRepositoryUrls`
+// aren't built at all: each contributes one buildGroupPlaceholderRow
+// instead. The empty URL stands for the local rows.
+// With a `cache`, repositories whose catalog rows haven't changed since
+// the call that filled it aren't built again either.
+QList<QVariantMap> buildPackageRows(const QVariantList& packagesArray,
+                                    const QVariantList& installedPackages,
+                                    const QStringList& validVariants,
+                                    const QSet<QString>& collapsedRepositoryUrls = {},
+                                    RepositoryRowCache* cache = nullptr);
+
+} // namespace packagerows
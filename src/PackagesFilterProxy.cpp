@@ -1,10 +1,27 @@
 #include "PackagesFilterProxy.h"
 
+#include <algorithm>
+#include <iterator>
+#include <utility>
+
 #include <QAbstractItemModel>
+#include <QVariantMap>
 
 PackagesFilterProxy::PackagesFilterProxy(QObject* parent)
     : QSortFilterProxyModel(parent)
 {
+    connect(this, &QAbstractItemModel::modelReset,
+            this, &PackagesFilterProxy::rebuildSourceGroups);
+    connect(this, &QAbstractItemModel::layoutChanged,
+            this, &PackagesFilterProxy::rebuildSourceGroups);
+    connect(this, &QAbstractItemModel::rowsMoved,
+            this, &PackagesFilterProxy::rebuildSourceGroups);
+    connect(this, &QAbstractItemModel::rowsInserted,
+            this, &PackagesFilterProxy::onRowsInserted);
+    connect(this, &QAbstractItemModel::rowsRemoved,
+            this, &PackagesFilterProxy::onRowsRemoved);
+    connect(this, &QAbstractItemModel::dataChanged,
+            this, &PackagesFilterProxy::onDataChanged);
 }
 
 // ───────────────────────────── filter ─────────────────────────────
@@ -13,34 +30,53 @@ void PackagesFilterProxy::setSearchText(const QString& text)
 {
     if (text == m_searchText) return;
     m_searchText = text;
-    invalidateFilter();
+    refilter();
 }
 
 void PackagesFilterProxy::setInstallStateFilter(int state)
 {
     if (state == m_installStateFilter) return;
     m_installStateFilter = state;
-    invalidateFilter();
+    refilter();
 }
 
 void PackagesFilterProxy::setTypeFilter(const QString& type)
 {
     if (type == m_typeFilter) return;
     m_typeFilter = type;
-    invalidateFilter();
+    refilter();
 }
 
 void PackagesFilterProxy::setCategoryFilter(const QString& category)
 {
     if (category == m_categoryFilter) return;
     m_categoryFilter = category;
+    refilter();
+}
+
+void PackagesFilterProxy::refilter()
+{
     invalidateFilter();
+    // A placeholder that stays put gets no signal from the refilter,
+    // but its groupMatchCount may have moved. Collapsed groups hold
+    // only placeholders, so a group's first row tells.
+    if (m_isGroupPlaceholderRole < 0) return;
+    bool any = false;
+    for (int g = 0; g < m_groups.size(); ++g) {
+        if (QSortFilterProxyModel::data(index(m_groups.at(g).first, 0),
+                                        m_isGroupPlaceholderRole).toBool()) {
+            markGroupRolesDirty(g);
+            any = true;
+        }
+    }
+    if (any) emit sourceGroupsChanged();
 }
 
 void PackagesFilterProxy::setSourceModel(QAbstractItemModel* sourceModel)
 {
     QSortFilterProxyModel::setSourceModel(sourceModel);
     recomputeRoleCaches();
+    rebuildSourceGroups();
 }
 
 void PackagesFilterProxy::recomputeRoleCaches()
@@ -53,6 +89,10 @@ void PackagesFilterProxy::recomputeRoleCaches()
     m_repositoryDisplayNameRole = -1;
     m_repositoryUrlRole         = -1;
     m_nameRole                  = -1;
+    m_isFirstOfSourceRole       = -1;
+    m_isGroupPlaceholderRole    = -1;
+    m_groupMembersRole          = -1;
+    m_groupRowCountRole         = -1;
     m_searchRoles.clear();
     if (!sourceModel()) return;
 
@@ -72,6 +112,10 @@ void PackagesFilterProxy::recomputeRoleCaches()
     m_repositoryDisplayNameRole = m_roleByName.value(QByteArrayLiteral("repositoryDisplayName"), -1);
     m_repositoryUrlRole         = m_roleByName.value(QByteArrayLiteral("repositoryUrl"), -1);
     m_nameRole                  = m_roleByName.value(QByteArrayLiteral("name"), -1);
+    m_isFirstOfSourceRole       = m_roleByName.value(QByteArrayLiteral("isFirstOfSource"), -1);
+    m_isGroupPlaceholderRole    = m_roleByName.value(QByteArrayLiteral("isGroupPlaceholder"), -1);
+    m_groupMembersRole          = m_roleByName.value(QByteArrayLiteral("groupMembers"), -1);
+    m_groupRowCountRole         = m_roleByName.value(QByteArrayLiteral("groupRowCount"), -1);
 
     for (const QByteArray& name : { QByteArrayLiteral("name"),
                                     QByteArrayLiteral("description") }) {
@@ -85,29 +129,20 @@ void PackagesFilterProxy::recomputeRoleCaches()
         setSortRoleByName(m_sortRoleName);
 }
 
-bool PackagesFilterProxy::filterAcceptsRow(int sourceRow,
-                                        const QModelIndex& sourceParent) const
+bool PackagesFilterProxy::passes(const QString& type, const QString& category, int status,
+                                 const QStringList& searchCells) const
 {
-    if (!sourceModel()) return true;
-    const QModelIndex idx = sourceModel()->index(sourceRow, 0, sourceParent);
+    if (!m_typeFilter.isEmpty() && m_typeFilterRole >= 0
+        && type.compare(m_typeFilter, Qt::CaseInsensitive) != 0)
+        return false;
 
-    if (!m_typeFilter.isEmpty() && m_typeFilterRole >= 0) {
-        const QString rowType = sourceModel()->data(idx, m_typeFilterRole).toString();
-        if (rowType.compare(m_typeFilter, Qt::CaseInsensitive) != 0)
-            return false;
-    }
-
-    if (!m_categoryFilter.isEmpty() && m_categoryFilterRole >= 0) {
-        const QString rowCategory =
-            sourceModel()->data(idx, m_categoryFilterRole).toString();
-        if (rowCategory.compare(m_categoryFilter, Qt::CaseInsensitive) != 0)
-            return false;
-    }
+    if (!m_categoryFilter.isEmpty() && m_categoryFilterRole >= 0
+        && category.compare(m_categoryFilter, Qt::CaseInsensitive) != 0)
+        return false;
 
     // Install-state filter. Looked up by role NAME (not by InstallStatusRole
     // enum) to avoid a hard #include dependency on the model.
     if (m_installStateFilter != 0 && m_installStatusRole >= 0) {
-        const int status = sourceModel()->data(idx, m_installStatusRole).toInt();
         const bool isInstalledBucket = (status != 0 && status != 3);
         if (m_installStateFilter == 1 && !isInstalledBucket) return false;
         if (m_installStateFilter == 2 &&  isInstalledBucket) return false;
@@ -115,13 +150,250 @@ bool PackagesFilterProxy::filterAcceptsRow(int sourceRow,
 
     // Text search. Empty query OR no resolved search roles → no filter.
     if (m_searchText.isEmpty() || m_searchRoles.isEmpty()) return true;
-    for (int role : m_searchRoles) {
-        const QString cell = sourceModel()->data(idx, role).toString();
+    for (const QString& cell : searchCells) {
         if (cell.contains(m_searchText, Qt::CaseInsensitive)) return true;
     }
     return false;
 }
 
+int PackagesFilterProxy::memberMatches(const QModelIndex& sourceIdx) const
+{
+    // A model that doesn't list the members: the whole group counts.
+    if (m_groupMembersRole < 0) {
+        return m_groupRowCountRole >= 0
+            ? sourceModel()->data(sourceIdx, m_groupRowCountRole).toInt() : 1;
+    }
+    const QVariantList members = sourceModel()->data(sourceIdx, m_groupMembersRole).toList();
+    if (m_searchText.isEmpty() && m_typeFilter.isEmpty() && m_categoryFilter.isEmpty()
+        && m_installStateFilter == 0)
+        return int(members.size());
+    int n = 0;
+    for (const QVariant& v : members) {
+        const QVariantMap m = v.toMap();
+        if (passes(m.value("type").toString(), m.value("category").toString(),
+                   m.value("installStatus").toInt(),
+                   {m.value("name").toString(), m.value("description").toString()}))
+            ++n;
+    }
+    return n;
+}
+
+bool PackagesFilterProxy::filterAcceptsRow(int sourceRow,
+                                        const QModelIndex& sourceParent) const
+{
+    if (!sourceModel()) return true;
+    const QModelIndex idx = sourceModel()->index(sourceRow, 0, sourceParent);
+
+    if (m_isGroupPlaceholderRole >= 0
+        && sourceModel()->data(idx, m_isGroupPlaceholderRole).toBool())
+        return memberMatches(idx) > 0;
+
+    // Only the roles an active filter looks at are read.
+    auto text = [&](bool active, int role) {
+        return active && role >= 0 ? sourceModel()->data(idx, role).toString() : QString();
+    };
+    QStringList searchCells;
+    if (!m_searchText.isEmpty()) {
+        for (int role : m_searchRoles) searchCells.append(sourceModel()->data(idx, role).toString());
+    }
+    const int status = m_installStateFilter != 0 && m_installStatusRole >= 0
+        ? sourceModel()->data(idx, m_installStatusRole).toInt() : 0;
+    return passes(text(!m_typeFilter.isEmpty(), m_typeFilterRole),
+                  text(!m_categoryFilter.isEmpty(), m_categoryFilterRole),
+                  status, searchCells);
+}
+
+// ─────────────────────────── source groups ──────────────────────────
+
+QVariant PackagesFilterProxy::data(const QModelIndex& index, int role) const
+{
+    if (index.isValid() && role == GroupMatchCountRole) return groupMatchCount(index.row());
+    if (index.isValid()
+        && (role == SourceGroupCountRole
+            || (role == m_isFirstOfSourceRole && m_isFirstOfSourceRole >= 0))) {
+        const int g = sourceGroupAt(index.row());
+        if (g < 0) return role == SourceGroupCountRole ? QVariant(0) : QVariant(false);
+        return role == SourceGroupCountRole ? QVariant(m_groups.at(g).count)
+                                            : QVariant(m_groups.at(g).first == index.row());
+    }
+    return QSortFilterProxyModel::data(index, role);
+}
+
+QHash<int, QByteArray> PackagesFilterProxy::roleNames() const
+{
+    QHash<int, QByteArray> roles = QSortFilterProxyModel::roleNames();
+    roles.insert(SourceGroupCountRole, QByteArrayLiteral("sourceGroupCount"));
+    roles.insert(GroupMatchCountRole,  QByteArrayLiteral("groupMatchCount"));
+    return roles;
+}
+
+int PackagesFilterProxy::sourceGroupAt(int proxyRow) const
+{
+    // Groups are few (one per repository); the first group starting
+    // after `proxyRow` bounds the answer.
+    const auto it = std::upper_bound(m_groups.cbegin(), m_groups.cend(), proxyRow,
+                                     [](int row, const SourceGroup& g) { return row < g.first; });
+    if (it == m_groups.cbegin()) return -1;
+    const int g = int(std::distance(m_groups.cbegin(), it)) - 1;
+    return proxyRow < m_groups.at(g).first + m_groups.at(g).count ? g : -1;
+}
+
+int PackagesFilterProxy::groupMatchCount(int proxyRow) const
+{
+    const QModelIndex idx = index(proxyRow, 0);
+    if (!idx.isValid() || m_isGroupPlaceholderRole < 0) return 1;
+    const QModelIndex src = mapToSource(idx);
+    if (!sourceModel()->data(src, m_isGroupPlaceholderRole).toBool()) return 1;
+    return memberMatches(src);
+}
+
+QString PackagesFilterProxy::sectionOf(int proxyRow) const
+{
+    if (m_repositoryDisplayNameRole < 0) return QString();
+    return QSortFilterProxyModel::data(index(proxyRow, 0), m_repositoryDisplayNameRole).toString();
+}
+
+void PackagesFilterProxy::rebuildSourceGroups()
+{
+    m_groups.clear();
+    const int n = rowCount();
+    for (int r = 0; r < n; ++r) {
+        const QString section = sectionOf(r);
+        if (m_groups.isEmpty() || m_groups.last().section != section)
+            m_groups.append({section, r, 0});
+        ++m_groups.last().count;
+    }
+    emit sourceGroupsChanged();
+}
+
+void PackagesFilterProxy::shiftGroupsAfter(int groupIndex, int delta)
+{
+    for (int g = groupIndex + 1; g < m_groups.size(); ++g)
+        m_groups[g].first += delta;
+}
+
+bool PackagesFilterProxy::insertIntoGroups(int row)
+{
+    // `row` is already in the proxy; every group at or past it still
+    // has its pre-insert offsets. The row joins the group it falls in or
+    // borders with the same section, or starts a new group between two
+    // others; landing mid-group with a different section means the
+    // ordering changed under us.
+    const QString section = sectionOf(row);
+    for (int g = 0; g < m_groups.size(); ++g) {
+        SourceGroup& grp = m_groups[g];
+        const int end = grp.first + grp.count;
+        if (row > end) continue;
+        if (row >= grp.first && grp.section == section) {
+            ++grp.count;
+            shiftGroupsAfter(g, 1);
+            return true;
+        }
+        if (row == end) continue;             // maybe the next group's
+        if (row > grp.first) return false;    // would split this group
+        m_groups.insert(g, {section, row, 1});
+        shiftGroupsAfter(g, 1);
+        return true;
+    }
+    m_groups.append({section, row, 1});
+    return true;
+}
+
+void PackagesFilterProxy::onRowsInserted(const QModelIndex& parent, int first, int last)
+{
+    if (parent.isValid()) return;
+    for (int r = first; r <= last; ++r) {
+        if (!insertIntoGroups(r)) {
+            rebuildSourceGroups();
+            markAllGroupRolesDirty();
+            return;
+        }
+    }
+    // The rows are contiguous, so the groups holding the first and last
+    // of them bound every group that grew or gained a new first row.
+    const int gFirst = sourceGroupAt(first);
+    const int gLast  = sourceGroupAt(last);
+    for (int g = gFirst; g >= 0 && g <= gLast; ++g) markGroupRolesDirty(g);
+    emit sourceGroupsChanged();
+}
+
+void PackagesFilterProxy::onRowsRemoved(const QModelIndex& parent, int first, int last)
+{
+    if (parent.isValid()) return;
+    // The rows are gone; work on the pre-removal offsets, last row first.
+    for (int r = last; r >= first; --r) {
+        const int g = sourceGroupAt(r);
+        if (g < 0) {
+            rebuildSourceGroups();
+            markAllGroupRolesDirty();
+            return;
+        }
+        --m_groups[g].count;
+        shiftGroupsAfter(g, -1);
+        if (m_groups.at(g).count == 0) {
+            m_groups.removeAt(g);
+            // Its neighbours may now be one run.
+            if (g > 0 && g < m_groups.size()
+                && m_groups.at(g - 1).section == m_groups.at(g).section) {
+                m_groups[g - 1].count += m_groups.at(g).count;
+                m_groups.removeAt(g);
+            }
+        }
+    }
+    // Only the groups either side of the gap lost rows (or their first
+    // row); everything past them just moved up.
+    if (first > 0) markGroupRolesDirty(sourceGroupAt(first - 1));
+    if (first < rowCount()) markGroupRolesDirty(sourceGroupAt(first));
+    emit sourceGroupsChanged();
+}
+
+void PackagesFilterProxy::onDataChanged(const QModelIndex&, const QModelIndex&,
+                                        const QList<int>& roles)
+{
+    // Only a repository relabel moves group boundaries.
+    if (roles.isEmpty() || roles.contains(m_repositoryDisplayNameRole)) {
+        rebuildSourceGroups();
+        markAllGroupRolesDirty();
+    }
+}
+
+void PackagesFilterProxy::markGroupRolesDirty(int groupIndex)
+{
+    if (groupIndex < 0 || groupIndex >= m_groups.size()) return;
+    m_dirtyGroupSections.insert(m_groups.at(groupIndex).section);
+    if (m_groupRolesFlushQueued) return;
+    m_groupRolesFlushQueued = true;
+    QMetaObject::invokeMethod(this, &PackagesFilterProxy::flushGroupRoles, Qt::QueuedConnection);
+}
+
+void PackagesFilterProxy::markAllGroupRolesDirty()
+{
+    m_allGroupRolesDirty = true;
+    if (m_groupRolesFlushQueued) return;
+    m_groupRolesFlushQueued = true;
+    QMetaObject::invokeMethod(this, &PackagesFilterProxy::flushGroupRoles, Qt::QueuedConnection);
+}
+
+void PackagesFilterProxy::flushGroupRoles()
+{
+    const bool all = m_allGroupRolesDirty;
+    const QSet<QString> dirty = std::exchange(m_dirtyGroupSections, {});
+    m_allGroupRolesDirty    = false;
+    m_groupRolesFlushQueued = false;
+
+    QList<int> roles{SourceGroupCountRole, GroupMatchCountRole};
+    if (m_isFirstOfSourceRole >= 0) roles.append(m_isFirstOfSourceRole);
+    if (all) {
+        if (rowCount() > 0)
+            emit dataChanged(index(0, 0), index(rowCount() - 1, 0), roles);
+        return;
+    }
+    for (const SourceGroup& g : std::as_const(m_groups)) {
+        if (g.count > 0 && dirty.contains(g.section))
+            emit dataChanged(index(g.first, 0), index(g.first + g.count - 1, 0), roles);
+    }
+}
+
 // ───────────────────────────── sort ───────────────────────────────
 
 void PackagesFilterProxy::setSortRoleByName(const QString& roleName)
@@ -2,14 +2,45 @@
 
 #include <QSortFilterProxyModel>
 #include <QHash>
+#include <QList>
+#include <QSet>
 #include <QString>
+#include <QStringList>
 
 // Filter + sort proxy for the package catalog. Searches `name` + `description`,
 // applies an install-state bucket filter, and sorts by a named role.
+//
+// Rows always come out grouped by source repository (see lessThan), and
+// the proxy keeps an index of those groups over its *filtered* rows —
+// first row and count per group — updated incrementally from its own
+// row insert / remove signals. It answers `isFirstOfSource` (overriding
+// the model's build-time tag, which filtering makes stale) and the
+// extra `sourceGroupCount` role, and emits dataChanged for both on the
+// rows of every group an insert / remove / relabel touched — queued, so
+// views have taken the insert or remove itself first.
+//
+// A collapsed group's placeholder row (`isGroupPlaceholder`) is filtered
+// by the rows it stands for (its `groupMembers`): it stays while any of
+// them passes, and the extra `groupMatchCount` role says how many do.
 class PackagesFilterProxy : public QSortFilterProxyModel {
     Q_OBJECT
 
 public:
+    // Rows in the row's source group after filtering.
+    static constexpr int SourceGroupCountRole = Qt::UserRole + 1000;
+    // On a placeholder row, how many of the rows it stands for pass the
+    // filters; 1 on any other row.
+    static constexpr int GroupMatchCountRole  = Qt::UserRole + 1001;
+
+    // One contiguous run of rows from the same repository. `section` is
+    // the rows' repositoryDisplayName — the string the QML section
+    // headers key on.
+    struct SourceGroup {
+        QString section;
+        int     first = 0;
+        int     count = 0;
+    };
+
     explicit PackagesFilterProxy(QObject* parent = nullptr);
 
     // Plain text. Empty string = no search filter (all source rows pass).
@@ -46,6 +77,22 @@ public:
 
     void setSourceModel(QAbstractItemModel* sourceModel) override;
 
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+    QHash<int, QByteArray> roleNames() const override;
+
+    // Groups in row order; counts sum to rowCount().
+    const QList<SourceGroup>& sourceGroups() const { return m_groups; }
+    // Index into sourceGroups() of the group holding `proxyRow`, or -1.
+    int sourceGroupAt(int proxyRow) const;
+    // GroupMatchCountRole of `proxyRow`.
+    int groupMatchCount(int proxyRow) const;
+
+signals:
+    // After any change to sourceGroups(), once per proxy signal, and
+    // after a refilter that may have moved a placeholder's
+    // groupMatchCount.
+    void sourceGroupsChanged();
+
 protected:
     bool filterAcceptsRow(int sourceRow, const QModelIndex& sourceParent) const override;
 
@@ -61,6 +108,35 @@ private:
     // Rebuild m_roleByName + resolve every cached role-int from the new source.
     void recomputeRoleCaches();
 
+    // The filters, applied to one row's values; `searchCells` are the
+    // texts the search looks in. Placeholder rows run it per member.
+    bool passes(const QString& type, const QString& category, int status,
+                const QStringList& searchCells) const;
+    int  memberMatches(const QModelIndex& sourceIdx) const;
+    // invalidateFilter, plus a groupMatchCount refresh for the
+    // placeholders that survived it.
+    void refilter();
+
+    // Group index upkeep. Resets and layout changes rebuild it in one
+    // pass over the rows; inserts and removes patch the affected group
+    // and shift the ones after it, falling back to a rebuild when a row
+    // lands where no existing group can take it.
+    QString sectionOf(int proxyRow) const;
+    void rebuildSourceGroups();
+    void onRowsInserted(const QModelIndex& parent, int first, int last);
+    void onRowsRemoved(const QModelIndex& parent, int first, int last);
+    void onDataChanged(const QModelIndex& topLeft, const QModelIndex& bottomRight,
+                       const QList<int>& roles);
+    bool insertIntoGroups(int row);
+    void shiftGroupsAfter(int groupIndex, int delta);
+
+    // Groups whose rows' isFirstOfSource / sourceGroupCount may have
+    // changed, by section; flushed by flushGroupRoles on the next turn
+    // of the event loop, against the groups as they are by then.
+    void markGroupRolesDirty(int groupIndex);
+    void markAllGroupRolesDirty();
+    void flushGroupRoles();
+
     QString           m_searchText;
     int               m_installStateFilter = 0;
     QString           m_typeFilter;
@@ -78,5 +154,14 @@ private:
     int m_repositoryDisplayNameRole = -1;
     int m_repositoryUrlRole         = -1;
     int m_nameRole                  = -1;
+    int m_isFirstOfSourceRole       = -1;
+    int m_isGroupPlaceholderRole    = -1;
+    int m_groupMembersRole          = -1;
+    int m_groupRowCountRole         = -1;
     QList<int> m_searchRoles;          // resolved name + description
+
+    QList<SourceGroup> m_groups;
+    QSet<QString>      m_dirtyGroupSections;
+    bool               m_allGroupRolesDirty = false;
+    bool               m_groupRolesFlushQueued = false;
 };
@@ -0,0 +1,124 @@
+#include "PerfStats.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include <QCoreApplication>
+#include <QDebug>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSaveFile>
+
+#ifdef Q_OS_LINUX
+#include <unistd.h>
+#endif
+
+PerfStats::PerfStats(bool enabled, const QString& traceFile)
+    : m_enabled(enabled || !traceFile.isEmpty())
+    , m_traceFile(traceFile)
+{
+    m_clock.start();
+}
+
+PerfStats* PerfStats::fromEnvironment()
+{
+    const bool on = qEnvironmentVariableIsSet("PMU_PERF_STATS")
+                 && qEnvironmentVariable("PMU_PERF_STATS") != QLatin1String("0");
+    return new PerfStats(on, qEnvironmentVariable("PMU_TRACE_FILE"));
+}
+
+qint64 PerfStats::residentBytes()
+{
+#ifdef Q_OS_LINUX
+    QFile f(QStringLiteral("/proc/self/statm"));
+    if (!f.open(QIODevice::ReadOnly)) return -1;
+    const QList<QByteArray> fields = f.readAll().split(' ');
+    return fields.size() > 1 ? fields.at(1).toLongLong() * sysconf(_SC_PAGESIZE) : -1;
+#else
+    return -1;
+#endif
+}
+
+PerfStats::~PerfStats()
+{
+    writeTrace();
+}
+
+void PerfStats::record(const char* name, qint64 startUs, qint64 durationUs)
+{
+    if (!m_enabled) return;
+    Series& s = m_series[QString::fromLatin1(name)];
+    if (s.samples.size() < kWindow) {
+        s.samples.append(durationUs);
+    } else {
+        s.samples[s.next] = durationUs;
+        s.next = (s.next + 1) % kWindow;
+    }
+    ++s.count;
+    s.last  = durationUs;
+    m_dirty = true;
+
+    if (!m_traceFile.isEmpty() && m_trace.size() < kMaxTraceEvents)
+        m_trace.append({name, startUs, durationUs});
+}
+
+QVariantMap PerfStats::toVariant() const
+{
+    auto ms = [](qint64 us) { return double(us) / 1000.0; };
+    QVariantMap out;
+    for (auto it = m_series.cbegin(); it != m_series.cend(); ++it) {
+        QList<qint64> sorted = it->samples;
+        std::sort(sorted.begin(), sorted.end());
+        // Nearest-rank percentile over the window.
+        auto pct = [&sorted](double p) {
+            const int rank = int(std::ceil(p * sorted.size())) - 1;
+            return sorted.at(std::clamp(rank, 0, int(sorted.size()) - 1));
+        };
+        out.insert(it.key(), QVariantMap{
+            {QStringLiteral("count"),  it->count},
+            {QStringLiteral("lastMs"), ms(it->last)},
+            {QStringLiteral("p50Ms"),  ms(pct(0.50))},
+            {QStringLiteral("p95Ms"),  ms(pct(0.95))},
+            {QStringLiteral("p99Ms"),  ms(pct(0.99))},
+            {QStringLiteral("maxMs"),  ms(sorted.last())},
+        });
+    }
+    return out;
+}
+
+bool PerfStats::takeDirty()
+{
+    const bool was = m_dirty;
+    m_dirty = false;
+    return was;
+}
+
+bool PerfStats::writeTrace() const
+{
+    if (m_traceFile.isEmpty() || m_trace.isEmpty()) return false;
+
+    const qint64 pid = QCoreApplication::applicationPid();
+    QJsonArray events;
+    for (const TraceEvent& e : m_trace) {
+        events.append(QJsonObject{
+            {QStringLiteral("name"), QString::fromLatin1(e.name)},
+            {QStringLiteral("cat"),  QStringLiteral("pmu")},
+            {QStringLiteral("ph"),   QStringLiteral("X")},
+            {QStringLiteral("ts"),   e.ts},
+            {QStringLiteral("dur"),  e.dur},
+            {QStringLiteral("pid"),  pid},
+            {QStringLiteral("tid"),  1},
+        });
+    }
+    QSaveFile f(m_traceFile);
+    if (!f.open(QIODevice::WriteOnly)
+        || f.write(QJsonDocument(QJsonObject{{QStringLiteral("traceEvents"), events}})
+                       .toJson(QJsonDocument::Compact)) < 0
+        || !f.commit()) {
+        qWarning() << "PerfStats: cannot write trace to" << m_traceFile;
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <QElapsedTimer>
+#include <QHash>
+#include <QList>
+#include <QString>
+#include <QVariantMap>
+
+// Hot-path timing: named spans (IPC round trips, row building, model
+// reset, filter / sort passes) recorded into a rolling window per name
+// and summarised as p50 / p95 / p99. Optionally every span is also kept
+// as a Chrome trace event ("X" phase) and written as
+// {"traceEvents": [...]} for chrome://tracing or Perfetto.
+//
+// Off by default. Disabled, scope() and begin() return inert tokens and
+// record nothing — one branch per span — and the backend doesn't wrap
+// its module gateway at all.
+//
+//   PMU_PERF_STATS=1           collect, publish as the `perfStats` PROP
+//   PMU_TRACE_FILE=<path>      also write a trace there on shutdown
+//                              (implies PMU_PERF_STATS)
+class PerfStats {
+public:
+    // Samples kept per name for the percentiles.
+    static constexpr int kWindow = 512;
+    // Trace events kept before recording into the trace stops.
+    static constexpr int kMaxTraceEvents = 500000;
+
+    explicit PerfStats(bool enabled = false, const QString& traceFile = QString());
+    static PerfStats* fromEnvironment();   // caller owns
+    // Resident set size, -1 where /proc isn't there to ask.
+    static qint64 residentBytes();
+    ~PerfStats();
+
+    PerfStats(const PerfStats&) = delete;
+    PerfStats& operator=(const PerfStats&) = delete;
+
+    bool    enabled() const { return m_enabled; }
+    QString traceFile() const { return m_traceFile; }
+
+    // Synchronous span: timed from construction to destruction.
+    class Scope {
+    public:
+        Scope(PerfStats* stats, const char* name)
+            : m_stats(stats), m_name(name), m_start(stats ? stats->nowUs() : 0) {}
+        ~Scope() { if (m_stats) m_stats->record(m_name, m_start, m_stats->nowUs() - m_start); }
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+    private:
+        PerfStats*  m_stats;
+        const char* m_name;
+        qint64      m_start;
+    };
+    Scope scope(const char* name) { return Scope(m_enabled ? this : nullptr, name); }
+
+    // Asynchronous span: begin() when the call goes out, end() in its
+    // callback. begin() is -1 when disabled and end() ignores it.
+    qint64 begin() const { return m_enabled ? nowUs() : -1; }
+    void   end(const char* name, qint64 beganUs)
+    {
+        if (beganUs >= 0) record(name, beganUs, nowUs() - beganUs);
+    }
+
+    void record(const char* name, qint64 startUs, qint64 durationUs);
+
+    // { <name>: { count, lastMs, p50Ms, p95Ms, p99Ms, maxMs } } — count
+    // is every sample seen; the rest cover the last kWindow.
+    QVariantMap toVariant() const;
+    // True once per batch of new samples; lets the publisher skip
+    // pushing an unchanged map.
+    bool takeDirty();
+
+    // Write the trace (no-op without a trace file). Also runs on
+    // destruction.
+    bool writeTrace() const;
+
+private:
+    struct Series {
+        QList<qint64> samples;   // ring buffer, µs
+        int    next  = 0;
+        qint64 count = 0;
+        qint64 last  = 0;
+    };
+    struct TraceEvent {
+        const char* name;
+        qint64      ts;
+        qint64      dur;
+    };
+
+    qint64 nowUs() const { return m_clock.nsecsElapsed() / 1000; }
+
+    bool    m_enabled;
+    QString m_traceFile;
+    bool    m_dirty = false;
+    QElapsedTimer m_clock;
+    QHash<QString, Series> m_series;
+    QList<TraceEvent>      m_trace;
+};
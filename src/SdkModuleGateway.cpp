@@ -0,0 +1,252 @@
+#include "SdkModuleGateway.h"
+
+#include <utility>
+
+#include <QDebug>
+#include <QTimer>
+
+namespace {
+
+// The context isn't wired yet, so there's no module to ask. Answer the
+// way a dropped call would — the empty value the typed wrappers hand
+// over on a transport failure, or a map saying why — and asynchronously,
+// like a real reply, so the caller's continuation still runs.
+template <typename Callback, typename Value>
+void failLater(Callback onDone, Value value)
+{
+    QTimer::singleShot(0, [onDone = std::move(onDone), value = std::move(value)]() mutable {
+        onDone(std::move(value));
+    });
+}
+
+QVariantMap notConnected(const char* moduleName)
+{
+    return {
+        {QStringLiteral("success"), false},
+        {QStringLiteral("error"),
+         QStringLiteral("%1 is not connected").arg(QLatin1String(moduleName))},
+    };
+}
+
+} // namespace
+
+SdkModuleGateway::SdkModuleGateway(std::function<LogosModules*()> modules)
+    : m_modules(std::move(modules))
+{
+}
+
+bool SdkModuleGateway::isReady(const char* moduleName) const
+{
+    // `api` is the LogosAPI the glue built the typed wrappers from — the
+    // same one their clients live on.
+    LogosModules* m = m_modules();
+    if (!m) return false;
+    LogosAPIClient* c = m->api->getClient(moduleName);
+    return c && c->isConnected();
+}
+
+// ─────────────────────────── package_downloader ───────────────────────────
+
+void SdkModuleGateway::refreshCatalog(MapCallback onDone)
+{
+    LogosModules* m = m_modules();
+    if (!m) {
+        failLater(std::move(onDone), notConnected("package_downloader"));
+        return;
+    }
+    m->package_downloader.refreshCatalogAsync(std::move(onDone));
+}
+
+void SdkModuleGateway::refreshRepository(const QString& repositoryUrl, MapCallback onDone)
+{
+    // package_downloader only refreshes every repository at once, so this
+    // re-fetches all of them until it grows a per-repository call; the
+    // backend still rebuilds just the repositories whose rows changed.
+    Q_UNUSED(repositoryUrl);
+    refreshCatalog(std::move(onDone));
+}
+
+void SdkModuleGateway::getCatalog(ListCallback onDone)
+{
+    LogosModules* m = m_modules();
+    if (!m) {
+        failLater(std::move(onDone), QVariantList());
+        return;
+    }
+    m->package_downloader.getCatalogAsync(std::move(onDone));
+}
+
+void SdkModuleGateway::getCatalogDelta(qint64 sinceGeneration, MapCallback onDone)
+{
+    // package_downloader doesn't version its catalog yet: always answer
+    // "fetch it whole", and asynchronously, like a real reply.
+    Q_UNUSED(sinceGeneration);
+    QTimer::singleShot(0, [onDone = std::move(onDone)]() {
+        onDone({{QStringLiteral("generation"), -1}, {QStringLiteral("full"), true}});
+    });
+}
+
+void SdkModuleGateway::listRepositories(ListCallback onDone)
+{
+    LogosModules* m = m_modules();
+    if (!m) {
+        failLater(std::move(onDone), QVariantList());
+        return;
+    }
+    m->package_downloader.listRepositoriesAsync(std::move(onDone));
+}
+
+void SdkModuleGateway::resolveDependencies(const QString& depsJson, const QString& installedJson,
+                                           ListCallback onDone)
+{
+    LogosModules* m = m_modules();
+    if (!m) {
+        failLater(std::move(onDone), QVariantList());
+        return;
+    }
+    m->package_downloader.resolveDependenciesAsync(depsJson, installedJson, std::move(onDone));
+}
+
+void SdkModuleGateway::downloadResolvedDependencies(const QString& depsJson,
+                                                    const QString& installedJson,
+                                                    ListCallback onDone, int timeoutMs)
+{
+    LogosModules* m = m_modules();
+    if (!m) {
+        failLater(std::move(onDone), QVariantList());
+        return;
+    }
+    m->package_downloader.downloadResolvedDependenciesAsync(depsJson, installedJson,
+                                                            std::move(onDone),
+                                                            Timeout(timeoutMs));
+}
+
+void SdkModuleGateway::onDownloaderEvent(const QString& event, EventHandler handler)
+{
+    LogosModules* m = m_modules();
+    if (!m) {
+        qWarning() << "SdkModuleGateway: package_downloader not wired; dropping the" << event
+                   << "subscription";
+        return;
+    }
+    m->package_downloader.on(event, std::move(handler));
+}
+
+// ───────────────────────────── package_manager ────────────────────────────
+
+void SdkModuleGateway::getInstalledPackages(ListCallback onDone)
+{
+    LogosModules* m = m_modules();
+    if (!m) {
+        failLater(std::move(onDone), QVariantList());
+        return;
+    }
+    m->package_manager.getInstalledPackagesAsync(std::move(onDone));
+}
+
+void SdkModuleGateway::getValidVariants(VariantCallback onDone)
+{
+    LogosModules* m = m_modules();
+    if (!m) {
+        failLater(std::move(onDone), QVariant());
+        return;
+    }
+    m->package_manager.getValidVariantsAsync(std::move(onDone));
+}
+
+void SdkModuleGateway::inspectPackage(const QString& filePath, MapCallback onDone)
+{
+    LogosModules* m = m_modules();
+    if (!m) {
+        failLater(std::move(onDone), notConnected("package_manager"));
+        return;
+    }
+    m->package_manager.inspectPackageAsync(filePath, std::move(onDone));
+}
+
+void SdkModuleGateway::installPlugin(const QString& filePath, InstallCallback onDone,
+                                     int timeoutMs)
+{
+    LogosModules* m = m_modules();
+    if (!m) {
+        InstallReply reply;
+        reply.ok           = false;
+        reply.errorCode    = QStringLiteral("NOT_CONNECTED");
+        reply.errorMessage = QStringLiteral("package_manager is not connected");
+        failLater(std::move(onDone), reply);
+        return;
+    }
+    // `installPluginAsyncResult`, not `installPluginAsync`: the plain async
+    // wrapper hands the callback a bare QVariantMap, so a transport failure is
+    // indistinguishable from a provider that legitimately returned an empty
+    // one. AsyncResult<T> carries the value and the error together.
+    m->package_manager.installPluginAsyncResult(filePath, false,
+        [onDone = std::move(onDone)](logos::AsyncResult<QVariantMap> r) {
+            InstallReply reply;
+            reply.ok = r.ok();
+            if (reply.ok) {
+                reply.value = r.value;
+            } else {
+                reply.errorCode    = QString::fromStdString(r.error.code);
+                reply.errorMessage = QString::fromStdString(r.error.message);
+            }
+            onDone(reply);
+        },
+        Timeout(timeoutMs));
+}
+
+void SdkModuleGateway::requestInstall(const QString& name, const QString& version,
+                                      const QString& repositoryUrl, const QString& changesJson,
+                                      MapCallback onDone)
+{
+    LogosModules* m = m_modules();
+    if (!m) {
+        failLater(std::move(onDone), notConnected("package_manager"));
+        return;
+    }
+    m->package_manager.requestInstallAsync(name, version, repositoryUrl, changesJson,
+                                           std::move(onDone));
+}
+
+void SdkModuleGateway::requestUpgrade(const QString& name, const QString& version, int mode,
+                                      const QString& changesJson, MapCallback onDone)
+{
+    LogosModules* m = m_modules();
+    if (!m) {
+        failLater(std::move(onDone), notConnected("package_manager"));
+        return;
+    }
+    m->package_manager.requestUpgradeAsync(name, version, mode, changesJson,
+                                           std::move(onDone));
+}
+
+void SdkModuleGateway::requestUninstall(const QString& name, MapCallback onDone)
+{
+    LogosModules* m = m_modules();
+    if (!m) {
+        failLater(std::move(onDone), notConnected("package_manager"));
+        return;
+    }
+    m->package_manager.requestUninstallAsync(name, std::move(onDone));
+}
+
+void SdkModuleGateway::requestMultiUninstall(const QStringList& names, MapCallback onDone)
+{
+    LogosModules* m = m_modules();
+    if (!m) {
+        failLater(std::move(onDone), notConnected("package_manager"));
+        return;
+    }
+    m->package_manager.requestMultiUninstallAsync(names, std::move(onDone));
+}
+
+void SdkModuleGateway::onManagerEvent(const QString& event, EventHandler handler)
+{
+    LogosModules* m = m_modules();
+    if (!m) {
+        qWarning() << "SdkModuleGateway: package_manager not wired; dropping the" << event
+                   << "subscription";
+        return;
+    }
+    m->package_manager.on(event, std::move(handler));
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <functional>
+
+#include "logos_sdk.h"
+#include "ModuleGateway.h"
+
+// ModuleGateway over the generated typed wrappers (LogosModules). The
+// accessor returns nullptr until the plugin context is wired; a call made
+// before that still gets its callback, with a failure (the backend gates
+// every call on isReady() first, so in practice none are). Event
+// subscriptions made that early are dropped, with a warning.
+class SdkModuleGateway : public ModuleGateway {
+public:
+    explicit SdkModuleGateway(std::function<LogosModules*()> modules);
+
+    bool isReady(const char* moduleName) const override;
+
+    void refreshCatalog(MapCallback onDone) override;
+    void refreshRepository(const QString& repositoryUrl, MapCallback onDone) override;
+    void getCatalog(ListCallback onDone) override;
+    void getCatalogDelta(qint64 sinceGeneration, MapCallback onDone) override;
+    void listRepositories(ListCallback onDone) override;
+    void resolveDependencies(const QString& depsJson, const QString& installedJson,
+                             ListCallback onDone) override;
+    void downloadResolvedDependencies(const QString& depsJson, const QString& installedJson,
+                                      ListCallback onDone, int timeoutMs) override;
+    void onDownloaderEvent(const QString& event, EventHandler handler) override;
+
+    void getInstalledPackages(ListCallback onDone) override;
+    void getValidVariants(VariantCallback onDone) override;
+    void inspectPackage(const QString& filePath, MapCallback onDone) override;
+    void installPlugin(const QString& filePath, InstallCallback onDone,
+                       int timeoutMs) override;
+    void requestInstall(const QString& name, const QString& version,
+                        const QString& repositoryUrl, const QString& changesJson,
+                        MapCallback onDone) override;
+    void requestUpgrade(const QString& name, const QString& version, int mode,
+                        const QString& changesJson, MapCallback onDone) override;
+    void requestUninstall(const QString& name, MapCallback onDone) override;
+    void requestMultiUninstall(const QStringList& names, MapCallback onDone) override;
+    void onManagerEvent(const QString& event, EventHandler handler) override;
+
+private:
+    std::function<LogosModules*()> m_modules;
+};
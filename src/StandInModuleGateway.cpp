@@ -0,0 +1,585 @@
+#include "StandInModuleGateway.h"
+
+#include <QDir>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSaveFile>
+
+#include "CatalogDelta.h"
+#include "SyntheticCatalog.h"
+
+namespace {
+
+int envInt(const char* name, int fallback)
+{
+    bool ok = false;
+    const int v = qEnvironmentVariableIntValue(name, &ok);
+    return ok ? v : fallback;
+}
+
+QStringList envList(const char* name)
+{
+    return qEnvironmentVariable(name).split(QLatin1Char(','), Qt::SkipEmptyParts);
+}
+
+QVariantMap readArtifact(const QString& path)
+{
+    QFile f(path);
+    if (!f.open(QIODevice::ReadOnly)) return {};
+    const QJsonDocument doc = QJsonDocument::fromJson(f.readAll());
+    return doc.isObject() ? doc.object().toVariantMap() : QVariantMap();
+}
+
+} // namespace
+
+StandInModuleGateway::Config StandInModuleGateway::Config::fromEnvironment()
+{
+    Config c;
+    c.catalogRows    = envInt("PMU_STANDIN_ROWS", c.catalogRows);
+    c.versionsPerRow = envInt("PMU_STANDIN_VERSIONS", c.versionsPerRow);
+    c.latencyMs      = envInt("PMU_STANDIN_LATENCY_MS", c.latencyMs);
+    c.downloadMs     = envInt("PMU_STANDIN_DOWNLOAD_MS", c.downloadMs);
+    c.installMs      = envInt("PMU_STANDIN_INSTALL_MS", c.installMs);
+    c.failDownloads  = envList("PMU_STANDIN_FAIL_DOWNLOAD");
+    c.failInstalls   = envList("PMU_STANDIN_FAIL_INSTALL");
+    c.seed           = static_cast<quint32>(envInt("PMU_STANDIN_SEED", int(c.seed)));
+    c.approveGates   = qEnvironmentVariable("PMU_STANDIN_DECLINE") != QLatin1String("1");
+    c.catalogChangedEveryMs = envInt("PMU_STANDIN_CATALOG_CHANGED_MS", 0);
+    c.deltaHistory          = envInt("PMU_STANDIN_DELTA_HISTORY", c.deltaHistory);
+    c.artifactDirectory     = qEnvironmentVariable("PMU_STANDIN_ARTIFACT_DIR");
+    bool ok = false;
+    const double rate = qEnvironmentVariable("PMU_STANDIN_FAILURE_RATE").toDouble(&ok);
+    if (ok) c.failureRate = qBound(0.0, rate, 1.0);
+    return c;
+}
+
+bool StandInModuleGateway::enabledByEnvironment()
+{
+    return qEnvironmentVariableIsSet("PMU_STANDIN_MODULES")
+        && qEnvironmentVariable("PMU_STANDIN_MODULES") != QLatin1String("0");
+}
+
+StandInModuleGateway::StandInModuleGateway(const Config& config, QObject* parent)
+    : QObject(parent)
+    , m_config(config)
+    , m_rng(config.seed)
+{
+    const syntheticcatalog::Catalog c =
+        syntheticcatalog::make(m_config.catalogRows, m_config.versionsPerRow);
+    m_catalog = c.rows;
+    reindexCatalog();
+    for (const QVariant& v : c.installed) {
+        const QVariantMap m = v.toMap();
+        m_installed.insert(m.value(QStringLiteral("name")).toString(), m);
+    }
+
+    m_artifactDir = m_config.artifactDirectory;
+    if (m_artifactDir.isEmpty()) {
+        m_tempDir = std::make_unique<QTemporaryDir>();
+        m_artifactDir = m_tempDir->path();
+    }
+    QDir().mkpath(m_artifactDir);
+
+    if (m_config.catalogChangedEveryMs > 0) {
+        m_catalogChangedTimer = new QTimer(this);
+        m_catalogChangedTimer->setInterval(m_config.catalogChangedEveryMs);
+        // Republish one row per tick (a fresh root hash on its newest
+        // version), walking the catalog.
+        connect(m_catalogChangedTimer, &QTimer::timeout, this, [this]() {
+            if (m_catalog.isEmpty()) return;
+            QVariantMap row = m_catalog.at(int(m_generation % m_catalog.size())).toMap();
+            QVariantList versions = row.value(QStringLiteral("versions")).toList();
+            if (!versions.isEmpty()) {
+                QVariantMap newest = versions.first().toMap();
+                newest.insert(QStringLiteral("rootHash"),
+                              QString::number(m_rng.generate64(), 16)
+                                  + QString::number(m_rng.generate64(), 16));
+                versions[0] = newest;
+                row.insert(QStringLiteral("versions"), versions);
+            }
+            editCatalog({row});
+        });
+        m_catalogChangedTimer->start();
+    }
+}
+
+StandInModuleGateway::~StandInModuleGateway() = default;
+
+QVariantList StandInModuleGateway::installedPackages() const
+{
+    QVariantList out;
+    out.reserve(m_installed.size());
+    for (const QVariantMap& m : m_installed) out.append(m);
+    return out;
+}
+
+void StandInModuleGateway::reindexCatalog()
+{
+    m_rowsByName.clear();
+    m_rowByKey.clear();
+    for (int i = 0; i < m_catalog.size(); ++i) {
+        const QVariantMap row = m_catalog.at(i).toMap();
+        m_rowsByName[row.value(QStringLiteral("name")).toString()].append(i);
+        m_rowByKey.insert(catalogdelta::rowKey(row), i);
+    }
+}
+
+void StandInModuleGateway::editCatalog(const QVariantList& rows, const QVariantList& removed)
+{
+    ++m_generation;
+    for (const QVariant& v : removed) {
+        const QString key = catalogdelta::rowKey(v.toMap());
+        if (!m_rowByKey.contains(key)) continue;
+        m_rowRemoved.insert(key, {m_generation, v.toMap()});
+        m_rowChanged.remove(key);
+        m_rowAdded.remove(key);
+    }
+    for (const QVariant& v : rows) {
+        const QString key = catalogdelta::rowKey(v.toMap());
+        if (!m_rowByKey.contains(key)) m_rowAdded.insert(key, m_generation);
+        m_rowChanged.insert(key, m_generation);
+        m_rowRemoved.remove(key);
+    }
+    m_catalog = catalogdelta::apply(m_catalog, {{QStringLiteral("changed"), rows},
+                                                {QStringLiteral("removed"), removed}});
+    reindexCatalog();
+    emitDownloaderEvent(QStringLiteral("catalogChanged"),
+                        jsonPayload({{QStringLiteral("generation"), m_generation}}));
+}
+
+void StandInModuleGateway::emitDownloaderEvent(const QString& event, const QVariantList& data)
+{
+    const auto handlers = m_downloaderHandlers.values(event);
+    for (const EventHandler& h : handlers) h(data);
+}
+
+void StandInModuleGateway::emitManagerEvent(const QString& event, const QVariantList& data)
+{
+    const auto handlers = m_managerHandlers.values(event);
+    for (const EventHandler& h : handlers) h(data);
+}
+
+bool StandInModuleGateway::isReady(const char*) const
+{
+    return true;
+}
+
+void StandInModuleGateway::after(int ms, std::function<void()> fn)
+{
+    QTimer::singleShot(qMax(0, ms), this, std::move(fn));
+}
+
+bool StandInModuleGateway::injectFailure(const QStringList& names, const QString& name)
+{
+    if (names.contains(name)) return true;
+    return m_config.failureRate > 0.0 && m_rng.generateDouble() < m_config.failureRate;
+}
+
+QVariantList StandInModuleGateway::jsonPayload(const QVariantMap& obj)
+{
+    return {QString::fromUtf8(
+        QJsonDocument(QJsonObject::fromVariantMap(obj)).toJson(QJsonDocument::Compact))};
+}
+
+// ─────────────────────────── package_downloader ───────────────────────────
+
+void StandInModuleGateway::refreshCatalog(MapCallback onDone)
+{
+    count("refreshCatalog");
+    after(m_config.latencyMs, [this, onDone]() {
+        onDone({});
+        emitDownloaderEvent(QStringLiteral("catalogChanged"), {});
+    });
+}
+
+void StandInModuleGateway::refreshRepository(const QString& repositoryUrl, MapCallback onDone)
+{
+    count("refreshRepository");
+    after(m_config.latencyMs, [this, repositoryUrl, onDone]() {
+        onDone({{QStringLiteral("repositoryUrl"), repositoryUrl}});
+        emitDownloaderEvent(QStringLiteral("catalogChanged"), {});
+    });
+}
+
+void StandInModuleGateway::getCatalog(ListCallback onDone)
+{
+    count("getCatalog");
+    after(m_config.latencyMs, [this, onDone]() { onDone(m_catalog); });
+}
+
+void StandInModuleGateway::getCatalogDelta(qint64 sinceGeneration, MapCallback onDone)
+{
+    count("getCatalogDelta");
+    QVariantMap reply{{QStringLiteral("generation"), m_generation}};
+    if (sinceGeneration < 0 || sinceGeneration > m_generation
+        || m_generation - sinceGeneration > m_config.deltaHistory) {
+        reply.insert(QStringLiteral("full"), true);
+    } else {
+        QVariantList added, changed, removed;
+        for (auto it = m_rowChanged.cbegin(); it != m_rowChanged.cend(); ++it) {
+            if (it.value() <= sinceGeneration) continue;
+            const QVariant row = m_catalog.at(m_rowByKey.value(it.key()));
+            if (m_rowAdded.value(it.key(), 0) > sinceGeneration)
+                added.append(row);
+            else
+                changed.append(row);
+        }
+        for (auto it = m_rowRemoved.cbegin(); it != m_rowRemoved.cend(); ++it)
+            if (it->first > sinceGeneration) removed.append(it->second);
+        reply.insert(QStringLiteral("full"), false);
+        reply.insert(QStringLiteral("added"), added);
+        reply.insert(QStringLiteral("changed"), changed);
+        reply.insert(QStringLiteral("removed"), removed);
+    }
+    after(m_config.latencyMs, [onDone, reply]() { onDone(reply); });
+}
+
+void StandInModuleGateway::listRepositories(ListCallback onDone)
+{
+    count("listRepositories");
+    QVariantList repos;
+    QSet<QString> seen;
+    for (const QVariant& v : std::as_const(m_catalog)) {
+        const QVariantMap row = v.toMap();
+        const QString name = row.value(QStringLiteral("repositoryName")).toString();
+        if (seen.contains(name)) continue;
+        seen.insert(name);
+        repos.append(QVariantMap{
+            {QStringLiteral("name"), name},
+            {QStringLiteral("displayName"), row.value(QStringLiteral("repositoryDisplayName"))},
+            {QStringLiteral("url"), row.value(QStringLiteral("repositoryUrl"))},
+            {QStringLiteral("enabled"), true},
+        });
+    }
+    after(m_config.latencyMs, [onDone, repos]() { onDone(repos); });
+}
+
+QVariantList StandInModuleGateway::resolve(const QString& depsJson,
+                                           const QString& installedJson) const
+{
+    QSet<QString> installed;
+    for (const QJsonValue& v : QJsonDocument::fromJson(installedJson.toUtf8()).array())
+        installed.insert(v.toObject().value(QStringLiteral("name")).toString());
+
+    QVariantList out;
+    QSet<QString> visited;
+    std::function<void(const QString&, const QString&, const QString&, bool)> visit =
+        [&](const QString& name, const QString& repoUrl, const QString& version, bool topLevel) {
+            if (visited.contains(name)) return;
+            visited.insert(name);
+
+            QVariantMap row;
+            for (int i : m_rowsByName.value(name)) {
+                const QVariantMap candidate = m_catalog.at(i).toMap();
+                if (repoUrl.isEmpty()
+                    || candidate.value(QStringLiteral("repositoryUrl")).toString() == repoUrl) {
+                    row = candidate;
+                    break;
+                }
+            }
+            QVariantMap picked;
+            for (const QVariant& vv : row.value(QStringLiteral("versions")).toList()) {
+                const QVariantMap vm = vv.toMap();
+                const QString v = vm.value(QStringLiteral("manifest")).toMap()
+                                      .value(QStringLiteral("version")).toString();
+                if (version.isEmpty() || v == version) { picked = vm; break; }
+            }
+            if (picked.isEmpty()) {
+                out.append(QVariantMap{
+                    {QStringLiteral("name"), name},
+                    {QStringLiteral("error"), QStringLiteral("%1 %2 not found in the catalog")
+                                                  .arg(name, version)}});
+                return;
+            }
+
+            const QVariantMap manifest = picked.value(QStringLiteral("manifest")).toMap();
+            for (const QVariant& d : manifest.value(QStringLiteral("dependencies")).toList()) {
+                const QString depName = d.typeId() == QMetaType::QString
+                    ? d.toString() : d.toMap().value(QStringLiteral("name")).toString();
+                if (!depName.isEmpty() && !installed.contains(depName))
+                    visit(depName, QString(), QString(), false);
+            }
+            out.append(QVariantMap{
+                {QStringLiteral("name"), name},
+                {QStringLiteral("version"), manifest.value(QStringLiteral("version"))},
+                {QStringLiteral("repositoryUrl"), row.value(QStringLiteral("repositoryUrl"))},
+                {QStringLiteral("rootHash"), picked.value(QStringLiteral("rootHash"))},
+                {QStringLiteral("size"), picked.value(QStringLiteral("size"))},
+                {QStringLiteral("topLevel"), topLevel},
+            });
+        };
+
+    for (const QJsonValue& v : QJsonDocument::fromJson(depsJson.toUtf8()).array()) {
+        const QJsonObject o = v.toObject();
+        visit(o.value(QStringLiteral("name")).toString(),
+              o.value(QStringLiteral("repositoryUrl")).toString(),
+              o.value(QStringLiteral("version")).toString(), true);
+    }
+    return out;
+}
+
+void StandInModuleGateway::resolveDependencies(const QString& depsJson,
+                                               const QString& installedJson,
+                                               ListCallback onDone)
+{
+    count("resolveDependencies");
+    const QVariantList resolved = resolve(depsJson, installedJson);
+    after(m_config.latencyMs, [onDone, resolved]() { onDone(resolved); });
+}
+
+QString StandInModuleGateway::writeArtifact(const QVariantMap& entry) const
+{
+    const QString path = QStringLiteral("%1/%2-%3.lgx")
+        .arg(m_artifactDir, entry.value(QStringLiteral("name")).toString(),
+             entry.value(QStringLiteral("version")).toString());
+    QSaveFile f(path);
+    if (!f.open(QIODevice::WriteOnly)) return {};
+    f.write(QJsonDocument(QJsonObject{
+        {QStringLiteral("name"),     entry.value(QStringLiteral("name")).toString()},
+        {QStringLiteral("version"),  entry.value(QStringLiteral("version")).toString()},
+        {QStringLiteral("rootHash"), entry.value(QStringLiteral("rootHash")).toString()},
+    }).toJson(QJsonDocument::Compact));
+    return f.commit() ? path : QString();
+}
+
+void StandInModuleGateway::downloadResolvedDependencies(const QString& depsJson,
+                                                        const QString& installedJson,
+                                                        ListCallback onDone, int timeoutMs)
+{
+    count("downloadResolvedDependencies");
+    const QVariantList resolved = resolve(depsJson, installedJson);
+    if (m_config.downloadMs > timeoutMs) {
+        after(timeoutMs, [onDone]() { onDone({}); });   // what a dropped reply looks like
+        return;
+    }
+
+    // Progress in four chunks per artifact, spread over downloadMs.
+    constexpr int kChunks = 4;
+    const int step = m_config.downloadMs / kChunks;
+    for (int k = 1; k <= kChunks; ++k) {
+        after(m_config.latencyMs + k * step, [this, resolved, k]() {
+            for (const QVariant& v : resolved) {
+                const QVariantMap e = v.toMap();
+                if (e.contains(QStringLiteral("error"))) continue;
+                const qint64 total = e.value(QStringLiteral("size")).toLongLong();
+                emitDownloaderEvent(QStringLiteral("downloadProgress"), jsonPayload({
+                    {QStringLiteral("name"), e.value(QStringLiteral("name"))},
+                    {QStringLiteral("version"), e.value(QStringLiteral("version"))},
+                    {QStringLiteral("rootHash"), e.value(QStringLiteral("rootHash"))},
+                    {QStringLiteral("bytesDone"), total * k / kChunks},
+                    {QStringLiteral("bytesTotal"), total},
+                }));
+            }
+        });
+    }
+
+    after(m_config.latencyMs + m_config.downloadMs, [this, onDone, resolved]() {
+        QVariantList results;
+        results.reserve(resolved.size());
+        for (const QVariant& v : resolved) {
+            QVariantMap e = v.toMap();
+            e.remove(QStringLiteral("size"));
+            if (!e.contains(QStringLiteral("error"))) {
+                const QString name = e.value(QStringLiteral("name")).toString();
+                const QString path = injectFailure(m_config.failDownloads, name)
+                    ? QString() : writeArtifact(e);
+                if (path.isEmpty())
+                    e.insert(QStringLiteral("error"), QStringLiteral("stand-in: download failed"));
+                else
+                    e.insert(QStringLiteral("path"), path);
+            }
+            results.append(e);
+        }
+        onDone(results);
+    });
+}
+
+void StandInModuleGateway::onDownloaderEvent(const QString& event, EventHandler handler)
+{
+    m_downloaderHandlers.insert(event, std::move(handler));
+}
+
+// ───────────────────────────── package_manager ────────────────────────────
+
+void StandInModuleGateway::getInstalledPackages(ListCallback onDone)
+{
+    count("getInstalledPackages");
+    after(m_config.latencyMs, [this, onDone]() { onDone(installedPackages()); });
+}
+
+void StandInModuleGateway::getValidVariants(VariantCallback onDone)
+{
+    count("getValidVariants");
+    after(m_config.latencyMs, [onDone]() {
+        onDone(QStringList{QStringLiteral("linux-x86_64")});
+    });
+}
+
+void StandInModuleGateway::inspectPackage(const QString& filePath, MapCallback onDone)
+{
+    count("inspectPackage");
+    QVariantMap info;
+    const QVariantMap artifact = readArtifact(filePath);
+    const QString name = artifact.value(QStringLiteral("name")).toString();
+    if (name.isEmpty()) {
+        info.insert(QStringLiteral("error"), QStringLiteral("stand-in: not a stand-in package"));
+    } else {
+        info.insert(QStringLiteral("name"), name);
+        info.insert(QStringLiteral("version"), artifact.value(QStringLiteral("version")));
+        info.insert(QStringLiteral("isAlreadyInstalled"), m_installed.contains(name));
+        info.insert(QStringLiteral("installedVersion"),
+                    m_installed.value(name).value(QStringLiteral("version")));
+        const int row = m_rowsByName.value(name).value(0, -1);
+        if (row >= 0) {
+            const QVariantMap newest = m_catalog.at(row).toMap()
+                .value(QStringLiteral("versions")).toList().value(0).toMap();
+            info.insert(QStringLiteral("dependencies"),
+                        newest.value(QStringLiteral("manifest")).toMap()
+                              .value(QStringLiteral("dependencies")));
+        }
+    }
+    after(m_config.latencyMs, [onDone, info]() { onDone(info); });
+}
+
+void StandInModuleGateway::installPlugin(const QString& filePath, InstallCallback onDone,
+                                         int timeoutMs)
+{
+    count("installPlugin");
+    if (m_config.installMs > timeoutMs) {
+        after(timeoutMs, [onDone]() {
+            InstallReply r;
+            r.ok = false;
+            r.errorCode    = QStringLiteral("timeout");
+            r.errorMessage = QStringLiteral("stand-in: installPlugin timed out");
+            onDone(r);
+        });
+        return;
+    }
+    after(m_config.installMs, [this, filePath, onDone]() {
+        InstallReply r;
+        const QVariantMap artifact = readArtifact(filePath);
+        const QString name = artifact.value(QStringLiteral("name")).toString();
+        if (name.isEmpty()) {
+            r.value.insert(QStringLiteral("error"), QStringLiteral("stand-in: unreadable package"));
+        } else if (injectFailure(m_config.failInstalls, name)) {
+            r.value.insert(QStringLiteral("error"), QStringLiteral("stand-in: install failed"));
+        } else {
+            m_installed.insert(name, QVariantMap{
+                {QStringLiteral("name"), name},
+                {QStringLiteral("moduleName"), name},
+                {QStringLiteral("version"), artifact.value(QStringLiteral("version"))},
+                {QStringLiteral("installType"), QStringLiteral("user")},
+                {QStringLiteral("hashes"), QVariantMap{
+                    {QStringLiteral("root"), artifact.value(QStringLiteral("rootHash"))}}},
+            });
+            r.value.insert(QStringLiteral("path"), m_artifactDir + QStringLiteral("/installed/") + name);
+        }
+        onDone(r);
+        if (!r.value.contains(QStringLiteral("error")))
+            emitManagerEvent(QStringLiteral("corePluginFileInstalled"), {name});
+    });
+}
+
+void StandInModuleGateway::requestInstall(const QString& name, const QString& version,
+                                          const QString& repositoryUrl, const QString&,
+                                          MapCallback onDone)
+{
+    count("requestInstall");
+    after(m_config.latencyMs, [this, name, version, repositoryUrl, onDone]() {
+        onDone({{QStringLiteral("success"), true}});
+        if (m_config.approveGates) {
+            emitManagerEvent(QStringLiteral("installApproved"), jsonPayload({
+                {QStringLiteral("name"), name},
+                {QStringLiteral("releaseTag"), version},
+                {QStringLiteral("repositoryUrl"), repositoryUrl}}));
+        } else {
+            emitManagerEvent(QStringLiteral("installCancelled"), jsonPayload({
+                {QStringLiteral("name"), name},
+                {QStringLiteral("reason"), QStringLiteral("declined by the stand-in host")}}));
+        }
+    });
+}
+
+bool StandInModuleGateway::uninstallOne(const QString& name, QString* error)
+{
+    auto it = m_installed.find(name);
+    if (it == m_installed.end()) {
+        *error = QStringLiteral("%1 is not installed").arg(name);
+        return false;
+    }
+    if (it->value(QStringLiteral("installType")).toString() == QLatin1String("embedded")) {
+        *error = QStringLiteral("%1 is embedded and cannot be uninstalled").arg(name);
+        return false;
+    }
+    m_installed.erase(it);
+    emitManagerEvent(QStringLiteral("corePluginUninstalled"), {name});
+    return true;
+}
+
+void StandInModuleGateway::requestUpgrade(const QString& name, const QString& version, int mode,
+                                          const QString&, MapCallback onDone)
+{
+    count("requestUpgrade");
+    after(m_config.latencyMs, [this, name, version, mode, onDone]() {
+        onDone({{QStringLiteral("success"), true}});
+        if (!m_config.approveGates) {
+            emitManagerEvent(QStringLiteral("upgradeCancelled"), jsonPayload({
+                {QStringLiteral("name"), name},
+                {QStringLiteral("releaseTag"), version},
+                {QStringLiteral("reason"), QStringLiteral("declined by the stand-in host")}}));
+            return;
+        }
+        // Like the real gate: the old version goes first, then PMU is
+        // told to bring in the new one.
+        QString ignored;
+        uninstallOne(name, &ignored);
+        emitManagerEvent(QStringLiteral("upgradeUninstallDone"), jsonPayload({
+            {QStringLiteral("name"), name},
+            {QStringLiteral("releaseTag"), version},
+            {QStringLiteral("mode"), mode}}));
+    });
+}
+
+void StandInModuleGateway::requestUninstall(const QString& name, MapCallback onDone)
+{
+    count("requestUninstall");
+    uninstallGate({name}, std::move(onDone));
+}
+
+void StandInModuleGateway::requestMultiUninstall(const QStringList& names, MapCallback onDone)
+{
+    count("requestMultiUninstall");
+    uninstallGate(names, std::move(onDone));
+}
+
+void StandInModuleGateway::uninstallGate(const QStringList& names, MapCallback onDone)
+{
+    after(m_config.latencyMs, [this, names, onDone]() {
+        if (!m_config.approveGates) {
+            onDone({{QStringLiteral("success"), true}});
+            for (const QString& name : names) {
+                emitManagerEvent(QStringLiteral("uninstallCancelled"), jsonPayload({
+                    {QStringLiteral("name"), name},
+                    {QStringLiteral("reason"), QStringLiteral("declined by the stand-in host")}}));
+            }
+            return;
+        }
+        QStringList errors;
+        for (const QString& name : names) {
+            QString err;
+            if (!uninstallOne(name, &err)) errors.append(err);
+        }
+        if (errors.isEmpty())
+            onDone({{QStringLiteral("success"), true}});
+        else
+            onDone({{QStringLiteral("success"), false},
+                    {QStringLiteral("error"), errors.join(QStringLiteral("; "))}});
+    });
+}
+
+void StandInModuleGateway::onManagerEvent(const QString& event, EventHandler handler)
+{
+    m_managerHandlers.insert(event, std::move(handler));
+}
@@ -0,0 +1,149 @@
+#pragma once
+
+#include <memory>
+
+#include <QHash>
+#include <QMap>
+#include <QObject>
+#include <QPair>
+#include <QRandomGenerator>
+#include <QSet>
+#include <QStringList>
+#include <QTemporaryDir>
+#include <QTimer>
+
+#include "ModuleGateway.h"
+
+// In-process stand-ins for package_downloader and package_manager, so the
+// backend can run with no modules and no host: headless end-to-end tests,
+// profiling the install and refresh flows on a plain Linux box.
+//
+// What they do:
+//   * catalog — a SyntheticCatalog of `catalogRows` × `versionsPerRow`,
+//     with its installed set as the starting on-disk state; editCatalog
+//     (or `catalogChangedEveryMs`) publishes changes, which
+//     getCatalogDelta reports back by generation;
+//   * resolve / download — a name-based walk of the catalog's manifest
+//     dependencies; "downloading" writes a tiny JSON .lgx per artifact
+//     after emitting a few downloadProgress events for it;
+//   * installPlugin / inspectPackage — read those files back (any other
+//     file fails inspection); a successful install updates the installed
+//     set and emits corePluginFileInstalled;
+//   * gates — the stand-in also plays the host: requestInstall /
+//     requestUpgrade / requestUninstall are approved (installApproved,
+//     corePluginUninstalled + upgradeUninstallDone) or, with
+//     approveGates off, cancelled.
+//
+// Every reply arrives after `latencyMs` on the event loop. Failures are
+// injected per package name or at `failureRate` (seeded, so a run is
+// reproducible).
+class StandInModuleGateway : public QObject, public ModuleGateway {
+    Q_OBJECT
+
+public:
+    struct Config {
+        int         catalogRows     = 200;
+        int         versionsPerRow  = 3;
+        int         latencyMs       = 15;    // every reply
+        int         downloadMs      = 120;   // per download call, progress spread over it
+        int         installMs       = 40;    // per installPlugin
+        QStringList failDownloads;           // names whose download reports an error
+        QStringList failInstalls;            // names whose installPlugin reports an error
+        double      failureRate     = 0.0;   // extra random download / install failures
+        quint32     seed            = 1;
+        bool        approveGates    = true;
+        int         catalogChangedEveryMs = 0;   // > 0: republish one row periodically
+        int         deltaHistory    = 64;    // generations getCatalogDelta can describe
+        QString     artifactDirectory;       // empty = a private temp dir
+
+        // PMU_STANDIN_ROWS, _VERSIONS, _LATENCY_MS, _DOWNLOAD_MS,
+        // _INSTALL_MS, _FAIL_DOWNLOAD / _FAIL_INSTALL (comma-separated
+        // names), _FAILURE_RATE, _SEED, _DECLINE (=1: cancel every gate),
+        // _CATALOG_CHANGED_MS, _DELTA_HISTORY, _ARTIFACT_DIR.
+        static Config fromEnvironment();
+    };
+
+    // PMU_STANDIN_MODULES set to anything but "0".
+    static bool enabledByEnvironment();
+
+    explicit StandInModuleGateway(const Config& config = Config(), QObject* parent = nullptr);
+    ~StandInModuleGateway() override;
+
+    const Config& config() const { return m_config; }
+    // Current installed set, as getInstalledPackages reports it.
+    QVariantList installedPackages() const;
+    // Calls received per method name ("getCatalog", "installPlugin", …).
+    int callCount(const QString& method) const { return m_calls.value(method); }
+
+    // Publish a catalog edit: upsert `rows` (by repositoryUrl + name),
+    // drop `removed` ({repositoryUrl, name}), bump the generation and
+    // emit catalogChanged with it, as a repository update would.
+    void editCatalog(const QVariantList& rows, const QVariantList& removed = {});
+    qint64 catalogGeneration() const { return m_generation; }
+
+    // Fire an event at the backend's subscribers, as the module would.
+    void emitDownloaderEvent(const QString& event, const QVariantList& data);
+    void emitManagerEvent(const QString& event, const QVariantList& data);
+
+    bool isReady(const char* moduleName) const override;
+
+    void refreshCatalog(MapCallback onDone) override;
+    void refreshRepository(const QString& repositoryUrl, MapCallback onDone) override;
+    void getCatalog(ListCallback onDone) override;
+    void getCatalogDelta(qint64 sinceGeneration, MapCallback onDone) override;
+    void listRepositories(ListCallback onDone) override;
+    void resolveDependencies(const QString& depsJson, const QString& installedJson,
+                             ListCallback onDone) override;
+    void downloadResolvedDependencies(const QString& depsJson, const QString& installedJson,
+                                      ListCallback onDone, int timeoutMs) override;
+    void onDownloaderEvent(const QString& event, EventHandler handler) override;
+
+    void getInstalledPackages(ListCallback onDone) override;
+    void getValidVariants(VariantCallback onDone) override;
+    void inspectPackage(const QString& filePath, MapCallback onDone) override;
+    void installPlugin(const QString& filePath, InstallCallback onDone,
+                       int timeoutMs) override;
+    void requestInstall(const QString& name, const QString& version,
+                        const QString& repositoryUrl, const QString& changesJson,
+                        MapCallback onDone) override;
+    void requestUpgrade(const QString& name, const QString& version, int mode,
+                        const QString& changesJson, MapCallback onDone) override;
+    void requestUninstall(const QString& name, MapCallback onDone) override;
+    void requestMultiUninstall(const QStringList& names, MapCallback onDone) override;
+    void onManagerEvent(const QString& event, EventHandler handler) override;
+
+private:
+    void after(int ms, std::function<void()> fn);
+    void count(const char* method) { ++m_calls[QString::fromLatin1(method)]; }
+    bool injectFailure(const QStringList& names, const QString& name);
+    void reindexCatalog();
+    // Event payloads are one JSON-encoded string, like the real modules'.
+    static QVariantList jsonPayload(const QVariantMap& obj);
+
+    // [{name, version, repositoryUrl, rootHash, size, topLevel} | {name, error}],
+    // dependencies before their dependents.
+    QVariantList resolve(const QString& depsJson, const QString& installedJson) const;
+    QString writeArtifact(const QVariantMap& entry) const;
+    bool uninstallOne(const QString& name, QString* error);
+    // Host side of requestUninstall / requestMultiUninstall.
+    void uninstallGate(const QStringList& names, MapCallback onDone);
+
+    Config       m_config;
+    QVariantList m_catalog;
+    QHash<QString, QList<int>> m_rowsByName;      // catalog row indices
+    QHash<QString, int> m_rowByKey;               // catalogdelta::rowKey → row index
+    // Catalog generation and, per row key, the generation it was last
+    // upserted / first added / removed in (rows from the start have none).
+    qint64 m_generation = 1;
+    QHash<QString, qint64> m_rowChanged;
+    QHash<QString, qint64> m_rowAdded;
+    QHash<QString, QPair<qint64, QVariantMap>> m_rowRemoved;
+    QMap<QString, QVariantMap> m_installed;       // by name; QMap keeps replies ordered
+    QRandomGenerator m_rng;
+    std::unique_ptr<QTemporaryDir> m_tempDir;
+    QString      m_artifactDir;
+    QTimer*      m_catalogChangedTimer = nullptr;
+    QHash<QString, int> m_calls;
+    QMultiHash<QString, EventHandler> m_downloaderHandlers;
+    QMultiHash<QString, EventHandler> m_managerHandlers;
+};
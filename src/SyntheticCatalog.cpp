@@ -0,0 +1,94 @@
+#include "SyntheticCatalog.h"
+
+#include <QRandomGenerator>
+#include <QStringList>
+#include <QVariantMap>
+
+namespace syntheticcatalog {
+
+namespace {
+
+const QStringList kRepos{QStringLiteral("logos-modules-official"),
+                         QStringLiteral("community-modules"),
+                         QStringLiteral("dario-modules")};
+const QStringList kCategories{QStringLiteral("Networking"), QStringLiteral("Chat"),
+                              QStringLiteral("Storage"), QStringLiteral("Wallet"),
+                              QStringLiteral("Developer"), QStringLiteral("Media")};
+const QStringList kTypes{QStringLiteral("core"), QStringLiteral("ui"), QStringLiteral("ui_qml")};
+
+} // namespace
+
+Catalog make(int rowCount, int versionCount)
+{
+    QRandomGenerator rng(0x5eed + rowCount * 31 + versionCount);
+    Catalog c;
+    c.rows.reserve(rowCount);
+    for (int i = 0; i < rowCount; ++i) {
+        const QString name = QStringLiteral("pkg_%1").arg(i, 6, 10, QLatin1Char('0'));
+        const QString repo = kRepos.at(i % kRepos.size());
+        const QString category = kCategories.at(rng.bounded(kCategories.size()));
+        const QString type = kTypes.at(i % kTypes.size());
+
+        QVariantMap main;
+        if (i % 10 == 9) {
+            main.insert(QStringLiteral("darwin-arm64"), name + QStringLiteral(".dylib"));
+        } else {
+            main.insert(QStringLiteral("linux-x86_64"), name + QStringLiteral(".so"));
+            main.insert(QStringLiteral("darwin-arm64"), name + QStringLiteral(".dylib"));
+        }
+        QVariantList deps;
+        if (i > 0) deps.append(QStringLiteral("pkg_%1").arg(rng.bounded(i), 6, 10, QLatin1Char('0')));
+        if (i > 1) deps.append(QVariantMap{
+            {QStringLiteral("name"), QStringLiteral("pkg_%1").arg(rng.bounded(i), 6, 10, QLatin1Char('0'))},
+            {QStringLiteral("version"), QStringLiteral(">=1.0.0")}});
+
+        QVariantList versions;
+        versions.reserve(versionCount);
+        for (int v = versionCount - 1; v >= 0; --v) {   // newest first
+            const QString version = QStringLiteral("1.%1.%2").arg(v).arg(i % 7);
+            versions.append(QVariantMap{
+                {QStringLiteral("rootHash"),
+                 QString::number(rng.generate64(), 16) + QString::number(rng.generate64(), 16)},
+                {QStringLiteral("releasedAt"), QStringLiteral("2026-0%1-15T12:00:00Z").arg(1 + v % 9)},
+                {QStringLiteral("size"), 40000 + int(rng.bounded(4000000))},
+                {QStringLiteral("url"), QStringLiteral("https://example.invalid/%1/%2.lgx").arg(repo, name)},
+                {QStringLiteral("manifest"), QVariantMap{
+                    {QStringLiteral("name"), name},
+                    {QStringLiteral("version"), version},
+                    {QStringLiteral("description"),
+                     QStringLiteral("Synthetic %1 module number %2").arg(category).arg(i)},
+                    {QStringLiteral("type"), type},
+                    {QStringLiteral("category"), category},
+                    {QStringLiteral("main"), main},
+                    {QStringLiteral("dependencies"), deps}}},
+            });
+        }
+        c.rows.append(QVariantMap{
+            {QStringLiteral("name"), name},
+            {QStringLiteral("repositoryUrl"), QStringLiteral("https://example.invalid/%1/logos-repo.json").arg(repo)},
+            {QStringLiteral("repositoryName"), repo},
+            {QStringLiteral("repositoryDisplayName"), repo},
+            {QStringLiteral("versions"), versions},
+        });
+
+        if (i % 4 == 0) {
+            c.installed.append(QVariantMap{
+                {QStringLiteral("name"), name},
+                {QStringLiteral("moduleName"), name},
+                {QStringLiteral("version"), QStringLiteral("1.0.%1").arg(i % 7)},
+                {QStringLiteral("installType"), QStringLiteral("user")},
+                {QStringLiteral("hashes"), QVariantMap{{QStringLiteral("root"), QStringLiteral("h%1").arg(i)}}},
+            });
+        }
+    }
+    for (int i = 0; i < rowCount / 100; ++i) {
+        c.installed.append(QVariantMap{
+            {QStringLiteral("name"), QStringLiteral("local_%1").arg(i)},
+            {QStringLiteral("version"), QStringLiteral("0.1.0")},
+            {QStringLiteral("installType"), QStringLiteral("user")},
+        });
+    }
+    return c;
+}
+
+} // namespace syntheticcatalog
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <QVariantList>
+
+// Deterministic synthetic catalog in package_downloader.getCatalog()'s
+// multi-repo shape, plus a matching getInstalledPackages() list. Used by
+// the stand-in modules (StandInModuleGateway) and the benchmarks, so
+// both exercise the same data.
+//
+// Shape: rows named pkg_000000…, spread over three repositories (the
+// first is the default "logos-modules-official"), six categories and
+// three types; `versionCount` versions per row, newest first, each with
+// a manifest carrying 0–2 dependencies on lower-numbered packages (so
+// the graph is acyclic). Every 4th package is installed at its oldest
+// version, one in ten offers only darwin-arm64 (not installable on
+// linux-x86_64), and 1% extra installed entries are local-only.
+namespace syntheticcatalog {
+
+struct Catalog {
+    QVariantList rows;
+    QVariantList installed;
+};
+
+// Same (rowCount, versionCount) → same catalog, byte for byte.
+Catalog make(int rowCount, int versionCount);
+
+} // namespace syntheticcatalog
@@ -0,0 +1,116 @@
+#include "TimedModuleGateway.h"
+
+TimedModuleGateway::TimedModuleGateway(std::unique_ptr<ModuleGateway> inner,
+                                       std::shared_ptr<PerfStats> perf)
+    : m_inner(std::move(inner))
+    , m_perf(std::move(perf))
+{
+}
+
+bool TimedModuleGateway::isReady(const char* moduleName) const
+{
+    return m_inner->isReady(moduleName);
+}
+
+// ── package_downloader ──────────────────────────────────────────────
+
+void TimedModuleGateway::refreshCatalog(MapCallback onDone)
+{
+    m_inner->refreshCatalog(timed("ipc.refreshCatalog", std::move(onDone)));
+}
+
+void TimedModuleGateway::refreshRepository(const QString& repositoryUrl, MapCallback onDone)
+{
+    m_inner->refreshRepository(repositoryUrl,
+                               timed("ipc.refreshRepository", std::move(onDone)));
+}
+
+void TimedModuleGateway::getCatalog(ListCallback onDone)
+{
+    m_inner->getCatalog(timed("ipc.getCatalog", std::move(onDone)));
+}
+
+void TimedModuleGateway::getCatalogDelta(qint64 sinceGeneration, MapCallback onDone)
+{
+    m_inner->getCatalogDelta(sinceGeneration, timed("ipc.getCatalogDelta", std::move(onDone)));
+}
+
+void TimedModuleGateway::listRepositories(ListCallback onDone)
+{
+    m_inner->listRepositories(timed("ipc.listRepositories", std::move(onDone)));
+}
+
+void TimedModuleGateway::resolveDependencies(const QString& depsJson,
+                                             const QString& installedJson,
+                                             ListCallback onDone)
+{
+    m_inner->resolveDependencies(depsJson, installedJson,
+                                 timed("ipc.resolveDependencies", std::move(onDone)));
+}
+
+void TimedModuleGateway::downloadResolvedDependencies(const QString& depsJson,
+                                                      const QString& installedJson,
+                                                      ListCallback onDone, int timeoutMs)
+{
+    m_inner->downloadResolvedDependencies(
+        depsJson, installedJson,
+        timed("ipc.downloadResolvedDependencies", std::move(onDone)), timeoutMs);
+}
+
+void TimedModuleGateway::onDownloaderEvent(const QString& event, EventHandler handler)
+{
+    m_inner->onDownloaderEvent(event, std::move(handler));
+}
+
+// ── package_manager ─────────────────────────────────────────────────
+
+void TimedModuleGateway::getInstalledPackages(ListCallback onDone)
+{
+    m_inner->getInstalledPackages(timed("ipc.getInstalledPackages", std::move(onDone)));
+}
+
+void TimedModuleGateway::getValidVariants(VariantCallback onDone)
+{
+    m_inner->getValidVariants(timed("ipc.getValidVariants", std::move(onDone)));
+}
+
+void TimedModuleGateway::inspectPackage(const QString& filePath, MapCallback onDone)
+{
+    m_inner->inspectPackage(filePath, timed("ipc.inspectPackage", std::move(onDone)));
+}
+
+void TimedModuleGateway::installPlugin(const QString& filePath, InstallCallback onDone,
+                                       int timeoutMs)
+{
+    m_inner->installPlugin(filePath, timed("ipc.installPlugin", std::move(onDone)), timeoutMs);
+}
+
+void TimedModuleGateway::requestInstall(const QString& name, const QString& version,
+                                        const QString& repositoryUrl,
+                                        const QString& changesJson, MapCallback onDone)
+{
+    m_inner->requestInstall(name, version, repositoryUrl, changesJson,
+                            timed("ipc.requestInstall", std::move(onDone)));
+}
+
+void TimedModuleGateway::requestUpgrade(const QString& name, const QString& version, int mode,
+                                        const QString& changesJson, MapCallback onDone)
+{
+    m_inner->requestUpgrade(name, version, mode, changesJson,
+                            timed("ipc.requestUpgrade", std::move(onDone)));
+}
+
+void TimedModuleGateway::requestUninstall(const QString& name, MapCallback onDone)
+{
+    m_inner->requestUninstall(name, timed("ipc.requestUninstall", std::move(onDone)));
+}
+
+void TimedModuleGateway::requestMultiUninstall(const QStringList& names, MapCallback onDone)
+{
+    m_inner->requestMultiUninstall(names, timed("ipc.requestMultiUninstall", std::move(onDone)));
+}
+
+void TimedModuleGateway::onManagerEvent(const QString& event, EventHandler handler)
+{
+    m_inner->onManagerEvent(event, std::move(handler));
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <memory>
+
+#include "ModuleGateway.h"
+#include "PerfStats.h"
+
+// ModuleGateway decorator that times every request/reply round trip as
+// "ipc.<method>" into a PerfStats, then forwards to the wrapped gateway.
+// Event subscriptions and isReady pass straight through. The backend
+// only installs it when timing is enabled, so the normal path keeps no
+// extra hop.
+//
+// The stats are shared, not borrowed: a reply can land after the
+// backend that owns them has started tearing down.
+class TimedModuleGateway : public ModuleGateway {
+public:
+    TimedModuleGateway(std::unique_ptr<ModuleGateway> inner, std::shared_ptr<PerfStats> perf);
+
+    ModuleGateway* inner() const { return m_inner.get(); }
+
+    bool isReady(const char* moduleName) const override;
+
+    void refreshCatalog(MapCallback onDone) override;
+    void refreshRepository(const QString& repositoryUrl, MapCallback onDone) override;
+    void getCatalog(ListCallback onDone) override;
+    void getCatalogDelta(qint64 sinceGeneration, MapCallback onDone) override;
+    void listRepositories(ListCallback onDone) override;
+    void resolveDependencies(const QString& depsJson, const QString& installedJson,
+                             ListCallback onDone) override;
+    void downloadResolvedDependencies(const QString& depsJson, const QString& installedJson,
+                                      ListCallback onDone, int timeoutMs) override;
+    void onDownloaderEvent(const QString& event, EventHandler handler) override;
+
+    void getInstalledPackages(ListCallback onDone) override;
+    void getValidVariants(VariantCallback onDone) override;
+    void inspectPackage(const QString& filePath, MapCallback onDone) override;
+    void installPlugin(const QString& filePath, InstallCallback onDone,
+                       int timeoutMs) override;
+    void requestInstall(const QString& name, const QString& version,
+                        const QString& repositoryUrl, const QString& changesJson,
+                        MapCallback onDone) override;
+    void requestUpgrade(const QString& name, const QString& version, int mode,
+                        const QString& changesJson, MapCallback onDone) override;
+    void requestUninstall(const QString& name, MapCallback onDone) override;
+    void requestMultiUninstall(const QStringList& names, MapCallback onDone) override;
+    void onManagerEvent(const QString& event, EventHandler handler) override;
+
+private:
+    // Wrap `onDone` so the span "name" closes just before it runs.
+    template <typename Callback>
+    Callback timed(const char* name, Callback onDone) const
+    {
+        return [perf = m_perf, name, began = m_perf->begin(),
+                onDone = std::move(onDone)](auto reply) {
+            perf->end(name, began);
+            onDone(std::move(reply));
+        };
+    }
+
+    std::unique_ptr<ModuleGateway> m_inner;
+    std::shared_ptr<PerfStats>     m_perf;
+};
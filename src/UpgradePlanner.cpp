@@ -0,0 +1,236 @@
+#include "UpgradePlanner.h"
+
+#include <algorithm>
+#include <QHash>
+
+#include "RowActionResolver.h"
+
+namespace {
+
+using Candidate = LocalDependencyResolver::Candidate;
+using Dep       = LocalDependencyResolver::Dep;
+
+struct State {
+    QString name;
+    QString moduleName;
+    QString installedVersion;
+    const Candidate*        installedCandidate = nullptr;
+    QList<const Candidate*> options;   // newer than installed, newest first
+    int     pick = -1;                 // index into options; -1 = stay installed
+    QString blockedBy;
+    QString reason;
+
+    QString version() const
+    {
+        return pick >= 0 ? options.at(pick)->version : installedVersion;
+    }
+    const QList<Dep>* deps() const
+    {
+        if (pick >= 0) return &options.at(pick)->deps;
+        return installedCandidate ? &installedCandidate->deps : nullptr;
+    }
+};
+
+// The same few ranges are checked against the same few versions over
+// and over; parsing a range costs far more than a hash lookup.
+class SatisfiesMemo {
+public:
+    bool operator()(const QString& version, const QString& range)
+    {
+        const QString key = range + QChar(0x01) + version;
+        auto it = m_memo.constFind(key);
+        if (it != m_memo.constEnd()) return it.value();
+        const bool ok = LocalDependencyResolver::satisfies(version, range);
+        m_memo.insert(key, ok);
+        return ok;
+    }
+
+private:
+    QHash<QString, bool> m_memo;
+};
+
+} // namespace
+
+UpgradePlanner::Plan UpgradePlanner::plan(const LocalDependencyResolver& catalog,
+                                          const InstalledSnapshot& installed)
+{
+    const QHash<QString, QList<Candidate>>& index = catalog.index();
+    const QHash<QString, QString>& installedVersions = installed.versionByName();
+
+    // Sorted so the greedy choices below don't depend on hash order.
+    QStringList names = index.keys();
+    std::sort(names.begin(), names.end());
+
+    QList<State> states;
+    QHash<QString, int> stateByName;   // catalog name and moduleName → state
+    for (const QString& name : names) {
+        const QList<Candidate>& candidates = index.find(name).value();
+        if (candidates.isEmpty()) continue;
+        State s;
+        s.name       = name;
+        s.moduleName = candidates.first().moduleName;
+        QString key  = s.moduleName;
+        s.installedVersion = installedVersions.value(key);
+        if (s.installedVersion.isEmpty()) {
+            key = name;
+            s.installedVersion = installedVersions.value(key);
+        }
+        if (s.installedVersion.isEmpty()) continue;
+
+        // Pin to the repository the installed bytes came from.
+        QString pin;
+        const QString rootHash = installed.rootHashFor(key);
+        if (!rootHash.isEmpty()) {
+            for (const Candidate& c : candidates) {
+                if (c.rootHash == rootHash) {
+                    pin = c.repositoryUrl;
+                    s.installedCandidate = &c;
+                    break;
+                }
+            }
+        }
+        if (!s.installedCandidate) {
+            for (const Candidate& c : candidates) {
+                if (rowaction::versionCmp(c.version, s.installedVersion) == 0) {
+                    s.installedCandidate = &c;
+                    break;
+                }
+            }
+        }
+
+        for (const Candidate& c : candidates) {
+            if (!pin.isEmpty() && c.repositoryUrl != pin) continue;
+            if (rowaction::versionCmp(c.version, s.installedVersion) <= 0) continue;
+            // Same version from a lower-priority repo adds nothing.
+            if (!s.options.isEmpty()
+                && rowaction::versionCmp(s.options.last()->version, c.version) == 0)
+                continue;
+            s.options.append(&c);
+        }
+        s.pick = s.options.isEmpty() ? -1 : 0;
+
+        const int id = states.size();
+        stateByName.insert(name, id);
+        if (s.moduleName != name) stateByName.insert(s.moduleName, id);
+        states.append(s);
+    }
+
+    // Static reverse index: who might ever depend on state j, across every
+    // version a state could settle on.
+    QList<QList<int>> dependents(states.size());
+    for (int i = 0; i < states.size(); ++i) {
+        const State& s = states.at(i);
+        auto addEdges = [&](const Candidate* c) {
+            if (!c) return;
+            for (const Dep& dep : c->deps) {
+                const int j = stateByName.value(dep.name, -1);
+                if (j < 0 || j == i) continue;
+                if (dependents[j].isEmpty() || dependents[j].last() != i)
+                    dependents[j].append(i);
+            }
+        };
+        addEdges(s.installedCandidate);
+        for (const Candidate* c : s.options) addEdges(c);
+    }
+
+    SatisfiesMemo satisfies;
+    auto anySatisfies = [&](const QList<Candidate>& candidates, const QString& range) {
+        for (const Candidate& c : candidates) {
+            if (satisfies(c.version, range)) return true;
+        }
+        return false;
+    };
+
+    QList<int>  queue;
+    QList<bool> queued(states.size(), true);
+    queue.reserve(states.size());
+    for (int i = 0; i < states.size(); ++i) queue.append(i);
+    auto touch = [&](int i) {
+        if (!queued[i]) { queued[i] = true; queue.append(i); }
+        for (int d : dependents.at(i)) {
+            if (!queued[d]) { queued[d] = true; queue.append(d); }
+        }
+    };
+    // Step state i one candidate down (or back to installed).
+    auto giveWay = [&](int i, const QString& blocker, const QString& why) {
+        State& s = states[i];
+        if (s.pick < 0) return false;
+        s.pick = s.pick + 1 < s.options.size() ? s.pick + 1 : -1;
+        s.blockedBy = blocker;
+        s.reason    = why;
+        return true;
+    };
+
+    for (int head = 0; head < queue.size(); ++head) {
+        const int i = queue.at(head);
+        queued[i] = false;
+        const QList<Dep>* deps = states.at(i).deps();
+        if (!deps) continue;
+
+        for (const Dep& dep : *deps) {
+            const int j = stateByName.value(dep.name, -1);
+            if (j == i) continue;
+            if (j < 0) {
+                // Not installed: the preview on dispatch adds it; just make
+                // sure something can.
+                if (anySatisfies(catalog.candidatesFor(dep.name), dep.range)) continue;
+                if (giveWay(i, dep.name,
+                            QStringLiteral("no catalog version of %1 satisfies '%2'")
+                                .arg(dep.name, dep.range)))
+                    touch(i);
+                break;
+            }
+
+            State& d = states[j];
+            if (satisfies(d.version(), dep.range)) continue;
+
+            // Prefer holding the dependency back: newest older candidate
+            // that fits, else its installed version.
+            if (d.pick >= 0) {
+                int found = -2;
+                for (int k = d.pick + 1; k < d.options.size(); ++k) {
+                    if (satisfies(d.options.at(k)->version, dep.range)) {
+                        found = k;
+                        break;
+                    }
+                }
+                if (found == -2 && satisfies(d.installedVersion, dep.range))
+                    found = -1;
+                if (found != -2) {
+                    d.pick      = found;
+                    d.blockedBy = states.at(i).name;
+                    d.reason    = QStringLiteral("%1 requires %2 '%3'")
+                                      .arg(states.at(i).name, dep.name, dep.range);
+                    touch(j);
+                    continue;
+                }
+            }
+
+            // The dependency can't move to fit — the dependent gives way.
+            // Its dependency list changes with it, so stop here; it's
+            // re-queued and re-checked from the top.
+            if (giveWay(i, dep.name,
+                        QStringLiteral("requires %1 '%2'; %1 can be at most %3")
+                            .arg(dep.name, dep.range, d.version())))
+                touch(i);
+            break;
+        }
+    }
+
+    Plan plan;
+    for (const State& s : states) {
+        if (s.options.isEmpty()) continue;
+        if (s.pick >= 0) {
+            const Candidate* c = s.options.at(s.pick);
+            plan.upgrades.append({s.name, s.moduleName, c->repositoryUrl,
+                                  s.installedVersion, c->version});
+        }
+        if (s.pick != 0) {
+            plan.conflicts.append({s.name, s.moduleName, s.installedVersion,
+                                   s.options.first()->version,
+                                   s.pick >= 0 ? s.options.at(s.pick)->version : QString(),
+                                   s.blockedBy, s.reason});
+        }
+    }
+    return plan;
+}
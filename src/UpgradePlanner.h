@@ -0,0 +1,59 @@
+#pragma once
+
+#include <QList>
+#include <QString>
+
+#include "InstalledSnapshot.h"
+#include "LocalDependencyResolver.h"
+
+// "Upgrade all" in one pass: picks, for every installed package with a
+// newer catalog version, the newest version that is compatible with
+// every other package's pick — both the packages being upgraded and the
+// installed ones staying put.
+//
+// Each upgradable package starts at its newest candidate and only ever
+// moves DOWN its candidate list (towards, and finally back to, the
+// installed version), so the pass always terminates. A worklist keyed
+// on a static reverse-dependency index re-checks only packages whose
+// picks or dependencies moved; on a catalog of thousands of modules
+// that is a few edge checks per package.
+//
+// When a dependency's range is violated, the dependency is lowered if
+// it can be (it's being upgraded too and an older candidate at or above
+// its installed version fits); otherwise the dependent is lowered. A
+// package that ends below its newest candidate is reported as a
+// conflict naming the package / range that held it back.
+//
+// Repo pins: an installed package stays with the repository its
+// installed rootHash came from. A package whose installed copy matches
+// no catalog entry is unpinned.
+//
+// Dependencies that aren't installed are left to the dependency preview
+// that runs on dispatch — the planner only checks some catalog version
+// can satisfy them at all.
+class UpgradePlanner {
+public:
+    struct Item {
+        QString name;            // catalog name
+        QString moduleName;
+        QString repositoryUrl;
+        QString fromVersion;
+        QString toVersion;
+    };
+    struct Conflict {
+        QString name;
+        QString moduleName;
+        QString installedVersion;
+        QString newestVersion;   // what "upgrade all" would have wanted
+        QString plannedVersion;  // what it settled on; empty = stays put
+        QString blockedBy;       // the dependency involved
+        QString reason;
+    };
+    struct Plan {
+        QList<Item>     upgrades;
+        QList<Conflict> conflicts;
+    };
+
+    static Plan plan(const LocalDependencyResolver& catalog,
+                     const InstalledSnapshot& installed);
+};
@@ -24,6 +24,11 @@ QtObject {
     // ─── Properties: reactive state (bind from views) ───
     readonly property bool isInstalling: backend ? backend.isInstalling : false
     readonly property bool isLoading: backend ? backend.isLoading : false
+    // Byte-level download progress (throttled by the backend) — see
+    // the downloadProgress PROP in the .rep for the shape.
+    readonly property var downloadProgress: backend ? backend.downloadProgress : ({})
+    // Installs a crash left half-done, awaiting resolveInterruptedInstalls.
+    readonly property var interruptedInstalls: backend ? backend.interruptedInstalls : []
     // Bulk "Run Actions" surface. Replaces the old has*Selection
     // booleans: the header reads the count for its label and the
     // confirm-summary popup reads the map for its per-action breakdown.
@@ -43,6 +48,8 @@ QtObject {
     readonly property int pageSize: backend ? backend.pageSize : 20
     readonly property int currentPage: backend ? backend.currentPage : 1
     readonly property int totalCount: backend ? backend.totalCount : 0
+    readonly property var sourceGroupCounts: backend ? backend.sourceGroupCounts : ({})
+    readonly property var collapsedSources: backend ? backend.collapsedSources : []
     readonly property int repositoryCount: backend ? backend.repositoryCount : 0
     readonly property string sortRole: backend ? backend.sortRole : ""
     readonly property int sortOrder: backend ? backend.sortOrder : Qt.AscendingOrder
@@ -51,12 +58,19 @@ QtObject {
     readonly property int selectedTypeIndex: backend ? backend.selectedTypeIndex : 0
 
     readonly property alias selectedPackageDetails: d.selectedPackageDetails
+    // Packages the last upgradeAll() held below their newest version —
+    // see the upgradePlanConflicts signal in the .rep for the shape.
+    readonly property alias upgradeConflicts: d.upgradeConflicts
+    // Last installRolledBack report (see the .rep); {} until one arrives.
+    readonly property alias rollbackReport: d.rollbackReport
 
     property QtObject d: QtObject {
         id: d
 
         property var selectedPackageDetails: ({})
         property int selectedPackageIndex: -1
+        property var upgradeConflicts: []
+        property var rollbackReport: ({})
 
         property Connections conn: Connections {
             target: store.backend
@@ -65,16 +79,30 @@ QtObject {
             function onPackageDetailsLoaded(details) {
                 d.selectedPackageDetails = details || ({})
             }
+
+            function onUpgradePlanConflicts(conflicts) {
+                d.upgradeConflicts = conflicts || []
+            }
+
+            function onInstallRolledBack(report) {
+                d.rollbackReport = report || ({})
+            }
         }
     }
 
     // ─── Methods: intents called by views ───
     function refreshCatalog() { if (backend) backend.refreshCatalog() }
+    function refreshRepository(url) { if (backend) backend.refreshRepository(url) }
     function installLocalPackage(url) { if (backend) backend.installLocalPackage(url) }
+    function installLocalPackages(urls) { if (backend) backend.installLocalPackages(urls) }
     // New bulk path — used by the "Run Actions (N)" header button.
     // Backend builds the per-row action plan and dispatches installs
     // through the batched downloader + version changes per-row.
     function runSelectedActions() { if (backend) backend.runSelectedActions() }
+    function upgradeAll() {
+        d.upgradeConflicts = []
+        if (backend) backend.upgradeAll()
+    }
     function selectCategory(i) { if (backend) backend.pushSelectedCategoryIndex(i) }
     function selectType(i) { if (backend) backend.pushSelectedTypeIndex(i) }
     function toggleSelection(i, checked) { if (backend) backend.togglePackage(i, checked) }
@@ -94,6 +122,10 @@ QtObject {
     function downgradePackage(i) { if (backend) backend.downgradePackage(i) }
     function reinstallPackage(i) { if (backend) backend.sidegradePackage(i) }
     function uninstallPackage(i) { if (backend) backend.uninstall(i) }
+    function cancelDownload(name) { if (backend) backend.cancelDownload(name) }
+    function resolveInterruptedInstalls(rollBack) {
+        if (backend) backend.resolveInterruptedInstalls(rollBack)
+    }
 
     // Dep-confirm dialog responses. Routed from
     // InstallDepsConfirm.qml's three signals back through the .rep
@@ -132,6 +164,9 @@ QtObject {
     function setCurrentPage(p)           { if (backend) backend.pushCurrentPage(p) }
     function setSortRole(role)           { if (backend) backend.pushSortRole(role) }
     function setSortOrder(order)         { if (backend) backend.pushSortOrder(order) }
+    function setSourceCollapsed(section, collapsed) {
+        if (backend) backend.setSourceCollapsed(section, collapsed)
+    }
 
     // Per-row version change. Also refetches details when the change is
     // on the row currently shown in the details panel
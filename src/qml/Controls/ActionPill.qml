@@ -17,6 +17,9 @@ import Logos.PackageManagerUi 1.0
 //     "Installing…" and disables, regardless of what action would
 //     otherwise be runnable. The transient state isn't a RowAction
 //     value (see PackageTypes::RowAction comment).
+//     While the row's download is still in flight (`downloading`,
+//     set by the caller) the pill stays clickable as Cancel instead:
+//     the click emits `cancelRequested()`.
 //   * `rowAction === NotAvailable` → disabled, tooltip carries the
 //     specific notAvailableReason.
 //
@@ -29,7 +32,12 @@ Control {
 
     required property var modelData
 
+    // True while this row is waiting on a download that can still be
+    // cancelled (downloadProgress.packages).
+    property bool downloading: false
+
     signal actionRequested(int rowAction)
+    signal cancelRequested()
 
     readonly property int _action: modelData ? (modelData.rowAction | 0)
                                              : PackageManagerUi.NoOp
@@ -38,11 +46,14 @@ Control {
     readonly property bool _runnable: !_installing
                                       && _action !== PackageManagerUi.NoOp
                                       && _action !== PackageManagerUi.NotAvailable
+    readonly property bool _cancellable: _installing && downloading
+    readonly property bool _clickable: _runnable || _cancellable
 
     QtObject {
         id: d
 
-        function actionText(a, installing) {
+        function actionText(a, installing, cancellable) {
+            if (cancellable) return qsTr("Downloading… ✕")
             if (installing) return qsTr("Installing…")
             switch (a) {
             case PackageManagerUi.Install:      return qsTr("Install")
@@ -85,6 +96,8 @@ Control {
         // tooltip carries the why. NotAvailable rows explain the reason.
         function tooltipText(r, a) {
             if (!r) return ""
+            if (root._cancellable)
+                return qsTr("Cancel the download")
             if (a === PackageManagerUi.NotAvailable)
                 return d.notAvailableTooltip(r)
             if (a === PackageManagerUi.Retry)
@@ -93,27 +106,29 @@ Control {
         }
     }
 
-    enabled: _runnable
-    hoverEnabled: _runnable
+    enabled: _clickable
+    hoverEnabled: _clickable
 
     // Click → emit the resolved action; caller routes to the matching
-    // backend slot via BackendStore.runRowAction().
+    // backend slot via BackendStore.runRowAction(). A downloading row
+    // emits cancelRequested() instead.
     Action {
         id: clickAction
-        enabled: root._runnable
-        onTriggered: root.actionRequested(root._action)
+        enabled: root._clickable
+        onTriggered: root._cancellable ? root.cancelRequested()
+                                       : root.actionRequested(root._action)
     }
 
     contentItem: LogosBadge {
         id: badge
-        text: d.actionText(root._action, root._installing)
-        color: root._runnable
+        text: d.actionText(root._action, root._installing, root._cancellable)
+        color: root._clickable
                ? d.baseColor(root._action, root._installing)
                : Theme.palette.textTertiary
-        backgroundColor: root._runnable
+        backgroundColor: root._clickable
                          ? Theme.colors.getColor(d.baseColor(root._action, root._installing), 0.18)
                          : Theme.palette.backgroundButton
-        borderColor: root._runnable
+        borderColor: root._clickable
                      ? d.baseColor(root._action, root._installing)
                      : Theme.palette.backgroundButton
         radius: Theme.spacing.radiusLarge
@@ -129,15 +144,21 @@ Control {
         // pointer handling fire so we get keyboard/Enter support too.
         MouseArea {
             anchors.fill: parent
-            enabled: root._runnable
+            enabled: root._clickable
             cursorShape: Qt.PointingHandCursor
             onClicked: clickAction.trigger()
         }
     }
 
-    LogosToolTip {
-        text: d.tooltipText(root.modelData, root._action)
-        placement: LogosToolTip.Top
-        visible: root.hovered && text !== ""
+    // Created on hover only — one popup per table row otherwise.
+    Loader {
+        // LogosToolTip places itself relative to its parent (this Loader).
+        anchors.fill: parent
+        active: root.hovered
+        sourceComponent: LogosToolTip {
+            text: d.tooltipText(root.modelData, root._action)
+            placement: LogosToolTip.Top
+            visible: text !== ""
+        }
     }
 }
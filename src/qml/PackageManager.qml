@@ -90,11 +90,19 @@ Rectangle {
                         actionSummary: ({})
                         stateIndex: store.installStateFilter
                         onReloadClicked: store.refreshCatalog()
-                        onInstallLocalClicked: installLocalDialog.open()
+                        onInstallLocalClicked: installLocalMenu.popup()
+                        onUpgradeAllClicked: store.upgradeAll()
                         onStateRequested: function(state) { store.setInstallStateFilter(state) }
                         onRepositoriesClicked: store.navigateToRepositories()
                     }
 
+                    DownloadProgress {
+                        Layout.fillWidth: true
+                        Layout.leftMargin: Theme.spacing.medium
+                        Layout.rightMargin: Theme.spacing.medium
+                        progress: store.downloadProgress
+                    }
+
                     // Empty state — only when no repositories are configured
                     // AND there are no local-only installed packages to fall
                     // back on. Any local rows keep the list rendered.
@@ -147,6 +155,9 @@ Rectangle {
                                  || store.isLoading
 
                         packagesModel: store.packagesModel
+                        sourceGroupCounts: store.sourceGroupCounts
+                        collapsedSources: store.collapsedSources
+                        downloadingPackages: store.downloadProgress.packages || []
                         sortRole: store.sortRole
                         sortOrder: store.sortOrder
                         onDetailsRequested: function(i) { store.requestDetails(i) }
@@ -161,7 +172,11 @@ Rectangle {
                         // signal per action type — store.runRowAction
                         // switches to the matching backend slot.
                         onActionRequested: function(i, action) { store.runRowAction(i, action) }
+                        onCancelDownloadRequested: function(name) { store.cancelDownload(name) }
                         onVersionChanged: function(i, vi) { store.setRowVersion(i, vi) }
+                        onSourceCollapseRequested: function(section, collapsed) {
+                            store.setSourceCollapsed(section, collapsed)
+                        }
                         onSortRequested: function(role, order) {
                             store.setSortRole(role)
                             store.setSortOrder(order)
@@ -227,14 +242,94 @@ Rectangle {
     //     onConfirmed: store.runSelectedActions()
     // }
 
+    // ── Upgrade All: held-back packages ──────────────────────────
+    //
+    // upgradeAll() runs what the planner could fit and reports the rest
+    // through upgradePlanConflicts; this lists them with their blocker
+    // so a partial upgrade isn't mistaken for a full one.
+    UpgradeConflicts {
+        id: upgradeConflictsDialog
+        objectName: "pmui.upgradeConflicts"
+        conflicts: store.upgradeConflicts
+    }
+
+    // ── Install rollback ──────────────────────────────────────────
+    //
+    // An install the app quit in the middle of is only undone if the
+    // user says so; a rollback that couldn't restore every prior
+    // version (not in the artifact cache) names the ones left behind.
+    InterruptedInstalls {
+        id: interruptedInstallsDialog
+        objectName: "pmui.interruptedInstalls"
+        transactions: store.interruptedInstalls
+        onResolved: function(rollBack) { store.resolveInterruptedInstalls(rollBack) }
+    }
+
+    RollbackReport {
+        id: rollbackReportDialog
+        objectName: "pmui.rollbackReport"
+        report: store.rollbackReport
+    }
+
+    Connections {
+        target: store
+        function onUpgradeConflictsChanged() {
+            if (store.upgradeConflicts.length > 0)
+                upgradeConflictsDialog.open()
+        }
+        function onInterruptedInstallsChanged() {
+            if (store.interruptedInstalls.length > 0)
+                interruptedInstallsDialog.open()
+            else
+                interruptedInstallsDialog.close()
+        }
+        function onRollbackReportChanged() {
+            if ((store.rollbackReport.notRestored || []).length > 0)
+                rollbackReportDialog.open()
+        }
+    }
+
     // ── Local .lgx picker ─────────────────────────────────────────
+    //
+    // "Install Local Package" offers files or a whole folder; both end
+    // in installLocalPackages for more than one .lgx.
+    Menu {
+        id: installLocalMenu
+        objectName: "pmui.installLocalMenu"
+        MenuItem {
+            text: qsTr("Select Files…")
+            onTriggered: installLocalDialog.open()
+        }
+        MenuItem {
+            text: qsTr("Select Folder…")
+            onTriggered: installLocalFolderDialog.open()
+        }
+    }
+
     FileDialog {
         id: installLocalDialog
         objectName: "pmui.installLocalDialog"
-        title: qsTr("Select LGX Package to Install")
+        title: qsTr("Select LGX Packages to Install")
         modality: Qt.NonModal
+        fileMode: FileDialog.OpenFiles
         nameFilters: [qsTr("LGX Package (*.lgx)"), qsTr("All Files (*)")]
-        onAccepted: store.installLocalPackage(selectedFile)
+        // One file keeps the single-package path; several go through the
+        // batch (dependency-ordered, one combined confirmation).
+        onAccepted: {
+            if (selectedFiles.length === 1)
+                store.installLocalPackage(selectedFiles[0])
+            else
+                store.installLocalPackages(selectedFiles)
+        }
+    }
+
+    // Every .lgx under the folder (recursively), as one batch.
+    FolderDialog {
+        id: installLocalFolderDialog
+        objectName: "pmui.installLocalFolderDialog"
+        title: qsTr("Select a Folder of LGX Packages")
+        modality: Qt.NonModal
+        onAccepted: store.installLocalPackages([selectedFolder])
     }
 
     // ── Per-row dep-confirm popup ─────────────────────────────────
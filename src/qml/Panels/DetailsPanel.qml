@@ -81,6 +81,20 @@ Rectangle {
             } else {
                 out += "\n" + qsTr("Dependencies: None") + "\n"
             }
+
+            // Reverse dependencies from the backend's local graph. Installed
+            // dependents are flagged — those are what an uninstall breaks.
+            var dependents = detail.dependents
+            if (dependents && dependents.length > 0) {
+                var installedDependents = detail.installedDependents || []
+                out += "\n" + qsTr("Required by:") + "\n"
+                for (var j = 0; j < dependents.length; j++) {
+                    out += "  • " + dependents[j]
+                    if (installedDependents.indexOf(dependents[j]) >= 0)
+                        out += " " + qsTr("(installed)")
+                    out += "\n"
+                }
+            }
             return out
         }
     }
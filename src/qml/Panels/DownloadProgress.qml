@@ -0,0 +1,90 @@
+import QtQuick
+import QtQuick.Layouts
+
+import Logos.Theme
+import Logos.Controls
+
+// Byte-level download strip shown under the table header while the
+// downloader is fetching artifacts: a bar plus
+// "12.4 MB of 48.0 MB · 2.1 MB/s · about 17 s left".
+// `progress` is the backend's downloadProgress map (see the .rep).
+//
+// Hidden until a downloadProgress event has actually arrived. The
+// released package_downloader doesn't send one yet (only the stand-in
+// modules do), so with it the strip never shows and installs keep the
+// per-package Installing… state; the byte figures are blocked on the
+// downloader adding that event.
+ColumnLayout {
+    id: root
+
+    property var progress: ({})
+
+    readonly property bool active: !!(progress && progress.active)
+    readonly property real bytesDone: active ? progress.bytesDone : 0
+    readonly property real bytesTotal: active ? progress.bytesTotal : 0
+    readonly property real fraction: bytesTotal > 0 ? Math.min(1, bytesDone / bytesTotal) : 0
+
+    visible: active
+    spacing: Theme.spacing.tiny
+
+    function formatBytes(n) {
+        if (n >= 1073741824) return (n / 1073741824).toFixed(1) + " GB"
+        if (n >= 1048576)    return (n / 1048576).toFixed(1) + " MB"
+        if (n >= 1024)       return (n / 1024).toFixed(0) + " KB"
+        return Math.round(n) + " B"
+    }
+
+    function formatEta(s) {
+        if (s < 0) return ""
+        if (s < 60) return qsTr("about %1 s left").arg(s)
+        if (s < 3600) return qsTr("about %1 min left").arg(Math.ceil(s / 60))
+        return qsTr("about %1 h left").arg((s / 3600).toFixed(1))
+    }
+
+    // Track + fill. Indeterminate (no fill, pulsing track) until every
+    // artifact has reported its size.
+    Rectangle {
+        id: track
+        Layout.fillWidth: true
+        Layout.preferredHeight: 4
+        radius: 2
+        color: Theme.palette.border
+
+        Rectangle {
+            width: parent.width * root.fraction
+            height: parent.height
+            radius: parent.radius
+            color: Theme.palette.primary
+            Behavior on width { NumberAnimation { duration: 200 } }
+        }
+
+        SequentialAnimation on opacity {
+            running: root.active && root.bytesTotal <= 0
+            loops: Animation.Infinite
+            onRunningChanged: if (!running) track.opacity = 1
+            NumberAnimation { to: 0.4; duration: 600 }
+            NumberAnimation { to: 1.0; duration: 600 }
+        }
+    }
+
+    LogosText {
+        objectName: "pmui.downloadProgressLabel"
+        Layout.fillWidth: true
+        font.pixelSize: Theme.typography.secondaryText
+        color: Theme.palette.textSecondary
+        elide: Text.ElideRight
+        text: {
+            if (!root.active) return ""
+            var parts = []
+            parts.push(root.bytesTotal > 0
+                       ? qsTr("%1 of %2").arg(root.formatBytes(root.bytesDone))
+                                          .arg(root.formatBytes(root.bytesTotal))
+                       : root.formatBytes(root.bytesDone))
+            if (root.progress.bytesPerSecond > 0)
+                parts.push(root.formatBytes(root.progress.bytesPerSecond) + "/s")
+            var eta = root.formatEta(root.progress.etaSeconds)
+            if (eta.length > 0) parts.push(eta)
+            return qsTr("Downloading: ") + parts.join(" · ")
+        }
+    }
+}
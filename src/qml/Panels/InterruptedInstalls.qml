@@ -0,0 +1,140 @@
+import QtQuick
+import QtQuick.Controls
+import QtQuick.Layouts
+
+import Logos.Theme
+import Logos.Controls
+
+// Startup prompt for installs the app quit (or crashed) in the middle
+// of. The journal knows what each one had changed; rolling back runs
+// more installs and removals through the host, so it only happens when
+// the user picks it here.
+//
+// Inputs:
+//   `transactions` — BackendStore.interruptedInstalls:
+//                    [{ id, startedAt, packages: [{ name, fromVersion
+//                       ("" = wasn't installed), toVersion }, ...] }, ...]
+//
+// Emits `resolved(bool rollBack)`; the caller forwards it to
+// BackendStore.resolveInterruptedInstalls.
+
+Popup {
+    id: root
+
+    property var transactions: []
+
+    signal resolved(bool rollBack)
+
+    modal: true
+    focus: true
+    closePolicy: Popup.NoAutoClose
+    anchors.centerIn: Overlay.overlay
+    width: 460
+    padding: Theme.spacing.medium
+
+    background: Rectangle {
+        color: Theme.palette.background
+        border.color: Theme.palette.border
+        border.width: 1
+        radius: 6
+    }
+
+    QtObject {
+        id: d
+
+        // "wallet: v1.0.0 → v1.1.0", or "wallet: new at v1.1.0".
+        function packageLine(p) {
+            if (!p.fromVersion)
+                return p.name + ": " + qsTr("new at v%1").arg(p.toVersion)
+            return p.name + ": v" + p.fromVersion + " → v" + p.toVersion
+        }
+
+        function choose(rollBack) {
+            root.resolved(rollBack)
+            root.close()
+        }
+    }
+
+    contentItem: ColumnLayout {
+        spacing: Theme.spacing.medium
+
+        LogosText {
+            Layout.fillWidth: true
+            text: qsTr("An install didn't finish")
+            font.pixelSize: Theme.typography.titleText
+            font.weight: Theme.typography.weightBold
+            color: Theme.palette.text
+            wrapMode: Text.WordWrap
+        }
+
+        LogosText {
+            Layout.fillWidth: true
+            text: qsTr("Roll back to put these packages back the way they were, or keep what's installed now.")
+            font.pixelSize: Theme.typography.primaryText
+            color: Theme.palette.textSecondary
+            wrapMode: Text.WordWrap
+        }
+
+        ScrollView {
+            Layout.fillWidth: true
+            Layout.preferredHeight: Math.min(implicitContentHeight, 320)
+            clip: true
+
+            ColumnLayout {
+                width: parent.width
+                spacing: Theme.spacing.small
+
+                Repeater {
+                    model: root.transactions
+
+                    ColumnLayout {
+                        Layout.fillWidth: true
+                        spacing: Theme.spacing.tiny
+
+                        LogosText {
+                            Layout.fillWidth: true
+                            visible: root.transactions.length > 1
+                            text: qsTr("Started %1").arg(modelData.startedAt)
+                            color: Theme.palette.textSecondary
+                            font.pixelSize: Theme.typography.secondaryText
+                        }
+                        Repeater {
+                            model: modelData.packages
+                            LogosText {
+                                Layout.fillWidth: true
+                                text: "• " + d.packageLine(modelData)
+                                color: Theme.palette.text
+                                font.pixelSize: Theme.typography.primaryText
+                                wrapMode: Text.WordWrap
+                            }
+                        }
+                    }
+                }
+            }
+        }
+
+        RowLayout {
+            Layout.fillWidth: true
+            Layout.topMargin: Theme.spacing.small
+            spacing: Theme.spacing.small
+
+            Item { Layout.fillWidth: true }
+
+            LogosButton {
+                text: qsTr("Keep")
+                Layout.preferredHeight: 36
+                Layout.preferredWidth: 100
+                radius: Theme.spacing.radiusLarge
+                onClicked: d.choose(false)
+            }
+
+            LogosButton {
+                text: qsTr("Roll Back")
+                Layout.preferredHeight: 36
+                Layout.preferredWidth: 110
+                radius: Theme.spacing.radiusLarge
+                onClicked: d.choose(true)
+            }
+        }
+    }
+}
@@ -11,8 +11,18 @@ import Controls
 // Package list rendered as a LogosTable.
 LogosTable {
     id: root
+    objectName: "pmui.packageList"
 
     property var packagesModel
+    // Filtered row count per source group, keyed by section string
+    // (backend `sourceGroupCounts`); read by the section headers.
+    property var sourceGroupCounts: ({})
+    // Collapsed section strings (backend `collapsedSources`). A collapsed
+    // group shows as its header plus one placeholder row.
+    property var collapsedSources: []
+    // Top-level package names still waiting on a download (backend
+    // `downloadProgress.packages`). Their Installing… pill offers Cancel.
+    property var downloadingPackages: []
 
     signal detailsRequested(int index)
     signal selectionToggled(int index, bool checked)
@@ -26,10 +36,16 @@ LogosTable {
     // value (Install / Upgrade / Downgrade / Reinstall / Retry). Parent
     // routes via `BackendStore.runRowAction(index, action)`.
     signal actionRequested(int index, int action)
+    // Cancel on a downloading row's pill. Parent wires this to
+    // backend.cancelDownload(name).
+    signal cancelDownloadRequested(string name)
     // Per-row Version dropdown — emitted when the user picks a different
     // version from the cell ComboBox. Parent wires this to
     // backend.setRowVersion.
     signal versionChanged(int index, int versionIndex)
+    // Section header chevron / placeholder row click. Parent wires this
+    // to backend.setSourceCollapsed.
+    signal sourceCollapseRequested(string section, bool collapsed)
 
     model: root.packagesModel
     // Bulk-action surface (checkbox column + Run Actions button) is
@@ -39,7 +55,14 @@ LogosTable {
     // kept compiled but never fire as long as selectionMode stays None.
     selectionMode: LogosTable.None
 
-    onRowClicked: function(idx, row) { root.detailsRequested(idx) }
+    // A collapsed group's placeholder row has no details; clicking it
+    // expands the group instead.
+    onRowClicked: function(idx, row) {
+        if (row && row.isGroupPlaceholder)
+            root.sourceCollapseRequested(row.repositoryDisplayName, false)
+        else
+            root.detailsRequested(idx)
+    }
 
     function clearSelections() {
         root.selectedIndices = []
@@ -134,6 +157,10 @@ LogosTable {
             return date.toLocaleDateString(Qt.locale(), Locale.ShortFormat)
         }
 
+        function isPlaceholder(r) {
+            return !!(r && r.isGroupPlaceholder)
+        }
+
         function newestVersionString(r) {
             if (!r) return ""
             const av = r.availableVersions || []
@@ -146,7 +173,7 @@ LogosTable {
         // isUninstallableRow predicate: must be user-installed AND in a
         // state where uninstall is meaningful.
         function canUninstall(r) {
-            if (!r) return false
+            if (!r || r.isGroupPlaceholder) return false
             if (r.installType !== "user") return false
             const s = r.installStatus | 0
             return s === PackageManagerUi.Installed
@@ -166,6 +193,7 @@ LogosTable {
             minWidth: 200
             preferredWidth: 220
             sortable: true
+            cellDelegate: packageCellComponent
         },
         // Source-by-row column intentionally absent — the row delegate
         // draws a section header for each source group (Logos Official
@@ -245,15 +273,45 @@ LogosTable {
         }
     ]
 
+    Component {
+        // Package name, or for a collapsed group's placeholder row how
+        // many packages it holds.
+        id: packageCellComponent
+        LogosText {
+            anchors.fill: parent
+            anchors.leftMargin: 8
+            text: {
+                if (!rowItem) return ""
+                if (!d.isPlaceholder(rowItem)) return rowItem.displayName || ""
+                // groupMatchCount: the hidden rows that pass the filters.
+                // The installed tally is for the whole group, so it only
+                // shows when no filter narrows it.
+                const n = rowItem.groupMatchCount | 0
+                const installed = n === (rowItem.groupRowCount | 0) ? rowItem.groupInstalledCount | 0 : 0
+                return installed > 0
+                    ? qsTr("%n package(s), %1 installed — click to expand", "", n).arg(installed)
+                    : qsTr("%n package(s) — click to expand", "", n)
+            }
+            color: d.isPlaceholder(rowItem) ? Theme.palette.textSecondary : Theme.palette.text
+            font.pixelSize: Theme.typography.primaryText
+            font.italic: d.isPlaceholder(rowItem)
+            verticalAlignment: Text.AlignVCenter
+            elide: Text.ElideRight
+        }
+    }
+
     Component {
         id: actionPillComponent
         Item {
+            visible: !d.isPlaceholder(rowItem)
             ActionPill {
                 anchors.centerIn: parent
                 modelData: rowItem
+                downloading: !!rowItem && root.downloadingPackages.indexOf(rowItem.name) >= 0
                 onActionRequested: function(action) {
                     root.actionRequested(rowIndex, action)
                 }
+                onCancelRequested: root.cancelDownloadRequested(rowItem.name)
             }
         }
     }
@@ -262,7 +320,7 @@ LogosTable {
         id: sizeCellComponent
         LogosText {
             anchors.fill: parent
-            text: rowItem ? d.formatSize(rowItem.size) : ""
+            text: rowItem && !d.isPlaceholder(rowItem) ? d.formatSize(rowItem.size) : ""
             color: Theme.palette.text
             font.pixelSize: Theme.typography.primaryText
             horizontalAlignment: (columnDef.alignment & Qt.AlignHCenter) ? Text.AlignHCenter
@@ -277,7 +335,7 @@ LogosTable {
         id: dateCellComponent
         LogosText {
             anchors.fill: parent
-            text: rowItem ? d.formatDate(rowItem.dateUpdated) : ""
+            text: rowItem && !d.isPlaceholder(rowItem) ? d.formatDate(rowItem.dateUpdated) : ""
             color: Theme.palette.text
             font.pixelSize: Theme.typography.primaryText
             horizontalAlignment: (columnDef.alignment & Qt.AlignHCenter) ? Text.AlignHCenter
@@ -294,9 +352,18 @@ LogosTable {
     // model order yields contiguous source runs. Section property is
     // `repositoryDisplayName`; the delegate below renders a header
     // strip above each group with the source label on the left and a
-    // count chip on the right.
+    // count chip on the right. The count is the whole group's after
+    // filtering (not just this page's rows), precomputed by the
+    // backend's filter proxy.
+    //
+    // reuseItems: rows scrolled out (and, on a page flip, the whole
+    // previous page) go to the view's pool and are rebound to the next
+    // rows instead of being destroyed and rebuilt. Cell delegates below
+    // therefore must not keep per-package state beyond their bindings —
+    // see versionCell.rowKey for the one that does.
     Component.onCompleted: {
         if (view) {
+            view.reuseItems = true
             view.section.property = "repositoryDisplayName"
             view.section.criteria = ViewSection.FullString
             view.section.delegate = sectionHeaderDelegate
@@ -313,6 +380,14 @@ LogosTable {
             height: 32
             color: Theme.palette.surface
 
+            readonly property bool collapsed: root.collapsedSources.indexOf(section) >= 0
+
+            MouseArea {
+                anchors.fill: parent
+                cursorShape: Qt.PointingHandCursor
+                onClicked: root.sourceCollapseRequested(parent.section, !parent.collapsed)
+            }
+
             Rectangle {
                 anchors.left: parent.left
                 anchors.right: parent.right
@@ -322,9 +397,19 @@ LogosTable {
             }
 
             LogosText {
+                id: sectionChevron
                 anchors.left: parent.left
                 anchors.leftMargin: 16
                 anchors.verticalCenter: parent.verticalCenter
+                text: parent.collapsed ? "▸" : "▾"
+                color: Theme.palette.textSecondary
+                font.pixelSize: Theme.typography.secondaryText
+            }
+
+            LogosText {
+                anchors.left: sectionChevron.right
+                anchors.leftMargin: 8
+                anchors.verticalCenter: parent.verticalCenter
                 // Empty string falls back to "(unresolved)" so a
                 // freshly-added repo whose logos-repo.json hasn't
                 // resolved yet still gets a visible header instead of
@@ -334,6 +419,22 @@ LogosTable {
                 font.pixelSize: Theme.typography.secondaryText
                 font.weight: Theme.typography.weightBold
             }
+
+            LogosBadge {
+                anchors.right: parent.right
+                anchors.rightMargin: 16
+                anchors.verticalCenter: parent.verticalCenter
+                readonly property int count: root.sourceGroupCounts[parent.section] || 0
+                visible: count > 0
+                text: count
+                color: Theme.palette.textSecondary
+                backgroundColor: Theme.palette.backgroundButton
+                borderColor: Theme.palette.backgroundButton
+                radius: Theme.spacing.radiusLarge
+                implicitHeight: 18
+                verticalPadding: 2
+                labelItem.font.pixelSize: 11
+            }
         }
     }
 
@@ -353,75 +454,105 @@ LogosTable {
         id: versionCellComponent
         Item {
             id: versionCell
-
-            // Filter availableVersions to entries that actually carry a
-            // version string. An empty version is useless to surface as
-            // a dropdown choice (and shows up as a blank "..." entry
-            // when the catalog row predates the new schema), so we
-            // treat the cell as "no usable versions" and fall back to
-            // the legacy plain-text VersionRole instead.
-            property var usableVersions: {
-                const raw = rowItem ? (rowItem.availableVersions || []) : []
-                const out = []
-                for (let i = 0; i < raw.length; ++i) {
-                    const v = raw[i]
-                    if (v && v.version && String(v.version).length > 0) out.push(v)
-                }
-                return out
-            }
+            visible: !d.isPlaceholder(rowItem)
+
+            // Dropdown labels, prebuilt per row by the backend
+            // (packagerows::buildPackageRow): one per availableVersions
+            // entry that carries a version string, disambiguated by
+            // date + short hash when a version repeats. An empty list
+            // means "no usable versions" — the cell falls back to the
+            // legacy plain-text VersionRole instead.
+            property var versionLabels: rowItem && rowItem.versionLabels
+                                        ? rowItem.versionLabels : []
             property int selectedIdx: rowItem && rowItem.selectedVersionIndex !== undefined
                                       ? rowItem.selectedVersionIndex : 0
-            property bool hasDuplicateVersions: {
-                if (!usableVersions || usableVersions.length < 2) return false
-                var seen = {}
-                for (var i = 0; i < usableVersions.length; ++i) {
-                    var v = usableVersions[i].version
-                    if (seen[v]) return true
-                    seen[v] = true
-                }
-                return false
-            }
             property bool updateAvailable: rowItem && rowItem.updateAvailable === true
 
-            LogosComboBox {
-                id: versionCombo
+            // A row shows a static look-alike of the dropdown until the
+            // user reaches for it; only then is the real LogosComboBox
+            // (and its popup) created, and opened straight away. A page
+            // of rows therefore costs one LogosText each here, not a
+            // combo. The combo stays for as long as the delegate shows
+            // the same package; a recycled delegate drops it.
+            property string rowKey: rowItem ? (rowItem.repositoryUrl + "\n" + rowItem.name) : ""
+            property bool comboWanted: false
+            onRowKeyChanged: comboWanted = false
+
+            Item {
+                id: versionSlot
                 // Fixed width so marker presence/absence doesn't reflow
                 // the combo, and so all rows render the same dropdown
                 // size regardless of cell width. 92px holds "1.0.10"
                 // comfortably after subtracting the chevron padding —
                 // longer prerelease strings (e.g. "1.0.0-rc.1") will
-                // elide, which the displayText fallback below already
-                // collapses to just the version number anyway.
+                // elide, which the displayText below already collapses
+                // to just the version number anyway.
                 anchors.left: parent.left
                 anchors.verticalCenter: parent.verticalCenter
                 anchors.leftMargin: 6
                 width: 92
                 height: Math.min(parent.height - 8, 32)
-                visible: versionCell.usableVersions.length > 0
-                model: versionCell.usableVersions.map(function(v) {
-                    if (!versionCell.hasDuplicateVersions) return v.version || ""
-                    // Disambiguate same-version re-releases by date +
-                    // short hash so the user can pick the right one.
-                    var date = (v.releasedAt || "").substring(0, 10)
-                    var sh = (v.rootHash || "").length > 12
-                             ? (v.rootHash.substring(0, 6) + "…")
-                             : (v.rootHash || "")
-                    return (v.version || "") + " · " + date + " · " + sh
-                })
-                currentIndex: versionCell.selectedIdx
-                // Override the closed-state label so it shows just the
-                // version string even when the dropdown items carry the
-                // verbose "version · date · hash" disambiguator. Without
-                // this the long disambiguator gets elided in the narrow
-                // cell down to a bare "…", which is what makes every
-                // version dropdown look identical at a glance.
-                displayText: {
-                    const v = versionCell.usableVersions[currentIndex]
-                    return v && v.version ? String(v.version) : ""
+                visible: versionCell.versionLabels.length > 0
+
+                // Placeholder: same footprint and label as the combo's
+                // closed state.
+                Rectangle {
+                    anchors.fill: parent
+                    visible: !comboLoader.item
+                    radius: Theme.spacing.radiusLarge
+                    color: Theme.palette.backgroundButton
+                    border.color: Theme.palette.border
+                    border.width: 1
+
+                    LogosText {
+                        anchors.left: parent.left
+                        anchors.right: chevron.left
+                        anchors.leftMargin: 8
+                        anchors.verticalCenter: parent.verticalCenter
+                        text: rowItem && rowItem.version ? String(rowItem.version) : ""
+                        color: Theme.palette.text
+                        font.pixelSize: Theme.typography.secondaryText
+                        elide: Text.ElideRight
+                    }
+                    LogosText {
+                        id: chevron
+                        anchors.right: parent.right
+                        anchors.rightMargin: 8
+                        anchors.verticalCenter: parent.verticalCenter
+                        text: "▾"
+                        color: Theme.palette.textSecondary
+                        font.pixelSize: Theme.typography.secondaryText
+                    }
+                    MouseArea {
+                        anchors.fill: parent
+                        cursorShape: Qt.PointingHandCursor
+                        onClicked: versionCell.comboWanted = true
+                    }
                 }
-                onActivated: function(idx) {
-                    if (idx !== versionCell.selectedIdx)
-                        root.versionChanged(rowIndex, idx)
+
+                Loader {
+                    id: comboLoader
+                    anchors.fill: parent
+                    active: versionCell.comboWanted
+                    onLoaded: item.popup.open()
+                    sourceComponent: LogosComboBox {
+                        model: versionCell.versionLabels
+                        currentIndex: versionCell.selectedIdx
+                        // Override the closed-state label so it shows just
+                        // the version string even when the dropdown items
+                        // carry the verbose "version · date · hash"
+                        // disambiguator. Without this the long
+                        // disambiguator gets elided in the narrow cell
+                        // down to a bare "…", which is what makes every
+                        // version dropdown look identical at a glance.
+                        // The row's VersionRole already mirrors the
+                        // selected entry.
+                        displayText: rowItem && rowItem.version ? String(rowItem.version) : ""
+                        onActivated: function(idx) {
+                            if (idx !== versionCell.selectedIdx)
+                                root.versionChanged(rowIndex, idx)
+                        }
+                    }
                 }
             }
 
@@ -430,18 +561,18 @@ LogosTable {
             // combo's size stays the same whether or not the marker is
             // visible (the user complained about the combo shrinking on
             // rows that had the marker — that's why this is anchored to
-            // versionCombo.right rather than to the cell's right edge).
+            // versionSlot.right rather than to the cell's right edge).
             // Independent of the dropdown pick — present whenever the
             // catalog's newest version is strictly newer than installed.
             Item {
                 id: updateMarker
-                anchors.left: versionCombo.right
+                anchors.left: versionSlot.right
                 anchors.verticalCenter: parent.verticalCenter
                 anchors.leftMargin: 6
                 width: 16
                 height: 16
                 visible: versionCell.updateAvailable
-                         && versionCell.usableVersions.length > 0
+                         && versionCell.versionLabels.length > 0
 
                 Rectangle {
                     anchors.fill: parent
@@ -466,17 +597,24 @@ LogosTable {
                     cursorShape: Qt.ArrowCursor
                 }
 
-                LogosToolTip {
-                    visible: markerHover.containsMouse
-                    placement: LogosToolTip.Top
-                    text: {
-                        if (!rowItem) return ""
-                        const installed = rowItem.installedVersion
-                                          ? String(rowItem.installedVersion) : ""
-                        const newest = d.newestVersionString(rowItem)
-                        if (installed && newest)
-                            return qsTr("v%1 installed · v%2 available").arg(installed).arg(newest)
-                        return qsTr("Update available")
+                // Tooltips are popups; build one only while hovered.
+                Loader {
+                    // The tooltip positions itself against its parent,
+                    // which is this Loader — give it the marker's geometry.
+                    anchors.fill: parent
+                    active: markerHover.containsMouse
+                    sourceComponent: LogosToolTip {
+                        visible: true
+                        placement: LogosToolTip.Top
+                        text: {
+                            if (!rowItem) return ""
+                            const installed = rowItem.installedVersion
+                                              ? String(rowItem.installedVersion) : ""
+                            const newest = d.newestVersionString(rowItem)
+                            if (installed && newest)
+                                return qsTr("v%1 installed · v%2 available").arg(installed).arg(newest)
+                            return qsTr("Update available")
+                        }
                     }
                 }
             }
@@ -490,7 +628,7 @@ LogosTable {
             LogosText {
                 anchors.fill: parent
                 anchors.margins: 8
-                visible: versionCell.usableVersions.length === 0
+                visible: versionCell.versionLabels.length === 0
                 text: {
                     if (!rowItem) return ""
                     const v = rowItem.version
@@ -520,10 +658,14 @@ LogosTable {
                 iconSource: LogosIcons.trash
                 background: Item {}
                 onClicked: root.uninstallRequested(rowIndex)
-                LogosToolTip {
-                    text: qsTr("Uninstall")
-                    placement: LogosToolTip.Top
-                    visible: parent.hovered
+                Loader {
+                    anchors.fill: parent
+                    active: parent.hovered
+                    sourceComponent: LogosToolTip {
+                        text: qsTr("Uninstall")
+                        placement: LogosToolTip.Top
+                        visible: true
+                    }
                 }
             }
         }
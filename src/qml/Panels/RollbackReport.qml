@@ -0,0 +1,124 @@
+import QtQuick
+import QtQuick.Controls
+import QtQuick.Layouts
+
+import Logos.Theme
+import Logos.Controls
+
+// Result popup for a rollback that couldn't put everything back. A
+// prior version is reinstalled from the local artifact cache; one that
+// was never cached (or no longer verifies) is listed here so the user
+// knows that package is missing or still on the newer version.
+//
+// Inputs:
+//   `report` — BackendStore.rollbackReport (installRolledBack payload):
+//              { packageName, restored: ["name version", ...],
+//                removed: [name, ...],
+//                notRestored: [{ name, version, reason }, ...] }
+
+Popup {
+    id: root
+
+    property var report: ({})
+
+    readonly property var notRestored: report.notRestored || []
+
+    modal: true
+    focus: true
+    anchors.centerIn: Overlay.overlay
+    width: 460
+    padding: Theme.spacing.medium
+
+    background: Rectangle {
+        color: Theme.palette.background
+        border.color: Theme.palette.border
+        border.width: 1
+        radius: 6
+    }
+
+    contentItem: ColumnLayout {
+        spacing: Theme.spacing.medium
+
+        LogosText {
+            Layout.fillWidth: true
+            text: root.report.packageName
+                  ? qsTr("Installing %1 failed and was rolled back").arg(root.report.packageName)
+                  : qsTr("The interrupted install was rolled back")
+            font.pixelSize: Theme.typography.titleText
+            font.weight: Theme.typography.weightBold
+            color: Theme.palette.text
+            wrapMode: Text.WordWrap
+        }
+
+        LogosText {
+            Layout.fillWidth: true
+            text: root.notRestored.length === 1
+                  ? qsTr("1 package couldn't be restored to its earlier version:")
+                  : qsTr("%1 packages couldn't be restored to their earlier version:")
+                        .arg(root.notRestored.length)
+            font.pixelSize: Theme.typography.primaryText
+            color: Theme.palette.textSecondary
+            wrapMode: Text.WordWrap
+        }
+
+        ScrollView {
+            Layout.fillWidth: true
+            Layout.preferredHeight: Math.min(implicitContentHeight, 320)
+            clip: true
+
+            ColumnLayout {
+                width: parent.width
+                spacing: Theme.spacing.small
+
+                Repeater {
+                    model: root.notRestored
+
+                    ColumnLayout {
+                        Layout.fillWidth: true
+                        spacing: Theme.spacing.tiny
+
+                        LogosText {
+                            Layout.fillWidth: true
+                            text: "• " + modelData.name + " v" + modelData.version
+                            color: Theme.palette.text
+                            font.pixelSize: Theme.typography.primaryText
+                            wrapMode: Text.WordWrap
+                        }
+                        LogosText {
+                            Layout.fillWidth: true
+                            Layout.leftMargin: Theme.spacing.medium
+                            visible: text.length > 0
+                            text: modelData.reason || ""
+                            color: Theme.palette.textSecondary
+                            font.pixelSize: Theme.typography.secondaryText
+                            wrapMode: Text.WordWrap
+                        }
+                    }
+                }
+            }
+        }
+
+        LogosText {
+            Layout.fillWidth: true
+            text: qsTr("Install those versions again from the package list if you need them.")
+            font.pixelSize: Theme.typography.secondaryText
+            color: Theme.palette.textSecondary
+            wrapMode: Text.WordWrap
+        }
+
+        RowLayout {
+            Layout.fillWidth: true
+            Layout.topMargin: Theme.spacing.small
+
+            Item { Layout.fillWidth: true }
+
+            LogosButton {
+                text: qsTr("OK")
+                Layout.preferredHeight: 36
+                Layout.preferredWidth: 100
+                radius: Theme.spacing.radiusLarge
+                onClicked: root.close()
+            }
+        }
+    }
+}
@@ -43,6 +43,9 @@ GridLayout {
     // calling `BackendStore.runSelectedActions()` on confirm; this
     // signal does NOT execute anything directly.
     signal runActionsClicked()
+    // "Upgrade All". The backend plans and dispatches the whole set;
+    // the host gate still confirms before anything changes.
+    signal upgradeAllClicked()
     signal stateRequested(int state)
     // Requests navigation to basecamp Settings → Repositories.
     signal repositoriesClicked()
@@ -123,6 +126,20 @@ GridLayout {
             onClicked: root.reloadClicked()
         }
 
+        LogosButton {
+            id: upgradeAllBtn
+            objectName: "pmui.upgradeAllButton"
+            Layout.fillWidth: true
+            Layout.minimumWidth: 90
+            Layout.preferredWidth: 130
+            Layout.maximumWidth: 130
+            Layout.preferredHeight: 40
+            radius: Theme.spacing.radiusLarge
+            text: qsTr("Upgrade All")
+            enabled: !root.isInstalling && !root.isLoading
+            onClicked: root.upgradeAllClicked()
+        }
+
         // Multi-repo: open the Manage Repositories popup.
         LogosButton {
             Layout.fillWidth: true
@@ -0,0 +1,132 @@
+import QtQuick
+import QtQuick.Controls
+import QtQuick.Layouts
+
+import Logos.Theme
+import Logos.Controls
+
+// Result popup for "Upgrade All": the packages the planner had to hold
+// below their newest version, and why. Without it those packages would
+// just quietly stay where they are while the rest of the batch goes
+// ahead.
+//
+// Inputs:
+//   `conflicts` — the upgradePlanConflicts payload (BackendStore
+//                 .upgradeConflicts): [{ name, installedVersion,
+//                 newestVersion, plannedVersion ("" = left as
+//                 installed), blockedBy, reason }, ...]
+
+Popup {
+    id: root
+
+    property var conflicts: []
+
+    modal: true
+    focus: true
+    anchors.centerIn: Overlay.overlay
+    width: 460
+    padding: Theme.spacing.medium
+
+    background: Rectangle {
+        color: Theme.palette.background
+        border.color: Theme.palette.border
+        border.width: 1
+        radius: 6
+    }
+
+    QtObject {
+        id: d
+
+        // "wallet: stays on v1.0.0 (newest v2.0.0)" or, when it could
+        // still move part of the way, "wallet: v1.0.0 → v1.4.0 (newest
+        // v2.0.0)".
+        function heldLine(c) {
+            var name = c.name || c.moduleName || ""
+            var newest = c.newestVersion ? " " + qsTr("(newest v%1)").arg(c.newestVersion) : ""
+            if (c.plannedVersion)
+                return name + ": v" + c.installedVersion + " → v" + c.plannedVersion + newest
+            return name + ": " + qsTr("stays on v%1").arg(c.installedVersion) + newest
+        }
+    }
+
+    contentItem: ColumnLayout {
+        spacing: Theme.spacing.medium
+
+        LogosText {
+            Layout.fillWidth: true
+            text: root.conflicts.length === 1
+                  ? qsTr("1 package was held back")
+                  : qsTr("%1 packages were held back").arg(root.conflicts.length)
+            font.pixelSize: Theme.typography.titleText
+            font.weight: Theme.typography.weightBold
+            color: Theme.palette.text
+            wrapMode: Text.WordWrap
+        }
+
+        LogosText {
+            Layout.fillWidth: true
+            text: qsTr("The other upgrades go ahead; these would break a dependency.")
+            font.pixelSize: Theme.typography.primaryText
+            color: Theme.palette.textSecondary
+            wrapMode: Text.WordWrap
+        }
+
+        ScrollView {
+            Layout.fillWidth: true
+            Layout.preferredHeight: Math.min(implicitContentHeight, 320)
+            clip: true
+
+            ColumnLayout {
+                width: parent.width
+                spacing: Theme.spacing.small
+
+                Repeater {
+                    model: root.conflicts
+
+                    ColumnLayout {
+                        Layout.fillWidth: true
+                        spacing: Theme.spacing.tiny
+
+                        LogosText {
+                            Layout.fillWidth: true
+                            text: "• " + d.heldLine(modelData)
+                            color: Theme.palette.text
+                            font.pixelSize: Theme.typography.primaryText
+                            wrapMode: Text.WordWrap
+                        }
+                        LogosText {
+                            Layout.fillWidth: true
+                            Layout.leftMargin: Theme.spacing.medium
+                            visible: text.length > 0
+                            text: {
+                                var why = modelData.reason || ""
+                                if (modelData.blockedBy)
+                                    why = why ? qsTr("%1 (%2)").arg(why).arg(modelData.blockedBy)
+                                              : modelData.blockedBy
+                                return why
+                            }
+                            color: Theme.palette.textSecondary
+                            font.pixelSize: Theme.typography.secondaryText
+                            wrapMode: Text.WordWrap
+                        }
+                    }
+                }
+            }
+        }
+
+        RowLayout {
+            Layout.fillWidth: true
+            Layout.topMargin: Theme.spacing.small
+
+            Item { Layout.fillWidth: true }
+
+            LogosButton {
+                text: qsTr("OK")
+                Layout.preferredHeight: 36
+                Layout.preferredWidth: 100
+                radius: Theme.spacing.radiusLarge
+                onClicked: root.close()
+            }
+        }
+    }
+}
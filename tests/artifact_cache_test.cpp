@@ -0,0 +1,190 @@
+// ArtifactCache: hit / miss, integrity check on hit, the sidecar bound
+// to its rootHash, the worker-side stage/verify split, LRU eviction
+// under the size cap, and the on-disk state surviving a restart.
+
+#include <QtTest>
+
+#include <QFile>
+#include <QFileInfo>
+#include <QTemporaryDir>
+#include <QThread>
+#include <QThreadPool>
+
+#include "ArtifactCache.h"
+
+namespace {
+
+QString writeFile(const QString& dir, const QString& name, const QByteArray& bytes)
+{
+    const QString path = dir + QLatin1Char('/') + name;
+    QFile f(path);
+    if (!f.open(QIODevice::WriteOnly | QIODevice::Truncate)) return {};
+    f.write(bytes);
+    return path;
+}
+
+QByteArray readFile(const QString& path)
+{
+    QFile f(path);
+    return f.open(QIODevice::ReadOnly) ? f.readAll() : QByteArray();
+}
+
+} // namespace
+
+class ArtifactCacheTest : public QObject {
+    Q_OBJECT
+
+private slots:
+    void init();
+
+    void storeThenLookup();
+    void missForUnknownHash();
+    void corruptEntryIsDropped();
+    void sidecarMustNameTheRootHash();
+    void stageAndVerifyOnWorker();
+    void evictsLeastRecentlyUsed();
+    void oversizedArtifactNotCached();
+    void survivesRestart();
+
+private:
+    QScopedPointer<QTemporaryDir> m_src;
+    QScopedPointer<QTemporaryDir> m_cacheDir;
+};
+
+void ArtifactCacheTest::init()
+{
+    m_src.reset(new QTemporaryDir);
+    m_cacheDir.reset(new QTemporaryDir);
+    QVERIFY(m_src->isValid());
+    QVERIFY(m_cacheDir->isValid());
+}
+
+void ArtifactCacheTest::storeThenLookup()
+{
+    ArtifactCache cache(m_cacheDir->path(), 1 << 20);
+    const QString src = writeFile(m_src->path(), "a.lgx", "alpha-bytes");
+    const QString stored = cache.store("sha256:aaaa", src);
+    QVERIFY(!stored.isEmpty());
+    QVERIFY(cache.contains("sha256:aaaa"));
+
+    // The downloader's copy can go away; the cached one stays.
+    QFile::remove(src);
+    const QString hit = cache.lookup("sha256:aaaa");
+    QCOMPARE(hit, stored);
+    QCOMPARE(readFile(hit), QByteArray("alpha-bytes"));
+    QCOMPARE(cache.count(), 1);
+    QCOMPARE(cache.totalBytes(), qint64(11));
+}
+
+void ArtifactCacheTest::missForUnknownHash()
+{
+    ArtifactCache cache(m_cacheDir->path(), 1 << 20);
+    QVERIFY(!cache.contains("nope"));
+    QVERIFY(cache.lookup("nope").isEmpty());
+    QVERIFY(cache.lookup(QString()).isEmpty());
+}
+
+void ArtifactCacheTest::corruptEntryIsDropped()
+{
+    ArtifactCache cache(m_cacheDir->path(), 1 << 20);
+    const QString stored = cache.store("h1", writeFile(m_src->path(), "a.lgx", "original"));
+    QVERIFY(!stored.isEmpty());
+
+    // Same size, different bytes — only the hash check catches it.
+    QFile::remove(stored);
+    writeFile(m_cacheDir->path(), QFileInfo(stored).fileName(), "0riginal");
+
+    QVERIFY(cache.lookup("h1").isEmpty());
+    QVERIFY(!cache.contains("h1"));
+    QVERIFY(!QFile::exists(stored));
+}
+
+void ArtifactCacheTest::sidecarMustNameTheRootHash()
+{
+    ArtifactCache cache(m_cacheDir->path(), 1 << 20);
+    const QString stored = cache.store("h1", writeFile(m_src->path(), "a.lgx", "original"));
+    QVERIFY(!stored.isEmpty());
+    const QString sidecar = stored.left(stored.size() - 4) + ".sha256";
+    const QByteArray body = readFile(sidecar);
+    QVERIFY(body.startsWith("h1\n"));
+
+    // Right bytes, but pinned for some other rootHash.
+    QFile::remove(sidecar);
+    writeFile(m_cacheDir->path(), QFileInfo(sidecar).fileName(), "h2" + body.mid(2));
+
+    QVERIFY(cache.find("h1").path.isEmpty());
+    QVERIFY(!cache.contains("h1"));
+    QVERIFY(!QFile::exists(stored));
+}
+
+void ArtifactCacheTest::stageAndVerifyOnWorker()
+{
+    ArtifactCache cache(m_cacheDir->path(), 1 << 20);
+    cache.load();
+    const QString src = writeFile(m_src->path(), "a.lgx", "worker-bytes");
+
+    ArtifactCache::Staged staged;
+    QThreadPool::globalInstance()->start([&]() { staged = cache.stage("w", src); });
+    QVERIFY(QThreadPool::globalInstance()->waitForDone(5000));
+    QVERIFY(!staged.tmpPath.isEmpty());
+    QVERIFY(!cache.contains("w"));   // nothing indexed until commit
+
+    const QString stored = cache.commit(staged);
+    QVERIFY(!stored.isEmpty());
+    QVERIFY(!QFile::exists(staged.tmpPath));
+
+    const ArtifactCache::Candidate c = cache.find("w");
+    QCOMPARE(c.path, stored);
+    bool ok = false;
+    QThreadPool::globalInstance()->start([&]() { ok = ArtifactCache::verify(c); });
+    QVERIFY(QThreadPool::globalInstance()->waitForDone(5000));
+    QVERIFY(ok);
+
+    // Same size, different bytes.
+    QFile::remove(stored);
+    writeFile(m_cacheDir->path(), QFileInfo(stored).fileName(), "w0rker-bytes");
+    QVERIFY(!ArtifactCache::verify(c));
+}
+
+void ArtifactCacheTest::evictsLeastRecentlyUsed()
+{
+    ArtifactCache cache(m_cacheDir->path(), 30);
+    QVERIFY(!cache.store("a", writeFile(m_src->path(), "a", QByteArray(10, 'a'))).isEmpty());
+    QThread::msleep(5);
+    QVERIFY(!cache.store("b", writeFile(m_src->path(), "b", QByteArray(10, 'b'))).isEmpty());
+    QThread::msleep(5);
+    QVERIFY(!cache.lookup("a").isEmpty());   // a is now the most recent
+    QThread::msleep(5);
+    QVERIFY(!cache.store("c", writeFile(m_src->path(), "c", QByteArray(15, 'c'))).isEmpty());
+
+    QVERIFY(cache.contains("a"));
+    QVERIFY(!cache.contains("b"));
+    QVERIFY(cache.contains("c"));
+    QVERIFY(cache.totalBytes() <= 30);
+}
+
+void ArtifactCacheTest::oversizedArtifactNotCached()
+{
+    ArtifactCache cache(m_cacheDir->path(), 8);
+    QVERIFY(cache.store("big", writeFile(m_src->path(), "big", QByteArray(9, 'x'))).isEmpty());
+    QCOMPARE(cache.count(), 0);
+}
+
+void ArtifactCacheTest::survivesRestart()
+{
+    {
+        ArtifactCache cache(m_cacheDir->path(), 1 << 20);
+        QVERIFY(!cache.store("keep", writeFile(m_src->path(), "k", "kept")).isEmpty());
+    }
+    // A half-finished store from a crash: artifact without sidecar.
+    writeFile(m_cacheDir->path(), "deadbeef.lgx", "partial");
+
+    ArtifactCache reopened(m_cacheDir->path(), 1 << 20);
+    QCOMPARE(reopened.count(), 1);
+    QCOMPARE(readFile(reopened.lookup("keep")), QByteArray("kept"));
+    QVERIFY(!QFile::exists(m_cacheDir->path() + "/deadbeef.lgx"));
+}
+
+QTEST_APPLESS_MAIN(ArtifactCacheTest)
+
+#include "artifact_cache_test.moc"
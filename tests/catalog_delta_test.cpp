@@ -0,0 +1,126 @@
+// Delta catalog: catalogdelta::apply upserts and removes by (repository,
+// name), and the stand-in's getCatalogDelta reports exactly the edits
+// since a generation — or asks for a full fetch when it can't.
+
+#include <QtTest>
+
+#include <QJsonDocument>
+#include <QJsonObject>
+
+#include "CatalogDelta.h"
+#include "StandInModuleGateway.h"
+
+namespace {
+
+QVariantMap row(const QString& repo, const QString& name, const QString& tag = QString())
+{
+    return {{"repositoryUrl", repo}, {"name", name}, {"tag", tag}};
+}
+
+StandInModuleGateway::Config fastConfig()
+{
+    StandInModuleGateway::Config c;
+    c.catalogRows    = 30;
+    c.versionsPerRow = 1;
+    c.latencyMs      = 1;
+    return c;
+}
+
+QVariantMap deltaSince(StandInModuleGateway& gw, qint64 generation)
+{
+    QVariantMap reply;
+    gw.getCatalogDelta(generation, [&](QVariantMap d) { reply = d; });
+    [&] { QTRY_VERIFY(!reply.isEmpty()); }();
+    return reply;
+}
+
+} // namespace
+
+class CatalogDeltaTest : public QObject {
+    Q_OBJECT
+
+private slots:
+    void applyUpsertsAndRemoves();
+    void standInReportsEditsSinceGeneration();
+    void standInAsksForFullFetch();
+};
+
+void CatalogDeltaTest::applyUpsertsAndRemoves()
+{
+    const QVariantList catalog{row("a", "x"), row("a", "y"), row("b", "x")};
+    const QVariantMap delta{
+        {"changed", QVariantList{row("b", "x", "new")}},
+        {"removed", QVariantList{row("a", "y")}},
+        {"added",   QVariantList{row("b", "z")}},
+    };
+    QCOMPARE(catalogdelta::size(delta), 3);
+    QCOMPARE(catalogdelta::names(delta), QSet<QString>({"x", "y", "z"}));
+
+    const QVariantList expected{row("a", "x"), row("b", "x", "new"), row("b", "z")};
+    QCOMPARE(catalogdelta::apply(catalog, delta), expected);
+    // Idempotent: applying it again changes nothing.
+    QCOMPARE(catalogdelta::apply(expected, delta), expected);
+}
+
+void CatalogDeltaTest::standInReportsEditsSinceGeneration()
+{
+    StandInModuleGateway gw(fastConfig());
+    QVariantList before;
+    gw.getCatalog([&](QVariantList rows) { before = rows; });
+    QTRY_VERIFY(!before.isEmpty());
+    const qint64 g0 = gw.catalogGeneration();
+
+    qint64 announced = -1;
+    gw.onDownloaderEvent("catalogChanged", [&](const QVariantList& d) {
+        announced = QJsonDocument::fromJson(d.value(0).toString().toUtf8())
+                        .object().value("generation").toInteger(-1);
+    });
+
+    QVariantMap changed = before.at(5).toMap();
+    changed["repositoryDisplayName"] = QStringLiteral("renamed");
+    QVariantMap added = before.at(6).toMap();
+    added["name"] = QStringLiteral("pkg_new");
+    gw.editCatalog({changed, added}, {before.at(7)});
+    QCOMPARE(gw.catalogGeneration(), g0 + 1);
+    QCOMPARE(announced, g0 + 1);
+
+    const QVariantMap delta = deltaSince(gw, g0);
+    QVERIFY(!delta.value("full").toBool());
+    QCOMPARE(delta.value("generation").toLongLong(), g0 + 1);
+    QCOMPARE(delta.value("added").toList(), QVariantList{added});
+    QCOMPARE(delta.value("changed").toList(), QVariantList{changed});
+    QCOMPARE(delta.value("removed").toList().size(), 1);
+
+    QVariantList after;
+    gw.getCatalog([&](QVariantList rows) { after = rows; });
+    QTRY_VERIFY(!after.isEmpty());
+    QCOMPARE(catalogdelta::apply(before, delta), after);
+
+    // Nothing new since the current generation.
+    QCOMPARE(catalogdelta::size(deltaSince(gw, g0 + 1)), 0);
+}
+
+void CatalogDeltaTest::standInAsksForFullFetch()
+{
+    StandInModuleGateway::Config c = fastConfig();
+    c.deltaHistory = 2;
+    StandInModuleGateway gw(c);
+    const qint64 g0 = gw.catalogGeneration();
+
+    QVERIFY(deltaSince(gw, -1).value("full").toBool());
+
+    QVariantList catalog;
+    gw.getCatalog([&](QVariantList rows) { catalog = rows; });
+    QTRY_VERIFY(!catalog.isEmpty());
+    for (int i = 0; i < 3; ++i) {
+        QVariantMap r = catalog.at(i).toMap();
+        r["repositoryDisplayName"] = QStringLiteral("edit %1").arg(i);
+        gw.editCatalog({r});
+    }
+    QVERIFY(deltaSince(gw, g0).value("full").toBool());
+    QVERIFY(!deltaSince(gw, g0 + 1).value("full").toBool());
+}
+
+QTEST_GUILESS_MAIN(CatalogDeltaTest)
+
+#include "catalog_delta_test.moc"
@@ -0,0 +1,143 @@
+// CatalogInterner: an interned catalog equals the original, equal
+// strings and manifests come back as one shared copy, and prune() drops
+// only what nothing outside the pool still holds. Containers that differ
+// only deep down stay apart.
+
+#include <QtTest>
+
+#include <QDataStream>
+
+#include "CatalogInterner.h"
+#include "SyntheticCatalog.h"
+
+namespace {
+
+QVariantMap manifest(const QString& version)
+{
+    return {{"name", "chat"}, {"version", version}, {"description", "A chat module"},
+            {"category", "Chat"}, {"main", QVariantMap{{"linux-x86_64", "chat.so"}}},
+            {"dependencies", QVariantList{"net", "store"}}};
+}
+
+QVariantMap row(const QString& repo, const QStringList& versions)
+{
+    QVariantList vs;
+    for (const QString& v : versions)
+        vs.append(QVariantMap{{"rootHash", repo + v}, {"manifest", manifest(v)}});
+    return {{"repositoryUrl", repo}, {"name", "chat"}, {"versions", vs}};
+}
+
+// Same content, no sharing — as if each had come off the wire.
+QVariantList unshared(const QVariantList& catalog)
+{
+    QByteArray bytes;
+    {
+        QDataStream out(&bytes, QIODevice::WriteOnly);
+        out << catalog;
+    }
+    QVariantList copy;
+    QDataStream in(bytes);
+    in >> copy;
+    return copy;
+}
+
+QVariantMap manifestAt(const QVariantList& catalog, int row, int version)
+{
+    return catalog.at(row).toMap().value("versions").toList().at(version).toMap()
+        .value("manifest").toMap();
+}
+
+QVariant at(const QVariantList& catalog, int row, int version, const QString& key)
+{
+    return manifestAt(catalog, row, version).value(key);
+}
+
+} // namespace
+
+class CatalogInternerTest : public QObject {
+    Q_OBJECT
+
+private slots:
+    void preservesContent();
+    void sharesStringsAndManifests();
+    void pruneKeepsWhatIsReferenced();
+    void nestedDifferencesStayApart();
+};
+
+void CatalogInternerTest::preservesContent()
+{
+    const QVariantList catalog = unshared(syntheticcatalog::make(200, 4).rows);
+    CatalogInterner pool;
+    QCOMPARE(pool.intern(catalog), catalog);
+    QVERIFY(pool.hits() > 0);
+}
+
+void CatalogInternerTest::sharesStringsAndManifests()
+{
+    // A mirror publishing the same two versions, and a version bump
+    // that changes nothing but the version string.
+    const QVariantList catalog = unshared({row("https://a", {"1.1.0", "1.0.0"}),
+                                           row("https://b", {"1.1.0", "1.0.0"})});
+    CatalogInterner pool;
+    const QVariantList interned = pool.intern(catalog);
+
+    // Mirrored manifests are one container...
+    QVERIFY(manifestAt(interned, 0, 0).isSharedWith(manifestAt(interned, 1, 0)));
+    QVERIFY(manifestAt(interned, 0, 1).isSharedWith(manifestAt(interned, 1, 1)));
+    // ...and what repeats across versions is one string or list.
+    QCOMPARE(at(interned, 0, 0, "description").toString().constData(),
+             at(interned, 0, 1, "description").toString().constData());
+    QVERIFY(at(interned, 0, 0, "dependencies").toList()
+                .isSharedWith(at(interned, 0, 1, "dependencies").toList()));
+    // Not so before interning.
+    QVERIFY(!manifestAt(catalog, 0, 0).isSharedWith(manifestAt(catalog, 1, 0)));
+}
+
+void CatalogInternerTest::pruneKeepsWhatIsReferenced()
+{
+    CatalogInterner pool;
+    const QVariantList kept = pool.intern(unshared({row("https://a", {"1.0.0"})}));
+    const int strings    = pool.stringCount();
+    const int containers = pool.containerCount();
+    {
+        const QVariantList dropped = pool.intern(unshared({row("https://c", {"9.9.9"})}));
+        QVERIFY(pool.stringCount() > strings);
+    }
+
+    pool.prune();
+    QCOMPARE(pool.stringCount(), strings);
+    QCOMPARE(pool.containerCount(), containers);
+
+    // What's kept still interns to the pooled copy.
+    const QVariantList again = pool.intern(unshared({row("https://a", {"1.0.0"})}));
+    QVERIFY(at(again, 0, 0, "dependencies").toList()
+                .isSharedWith(at(kept, 0, 0, "dependencies").toList()));
+}
+
+void CatalogInternerTest::nestedDifferencesStayApart()
+{
+    // Same manifest but for one `main` entry, and for one dependency.
+    QVariantMap otherMain = manifest("1.0.0");
+    otherMain["main"] = QVariantMap{{"linux-x86_64", "chat2.so"}};
+    QVariantMap otherDeps = manifest("1.0.0");
+    otherDeps["dependencies"] = QVariantList{"net", "storage"};
+    auto single = [](const QString& repo, const QVariantMap& m) {
+        return QVariantMap{{"repositoryUrl", repo}, {"name", "chat"},
+                           {"versions", QVariantList{QVariantMap{{"manifest", m}}}}};
+    };
+    const QVariantList catalog = unshared({single("https://a", manifest("1.0.0")),
+                                           single("https://b", otherMain),
+                                           single("https://c", otherDeps)});
+    CatalogInterner pool;
+    const QVariantList interned = pool.intern(catalog);
+    QCOMPARE(interned, catalog);
+    QVERIFY(!manifestAt(interned, 0, 0).isSharedWith(manifestAt(interned, 1, 0)));
+    QVERIFY(!manifestAt(interned, 0, 0).isSharedWith(manifestAt(interned, 2, 0)));
+    // The parts they do share are still one copy.
+    QVERIFY(at(interned, 0, 0, "dependencies").toList()
+                .isSharedWith(at(interned, 1, 0, "dependencies").toList()));
+}
+
+QTEST_GUILESS_MAIN(CatalogInternerTest)
+
+#include "catalog_interner_test.moc"
@@ -0,0 +1,217 @@
+// DependencyGraph over a small fixed catalog: reverse dependencies
+// (all / installed-only), forward and reverse closures, cycles, module
+// aliases, and an installed version the catalog doesn't list. A graph
+// patched by update() answers like one built from scratch. An install
+// patches the installed snapshot under the row's moduleName.
+
+#include <QtTest>
+
+#include "DependencyGraph.h"
+#include "InstalledSnapshot.h"
+
+namespace {
+
+QVariantMap version(const QString& v, const QVariantList& deps)
+{
+    return {{"manifest", QVariantMap{{"version", v}, {"dependencies", deps}}}};
+}
+
+QVariantMap row(const QString& name, const QVariantList& versions,
+                const QString& moduleName = QString())
+{
+    QVariantMap m{{"name", name}, {"versions", versions}};
+    if (!moduleName.isEmpty()) m.insert("moduleName", moduleName);
+    return m;
+}
+
+QVariantMap installed(const QString& name, const QString& version)
+{
+    return {{"name", name}, {"version", version}};
+}
+
+// app 2.0 → ui, net        app 1.0 → net
+// ui  1.0 → net, store     net 1.0 → crypto      crypto 1.0 → (none)
+// store 1.0 → ui           (cycle ui ↔ store)
+// wallet 1.0 → { name: crypto_module }  (crypto's moduleName)
+QVariantList catalog()
+{
+    return {
+        row("app",    {version("2.0.0", {"ui", "net"}), version("1.0.0", {"net"})}),
+        row("ui",     {version("1.0.0", {"net", "store"})}),
+        row("net",    {version("1.0.0", {"crypto"})}),
+        row("crypto", {version("1.0.0", {})}, "crypto_module"),
+        row("store",  {version("1.0.0", {"ui"})}),
+        row("wallet", {version("1.0.0", {QVariantMap{{"name", "crypto_module"},
+                                                     {"version", "^1.0.0"}}})}),
+    };
+}
+
+} // namespace
+
+class DependencyGraphTest : public QObject {
+    Q_OBJECT
+
+private slots:
+    void dependents();
+    void dependencyClosure();
+    void cyclesTerminate();
+    void dependentClosure();
+    void unknownInstalledVersion();
+    void updateMatchesBuild();
+    void updateRefusesAliasChange();
+    void installPatchKeysByModuleName();
+};
+
+void DependencyGraphTest::dependents()
+{
+    DependencyGraph g;
+    g.build(catalog(), {installed("app", "1.0.0"), installed("net", "1.0.0")});
+
+    QCOMPARE(g.dependents("net", false), QStringList({"app", "ui"}));
+    // Installed app is 1.0, which does depend on net; ui isn't installed.
+    QCOMPARE(g.dependents("net", true), QStringList({"app"}));
+    // Installed app 1.0 doesn't depend on ui; 2.0 would.
+    QCOMPARE(g.dependents("ui", false), QStringList({"app", "store"}));
+    QCOMPARE(g.dependents("ui", true), QStringList());
+    // A moduleName resolves to its catalog name, both ways.
+    QCOMPARE(g.dependents("crypto_module", false), QStringList({"net", "wallet"}));
+    QCOMPARE(g.dependencies("wallet"), QStringList({"crypto"}));
+}
+
+void DependencyGraphTest::dependencyClosure()
+{
+    DependencyGraph g;
+    g.build(catalog(), {installed("app", "1.0.0")});
+
+    // Empty version = the installed one.
+    QCOMPARE(g.dependencyClosure("app"), QStringList({"net", "crypto"}));
+    QCOMPARE(g.dependencyClosure("app", "2.0.0"),
+             QStringList({"ui", "net", "store", "crypto"}));
+    QCOMPARE(g.dependencyClosure("crypto"), QStringList());
+    QCOMPARE(g.dependencyClosure("no_such_pkg"), QStringList());
+}
+
+void DependencyGraphTest::cyclesTerminate()
+{
+    DependencyGraph g;
+    g.build(catalog(), {});
+    QCOMPARE(g.dependencyClosure("ui"), QStringList({"net", "store", "crypto"}));
+    QCOMPARE(g.dependencyClosure("store"), QStringList({"ui", "net", "crypto"}));
+}
+
+void DependencyGraphTest::dependentClosure()
+{
+    DependencyGraph g;
+    g.build(catalog(), {installed("app", "2.0.0"), installed("ui", "1.0.0"),
+                        installed("net", "1.0.0"), installed("crypto_module", "1.0.0")});
+
+    // Nearest first: net's installed dependents, then theirs.
+    QCOMPARE(g.dependentClosure("crypto"), QStringList({"net", "app", "ui"}));
+    QCOMPARE(g.dependentClosure("app"), QStringList());
+
+    // Re-pointing the installed set: app back on 1.0 no longer needs ui.
+    g.setInstalledVersions({{"app", "1.0.0"}, {"ui", "1.0.0"}, {"net", "1.0.0"}});
+    QCOMPARE(g.dependentClosure("ui"), QStringList());
+}
+
+void DependencyGraphTest::unknownInstalledVersion()
+{
+    DependencyGraph g;
+    // net 0.9 is on disk, but neither the catalog nor the installed entry
+    // says what it depends on.
+    g.build(catalog(), {installed("app", "1.0.0"), installed("net", "0.9.0")});
+
+    QVERIFY(g.isInstalledVersionUnknown("net"));
+    QVERIFY(!g.isInstalledVersionUnknown("app"));
+    QVERIFY(!g.isInstalledVersionUnknown("crypto"));
+
+    // The walk names net but doesn't step through net 1.0's edges.
+    QStringList unknown;
+    QCOMPARE(g.dependencyClosure("app", QString(), &unknown), QStringList({"net"}));
+    QCOMPARE(unknown, QStringList({"net"}));
+
+    unknown.clear();
+    QCOMPARE(g.dependencyClosure("net", QString(), &unknown), QStringList());
+    QCOMPARE(unknown, QStringList({"net"}));
+    QCOMPARE(g.dependencies("net"), QStringList());
+    // An explicit catalog version is still answered.
+    QCOMPARE(g.dependencies("net", "1.0.0"), QStringList({"crypto"}));
+
+    // Nothing installed depends on crypto through an unknown net.
+    QCOMPARE(g.dependents("crypto", true), QStringList());
+    QCOMPARE(g.dependentClosure("crypto"), QStringList());
+}
+
+void DependencyGraphTest::updateMatchesBuild()
+{
+    const QVariantList inst{installed("app", "2.0.0"), installed("ui", "1.0.0"),
+                            installed("net", "2.0.0"), installed("crypto_module", "1.0.0")};
+    DependencyGraph patched;
+    patched.build(catalog(), inst);
+
+    // net gains 2.0 (→ store) and 1.0 loses its edge, store leaves the
+    // catalog, and a new package depends on app.
+    QVariantList after;
+    for (const QVariant& v : catalog()) {
+        const QString name = v.toMap().value("name").toString();
+        if (name == "store") continue;
+        if (name == "net")
+            after.append(row("net", {version("2.0.0", {"store"}), version("1.0.0", {})}));
+        else
+            after.append(v);
+    }
+    after.append(row("extra", {version("1.0.0", {"app"})}));
+    QVERIFY(patched.update(after, inst, {"net", "store", "extra"}));
+
+    DependencyGraph built;
+    built.build(after, inst);
+    for (const QString& name : {"app", "ui", "net", "crypto", "crypto_module", "store",
+                                "wallet", "extra"}) {
+        QCOMPARE(patched.dependencies(name), built.dependencies(name));
+        QCOMPARE(patched.dependents(name, false), built.dependents(name, false));
+        QCOMPARE(patched.dependents(name, true), built.dependents(name, true));
+        QCOMPARE(patched.dependencyClosure(name), built.dependencyClosure(name));
+        QStringList a = patched.dependentClosure(name);
+        QStringList b = built.dependentClosure(name);
+        a.sort();
+        b.sort();
+        QCOMPARE(a, b);
+    }
+    QCOMPARE(patched.dependencies("net", "1.0.0"), QStringList());
+    QCOMPARE(patched.dependents("store", false), QStringList({"net", "ui"}));
+}
+
+void DependencyGraphTest::updateRefusesAliasChange()
+{
+    DependencyGraph g;
+    g.build(catalog(), {});
+    QVariantList after = catalog();
+    after[3] = row("crypto", {version("1.0.0", {})}, "crypto_lib");
+    QVERIFY(!g.update(after, {}, {"crypto"}));
+    // Untouched: the old alias still resolves.
+    QCOMPARE(g.dependencies("wallet"), QStringList({"crypto"}));
+}
+
+void DependencyGraphTest::installPatchKeysByModuleName()
+{
+    DependencyGraph g;
+    g.build(catalog(), {});
+    QCOMPARE(g.moduleName("crypto"), QString("crypto_module"));
+    QCOMPARE(g.moduleName("net"), QString("net"));
+
+    // A download result names the catalog row ("crypto"); the installed
+    // set knows it by moduleName. The patch has to replace that entry,
+    // not add a second one next to it.
+    const auto before = InstalledSnapshot::build({
+        QVariantMap{{"name", "crypto"}, {"moduleName", "crypto_module"}, {"version", "1.0.0"}},
+    });
+    const auto after = before->withInstalled(g.moduleName("crypto"), "1.1.0", "abc");
+    QCOMPARE(after->size(), 1);
+    QCOMPARE(after->versionByName().value("crypto_module"), QString("1.1.0"));
+    QVERIFY(!after->contains("crypto"));
+    QVERIFY(after->fingerprint() != before->fingerprint());
+}
+
+QTEST_GUILESS_MAIN(DependencyGraphTest)
+
+#include "dependency_graph_test.moc"
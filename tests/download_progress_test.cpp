@@ -0,0 +1,105 @@
+// DownloadProgressTracker: aggregation across artifacts, EWMA smoothing
+// and the ETA, driven by a fake clock.
+
+#include <QtTest>
+
+#include "DownloadProgressTracker.h"
+
+class DownloadProgressTest : public QObject {
+    Q_OBJECT
+
+private slots:
+    void aggregatesAcrossArtifacts();
+    void totalUnknownUntilEverySizeIsKnown();
+    void smoothsThroughputAndEstimatesEta();
+    void retryDoesNotProduceNegativeRate();
+    void clearResets();
+    void acceptsOnlyTheExpectedEventShape();
+};
+
+void DownloadProgressTest::aggregatesAcrossArtifacts()
+{
+    DownloadProgressTracker t;
+    t.update("a", 100, 1000, 0);
+    t.update("b", 50, 500, 0);
+    t.update("a", 400, 1000, 10);
+    QCOMPARE(t.bytesDone(), qint64(450));
+    QCOMPARE(t.bytesTotal(), qint64(1500));
+
+    t.update("b", 500, 500, 20);
+    const QVariantMap v = t.toVariant();
+    QCOMPARE(v.value("active").toBool(), true);
+    QCOMPARE(v.value("artifactCount").toInt(), 2);
+    QCOMPARE(v.value("completedCount").toInt(), 1);
+}
+
+void DownloadProgressTest::totalUnknownUntilEverySizeIsKnown()
+{
+    DownloadProgressTracker t;
+    t.update("a", 100, 1000, 0);
+    t.update("b", 10, 0, 0);
+    QCOMPARE(t.bytesTotal(), qint64(0));
+    QCOMPARE(t.etaSeconds(), qint64(-1));
+    t.update("b", 20, 200, 0);
+    QCOMPARE(t.bytesTotal(), qint64(1200));
+}
+
+void DownloadProgressTest::smoothsThroughputAndEstimatesEta()
+{
+    DownloadProgressTracker t;
+    t.update("a", 0, 10000, 0);
+    t.update("a", 1000, 10000, 1000);       // 1000 B/s
+    QCOMPARE(t.bytesPerSecond(), 1000.0);
+    QCOMPARE(t.etaSeconds(), qint64(9));
+
+    // Samples closer together than the interval don't move the rate.
+    t.update("a", 5000, 10000, 1100);
+    QCOMPARE(t.bytesPerSecond(), 1000.0);
+
+    // One fast window only pulls the average part of the way.
+    t.update("a", 5000, 10000, 2000);       // 4000 B over 1 s
+    QVERIFY(t.bytesPerSecond() > 1000.0);
+    QVERIFY(t.bytesPerSecond() < 4000.0);
+    QVERIFY(t.etaSeconds() > 0);
+}
+
+void DownloadProgressTest::retryDoesNotProduceNegativeRate()
+{
+    DownloadProgressTracker t;
+    t.update("a", 800, 1000, 0);
+    t.update("a", 100, 1000, 500);
+    QCOMPARE(t.bytesDone(), qint64(100));
+    QVERIFY(t.bytesPerSecond() >= 0.0);
+}
+
+void DownloadProgressTest::clearResets()
+{
+    DownloadProgressTracker t;
+    t.update("a", 500, 1000, 0);
+    t.update("a", 900, 1000, 1000);
+    t.clear();
+    QVERIFY(t.isEmpty());
+    QCOMPARE(t.bytesDone(), qint64(0));
+    QCOMPARE(t.bytesPerSecond(), 0.0);
+    QCOMPARE(t.toVariant().value("active").toBool(), false);
+}
+
+void DownloadProgressTest::acceptsOnlyTheExpectedEventShape()
+{
+    DownloadProgressTracker t;
+    QVERIFY(!t.applyEvent(QJsonObject(), 0));
+    QVERIFY(!t.applyEvent(QJsonObject{{"name", "a"}}, 0));
+    QVERIFY(!t.applyEvent(QJsonObject{{"name", "a"}, {"bytesDone", "12"}}, 0));
+    QVERIFY(!t.applyEvent(QJsonObject{{"bytesDone", 12}, {"bytesTotal", 100}}, 0));
+    QVERIFY(t.isEmpty());
+    QCOMPARE(t.toVariant().value("active").toBool(), false);
+
+    QVERIFY(t.applyEvent(QJsonObject{{"name", "a"}, {"version", "1.0"}, {"bytesDone", 12}}, 0));
+    QVERIFY(t.applyEvent(QJsonObject{{"rootHash", "h"}, {"bytesDone", 30}, {"bytesTotal", 100}}, 0));
+    QCOMPARE(t.bytesDone(), qint64(42));
+    QCOMPARE(t.toVariant().value("artifactCount").toInt(), 2);
+}
+
+QTEST_APPLESS_MAIN(DownloadProgressTest)
+
+#include "download_progress_test.moc"
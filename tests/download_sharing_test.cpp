@@ -0,0 +1,222 @@
+// DownloadSharing: identical requests share one call, overlapping ones
+// share the artifacts they have in common, a cancelled requester is
+// answered at once while the others stay on the call, and a call nobody
+// waits on any more can be re-joined.
+
+#include <QtTest>
+
+#include "DownloadSharing.h"
+
+namespace {
+
+QVariantList reply(const QString& name)
+{
+    return {QVariantMap{{"name", name}, {"path", "/tmp/" + name + ".lgx"}}};
+}
+
+QVariantMap entry(const QString& name, bool topLevel)
+{
+    return {{"name", name}, {"path", "/tmp/" + name + ".lgx"}, {"topLevel", topLevel}};
+}
+
+DownloadSharing::Part part(const QString& key, const QString& topLevelName,
+                           const QStringList& names)
+{
+    return DownloadSharing::Part{key, topLevelName, names};
+}
+
+} // namespace
+
+class DownloadSharingTest : public QObject {
+    Q_OBJECT
+
+private slots:
+    void identicalRequestsShareOneCall();
+    void differentKeysGetTheirOwnCalls();
+    void cancelOneWhileTheOtherContinues();
+    void cancelledCallCanBeRejoined();
+    void ticketsAndWaitingNames();
+    void overlappingRequestsShareTheCommonArtifact();
+    void missingSharedTopLevelBecomesAnError();
+    void cancelCountsEveryEmptiedCall();
+    void unkeyedPartsAreNeverShared();
+};
+
+void DownloadSharingTest::identicalRequestsShareOneCall()
+{
+    DownloadSharing sharing;
+    QVariantList gotA, gotB;
+    const auto a = sharing.attach("k", {"wallet"}, [&](const QVariantList& r) { gotA = r; });
+    const auto b = sharing.attach("k", {"wallet"}, [&](const QVariantList& r) { gotB = r; });
+
+    QVERIFY(a.newCall);
+    QCOMPARE(a.woken, 1);
+    QVERIFY(!b.newCall);
+    QCOMPARE(b.woken, 0);
+    QCOMPARE(b.call, a.call);
+    QVERIFY(a.ticket != b.ticket);
+    QCOMPARE(sharing.requesterCount(a.call), 2);
+
+    QVERIFY(sharing.finish(a.call, reply("wallet")));
+    QCOMPARE(gotA, reply("wallet"));
+    QCOMPARE(gotB, reply("wallet"));
+    QVERIFY(!sharing.isOpen(a.call));
+
+    // Closed: the next identical request sends a fresh call.
+    const auto c = sharing.attach("k", {"wallet"}, {});
+    QVERIFY(c.newCall);
+    QVERIFY(c.call != a.call);
+}
+
+void DownloadSharingTest::differentKeysGetTheirOwnCalls()
+{
+    // Overlapping but not identical (say wallet vs. wallet + chat): the
+    // downloader resolves each, so they don't share.
+    DownloadSharing sharing;
+    const auto a = sharing.attach("wallet", {"wallet"}, {});
+    const auto b = sharing.attach("wallet+chat", {"wallet", "chat"}, {});
+    QVERIFY(a.newCall);
+    QVERIFY(b.newCall);
+    QVERIFY(a.call != b.call);
+}
+
+void DownloadSharingTest::cancelOneWhileTheOtherContinues()
+{
+    DownloadSharing sharing;
+    QVariantList gotA, gotB;
+    int callsA = 0;
+    const auto a = sharing.attach("k", {"wallet", "chat"},
+                                  [&](const QVariantList& r) { gotA = r; ++callsA; });
+    const auto b = sharing.attach("k", {"wallet"}, [&](const QVariantList& r) { gotB = r; });
+
+    QVERIFY(!sharing.cancel(a.ticket, "Download cancelled"));   // b still waiting
+    QCOMPARE(callsA, 1);
+    QCOMPARE(gotA.size(), 2);
+    for (const QVariant& v : std::as_const(gotA)) {
+        QCOMPARE(v.toMap().value("error").toString(), QString("Download cancelled"));
+        QVERIFY(v.toMap().value("topLevel").toBool());
+    }
+    QVERIFY(gotB.isEmpty());
+    QVERIFY(sharing.isOpen(a.call));
+    QCOMPARE(sharing.requesterCount(a.call), 1);
+
+    QVERIFY(sharing.finish(a.call, reply("wallet")));
+    QCOMPARE(gotB, reply("wallet"));
+    QCOMPARE(callsA, 1);   // not answered twice
+
+    QVERIFY(!sharing.cancel(a.ticket, "late"));   // already gone
+}
+
+void DownloadSharingTest::cancelledCallCanBeRejoined()
+{
+    DownloadSharing sharing;
+    const auto a = sharing.attach("k", {"wallet"}, {});
+    QVERIFY(sharing.cancel(a.ticket, "Download cancelled"));   // last one out
+    QVERIFY(sharing.isOpen(a.call));                           // IPC runs on
+
+    QVariantList got;
+    const auto b = sharing.attach("k", {"wallet"}, [&](const QVariantList& r) { got = r; });
+    QVERIFY(!b.newCall);
+    QCOMPARE(b.woken, 1);
+    QCOMPARE(b.call, a.call);
+
+    sharing.finish(a.call, reply("wallet"));
+    QCOMPARE(got, reply("wallet"));
+
+    // A reply for a call nobody is attached to any more.
+    const auto c = sharing.attach("other", {"chat"}, {});
+    sharing.cancel(c.ticket, "Download cancelled");
+    QVERIFY(!sharing.finish(c.call, reply("chat")));
+}
+
+void DownloadSharingTest::ticketsAndWaitingNames()
+{
+    DownloadSharing sharing;
+    const auto a = sharing.attach("k1", {"wallet", "chat"}, {});
+    const auto b = sharing.attach("k2", {"chat"}, {});
+    QCOMPARE(sharing.ticketsFor("chat").size(), 2);
+    QCOMPARE(sharing.ticketsFor("wallet"), QList<quint64>{a.ticket});
+    QCOMPARE(sharing.waitingNames().size(), 2);
+
+    sharing.cancel(a.ticket, "x");
+    QCOMPARE(sharing.waitingNames(), QStringList{"chat"});
+    sharing.finish(b.call, {});
+    QVERIFY(sharing.waitingNames().isEmpty());
+}
+
+void DownloadSharingTest::overlappingRequestsShareTheCommonArtifact()
+{
+    DownloadSharing sharing;
+    QVariantList gotA, gotB;
+    const auto a = sharing.attach({part("wallet@1/h1", "wallet", {"wallet", "crypto"}),
+                                   part("extra@1/h3", "extra", {"extra"})},
+                                  {"wallet", "extra"}, [&](const QVariantList& r) { gotA = r; });
+    const auto b = sharing.attach({part("wallet@1/h1", "wallet", {"wallet", "crypto"}),
+                                   part("chat@2/h2", "chat", {"chat", "crypto", "net"})},
+                                  {"wallet", "chat"}, [&](const QVariantList& r) { gotB = r; });
+
+    // wallet rides on a's call; only chat goes out.
+    QVERIFY(b.newCall);
+    QVERIFY(b.call != a.call);
+    QCOMPARE(b.unshared, QList<int>{1});
+    QCOMPARE(b.woken, 1);
+    QCOMPARE(sharing.requesterCount(a.call), 2);
+    QCOMPARE(sharing.requesterCount(b.call), 1);
+
+    const QVariantList replyA{entry("crypto", false), entry("wallet", true), entry("extra", true)};
+    QVERIFY(sharing.finish(a.call, replyA));
+    QCOMPARE(gotA, replyA);
+    QVERIFY(gotB.isEmpty());   // still waiting on its own call
+
+    // b's call fetched crypto again for chat; the shared copy wins.
+    QVERIFY(sharing.finish(b.call, {entry("crypto", false), entry("net", false), entry("chat", true)}));
+    QCOMPARE(gotB, (QVariantList{entry("crypto", false), entry("wallet", true),
+                                 entry("net", false), entry("chat", true)}));
+}
+
+void DownloadSharingTest::missingSharedTopLevelBecomesAnError()
+{
+    DownloadSharing sharing;
+    QVariantList got;
+    const auto a = sharing.attach({part("wallet@1/h1", "wallet", {"wallet"}),
+                                   part("extra@1/h3", "extra", {"extra"})},
+                                  {"wallet", "extra"}, {});
+    const auto b = sharing.attach({part("wallet@1/h1", "wallet", {"wallet"})},
+                                  {"wallet"}, [&](const QVariantList& r) { got = r; });
+    QVERIFY(!b.newCall);
+    QCOMPARE(b.call, 0);
+
+    sharing.finish(a.call, {QVariantMap{{"name", "extra"}, {"error", "boom"}}});
+    QCOMPARE(got.size(), 1);
+    const QVariantMap m = got.first().toMap();
+    QCOMPARE(m.value("name").toString(), QString("wallet"));
+    QVERIFY(m.value("topLevel").toBool());
+    QVERIFY(m.contains("error"));
+}
+
+void DownloadSharingTest::cancelCountsEveryEmptiedCall()
+{
+    DownloadSharing sharing;
+    const auto a = sharing.attach({part("wallet@1/h1", "wallet", {"wallet"})}, {"wallet"}, {});
+    const auto b = sharing.attach({part("wallet@1/h1", "wallet", {"wallet"}),
+                                   part("chat@2/h2", "chat", {"chat"})},
+                                  {"wallet", "chat"}, {});
+    QCOMPARE(sharing.cancel(a.ticket, "x"), 0);   // b still on a's call
+    QCOMPARE(sharing.cancel(b.ticket, "x"), 2);   // leaves both calls empty
+    QVERIFY(sharing.isOpen(a.call));
+    QVERIFY(sharing.isOpen(b.call));
+}
+
+void DownloadSharingTest::unkeyedPartsAreNeverShared()
+{
+    DownloadSharing sharing;
+    const auto a = sharing.attach({part("", "wallet", {"wallet"})}, {"wallet"}, {});
+    const auto b = sharing.attach({part("", "wallet", {"wallet"})}, {"wallet"}, {});
+    QVERIFY(a.newCall);
+    QVERIFY(b.newCall);
+    QVERIFY(a.call != b.call);
+}
+
+QTEST_APPLESS_MAIN(DownloadSharingTest)
+
+#include "download_sharing_test.moc"
@@ -0,0 +1,343 @@
+// PackagesFilterProxy's source-group index: after every kind of filter
+// and sort change it must match a from-scratch scan of the proxy's rows,
+// and isFirstOfSource / sourceGroupCount must agree with it. A collapsed
+// group is a single placeholder row, filtered by the rows it stands for.
+// A view that only follows the proxy's signals ends up with the same
+// isFirstOfSource / sourceGroupCount the proxy answers. Selections and
+// dropdown picks come back when a collapsed group is expanded again.
+
+#include <QtTest>
+
+#include "PackageListModel.h"
+#include "PackageRowBuilder.h"
+#include "PackagesFilterProxy.h"
+#include "SyntheticCatalog.h"
+
+namespace {
+
+const QStringList kValidVariants{QStringLiteral("linux-x86_64")};
+
+int roleId(const QAbstractItemModel& m, const char* name)
+{
+    return m.roleNames().key(QByteArray(name), -1);
+}
+
+// The groups as a plain scan of the rows sees them.
+QList<PackagesFilterProxy::SourceGroup> scanGroups(const PackagesFilterProxy& proxy)
+{
+    const int sectionRole = roleId(proxy, "repositoryDisplayName");
+    QList<PackagesFilterProxy::SourceGroup> out;
+    for (int r = 0; r < proxy.rowCount(); ++r) {
+        const QString s = proxy.data(proxy.index(r, 0), sectionRole).toString();
+        if (out.isEmpty() || out.last().section != s) out.append({s, r, 0});
+        ++out.last().count;
+    }
+    return out;
+}
+
+} // namespace
+
+class FilterProxyGroupsTest : public QObject {
+    Q_OBJECT
+
+private slots:
+    void init();
+    void groupsAfterLoad();
+    void groupsTrackFilters();
+    void groupsTrackSort();
+    void rolesMatchGroups();
+    void collapsedGroupIsOnePlaceholder();
+    void collapsedCountMatchesExpandedRows();
+    void groupRolesReachViews();
+    void choicesSurviveCollapse();
+    void collapsedTallyMatchesLocalRowsByModule();
+
+private:
+    void verifyGroups();
+
+    QScopedPointer<PackageListModel>    m_model;
+    QScopedPointer<PackagesFilterProxy> m_proxy;
+};
+
+void FilterProxyGroupsTest::init()
+{
+    m_model.reset(new PackageListModel);
+    m_proxy.reset(new PackagesFilterProxy);
+    m_proxy->setSourceModel(m_model.data());
+    const syntheticcatalog::Catalog c = syntheticcatalog::make(600, 2);
+    m_model->setPackages(packagerows::buildPackageRows(c.rows, c.installed, kValidVariants));
+}
+
+void FilterProxyGroupsTest::verifyGroups()
+{
+    const auto expected = scanGroups(*m_proxy);
+    const auto actual   = m_proxy->sourceGroups();
+    QCOMPARE(actual.size(), expected.size());
+    for (int g = 0; g < expected.size(); ++g) {
+        QCOMPARE(actual.at(g).section, expected.at(g).section);
+        QCOMPARE(actual.at(g).first,   expected.at(g).first);
+        QCOMPARE(actual.at(g).count,   expected.at(g).count);
+    }
+}
+
+void FilterProxyGroupsTest::groupsAfterLoad()
+{
+    // Three synthetic repositories plus the local bucket.
+    QCOMPARE(m_proxy->sourceGroups().size(), 4);
+    verifyGroups();
+}
+
+void FilterProxyGroupsTest::groupsTrackFilters()
+{
+    QSignalSpy changed(m_proxy.data(), &PackagesFilterProxy::sourceGroupsChanged);
+
+    m_proxy->setSearchText(QStringLiteral("pkg_0001"));
+    verifyGroups();
+    m_proxy->setSearchText(QStringLiteral("pkg_00012"));
+    verifyGroups();
+    m_proxy->setSearchText(QStringLiteral("no-such-package"));
+    verifyGroups();
+    QVERIFY(m_proxy->sourceGroups().isEmpty());
+    m_proxy->setSearchText(QString());
+    verifyGroups();
+
+    m_proxy->setInstallStateFilter(1);
+    verifyGroups();
+    m_proxy->setInstallStateFilter(2);
+    verifyGroups();
+    m_proxy->setInstallStateFilter(0);
+    m_proxy->setCategoryFilter(QStringLiteral("Chat"));
+    verifyGroups();
+    m_proxy->setTypeFilter(QStringLiteral("ui"));
+    verifyGroups();
+    m_proxy->setCategoryFilter(QString());
+    m_proxy->setTypeFilter(QString());
+    verifyGroups();
+    QVERIFY(changed.count() > 0);
+}
+
+void FilterProxyGroupsTest::groupsTrackSort()
+{
+    m_proxy->setSortRoleByName(QStringLiteral("name"));
+    m_proxy->setSortOrderInt(Qt::DescendingOrder);
+    verifyGroups();
+    // Sorting never interleaves repositories.
+    QCOMPARE(m_proxy->sourceGroups().size(), 4);
+    m_proxy->setSearchText(QStringLiteral("pkg_00"));
+    verifyGroups();
+}
+
+void FilterProxyGroupsTest::rolesMatchGroups()
+{
+    m_proxy->setSearchText(QStringLiteral("pkg_0002"));
+    const int firstRole = roleId(*m_proxy, "isFirstOfSource");
+    const int countRole = roleId(*m_proxy, "sourceGroupCount");
+    QCOMPARE(countRole, int(PackagesFilterProxy::SourceGroupCountRole));
+    for (const PackagesFilterProxy::SourceGroup& g : m_proxy->sourceGroups()) {
+        for (int r = g.first; r < g.first + g.count; ++r) {
+            const QModelIndex idx = m_proxy->index(r, 0);
+            QCOMPARE(m_proxy->data(idx, firstRole).toBool(), r == g.first);
+            QCOMPARE(m_proxy->data(idx, countRole).toInt(), g.count);
+        }
+    }
+}
+
+void FilterProxyGroupsTest::collapsedGroupIsOnePlaceholder()
+{
+    const PackagesFilterProxy::SourceGroup expanded = m_proxy->sourceGroups().first();
+    const QString url = m_proxy->data(m_proxy->index(expanded.first, 0),
+                                      roleId(*m_proxy, "repositoryUrl")).toString();
+    const syntheticcatalog::Catalog c = syntheticcatalog::make(600, 2);
+    m_model->setPackages(packagerows::buildPackageRows(c.rows, c.installed, kValidVariants, {url}));
+    verifyGroups();
+    QCOMPARE(m_proxy->sourceGroups().size(), 4);
+
+    const PackagesFilterProxy::SourceGroup collapsed = m_proxy->sourceGroups().first();
+    QCOMPARE(collapsed.section, expanded.section);
+    QCOMPARE(collapsed.count, 1);
+    const QModelIndex idx = m_proxy->index(collapsed.first, 0);
+    QVERIFY(m_proxy->data(idx, roleId(*m_proxy, "isGroupPlaceholder")).toBool());
+    QCOMPARE(m_proxy->data(idx, roleId(*m_proxy, "groupRowCount")).toInt(), expanded.count);
+    QCOMPARE(m_proxy->data(idx, PackagesFilterProxy::GroupMatchCountRole).toInt(), expanded.count);
+
+    // A filter nothing in the group passes hides the placeholder too.
+    m_proxy->setSearchText(QStringLiteral("no-such-package"));
+    verifyGroups();
+    QVERIFY(m_proxy->sourceGroups().isEmpty());
+}
+
+void FilterProxyGroupsTest::collapsedCountMatchesExpandedRows()
+{
+    const PackagesFilterProxy::SourceGroup first = m_proxy->sourceGroups().first();
+    const QString section = first.section;
+    const QString url = m_proxy->data(m_proxy->index(first.first, 0),
+                                      roleId(*m_proxy, "repositoryUrl")).toString();
+    const syntheticcatalog::Catalog c = syntheticcatalog::make(600, 2);
+
+    // The section's filtered row count, whether expanded or collapsed.
+    auto countFor = [&]() {
+        for (const PackagesFilterProxy::SourceGroup& g : m_proxy->sourceGroups()) {
+            if (g.section != section) continue;
+            int n = 0;
+            for (int r = g.first; r < g.first + g.count; ++r) n += m_proxy->groupMatchCount(r);
+            return n;
+        }
+        return 0;
+    };
+    auto check = [&]() {
+        m_model->setPackages(packagerows::buildPackageRows(c.rows, c.installed, kValidVariants));
+        const int expandedCount = countFor();
+        m_model->setPackages(packagerows::buildPackageRows(c.rows, c.installed, kValidVariants,
+                                                           {url}));
+        verifyGroups();
+        QCOMPARE(countFor(), expandedCount);
+    };
+
+    check();
+    m_proxy->setSearchText(QStringLiteral("pkg_0001"));
+    check();
+    m_proxy->setSearchText(QString());
+    m_proxy->setInstallStateFilter(1);
+    check();
+    m_proxy->setInstallStateFilter(2);
+    check();
+    m_proxy->setInstallStateFilter(0);
+    m_proxy->setCategoryFilter(QStringLiteral("Chat"));
+    check();
+    m_proxy->setTypeFilter(QStringLiteral("ui"));
+    check();
+
+    // Changing the filter while collapsed moves the count without a reload.
+    m_proxy->setCategoryFilter(QString());
+    m_proxy->setTypeFilter(QString());
+    QCOMPARE(countFor(), first.count);
+}
+
+void FilterProxyGroupsTest::groupRolesReachViews()
+{
+    // What a view holds: per row (isFirstOfSource, sourceGroupCount),
+    // read when the row arrives or when dataChanged names those roles.
+    const int firstRole = roleId(*m_proxy, "isFirstOfSource");
+    const int countRole = PackagesFilterProxy::SourceGroupCountRole;
+    auto read = [&](int r) {
+        const QModelIndex idx = m_proxy->index(r, 0);
+        return qMakePair(m_proxy->data(idx, firstRole).toBool(),
+                         m_proxy->data(idx, countRole).toInt());
+    };
+    QList<QPair<bool, int>> view;
+    auto reload = [&]() {
+        view.clear();
+        for (int r = 0; r < m_proxy->rowCount(); ++r) view.append(read(r));
+    };
+    reload();
+    connect(m_proxy.data(), &QAbstractItemModel::modelReset, this, reload);
+    connect(m_proxy.data(), &QAbstractItemModel::layoutChanged, this, reload);
+    connect(m_proxy.data(), &QAbstractItemModel::rowsInserted, this,
+            [&](const QModelIndex&, int first, int last) {
+                for (int r = first; r <= last; ++r) view.insert(r, read(r));
+            });
+    connect(m_proxy.data(), &QAbstractItemModel::rowsRemoved, this,
+            [&](const QModelIndex&, int first, int last) {
+                view.remove(first, last - first + 1);
+            });
+    connect(m_proxy.data(), &QAbstractItemModel::dataChanged, this,
+            [&](const QModelIndex& tl, const QModelIndex& br, const QList<int>& roles) {
+                if (!roles.isEmpty() && !roles.contains(firstRole) && !roles.contains(countRole))
+                    return;
+                for (int r = tl.row(); r <= br.row(); ++r) view[r] = read(r);
+            });
+
+    auto verifyView = [&]() {
+        QCoreApplication::processEvents();   // the role refresh is queued
+        QCOMPARE(view.size(), m_proxy->rowCount());
+        for (int r = 0; r < view.size(); ++r) QCOMPARE(view.at(r), read(r));
+    };
+    // Narrowing removes rows from every group, widening puts them back;
+    // the install-state filter cuts groups in the middle.
+    m_proxy->setSearchText(QStringLiteral("pkg_0001"));
+    verifyView();
+    m_proxy->setSearchText(QStringLiteral("pkg_0001"));
+    verifyView();
+    m_proxy->setInstallStateFilter(1);
+    verifyView();
+    m_proxy->setInstallStateFilter(0);
+    verifyView();
+    m_proxy->setSearchText(QString());
+    verifyView();
+    disconnect(m_proxy.data(), nullptr, this, nullptr);
+}
+
+void FilterProxyGroupsTest::choicesSurviveCollapse()
+{
+    const syntheticcatalog::Catalog c = syntheticcatalog::make(600, 2);
+    int row = -1;
+    for (int r = 0; r < m_model->rowCount() && row < 0; ++r) {
+        const QVariantMap p = m_model->packageAt(r);
+        if (p.value("isVariantAvailable").toBool() && p.value("availableVersions").toList().size() > 1)
+            row = r;
+    }
+    QVERIFY(row >= 0);
+    const QVariantMap picked = m_model->packageAt(row);
+    const QString url = picked.value("repositoryUrl").toString();
+    m_model->updatePackageSelection(row, true);
+    m_model->setRowVersion(row, 1);
+
+    m_model->setPackages(packagerows::buildPackageRows(c.rows, c.installed, kValidVariants,
+                                                       {url}));
+    for (int r = 0; r < m_model->rowCount(); ++r)
+        QVERIFY(m_model->packageAt(r).value("name") != picked.value("name")
+                || m_model->packageAt(r).value("repositoryUrl") != picked.value("repositoryUrl"));
+
+    m_model->setPackages(packagerows::buildPackageRows(c.rows, c.installed, kValidVariants));
+    bool found = false;
+    for (int r = 0; r < m_model->rowCount(); ++r) {
+        const QVariantMap p = m_model->packageAt(r);
+        if (p.value("name") != picked.value("name")
+            || p.value("repositoryUrl") != picked.value("repositoryUrl"))
+            continue;
+        found = true;
+        QVERIFY(p.value("isSelected").toBool());
+        QCOMPARE(p.value("selectedVersionIndex").toInt(), 1);
+    }
+    QVERIFY(found);
+
+    // Clearing while collapsed reaches the hidden row too.
+    m_model->setPackages(packagerows::buildPackageRows(c.rows, c.installed, kValidVariants,
+                                                       {url}));
+    m_model->clearAllSelections();
+    m_model->setPackages(packagerows::buildPackageRows(c.rows, c.installed, kValidVariants));
+    for (int r = 0; r < m_model->rowCount(); ++r)
+        QVERIFY(!m_model->packageAt(r).value("isSelected").toBool());
+}
+
+void FilterProxyGroupsTest::collapsedTallyMatchesLocalRowsByModule()
+{
+    // A catalog package whose name differs from the module it installs.
+    const QVariantMap manifest{{"name", "wallet_module"}};
+    const QVariantList catalog{QVariantMap{
+        {"name", "wallet"},
+        {"repositoryUrl", "https://example.org/logos-repo.json"},
+        {"repositoryName", "example"},
+        {"repositoryDisplayName", "Example"},
+        {"versions", QVariantList{QVariantMap{{"version", "1.0.0"}, {"manifest", manifest}}}},
+    }};
+    const QVariantList installed{QVariantMap{
+        {"name", "wallet_module"},
+        {"moduleName", "wallet_module"},
+        {"version", "1.0.0"},
+        {"installType", "user"},
+    }};
+
+    const auto expanded = packagerows::buildPackageRows(catalog, installed, kValidVariants);
+    QCOMPARE(expanded.size(), 1);
+    const auto collapsed = packagerows::buildPackageRows(catalog, installed, kValidVariants,
+                                                         {QStringLiteral("https://example.org/logos-repo.json")});
+    QCOMPARE(collapsed.size(), 1);
+    QVERIFY(collapsed.first().value("isGroupPlaceholder").toBool());
+    QCOMPARE(collapsed.first().value("groupRowCount").toInt(), 1);
+    QCOMPARE(collapsed.first().value("groupInstalledCount").toInt(), 1);
+}
+
+QTEST_GUILESS_MAIN(FilterProxyGroupsTest)
+
+#include "filter_proxy_groups_test.moc"
@@ -0,0 +1,146 @@
+// InstallJournal: state transitions persist, open transactions survive a
+// restart, and the rollback plan undoes the right steps in the right
+// order.
+
+#include <QtTest>
+
+#include <QFile>
+#include <QTemporaryDir>
+
+#include "InstallJournal.h"
+
+namespace {
+
+InstallJournal::Step step(const QString& name, const QString& from, const QString& to,
+                          bool priorRemoved = false)
+{
+    InstallJournal::Step s;
+    s.name         = name;
+    s.fromVersion  = from;
+    s.fromRootHash = from.isEmpty() ? QString() : name + QLatin1Char('@') + from;
+    s.toVersion    = to;
+    s.toRootHash   = name + QLatin1Char('@') + to;
+    s.priorRemoved = priorRemoved;
+    return s;
+}
+
+QStringList names(const QList<InstallJournal::Step>& steps)
+{
+    QStringList out;
+    for (const InstallJournal::Step& s : steps) out.append(s.name);
+    return out;
+}
+
+} // namespace
+
+class InstallJournalTest : public QObject {
+    Q_OBJECT
+
+private slots:
+    void init();
+
+    void beginThenFinish();
+    void stateSurvivesRestart();
+    void rollbackPlanIsNewestFirst();
+    void failedStepWithRemovedPrior();
+    void unknownTransactionIsIgnored();
+
+private:
+    QString journalPath() const { return m_dir->path() + "/journal.json"; }
+    QScopedPointer<QTemporaryDir> m_dir;
+};
+
+void InstallJournalTest::init()
+{
+    m_dir.reset(new QTemporaryDir);
+    QVERIFY(m_dir->isValid());
+}
+
+void InstallJournalTest::beginThenFinish()
+{
+    InstallJournal journal(journalPath());
+    const QString txn = journal.begin({step("a", "", "1.0.0")});
+    QVERIFY(!txn.isEmpty());
+    QVERIFY(QFile::exists(journalPath()));
+    QCOMPARE(journal.transactions().size(), 1);
+
+    journal.setState(txn, "a", InstallJournal::Step::Applied);
+    journal.finish(txn);
+    QVERIFY(journal.transactions().isEmpty());
+    QVERIFY(!journal.find(txn));
+
+    InstallJournal reopened(journalPath());
+    QVERIFY(reopened.transactions().isEmpty());
+}
+
+void InstallJournalTest::stateSurvivesRestart()
+{
+    QString txn;
+    {
+        InstallJournal journal(journalPath());
+        InstallJournal::Step dep = step("dep", "1.0.0", "1.1.0");
+        dep.moduleName = "dep_module";
+        txn = journal.begin({dep, step("app", "", "2.0.0")});
+        journal.setState(txn, "dep", InstallJournal::Step::Applied);
+    }
+
+    InstallJournal reopened(journalPath());
+    const QList<InstallJournal::Transaction> open = reopened.transactions();
+    QCOMPARE(open.size(), 1);
+    QCOMPARE(open.first().id, txn);
+    QVERIFY(open.first().startedAt.isValid());
+    QCOMPARE(open.first().steps.size(), 2);
+    const InstallJournal::Step dep = open.first().steps.at(0);
+    QCOMPARE(dep.state, InstallJournal::Step::Applied);
+    QCOMPARE(dep.moduleName, QString("dep_module"));
+    QCOMPARE(dep.fromVersion, QString("1.0.0"));
+    QCOMPARE(dep.fromRootHash, QString("dep@1.0.0"));
+    QCOMPARE(dep.toRootHash, QString("dep@1.1.0"));
+    QCOMPARE(open.first().steps.at(1).state, InstallJournal::Step::Pending);
+}
+
+void InstallJournalTest::rollbackPlanIsNewestFirst()
+{
+    InstallJournal journal(journalPath());
+    const QString txn = journal.begin({step("a", "", "1.0.0"),
+                                       step("b", "0.9.0", "1.0.0"),
+                                       step("c", "", "1.0.0"),
+                                       step("d", "", "1.0.0")});
+    journal.setState(txn, "a", InstallJournal::Step::Applied);
+    journal.setState(txn, "b", InstallJournal::Step::Applied);
+    journal.setState(txn, "c", InstallJournal::Step::Failed);
+
+    const InstallJournal::Transaction* t = journal.find(txn);
+    QVERIFY(t);
+    // c failed without touching anything; d never ran.
+    QCOMPARE(names(InstallJournal::rollbackPlan(*t)), QStringList({"b", "a"}));
+}
+
+void InstallJournalTest::failedStepWithRemovedPrior()
+{
+    InstallJournal journal(journalPath());
+    const QString txn = journal.begin({step("dep", "", "1.0.0"),
+                                       step("app", "1.0.0", "2.0.0", true)});
+    journal.setState(txn, "dep", InstallJournal::Step::Applied);
+    journal.setState(txn, "app", InstallJournal::Step::Failed);
+
+    // The upgrade gate had already removed app 1.0.0, so it's restored
+    // even though its own step failed.
+    const InstallJournal::Transaction* t = journal.find(txn);
+    QVERIFY(t);
+    QCOMPARE(names(InstallJournal::rollbackPlan(*t)), QStringList({"app", "dep"}));
+}
+
+void InstallJournalTest::unknownTransactionIsIgnored()
+{
+    InstallJournal journal(journalPath());
+    const QString txn = journal.begin({step("a", "", "1.0.0")});
+    journal.setState("nope", "a", InstallJournal::Step::Applied);
+    journal.finish("nope");
+    QCOMPARE(journal.transactions().size(), 1);
+    QCOMPARE(journal.find(txn)->steps.first().state, InstallJournal::Step::Pending);
+}
+
+QTEST_APPLESS_MAIN(InstallJournalTest)
+
+#include "install_journal_test.moc"
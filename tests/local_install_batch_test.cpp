@@ -0,0 +1,161 @@
+// LocalInstallBatch: deps-first ordering, cycles, the parallel cap,
+// skipping dependents of a failed entry, and when the batch counts as
+// done.
+
+#include <QtTest>
+
+#include "LocalInstallBatch.h"
+
+namespace {
+
+LocalInstallBatch::Entry entry(const QString& name, const QStringList& deps = {},
+                               const QString& version = QStringLiteral("1.0.0"))
+{
+    LocalInstallBatch::Entry e;
+    e.file    = QStringLiteral("/pkgs/%1-%2.lgx").arg(name, version);
+    e.name    = name;
+    e.version = version;
+    e.deps    = deps;
+    return e;
+}
+
+// A batch over `entries`, inspected in the given (file) order and planned.
+void load(LocalInstallBatch& b, const QList<LocalInstallBatch::Entry>& entries)
+{
+    QStringList files;
+    for (const auto& e : entries) files.append(e.file);
+    b.reset(1, files);
+    for (const auto& e : entries) b.inspected(&e);
+    b.plan();
+}
+
+void approveAll(LocalInstallBatch& b)
+{
+    for (const QString& n : b.order()) QVERIFY(b.approve(n));
+}
+
+} // namespace
+
+class LocalInstallBatchTest : public QObject {
+    Q_OBJECT
+
+private slots:
+    void ordersDependenciesFirst();
+    void newerFileForOnePackageWins();
+    void cycleDoesNotStall();
+    void waitsForDependenciesAndRespectsCap();
+    void failedDependencySkipsDependents();
+    void doneOnlyOnceEveryGateIsAnswered();
+    void unreadableFilesLeaveNothingToPlan();
+};
+
+void LocalInstallBatchTest::ordersDependenciesFirst()
+{
+    LocalInstallBatch b;
+    load(b, {entry("app", {"lib"}), entry("tool"), entry("lib", {"core", "external"}),
+             entry("core")});
+    QCOMPARE(b.order(), (QStringList{"tool", "core", "lib", "app"}));
+    QCOMPARE(b.waitsFor("lib"), QStringList{"core"});   // "external" isn't in the batch
+    QVERIFY(b.waitsFor("tool").isEmpty());
+
+    // What each entry's gate dialog lists: itself plus what it waits
+    // for, transitively, deps first.
+    QCOMPARE(b.waitsForClosure("app"), (QStringList{"core", "lib", "app"}));
+    QCOMPARE(b.waitsForClosure("lib"), (QStringList{"core", "lib"}));
+    QCOMPARE(b.waitsForClosure("tool"), QStringList{"tool"});
+}
+
+void LocalInstallBatchTest::newerFileForOnePackageWins()
+{
+    LocalInstallBatch b;
+    const auto older = entry("lib", {}, "1.2.0");
+    const auto newer = entry("lib", {}, "1.10.0");
+    b.reset(1, {newer.file, older.file});
+    QVERIFY(!b.inspected(&newer));
+    QVERIFY(b.inspected(&older));   // last reply
+    b.plan();
+    QCOMPARE(b.order(), QStringList{"lib"});
+    QCOMPARE(b.entry("lib")->version, QString("1.10.0"));
+}
+
+void LocalInstallBatchTest::cycleDoesNotStall()
+{
+    LocalInstallBatch b;
+    load(b, {entry("a", {"b"}), entry("b", {"a"})});
+    QCOMPARE(b.order(), (QStringList{"a", "b"}));
+    QVERIFY(b.waitsFor("a").isEmpty());
+    QCOMPARE(b.waitsFor("b"), QStringList{"a"});
+
+    approveAll(b);
+    QCOMPARE(b.takeReady(4), QStringList{"a"});
+    QVERIFY(b.settle("a", true).isEmpty());
+    QCOMPARE(b.takeReady(4), QStringList{"b"});
+}
+
+void LocalInstallBatchTest::waitsForDependenciesAndRespectsCap()
+{
+    LocalInstallBatch b;
+    load(b, {entry("core"), entry("p1", {"core"}), entry("p2", {"core"}), entry("x1"),
+             entry("x2"), entry("x3"), entry("x4")});
+
+    // Nothing runs before its gate is approved.
+    QVERIFY(b.takeReady(4).isEmpty());
+    approveAll(b);
+
+    QCOMPARE(b.takeReady(4), (QStringList{"core", "x1", "x2", "x3"}));
+    QCOMPARE(b.running(), 4);
+    QVERIFY(b.takeReady(4).isEmpty());
+
+    b.settle("x1", true);
+    QCOMPARE(b.takeReady(4), QStringList{"x4"});   // p1/p2 still wait for core
+    b.settle("core", true);
+    b.settle("x2", true);
+    QCOMPARE(b.takeReady(4), (QStringList{"p1", "p2"}));
+}
+
+void LocalInstallBatchTest::failedDependencySkipsDependents()
+{
+    LocalInstallBatch b;
+    load(b, {entry("core"), entry("lib", {"core"}), entry("app", {"lib"}), entry("solo")});
+    approveAll(b);
+    QCOMPARE(b.takeReady(4), (QStringList{"core", "solo"}));
+
+    QCOMPARE(b.settle("core", false), (QStringList{"lib", "app"}));
+    QVERIFY(b.isSettled("lib"));
+    QVERIFY(b.isSettled("app"));
+    QVERIFY(b.takeReady(4).isEmpty());   // neither is installed against a missing core
+    QVERIFY(!b.isSettled("solo"));
+    QCOMPARE(b.running(), 1);
+}
+
+void LocalInstallBatchTest::doneOnlyOnceEveryGateIsAnswered()
+{
+    LocalInstallBatch b;
+    load(b, {entry("core"), entry("app", {"core"})});
+    QVERIFY(b.approve("core"));
+    QCOMPARE(b.takeReady(4), QStringList{"core"});
+    QCOMPARE(b.settle("core", false), QStringList{"app"});
+
+    // app is settled (skipped) but its gate is still with the host.
+    QVERIFY(!b.isDone());
+    QVERIFY(b.active());
+    QVERIFY(!b.approve("app"));   // approved late: must not install
+    QVERIFY(b.isDone());
+}
+
+void LocalInstallBatchTest::unreadableFilesLeaveNothingToPlan()
+{
+    LocalInstallBatch b;
+    b.reset(1, {"/pkgs/a.lgx", "/pkgs/b.lgx"});
+    QVERIFY(b.active());
+    QVERIFY(!b.inspected(nullptr));
+    QVERIFY(b.inspected(nullptr));
+    b.plan();
+    QVERIFY(b.order().isEmpty());
+    QVERIFY(!b.active());
+    QVERIFY(!b.isDone());
+}
+
+QTEST_APPLESS_MAIN(LocalInstallBatchTest)
+
+#include "local_install_batch_test.moc"
@@ -0,0 +1,394 @@
+// Tests for LocalDependencyResolver: range satisfaction through the
+// vendored semver library, resolve() against hand-checked expected
+// outputs, and updateNames() against a full setCatalog() rebuild.
+
+#include <QtTest>
+
+#include <QRandomGenerator>
+
+#include "LocalDependencyResolver.h"
+
+namespace {
+
+// name → "version|repo|topLevel", or "ERROR" when any entry for the name
+// carries an error.
+QMap<QString, QString> summarise(const QVariantList& resolved)
+{
+    QMap<QString, QString> out;
+    for (const QVariant& v : resolved) {
+        const QVariantMap m = v.toMap();
+        const QString name = m.value("name").toString();
+        if (m.contains("error")) { out.insert(name, QStringLiteral("ERROR")); continue; }
+        if (out.value(name) == QLatin1String("ERROR")) continue;
+        out.insert(name, QStringLiteral("%1|%2|%3")
+                             .arg(m.value("version").toString(),
+                                  m.value("repositoryUrl").toString(),
+                                  m.value("topLevel").toBool() ? "top" : "dep"));
+    }
+    return out;
+}
+
+} // namespace
+
+class LocalResolverTest : public QObject {
+    Q_OBJECT
+
+private slots:
+    void satisfies_data();
+    void satisfies();
+    void pinsFollowInstallSpec();
+    void installedSatisfyingDepIsSkipped();
+    void resolvesExpected_data();
+    void resolvesExpected();
+    void updateNamesMatchesSetCatalog();
+
+private:
+    QString randomVersion(QRandomGenerator& rng) const;
+    QString randomRange(QRandomGenerator& rng) const;
+    QVariantList randomCatalog(QRandomGenerator& rng, const QStringList& names) const;
+};
+
+void LocalResolverTest::satisfies_data()
+{
+    QTest::addColumn<QString>("version");
+    QTest::addColumn<QString>("range");
+    QTest::addColumn<bool>("expected");
+
+    QTest::newRow("empty")            << "1.2.3"      << ""                  << true;
+    QTest::newRow("star")             << "1.2.3"      << "*"                 << true;
+    QTest::newRow("exact")            << "1.2.3"      << "1.2.3"             << true;
+    QTest::newRow("exact-eq")         << "1.2.3"      << "=1.2.3"            << true;
+    QTest::newRow("exact-miss")       << "1.2.4"      << "1.2.3"             << false;
+    QTest::newRow("v-prefix")         << "1.2.3"      << "v1.2.3"            << true;
+    QTest::newRow("caret")            << "1.9.0"      << "^1.2.3"            << true;
+    QTest::newRow("caret-major")      << "2.0.0"      << "^1.2.3"            << false;
+    QTest::newRow("caret-zero-minor") << "0.2.9"      << "^0.2.3"            << true;
+    QTest::newRow("caret-zero-bump")  << "0.3.0"      << "^0.2.3"            << false;
+    QTest::newRow("caret-zero-zero")  << "0.0.4"      << "^0.0.3"            << false;
+    QTest::newRow("caret-partial")    << "1.5.0"      << "^1.2"              << true;
+    QTest::newRow("tilde")            << "1.2.9"      << "~1.2.3"            << true;
+    QTest::newRow("tilde-bump")       << "1.3.0"      << "~1.2.3"            << false;
+    QTest::newRow("tilde-major")      << "1.7.0"      << "~1"                << true;
+    QTest::newRow("x-range")          << "1.7.3"      << "1.x"               << true;
+    QTest::newRow("x-range-miss")     << "2.0.0"      << "1.x"               << false;
+    QTest::newRow("minor-x")          << "1.2.7"      << "1.2.*"             << true;
+    QTest::newRow("gte")              << "2.0.0"      << ">=1.2.3"           << true;
+    QTest::newRow("gte-spaced")       << "2.0.0"      << ">= 1.2.3"          << true;
+    QTest::newRow("gt-partial")       << "1.2.9"      << ">1.2"              << false;
+    QTest::newRow("lt")               << "1.2.2"      << "<1.2.3"            << true;
+    QTest::newRow("lte-partial")      << "1.2.9"      << "<=1.2"             << true;
+    QTest::newRow("and")              << "1.5.0"      << ">=1.0.0 <2.0.0"    << true;
+    QTest::newRow("and-miss")         << "2.0.0"      << ">=1.0.0 <2.0.0"    << false;
+    QTest::newRow("or")               << "3.1.0"      << "^1.0.0 || ^3.0.0"  << true;
+    QTest::newRow("hyphen")           << "1.5.0"      << "1.0.0 - 2.0.0"     << true;
+    QTest::newRow("hyphen-partial")   << "2.9.9"      << "1.0 - 2"           << true;
+    QTest::newRow("hyphen-above")     << "3.0.0"      << "1.0 - 2"           << false;
+    QTest::newRow("pre-excluded")     << "1.3.0-rc.1" << "^1.2.0"            << false;
+    QTest::newRow("pre-same-core")    << "1.2.3-rc.2" << ">=1.2.3-rc.1"      << true;
+    QTest::newRow("pre-below-rel")    << "2.0.0-rc.1" << "<2.0.0"            << false;
+    QTest::newRow("garbage")          << "1.2.3"      << "not-a-range"       << false;
+}
+
+void LocalResolverTest::satisfies()
+{
+    QFETCH(QString, version);
+    QFETCH(QString, range);
+    QFETCH(bool, expected);
+    QCOMPARE(LocalDependencyResolver::satisfies(version, range), expected);
+}
+
+static QVariantMap catalogRow(const QString& name, const QString& repo,
+                              const QList<QPair<QString, QVariantList>>& versions)
+{
+    QVariantList vs;
+    for (const auto& v : versions) {
+        vs.append(QVariantMap{
+            {"rootHash", name + "-" + v.first + "@" + repo},
+            {"releasedAt", "2026-01-01T00:00:00Z"},
+            {"manifest", QVariantMap{{"name", name}, {"version", v.first},
+                                     {"dependencies", v.second}}}});
+    }
+    return QVariantMap{{"name", name}, {"repositoryUrl", repo}, {"versions", vs}};
+}
+
+void LocalResolverTest::pinsFollowInstallSpec()
+{
+    LocalDependencyResolver r;
+    r.setCatalog({catalogRow("wallet", "repoA", {{"1.0.0", {}}}),
+                  catalogRow("wallet", "repoB", {{"1.0.1", {}}, {"0.9.0", {}}})});
+
+    PackageInstallSpec any;  any.name = "wallet";
+    QCOMPARE(r.resolve({any}, {}).first().toMap().value("repositoryUrl").toString(),
+             QStringLiteral("repoB"));
+
+    PackageInstallSpec pinned; pinned.name = "wallet"; pinned.repositoryUrl = "repoA";
+    const QVariantMap a = r.resolve({pinned}, {}).first().toMap();
+    QCOMPARE(a.value("repositoryUrl").toString(), QStringLiteral("repoA"));
+    QCOMPARE(a.value("version").toString(), QStringLiteral("1.0.0"));
+
+    PackageInstallSpec exact; exact.name = "wallet"; exact.version = "0.9.0";
+    QCOMPARE(r.resolve({exact}, {}).first().toMap().value("version").toString(),
+             QStringLiteral("0.9.0"));
+
+    PackageInstallSpec wrong; wrong.name = "wallet"; wrong.repositoryUrl = "repoA"; wrong.version = "0.9.0";
+    QVERIFY(LocalDependencyResolver::hasErrors(r.resolve({wrong}, {})));
+}
+
+void LocalResolverTest::installedSatisfyingDepIsSkipped()
+{
+    LocalDependencyResolver r;
+    const QVariantList deps{QVariantMap{{"name", "core"}, {"version", "^1.2.0"}}};
+    r.setCatalog({catalogRow("app", "repo", {{"1.0.0", deps}}),
+                  catalogRow("core", "repo", {{"1.4.0", {}}, {"2.0.0", {}}})});
+    PackageInstallSpec app; app.name = "app";
+
+    const QVariantList skipped = r.resolve({app}, {{"core", "1.3.0"}});
+    QCOMPARE(skipped.size(), 1);
+
+    const QVariantList upgraded = r.resolve({app}, {{"core", "1.1.0"}});
+    QCOMPARE(upgraded.size(), 2);
+    QCOMPARE(upgraded.at(1).toMap().value("version").toString(), QStringLiteral("1.4.0"));
+    QCOMPARE(upgraded.at(1).toMap().value("topLevel").toBool(), false);
+}
+
+QString LocalResolverTest::randomVersion(QRandomGenerator& rng) const
+{
+    QString v = QStringLiteral("%1.%2.%3")
+                    .arg(rng.bounded(3)).arg(rng.bounded(4)).arg(rng.bounded(4));
+    if (rng.bounded(8) == 0) v += QStringLiteral("-rc.1");
+    return v;
+}
+
+QString LocalResolverTest::randomRange(QRandomGenerator& rng) const
+{
+    auto release = [&] {
+        return QStringLiteral("%1.%2.%3")
+            .arg(rng.bounded(3)).arg(rng.bounded(4)).arg(rng.bounded(4));
+    };
+    auto one = [&]() -> QString {
+        switch (rng.bounded(9)) {
+        case 0: return QString();
+        case 1: return QStringLiteral("^") + release();
+        case 2: return QStringLiteral("~") + release();
+        case 3: return QStringLiteral(">=") + release();
+        case 4: return QStringLiteral("<") + release();
+        case 5: return QStringLiteral(">=%1 <%2").arg(release(), release());
+        case 6: return QStringLiteral("%1.x").arg(rng.bounded(3));
+        case 7: return QStringLiteral("=") + randomVersion(rng);
+        default: return release();
+        }
+    };
+    QString r = one();
+    if (!r.isEmpty() && rng.bounded(5) == 0) r += QStringLiteral(" || ") + one();
+    return r;
+}
+
+QVariantList LocalResolverTest::randomCatalog(QRandomGenerator& rng, const QStringList& names) const
+{
+    static const QStringList kRepos{QStringLiteral("repoA"), QStringLiteral("repoB")};
+    QVariantList catalog;
+    for (int n = 0; n < names.size(); ++n) {
+        for (const QString& repo : kRepos) {
+            if (rng.bounded(3) == 0) continue;
+            QVariantList versions;
+            const int count = 1 + rng.bounded(4);
+            for (int i = 0; i < count; ++i) {
+                QVariantList deps;
+                const int depCount = rng.bounded(3);
+                for (int d = 0; d < depCount; ++d) {
+                    // Mostly forward edges, occasionally a back edge so
+                    // cycles get exercised too.
+                    const int target = rng.bounded(6) == 0
+                        ? rng.bounded(names.size())
+                        : n + 1 + rng.bounded(std::max(1, int(names.size()) - n - 1));
+                    if (target >= names.size() || target == n) continue;
+                    deps.append(QVariantMap{{"name", names.at(target)},
+                                            {"version", randomRange(rng)}});
+                }
+                const QString version = randomVersion(rng);
+                versions.append(QVariantMap{
+                    {"rootHash", QStringLiteral("%1-%2@%3").arg(names.at(n), version, repo)},
+                    {"releasedAt", QStringLiteral("2026-0%1-01T00:00:00Z").arg(1 + rng.bounded(9))},
+                    {"manifest", QVariantMap{{"name", names.at(n)}, {"version", version},
+                                             {"dependencies", deps}}}});
+            }
+            catalog.append(QVariantMap{{"name", names.at(n)}, {"repositoryUrl", repo},
+                                       {"versions", versions}});
+        }
+    }
+    return catalog;
+}
+
+void LocalResolverTest::resolvesExpected_data()
+{
+    QTest::addColumn<QVariantList>("catalog");
+    QTest::addColumn<QStringList>("specs");         // "name", "name@version" or "name@version@repo"
+    QTest::addColumn<QVariantMap>("installed");
+    QTest::addColumn<QStringList>("expected");      // "name=version|repo|top|dep" or "name=ERROR"
+
+    auto dep = [](const QString& name, const QString& range) {
+        return QVariant(QVariantMap{{"name", name}, {"version", range}});
+    };
+
+    QTest::newRow("newest-across-repos")
+        << QVariantList{catalogRow("core", "repoA", {{"1.0.0", {}}}),
+                        catalogRow("core", "repoB", {{"1.2.0", {}}})}
+        << QStringList{"core"} << QVariantMap{}
+        << QStringList{"core=1.2.0|repoB|top"};
+
+    QTest::newRow("equal-versions-keep-catalog-order")
+        << QVariantList{catalogRow("core", "repoA", {{"1.0.0", {}}}),
+                        catalogRow("core", "repoB", {{"1.0.0", {}}})}
+        << QStringList{"core"} << QVariantMap{}
+        << QStringList{"core=1.0.0|repoA|top"};
+
+    QTest::newRow("exact-pin-in-repo")
+        << QVariantList{catalogRow("core", "repoA", {{"1.0.0", {}}, {"0.9.0", {}}}),
+                        catalogRow("core", "repoB", {{"1.2.0", {}}})}
+        << QStringList{"core@0.9.0@repoA"} << QVariantMap{}
+        << QStringList{"core=0.9.0|repoA|top"};
+
+    QTest::newRow("missing-top-level")
+        << QVariantList{catalogRow("core", "repoA", {{"1.0.0", {}}})}
+        << QStringList{"ghost"} << QVariantMap{}
+        << QStringList{"ghost=ERROR"};
+
+    QTest::newRow("caret-picks-newest-in-major")
+        << QVariantList{catalogRow("app", "repo", {{"1.0.0", {dep("core", "^1.0.0")}}}),
+                        catalogRow("core", "repo", {{"1.4.0", {}}, {"2.0.0", {}}})}
+        << QStringList{"app"} << QVariantMap{}
+        << QStringList{"app=1.0.0|repo|top", "core=1.4.0|repo|dep"};
+
+    QTest::newRow("caret-zero-minor")
+        << QVariantList{catalogRow("app", "repo", {{"1.0.0", {dep("core", "^0.2.0")}}}),
+                        catalogRow("core", "repo", {{"0.2.5", {}}, {"0.3.0", {}}})}
+        << QStringList{"app"} << QVariantMap{}
+        << QStringList{"app=1.0.0|repo|top", "core=0.2.5|repo|dep"};
+
+    QTest::newRow("prerelease-not-picked")
+        << QVariantList{catalogRow("app", "repo", {{"1.0.0", {dep("core", "^1.0.0")}}}),
+                        catalogRow("core", "repo", {{"1.1.0-rc.1", {}}, {"1.0.0", {}}})}
+        << QStringList{"app"} << QVariantMap{}
+        << QStringList{"app=1.0.0|repo|top", "core=1.0.0|repo|dep"};
+
+    QTest::newRow("hyphen-range")
+        << QVariantList{catalogRow("app", "repo", {{"1.0.0", {dep("core", "1.0.0 - 1.5.0")}}}),
+                        catalogRow("core", "repo", {{"1.5.0", {}}, {"1.6.0", {}}})}
+        << QStringList{"app"} << QVariantMap{}
+        << QStringList{"app=1.0.0|repo|top", "core=1.5.0|repo|dep"};
+
+    QTest::newRow("installed-satisfies")
+        << QVariantList{catalogRow("app", "repo", {{"1.0.0", {dep("core", ">=1.0.0")}}}),
+                        catalogRow("core", "repo", {{"1.4.0", {}}})}
+        << QStringList{"app"} << QVariantMap{{"core", "1.1.0"}}
+        << QStringList{"app=1.0.0|repo|top"};
+
+    QTest::newRow("installed-too-old")
+        << QVariantList{catalogRow("app", "repo", {{"1.0.0", {dep("core", ">=1.2.0")}}}),
+                        catalogRow("core", "repo", {{"1.4.0", {}}})}
+        << QStringList{"app"} << QVariantMap{{"core", "1.1.0"}}
+        << QStringList{"app=1.0.0|repo|top", "core=1.4.0|repo|dep"};
+
+    QTest::newRow("unsatisfiable")
+        << QVariantList{catalogRow("app", "repo", {{"1.0.0", {dep("core", ">=3.0.0")}}}),
+                        catalogRow("core", "repo", {{"2.0.0", {}}})}
+        << QStringList{"app"} << QVariantMap{}
+        << QStringList{"app=1.0.0|repo|top", "core=ERROR"};
+
+    // app picks lib 1.5.0 first; core's narrower range then clashes.
+    QTest::newRow("greedy-conflict")
+        << QVariantList{catalogRow("app", "repo", {{"1.0.0", {dep("lib", "^1.0.0"), dep("core", "^1.0.0")}}}),
+                        catalogRow("core", "repo", {{"1.0.0", {dep("lib", "<1.1.0")}}}),
+                        catalogRow("lib", "repo", {{"1.0.0", {}}, {"1.5.0", {}}})}
+        << QStringList{"app"} << QVariantMap{}
+        << QStringList{"app=1.0.0|repo|top", "core=1.0.0|repo|dep", "lib=ERROR"};
+
+    QTest::newRow("cycle")
+        << QVariantList{catalogRow("a", "repo", {{"1.0.0", {dep("b", "^1.0.0")}}}),
+                        catalogRow("b", "repo", {{"1.0.0", {dep("a", "^1.0.0")}}})}
+        << QStringList{"a"} << QVariantMap{}
+        << QStringList{"a=1.0.0|repo|top", "b=1.0.0|repo|dep"};
+
+    QTest::newRow("bare-name-dep")
+        << QVariantList{catalogRow("app", "repo", {{"1.0.0", {QVariant(QStringLiteral("core"))}}}),
+                        catalogRow("core", "repo", {{"1.0.0", {}}, {"2.0.0-rc.1", {}}})}
+        << QStringList{"app"} << QVariantMap{}
+        << QStringList{"app=1.0.0|repo|top", "core=1.0.0|repo|dep"};
+}
+
+void LocalResolverTest::resolvesExpected()
+{
+    QFETCH(QVariantList, catalog);
+    QFETCH(QStringList, specs);
+    QFETCH(QVariantMap, installed);
+    QFETCH(QStringList, expected);
+
+    QList<PackageInstallSpec> specList;
+    for (const QString& text : specs) {
+        const QStringList parts = text.split(QLatin1Char('@'));
+        PackageInstallSpec s;
+        s.name          = parts.value(0);
+        s.version       = parts.value(1);
+        s.repositoryUrl = parts.value(2);
+        specList.append(s);
+    }
+    QHash<QString, QString> installedByName;
+    for (auto it = installed.constBegin(); it != installed.constEnd(); ++it)
+        installedByName.insert(it.key(), it.value().toString());
+
+    LocalDependencyResolver r;
+    r.setCatalog(catalog);
+    QStringList got;
+    const auto summary = summarise(r.resolve(specList, installedByName));
+    for (auto it = summary.constBegin(); it != summary.constEnd(); ++it)
+        got.append(it.key() + QLatin1Char('=') + it.value());
+    QCOMPARE(got, expected);
+}
+
+void LocalResolverTest::updateNamesMatchesSetCatalog()
+{
+    const QStringList names{"p0", "p1", "p2", "p3", "p4", "p5", "p6"};
+    QRandomGenerator rng(20261019u);
+
+    // Index as text: candidate fields in list order, per name. `order`
+    // itself is left out; only the list order it decides has to match.
+    auto dump = [](const LocalDependencyResolver& r) {
+        QMap<QString, QStringList> out;
+        for (auto it = r.index().constBegin(); it != r.index().constEnd(); ++it) {
+            QStringList& lines = out[it.key()];
+            for (const LocalDependencyResolver::Candidate& c : it.value()) {
+                QString line = QStringLiteral("%1|%2|%3|%4|%5")
+                    .arg(c.moduleName, c.version, c.repositoryUrl, c.rootHash, c.releasedAt);
+                for (const LocalDependencyResolver::Dep& d : c.deps)
+                    line += QStringLiteral("|%1 %2").arg(d.name, d.range);
+                lines.append(line);
+            }
+        }
+        return out;
+    };
+
+    for (int round = 0; round < 200; ++round) {
+        const QVariantList before = randomCatalog(rng, names);
+        const QVariantList replacement = randomCatalog(rng, names);
+        QSet<QString> touched;
+        for (const QString& n : names)
+            if (rng.bounded(3) == 0) touched.insert(n);
+
+        QVariantList after;
+        for (const QVariant& v : before)
+            if (!touched.contains(v.toMap().value("name").toString())) after.append(v);
+        for (const QVariant& v : replacement)
+            if (touched.contains(v.toMap().value("name").toString())) after.append(v);
+
+        LocalDependencyResolver patched;
+        patched.setCatalog(before);
+        patched.updateNames(after, touched);
+        LocalDependencyResolver full;
+        full.setCatalog(after);
+        QCOMPARE(dump(patched), dump(full));
+    }
+}
+
+QTEST_APPLESS_MAIN(LocalResolverTest)
+
+#include "local_resolver_test.moc"
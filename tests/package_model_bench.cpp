@@ -0,0 +1,301 @@
+// Benchmarks for the catalog → table path: row building, the model
+// reset, the filter / sort proxy, paging, and the bulk action plan, on a
+// synthetic catalog at 1k / 10k / 100k rows and 1 / 4 / 16 versions per
+// row. internCatalog logs the resident memory a catalog takes off the
+// wire and interned into a CatalogInterner (Linux only), and times the
+// interning.
+//
+// Results are QtTest benchmark output, so any of its formats work:
+//   package_model_bench -o results.xml,xml      (tracked by `bench_report`)
+//   package_model_bench -o results.csv,csv
+// PMU_BENCH_MAX_ROWS caps the catalog sizes (ctest runs it at 1000 as a
+// smoke test).
+
+#include <QtTest>
+
+#include <QDataStream>
+#include <QHash>
+
+#include "CatalogInterner.h"
+#include "PackageListModel.h"
+#include "PackageRowBuilder.h"
+#include "PerfStats.h"
+#include "SyntheticCatalog.h"
+#include "PackagesFilterProxy.h"
+#include "PackagesPagingProxy.h"
+
+namespace {
+
+const QStringList kValidVariants{QStringLiteral("linux-x86_64"), QStringLiteral("linux-amd64")};
+
+QHash<QString, QVariantMap> installedByName(const QVariantList& installed)
+{
+    QHash<QString, QVariantMap> out;
+    for (const QVariant& v : installed) {
+        const QVariantMap m = v.toMap();
+        out.insert(m.value(QStringLiteral("name")).toString(), m);
+    }
+    return out;
+}
+
+} // namespace
+
+class PackageModelBench : public QObject {
+    Q_OBJECT
+
+private slots:
+    void buildPackageRow_data()            { addSizes(); }
+    void buildPackageRow();
+    void buildPackageRows_data()           { addSizes(); }
+    void buildPackageRows();
+    void modelSetPackages_data()           { addSizes(); }
+    void modelSetPackages();
+    void filterSearch_data()               { addSizes(); }
+    void filterSearch();
+    void filterInstallState_data()         { addSizes(); }
+    void filterInstallState();
+    void sortByName_data()                 { addSizes(); }
+    void sortByName();
+    void paging_data()                     { addSizes(); }
+    void paging();
+    void buildActionPlanForSelected_data() { addSizes(); }
+    void buildActionPlanForSelected();
+    void internCatalog_data()              { addSizes(); }
+    void internCatalog();
+
+private:
+    void addSizes();
+    const syntheticcatalog::Catalog& catalog(int rows, int versions);
+    const QList<QVariantMap>& modelRows(int rows, int versions);
+
+    QHash<quint64, syntheticcatalog::Catalog> m_catalogs;
+    QHash<quint64, QList<QVariantMap>>        m_rows;
+};
+
+void PackageModelBench::addSizes()
+{
+    QTest::addColumn<int>("rows");
+    QTest::addColumn<int>("versions");
+
+    bool ok = false;
+    const int cap = qEnvironmentVariableIntValue("PMU_BENCH_MAX_ROWS", &ok);
+    const int maxRows = ok && cap > 0 ? cap : 100000;
+    // 100k × 16 versions is a multi-GB catalog; the 4-version run
+    // already shows the per-version cost at that size.
+    const QList<QPair<int, int>> sizes{{1000, 1},  {1000, 4},  {1000, 16},
+                                       {10000, 1}, {10000, 4}, {10000, 16},
+                                       {100000, 1}, {100000, 4}};
+    for (const auto& [rows, versions] : sizes) {
+        if (rows > maxRows) continue;
+        QTest::addRow("%dx%d", rows, versions) << rows << versions;
+    }
+}
+
+const syntheticcatalog::Catalog& PackageModelBench::catalog(int rows, int versions)
+{
+    const quint64 key = (quint64(rows) << 32) | quint32(versions);
+    auto it = m_catalogs.find(key);
+    if (it == m_catalogs.end()) it = m_catalogs.insert(key, syntheticcatalog::make(rows, versions));
+    return it.value();
+}
+
+const QList<QVariantMap>& PackageModelBench::modelRows(int rows, int versions)
+{
+    const quint64 key = (quint64(rows) << 32) | quint32(versions);
+    auto it = m_rows.find(key);
+    if (it == m_rows.end()) {
+        const syntheticcatalog::Catalog& c = catalog(rows, versions);
+        it = m_rows.insert(key, packagerows::buildPackageRows(c.rows, c.installed, kValidVariants));
+    }
+    return it.value();
+}
+
+void PackageModelBench::buildPackageRow()
+{
+    QFETCH(int, rows);
+    QFETCH(int, versions);
+    const syntheticcatalog::Catalog& c = catalog(rows, versions);
+    const QHash<QString, QVariantMap> installed = installedByName(c.installed);
+    const packagerows::VariantMask variants(kValidVariants);
+
+    int built = 0;
+    QBENCHMARK {
+        for (const QVariant& row : c.rows)
+            built += packagerows::buildPackageRow(row.toMap(), installed, variants).size() > 0;
+    }
+    QVERIFY(built > 0);
+}
+
+void PackageModelBench::buildPackageRows()
+{
+    QFETCH(int, rows);
+    QFETCH(int, versions);
+    const syntheticcatalog::Catalog& c = catalog(rows, versions);
+
+    QList<QVariantMap> out;
+    QBENCHMARK {
+        out = packagerows::buildPackageRows(c.rows, c.installed, kValidVariants);
+    }
+    QCOMPARE(out.size(), rows + rows / 100);
+}
+
+void PackageModelBench::modelSetPackages()
+{
+    QFETCH(int, rows);
+    QFETCH(int, versions);
+    const QList<QVariantMap>& packages = modelRows(rows, versions);
+
+    PackageListModel model;
+    QBENCHMARK {
+        model.setPackages(packages);
+    }
+    QCOMPARE(model.rowCount(), packages.size());
+}
+
+void PackageModelBench::filterSearch()
+{
+    QFETCH(int, rows);
+    QFETCH(int, versions);
+    PackageListModel model;
+    model.setPackages(modelRows(rows, versions));
+    PackagesFilterProxy proxy;
+    proxy.setSourceModel(&model);
+
+    // Alternate between two queries so every iteration refilters.
+    int i = 0;
+    QBENCHMARK {
+        proxy.setSearchText((i++ & 1) ? QStringLiteral("pkg_0001") : QStringLiteral("storage"));
+    }
+    QVERIFY(proxy.rowCount() > 0);
+}
+
+void PackageModelBench::filterInstallState()
+{
+    QFETCH(int, rows);
+    QFETCH(int, versions);
+    PackageListModel model;
+    model.setPackages(modelRows(rows, versions));
+    PackagesFilterProxy proxy;
+    proxy.setSourceModel(&model);
+
+    int i = 0;
+    QBENCHMARK {
+        proxy.setInstallStateFilter((i++ & 1) ? 1 : 2);
+    }
+    QVERIFY(proxy.rowCount() > 0);
+}
+
+void PackageModelBench::sortByName()
+{
+    QFETCH(int, rows);
+    QFETCH(int, versions);
+    PackageListModel model;
+    model.setPackages(modelRows(rows, versions));
+    PackagesFilterProxy proxy;
+    proxy.setSourceModel(&model);
+    proxy.setSortRoleByName(QStringLiteral("name"));
+
+    int i = 0;
+    QBENCHMARK {
+        proxy.setSortOrderInt((i++ & 1) ? Qt::AscendingOrder : Qt::DescendingOrder);
+    }
+    QCOMPARE(proxy.rowCount(), model.rowCount());
+}
+
+void PackageModelBench::paging()
+{
+    QFETCH(int, rows);
+    QFETCH(int, versions);
+    PackageListModel model;
+    model.setPackages(modelRows(rows, versions));
+    PackagesFilterProxy filter;
+    filter.setSourceModel(&model);
+    filter.setSortRoleByName(QStringLiteral("name"));
+    PackagesPagingProxy pages;
+    pages.setSourceModel(&filter);
+
+    // Flip through the first 50 pages reading every visible cell's name,
+    // the way the table delegate does.
+    const int pageCount = qMin(50, (pages.totalCount() + pages.pageSize() - 1) / pages.pageSize());
+    int read = 0;
+    QBENCHMARK {
+        for (int p = 1; p <= pageCount; ++p) {
+            pages.setCurrentPage(p);
+            for (int r = 0; r < pages.rowCount(); ++r)
+                read += !pages.index(r, 0).data(PackageListModel::NameRole).toString().isEmpty();
+        }
+    }
+    QVERIFY(read > 0);
+}
+
+void PackageModelBench::buildActionPlanForSelected()
+{
+    QFETCH(int, rows);
+    QFETCH(int, versions);
+    PackageListModel model;
+    model.setPackages(modelRows(rows, versions));
+    for (int r = 0; r < model.rowCount(); r += 3) model.updatePackageSelection(r, true);
+
+    PackageActionPlan plan;
+    QBENCHMARK {
+        plan = model.buildActionPlanForSelected();
+    }
+    QVERIFY(plan.total() > 0);
+}
+
+void PackageModelBench::internCatalog()
+{
+    QFETCH(int, rows);
+    QFETCH(int, versions);
+    const syntheticcatalog::Catalog& c = catalog(rows, versions);
+
+    // Through QDataStream, so every string is its own allocation, as it
+    // is off the wire (the synthetic catalog's strings share literals).
+    QByteArray bytes;
+    {
+        QDataStream out(&bytes, QIODevice::WriteOnly);
+        out << c.rows;
+    }
+
+    const qint64 wireBefore = PerfStats::residentBytes();
+    QVariantList wire;
+    {
+        QDataStream in(bytes);
+        in >> wire;
+    }
+    const qint64 wireAfter = PerfStats::residentBytes();
+
+    // Interned row by row as it's read, so the raw rows never pile up.
+    CatalogInterner pool;
+    QVariantList interned;
+    const qint64 internBefore = PerfStats::residentBytes();
+    {
+        QDataStream in(bytes);
+        quint32 count = 0;
+        in >> count;
+        interned.reserve(count);
+        for (quint32 i = 0; i < count; ++i) {
+            QVariant row;
+            in >> row;
+            interned.append(pool.intern({row}).first());
+        }
+    }
+    const qint64 internAfter = PerfStats::residentBytes();
+    if (wireBefore >= 0) {
+        qInfo("%dx%d: resident +%lld KiB off the wire, +%lld KiB interned "
+              "(%d strings, %d shared containers)",
+              rows, versions, qlonglong((wireAfter - wireBefore) / 1024),
+              qlonglong((internAfter - internBefore) / 1024),
+              pool.stringCount(), pool.containerCount());
+    }
+    QCOMPARE(interned, wire);
+
+    QBENCHMARK {
+        CatalogInterner fresh;
+        interned = fresh.intern(wire);
+    }
+}
+
+QTEST_GUILESS_MAIN(PackageModelBench)
+
+#include "package_model_bench.moc"
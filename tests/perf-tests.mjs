@@ -0,0 +1,354 @@
+#!/usr/bin/env node
+// Performance scenarios: time to first row, category switch, search
+// keystroke, page flip and 100-row page latency against the stand-in
+// modules' synthetic catalog. Kept out of ui-tests.mjs so that suite
+// runs on the real modules; this one needs a plugin built with
+// -DPMU_WITH_STANDIN_MODULES=ON.
+//
+// Usage:
+//   node tests/perf-tests.mjs --ci <binary>   # launch on the stand-ins, measure, kill
+//   node tests/perf-tests.mjs                 # against an app already started with
+//                                             # the PMU_STANDIN_* values below
+//
+// Each scenario takes a few samples and logs their median; timings are
+// taken from this process, so they include one inspector round trip per
+// poll. A median over its baseline in perf-baselines.json by more than
+// the file's tolerance fails the run (non-zero exit).
+// PMU_PERF_WRITE_BASELINES=1 writes the medians there instead of
+// checking them.
+
+import { readFileSync, writeFileSync } from "node:fs";
+import { hostname } from "node:os";
+import { resolve } from "node:path";
+
+import { waitForPmuiLoaded, storeProperty, resetStoreFilters } from "./ui-helpers.mjs";
+
+const root = process.env.LOGOS_QT_MCP || new URL("../result-mcp", import.meta.url).pathname;
+const { test, run } = await import(resolve(root, "test-framework/framework.mjs"));
+
+const baselinesPath = new URL("./perf-baselines.json", import.meta.url).pathname;
+const perfBaselines = JSON.parse(readFileSync(baselinesPath, "utf8"));
+
+// The launched app inherits this process's environment.
+if (process.argv.includes("--ci")) {
+  process.env.PMU_STANDIN_MODULES = "1";
+  process.env.PMU_STANDIN_ROWS = String(perfBaselines.rows);
+  process.env.PMU_STANDIN_VERSIONS = "3";
+  process.env.PMU_STANDIN_LATENCY_MS = "5";
+  process.env.PMU_PERF_STATS = "1";
+}
+
+const perfMeasured = {};
+
+async function storeEval(app, expression, what) {
+  const store = await app.findByProperty("objectName", "pmui.BackendStore");
+  if (!store.matches || store.matches.length === 0) throw new Error("BackendStore not found");
+  const res = await app.inspector.send("evaluate", {
+    objectId: store.matches[0].id,
+    expression,
+  });
+  if (res.error) throw new Error(`${what}: ${res.error}`);
+  return res.result;
+}
+
+// Poll `probe` until it returns true; resolves to the elapsed ms since
+// `startedAt`. Tight interval — this is the measurement.
+async function settle(probe, startedAt, description, timeout = 20000) {
+  for (;;) {
+    if (await probe()) return performance.now() - startedAt;
+    if (performance.now() - startedAt > timeout) {
+      throw new Error(`timed out after ${timeout}ms waiting for ${description}`);
+    }
+    await new Promise((r) => setTimeout(r, 5));
+  }
+}
+
+function median(samples) {
+  const s = [...samples].sort((a, b) => a - b);
+  const mid = Math.floor(s.length / 2);
+  return s.length % 2 ? s[mid] : (s[mid - 1] + s[mid]) / 2;
+}
+
+// Logs the median next to the recorded baseline, if there is one. A
+// median past baseline × (1 + tolerance) is a regression; the last test
+// fails the run on any. Metrics without a recorded baseline only report.
+const perfRegressions = [];
+function report(metric, samples, unit = "ms") {
+  const measured = median(samples);
+  perfMeasured[metric] = measured;
+  const baseline = perfBaselines.metrics[metric];
+  let vs = "no baseline recorded";
+  if (typeof baseline === "number") {
+    // The +1 lets a count baselined at 0 move by one without failing.
+    const allowed = Math.max(baseline * (1 + perfBaselines.tolerance), baseline + 1);
+    vs = `baseline ${baseline}${unit}, allowed ${allowed.toFixed(0)}${unit}`;
+    if (measured > allowed) {
+      perfRegressions.push(`${metric}: median ${measured.toFixed(1)}${unit} > ${allowed.toFixed(1)}${unit}`);
+      vs += " — REGRESSION";
+    }
+  }
+  console.log(`    ${metric}: median ${measured.toFixed(1)}${unit} ` +
+              `(samples ${samples.map((v) => v.toFixed(0)).join(", ")}; ${vs})`);
+}
+
+async function waitForFullCatalog(app) {
+  await waitForPmuiLoaded(app);
+  await resetStoreFilters(app);
+  await app.waitFor(
+    async () => {
+      if (await storeProperty(app, "isLoading")) throw new Error("still loading");
+      const total = await storeProperty(app, "totalCount");
+      if (total !== perfBaselines.rows) throw new Error(`totalCount=${total}`);
+    },
+    { timeout: 60000, interval: 250, description: "synthetic catalog to load in full" }
+  );
+}
+
+async function firstRowName(app, role = "name") {
+  return storeEval(app, `(function() {
+      var m = packagesModel;
+      if (!m || m.rowCount() === 0) return "";
+      var rn = m.roleNames();
+      for (var k in rn) {
+        if (String(rn[k]) === ${JSON.stringify(role)})
+          return String(m.data(m.index(0, 0), parseInt(k)) || "");
+      }
+      return "";
+    })()`, `first row ${role}`);
+}
+
+// Stand-in package names are pkg_%06d over [0, rows): how many contain
+// `query` (a "pkg_…" prefix; descriptions never do).
+function expectedNameMatches(query) {
+  let n = 0;
+  for (let i = 0; i < perfBaselines.rows; ++i) {
+    if (`pkg_${String(i).padStart(6, "0")}`.includes(query)) ++n;
+  }
+  return n;
+}
+
+test("perf: time to first row", async (app) => {
+  await waitForFullCatalog(app);
+  // Measured in the backend, construction → first non-empty table; the
+  // app started before this process could see it.
+  let firstRows = null;
+  await app.waitFor(
+    async () => {
+      const json = await storeEval(app,
+        `JSON.stringify(backend && backend.perfStats ? backend.perfStats["startup.firstRows"] || null : null)`,
+        "perfStats");
+      firstRows = JSON.parse(json);
+      if (!firstRows) throw new Error("startup.firstRows not published (PMU_PERF_STATS unset?)");
+    },
+    { timeout: 5000, interval: 250, description: "perfStats to publish startup.firstRows" }
+  );
+  report("timeToFirstRowMs", [firstRows.lastMs]);
+});
+
+test("perf: category switch settles", async (app) => {
+  await waitForFullCatalog(app);
+  const categories = await storeProperty(app, "categories");
+  if (!Array.isArray(categories) || categories.length < 2) {
+    throw new Error(`expected synthetic categories, got ${JSON.stringify(categories)}`);
+  }
+
+  const samples = [];
+  for (let i = 1; i < Math.min(categories.length, 6); ++i) {
+    const before = await storeProperty(app, "totalCount");
+    const t0 = performance.now();
+    await storeEval(app, `selectCategory(${i})`, "selectCategory");
+    samples.push(await settle(async () => {
+      const total = await storeProperty(app, "totalCount");
+      return total !== before && total > 0;
+    }, t0, `category ${categories[i]} to apply`));
+    await storeEval(app, "selectCategory(0)", "selectCategory(0)");
+    await settle(async () => (await storeProperty(app, "totalCount")) === perfBaselines.rows,
+                 performance.now(), "category reset");
+  }
+  report("categorySwitchMs", samples);
+});
+
+test("perf: search keystroke latency", async (app) => {
+  await waitForFullCatalog(app);
+
+  // One keystroke at a time; each narrows the result to a known count.
+  const samples = [];
+  for (const query of ["pkg_01", "pkg_012", "pkg_0123", "pkg_01234"]) {
+    const expected = expectedNameMatches(query);
+    const t0 = performance.now();
+    await storeEval(app, `setSearchText(${JSON.stringify(query)})`, "setSearchText");
+    samples.push(await settle(async () => (await storeProperty(app, "totalCount")) === expected,
+                              t0, `search "${query}" → ${expected} rows`));
+  }
+  await storeEval(app, `setSearchText("")`, "clear search");
+  report("searchKeystrokeMs", samples);
+});
+
+test("perf: page flip latency", async (app) => {
+  await waitForFullCatalog(app);
+
+  const samples = [];
+  for (const page of [2, 3, 50, 400, 1]) {
+    const before = await firstRowName(app);
+    const t0 = performance.now();
+    await storeEval(app, `setCurrentPage(${page})`, "setCurrentPage");
+    samples.push(await settle(async () => {
+      if ((await storeProperty(app, "currentPage")) !== page) return false;
+      const name = await firstRowName(app);
+      return name !== "" && name !== before;
+    }, t0, `page ${page} to render`));
+  }
+  report("pageFlipMs", samples);
+});
+
+async function listEval(app, expression, what) {
+  const list = await app.findByProperty("objectName", "pmui.packageList");
+  if (!list.matches || list.matches.length === 0) throw new Error("pmui.packageList not found");
+  const res = await app.inspector.send("evaluate", { objectId: list.matches[0].id, expression });
+  if (res.error) throw new Error(`${what}: ${res.error}`);
+  return res.result;
+}
+
+// 100-row pages, per flip:
+//   pageFlip100RowsMs           until delegate 0 of a 100-row view shows
+//                               the new page's first row (not merely
+//                               that some 100 delegates exist — the old
+//                               page satisfies that);
+//   pageFlip100FirstFrameMs     until the first frame swapped after the
+//                               view reached that state;
+//   pageFlip100FrameMs          that frame's beforeSynchronizing →
+//                               frameSwapped (sync + render);
+//   pageFlip100DelegatesCreated delegates the view had never handed out
+//                               before — what reuseItems should keep near 0.
+// The probe lives in the app: on beforeSynchronizing (after the frame's
+// polish, so the view has laid out) it snapshots the texts delegate 0
+// shows; on frameSwapped it stamps the swap. A threaded render loop
+// emits both on the render thread and the probe sees them queued, late,
+// so there the frame figures lean high. Both clocks are this machine's
+// wall clock.
+test("perf: 100-row page — delegate build and first frame", async (app) => {
+  await waitForFullCatalog(app);
+
+  const findProbe = `(function() {
+      for (var i = 0; i < root.children.length; ++i)
+        if (root.children[i].objectName === "pmui.frameProbe") return root.children[i];
+      return null;
+    })()`;
+  const probe = await listEval(app, `(function() {
+      if (!Window.window || !view) return "no window";
+      if (${findProbe}) return "ok";
+      var p = Qt.createQmlObject(
+          'import QtQuick; Item {' +
+          '  objectName: "pmui.frameProbe"; visible: false;' +
+          '  property var view: null; property bool armed: false;' +
+          '  property var snapshots: []; property var swaps: []; property var seen: [];' +
+          '  function texts(item, out, depth) {' +
+          '    if (!item || depth > 10) return out;' +
+          '    if (typeof item.text === "string" && item.text !== "") out.push(item.text);' +
+          '    for (var i = 0; i < item.children.length; ++i) texts(item.children[i], out, depth + 1);' +
+          '    return out;' +
+          '  }' +
+          '  function snapshot() {' +
+          '    if (!armed || snapshots.length > 240) return;' +
+          '    snapshots.push({ t: Date.now(), count: view.count,' +
+          '                     texts: texts(view.itemAtIndex(0), [], 0) });' +
+          '  }' +
+          '  function swapped() { if (armed && swaps.length < 240) swaps.push(Date.now()) }' +
+          '  function created() {' +
+          '    var n = 0;' +
+          '    for (var i = 0; i < view.count; ++i) {' +
+          '      var it = view.itemAtIndex(i);' +
+          '      if (it && seen.indexOf(it) < 0) { seen.push(it); ++n }' +
+          '    }' +
+          '    return n;' +
+          '  }' +
+          '}', root, "pmuiFrameProbe");
+      p.view = view;
+      Window.window.beforeSynchronizing.connect(p.snapshot);
+      Window.window.frameSwapped.connect(p.swapped);
+      return "ok";
+    })()`, "frame probe");
+  if (probe !== "ok") throw new Error(`cannot hook the window's frame signals: ${probe}`);
+
+  const previousPageSize = await storeProperty(app, "pageSize");
+  await storeEval(app, "setPageSize(100)", "setPageSize(100)");
+  await settle(async () => Number(await listEval(app, "view ? view.count : -1", "view.count")) === 100,
+               performance.now(), "100-row page");
+  // Everything the first 100-row page built counts as already seen.
+  await listEval(app, `${findProbe}.created()`, "seed seen delegates");
+
+  const build = [];
+  const firstFrame = [];
+  const frameTime = [];
+  const created = [];
+  try {
+    for (const page of [2, 3, 40, 120, 1]) {
+      const before = await firstRowName(app, "displayName");
+      await listEval(app,
+        `(function(p) { p.snapshots = []; p.swaps = []; p.armed = true; return true })(${findProbe})`,
+        "arm probe");
+      const wallT0 = Date.now();
+      const t0 = performance.now();
+      await storeEval(app, `setCurrentPage(${page})`, "setCurrentPage");
+
+      // The model first: which label marks the new page's row 0.
+      let target = "";
+      await settle(async () => {
+        if ((await storeProperty(app, "currentPage")) !== page) return false;
+        target = await firstRowName(app, "displayName");
+        return target !== "" && target !== before;
+      }, t0, `page ${page} rows`);
+      // Then the view: delegate 0 showing that label, 100 delegates.
+      build.push(await settle(async () => (await listEval(app, `(function(p) {
+          var d = p.view.itemAtIndex(0);
+          return p.view.count === 100 && !!d && p.texts(d, [], 0).indexOf(${JSON.stringify(target)}) >= 0;
+        })(${findProbe})`, "delegates")) === true, t0, `page ${page} delegates`));
+
+      // The frame showing it follows layout; give it a moment.
+      await new Promise((r) => setTimeout(r, 150));
+      const res = JSON.parse(await listEval(app, `(function(p) {
+          p.armed = false;
+          return JSON.stringify({ snapshots: p.snapshots, swaps: p.swaps, created: p.created() });
+        })(${findProbe})`, "read probe"));
+      created.push(res.created);
+      const ready = res.snapshots.find((s) => s.count === 100 && s.texts.includes(target));
+      const swap = ready ? res.swaps.find((t) => t >= ready.t) : undefined;
+      if (swap !== undefined) {
+        firstFrame.push(swap - wallT0);
+        frameTime.push(swap - ready.t);
+      }
+    }
+  } finally {
+    await listEval(app, `(function(p) { if (p) p.armed = false; return true })(${findProbe})`,
+                   "disarm probe");
+    await storeEval(app, `setPageSize(${Number(previousPageSize) || 20})`, "restore pageSize");
+  }
+  report("pageFlip100RowsMs", build);
+  report("pageFlip100DelegatesCreated", created, "");
+  // Offscreen platforms may never swap.
+  if (firstFrame.length > 0) {
+    report("pageFlip100FirstFrameMs", firstFrame);
+    report("pageFlip100FrameMs", frameTime);
+  } else {
+    console.log("    no frame swapped showing a new page (offscreen platform?) — frame figures skipped");
+  }
+});
+
+test("perf: record baselines (PMU_PERF_WRITE_BASELINES=1)", async () => {
+  if (process.env.PMU_PERF_WRITE_BASELINES !== "1") return;
+  const metrics = { ...perfBaselines.metrics };
+  for (const [k, v] of Object.entries(perfMeasured)) metrics[k] = Math.ceil(v);
+  const recordedOn = { host: hostname(), date: new Date().toISOString().slice(0, 10) };
+  writeFileSync(baselinesPath,
+                JSON.stringify({ ...perfBaselines, recordedOn, metrics }, null, 2) + "\n");
+  console.log(`    wrote ${baselinesPath}`);
+});
+
+test("perf: no regressions against the baselines", async () => {
+  if (process.env.PMU_PERF_WRITE_BASELINES === "1") return;
+  if (perfRegressions.length > 0) {
+    throw new Error(`${perfRegressions.length} metric(s) regressed:\n  ${perfRegressions.join("\n  ")}`);
+  }
+});
+
+run();
@@ -0,0 +1,109 @@
+// PerfStats: percentiles over the rolling window, inert when disabled,
+// the Chrome trace file, and TimedModuleGateway timing real round trips.
+
+#include <QtTest>
+
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTemporaryDir>
+
+#include "PerfStats.h"
+#include "StandInModuleGateway.h"
+#include "TimedModuleGateway.h"
+
+class PerfStatsTest : public QObject {
+    Q_OBJECT
+
+private slots:
+    void percentilesOverWindow();
+    void disabledRecordsNothing();
+    void writesChromeTrace();
+    void timedGatewayRecordsIpc();
+};
+
+void PerfStatsTest::percentilesOverWindow()
+{
+    PerfStats perf(true);
+    // 1..100 ms; nearest-rank puts p50 at 50, p95 at 95, p99 at 99.
+    for (int i = 1; i <= 100; ++i)
+        perf.record("rows.build", 0, i * 1000);
+    QVERIFY(perf.takeDirty());
+    QVERIFY(!perf.takeDirty());
+
+    const QVariantMap m = perf.toVariant().value("rows.build").toMap();
+    QCOMPARE(m.value("count").toLongLong(), qlonglong(100));
+    QCOMPARE(m.value("p50Ms").toDouble(), 50.0);
+    QCOMPARE(m.value("p95Ms").toDouble(), 95.0);
+    QCOMPARE(m.value("p99Ms").toDouble(), 99.0);
+    QCOMPARE(m.value("maxMs").toDouble(), 100.0);
+    QCOMPARE(m.value("lastMs").toDouble(), 100.0);
+
+    // Older samples roll out of the window; count keeps the lifetime.
+    for (int i = 0; i < PerfStats::kWindow; ++i)
+        perf.record("rows.build", 0, 1000);
+    const QVariantMap rolled = perf.toVariant().value("rows.build").toMap();
+    QCOMPARE(rolled.value("count").toLongLong(), qlonglong(100 + PerfStats::kWindow));
+    QCOMPARE(rolled.value("maxMs").toDouble(), 1.0);
+}
+
+void PerfStatsTest::disabledRecordsNothing()
+{
+    PerfStats perf(false);
+    QVERIFY(!perf.enabled());
+    {
+        const auto t = perf.scope("sort");
+    }
+    QCOMPARE(perf.begin(), qint64(-1));
+    perf.end("ipc.getCatalog", perf.begin());
+    perf.record("rows.build", 0, 10);
+    QVERIFY(!perf.takeDirty());
+    QVERIFY(perf.toVariant().isEmpty());
+}
+
+void PerfStatsTest::writesChromeTrace()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString path = dir.filePath("trace.json");
+    {
+        PerfStats perf(false, path);   // a trace file implies enabled
+        QVERIFY(perf.enabled());
+        {
+            const auto t = perf.scope("model.setPackages");
+        }
+        perf.end("ipc.getCatalog", perf.begin());
+    }   // written on destruction
+
+    QFile f(path);
+    QVERIFY(f.open(QIODevice::ReadOnly));
+    const QJsonArray events =
+        QJsonDocument::fromJson(f.readAll()).object().value("traceEvents").toArray();
+    QCOMPARE(events.size(), 2);
+    const QJsonObject first = events.first().toObject();
+    QCOMPARE(first.value("name").toString(), QString("model.setPackages"));
+    QCOMPARE(first.value("ph").toString(), QString("X"));
+    QVERIFY(first.contains("ts") && first.contains("dur") && first.contains("pid"));
+}
+
+void PerfStatsTest::timedGatewayRecordsIpc()
+{
+    StandInModuleGateway::Config c;
+    c.catalogRows = 20;
+    c.latencyMs   = 5;
+    auto perf = std::make_shared<PerfStats>(true);
+    TimedModuleGateway gw(std::make_unique<StandInModuleGateway>(c), perf);
+
+    int rows = -1;
+    gw.getCatalog([&](QVariantList r) { rows = r.size(); });
+    QTRY_COMPARE(rows, 20);
+
+    const QVariantMap m = perf->toVariant().value("ipc.getCatalog").toMap();
+    QCOMPARE(m.value("count").toLongLong(), qlonglong(1));
+    QVERIFY(m.value("lastMs").toDouble() >= 4.0);   // timer slack
+}
+
+QTEST_GUILESS_MAIN(PerfStatsTest)
+
+#include "perf_stats_test.moc"
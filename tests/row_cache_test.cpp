@@ -0,0 +1,140 @@
+// Incremental refresh: buildPackageRows reuses a repository's rows while
+// its catalog fingerprint holds and rebuilds only the ones that moved,
+// and PackageListModel::setPackages signals just the changed range. An
+// install or removal reuses every repository; the rows of packages that
+// aren't installed stay shared with the cache.
+
+#include <QtTest>
+
+#include "PackageListModel.h"
+#include "PackageRowBuilder.h"
+#include "PackageTypes.h"
+#include "SyntheticCatalog.h"
+
+namespace {
+
+const QStringList kValidVariants{QStringLiteral("linux-x86_64")};
+
+// Edit every catalog row of one repository (its newest manifest's
+// description).
+void touchRepository(QVariantList& rows, const QString& repositoryUrl)
+{
+    for (QVariant& v : rows) {
+        QVariantMap m = v.toMap();
+        if (m.value("repositoryUrl").toString() != repositoryUrl) continue;
+        QVariantList versions = m.value("versions").toList();
+        QVariantMap newest = versions.first().toMap();
+        QVariantMap manifest = newest.value("manifest").toMap();
+        manifest["description"] = manifest.value("description").toString()
+                                + QStringLiteral(" (edited)");
+        newest["manifest"] = manifest;
+        versions[0] = newest;
+        m["versions"] = versions;
+        v = m;
+    }
+}
+
+} // namespace
+
+class RowCacheTest : public QObject {
+    Q_OBJECT
+
+private slots:
+    void unchangedRepositoriesAreReused();
+    void installedChangeReusesRows();
+    void modelSignalsOnlyTheChangedRange();
+};
+
+void RowCacheTest::unchangedRepositoriesAreReused()
+{
+    syntheticcatalog::Catalog c = syntheticcatalog::make(300, 2);
+    packagerows::RepositoryRowCache cache;
+
+    const auto first = packagerows::buildPackageRows(c.rows, c.installed, kValidVariants, {},
+                                                     &cache);
+    QCOMPARE(cache.rebuilt.size(), 3);
+
+    const auto again = packagerows::buildPackageRows(c.rows, c.installed, kValidVariants, {},
+                                                     &cache);
+    QVERIFY(cache.rebuilt.isEmpty());
+    QCOMPARE(again, first);
+
+    const QString url = c.rows.first().toMap().value("repositoryUrl").toString();
+    touchRepository(c.rows, url);
+    const auto edited = packagerows::buildPackageRows(c.rows, c.installed, kValidVariants, {},
+                                                      &cache);
+    QCOMPARE(cache.rebuilt, QStringList{url});
+    QCOMPARE(edited, packagerows::buildPackageRows(c.rows, c.installed, kValidVariants));
+}
+
+void RowCacheTest::installedChangeReusesRows()
+{
+    syntheticcatalog::Catalog c = syntheticcatalog::make(300, 2);
+    packagerows::RepositoryRowCache cache;
+    packagerows::buildPackageRows(c.rows, c.installed, kValidVariants, {}, &cache);
+
+    c.installed.removeFirst();
+    const auto rows = packagerows::buildPackageRows(c.rows, c.installed, kValidVariants, {},
+                                                    &cache);
+    QVERIFY(cache.rebuilt.isEmpty());
+    QCOMPARE(rows, packagerows::buildPackageRows(c.rows, c.installed, kValidVariants));
+
+    // A row that isn't installed (nor first of its group) is the cached
+    // row itself, not a copy.
+    const auto plain = std::find_if(rows.begin(), rows.end(), [](const QVariantMap& r) {
+        return r.value("installStatus").toInt() == int(PackageTypes::NotInstalled)
+            && !r.value("isFirstOfSource", false).toBool()
+            && !r.value("isGroupPlaceholder", false).toBool()
+            && !r.value("repositoryUrl").toString().isEmpty();
+    });
+    QVERIFY(plain != rows.end());
+    bool shared = false;
+    for (const QVariantMap& cached : cache.rows.value(plain->value("repositoryUrl").toString()))
+        shared = shared || cached.isSharedWith(*plain);
+    QVERIFY(shared);
+}
+
+void RowCacheTest::modelSignalsOnlyTheChangedRange()
+{
+    syntheticcatalog::Catalog c = syntheticcatalog::make(300, 2);
+    PackageListModel model;
+    model.setPackages(packagerows::buildPackageRows(c.rows, c.installed, kValidVariants));
+    const int total = model.rowCount();
+
+    QSignalSpy reset(&model, &QAbstractItemModel::modelReset);
+    QSignalSpy inserted(&model, &QAbstractItemModel::rowsInserted);
+    QSignalSpy removed(&model, &QAbstractItemModel::rowsRemoved);
+    QSignalSpy changed(&model, &QAbstractItemModel::dataChanged);
+
+    // Identical rows: nothing to signal.
+    model.setPackages(packagerows::buildPackageRows(c.rows, c.installed, kValidVariants));
+    QCOMPARE(reset.count() + inserted.count() + removed.count() + changed.count(), 0);
+
+    // One repository's fields change in place: a dataChanged over its run.
+    const QString url = c.rows.last().toMap().value("repositoryUrl").toString();
+    touchRepository(c.rows, url);
+    model.setPackages(packagerows::buildPackageRows(c.rows, c.installed, kValidVariants));
+    QCOMPARE(reset.count(), 0);
+    QCOMPARE(inserted.count() + removed.count(), 0);
+    QCOMPARE(changed.count(), 1);
+    const QModelIndex tl = changed.first().at(0).value<QModelIndex>();
+    const QModelIndex br = changed.first().at(1).value<QModelIndex>();
+    QVERIFY(tl.row() > 0 || br.row() < total - 1);
+    for (int r = tl.row(); r <= br.row(); ++r)
+        QCOMPARE(model.packageAt(r).value("repositoryUrl").toString(), url);
+
+    // The repository leaves the catalog: its run goes (and its installed
+    // packages move under local), without a reset.
+    QVariantList kept;
+    for (const QVariant& v : std::as_const(c.rows))
+        if (v.toMap().value("repositoryUrl").toString() != url) kept.append(v);
+    model.setPackages(packagerows::buildPackageRows(kept, c.installed, kValidVariants));
+    QCOMPARE(reset.count(), 0);
+    QCOMPARE(removed.count(), 1);
+    QCOMPARE(model.rowCount(),
+             packagerows::buildPackageRows(kept, c.installed, kValidVariants).size());
+}
+
+QTEST_GUILESS_MAIN(RowCacheTest)
+
+#include "row_cache_test.moc"
@@ -0,0 +1,214 @@
+// StandInModuleGateway: replies are asynchronous, the download → install
+// round trip updates the installed set and emits the module events, the
+// gates play the host, and injected failures surface where the real
+// modules would report them.
+
+#include <QtTest>
+
+#include <QFile>
+#include <QJsonDocument>
+#include <QJsonObject>
+
+#include "StandInModuleGateway.h"
+
+namespace {
+
+StandInModuleGateway::Config fastConfig()
+{
+    StandInModuleGateway::Config c;
+    c.catalogRows    = 50;
+    c.versionsPerRow = 2;
+    c.latencyMs      = 1;
+    c.downloadMs     = 8;
+    c.installMs      = 1;
+    return c;
+}
+
+QJsonObject payload(const QVariantList& data)
+{
+    return data.isEmpty() ? QJsonObject()
+                          : QJsonDocument::fromJson(data.first().toString().toUtf8()).object();
+}
+
+// A catalog package that isn't installed yet (every 4th one is).
+const QString kFresh = QStringLiteral("pkg_000005");
+
+} // namespace
+
+class StandInGatewayTest : public QObject {
+    Q_OBJECT
+
+private slots:
+    void repliesAreAsynchronous();
+    void catalogMatchesConfig();
+    void downloadThenInstall();
+    void injectedDownloadFailure();
+    void injectedInstallFailure();
+    void installGateApproves();
+    void declinedGateCancels();
+    void upgradeGateRemovesOldVersionFirst();
+};
+
+void StandInGatewayTest::repliesAreAsynchronous()
+{
+    StandInModuleGateway gw(fastConfig());
+    bool called = false;
+    gw.getCatalog([&](QVariantList) { called = true; });
+    QVERIFY(!called);
+    QTRY_VERIFY(called);
+    QCOMPARE(gw.callCount("getCatalog"), 1);
+}
+
+void StandInGatewayTest::catalogMatchesConfig()
+{
+    StandInModuleGateway gw(fastConfig());
+    QVariantList catalog;
+    QVariantList installed;
+    gw.getCatalog([&](QVariantList rows) { catalog = rows; });
+    gw.getInstalledPackages([&](QVariantList rows) { installed = rows; });
+    QTRY_COMPARE(catalog.size(), 50);
+    QTRY_VERIFY(!installed.isEmpty());
+    QCOMPARE(catalog.first().toMap().value("versions").toList().size(), 2);
+}
+
+void StandInGatewayTest::downloadThenInstall()
+{
+    StandInModuleGateway gw(fastConfig());
+    int progressEvents = 0;
+    QStringList installedEvents;
+    gw.onDownloaderEvent("downloadProgress", [&](const QVariantList&) { ++progressEvents; });
+    gw.onManagerEvent("corePluginFileInstalled", [&](const QVariantList& d) {
+        installedEvents.append(d.value(0).toString());
+    });
+
+    const QString deps = QStringLiteral("[{\"name\":\"%1\"}]").arg(kFresh);
+    QVariantList results;
+    bool done = false;
+    gw.downloadResolvedDependencies(deps, "[]", [&](QVariantList r) { results = r; done = true; },
+                                    60000);
+    QTRY_VERIFY(done);
+    QVERIFY(progressEvents > 0);
+    QVERIFY(!results.isEmpty());
+    // Dependencies come first; the requested package is the top-level one, last.
+    const QVariantMap top = results.last().toMap();
+    QCOMPARE(top.value("name").toString(), kFresh);
+    QVERIFY(top.value("topLevel").toBool());
+    QVERIFY(QFile::exists(top.value("path").toString()));
+
+    QVariantMap inspected;
+    gw.inspectPackage(top.value("path").toString(), [&](QVariantMap m) { inspected = m; });
+    QTRY_COMPARE(inspected.value("name").toString(), kFresh);
+    QVERIFY(!inspected.value("isAlreadyInstalled").toBool());
+
+    bool installedOk = false;
+    gw.installPlugin(top.value("path").toString(), [&](ModuleGateway::InstallReply r) {
+        installedOk = r.ok && r.value.contains("path") && !r.value.contains("error");
+    }, 60000);
+    QTRY_VERIFY(installedOk);
+    QCOMPARE(installedEvents, QStringList{kFresh});
+
+    bool found = false;
+    for (const QVariant& v : gw.installedPackages())
+        found = found || v.toMap().value("name").toString() == kFresh;
+    QVERIFY(found);
+}
+
+void StandInGatewayTest::injectedDownloadFailure()
+{
+    StandInModuleGateway::Config c = fastConfig();
+    c.failDownloads = {kFresh};
+    StandInModuleGateway gw(c);
+
+    QVariantList results;
+    gw.downloadResolvedDependencies(QStringLiteral("[{\"name\":\"%1\"}]").arg(kFresh), "[]",
+                                    [&](QVariantList r) { results = r; }, 60000);
+    QTRY_VERIFY(!results.isEmpty());
+    QVERIFY(results.last().toMap().contains("error"));
+
+    QVariantList unknown;
+    gw.resolveDependencies("[{\"name\":\"no_such_pkg\"}]", "[]",
+                           [&](QVariantList r) { unknown = r; });
+    QTRY_COMPARE(unknown.size(), 1);
+    QVERIFY(unknown.first().toMap().contains("error"));
+}
+
+void StandInGatewayTest::injectedInstallFailure()
+{
+    StandInModuleGateway::Config c = fastConfig();
+    c.failInstalls = {kFresh};
+    StandInModuleGateway gw(c);
+
+    QVariantList results;
+    gw.downloadResolvedDependencies(QStringLiteral("[{\"name\":\"%1\"}]").arg(kFresh), "[]",
+                                    [&](QVariantList r) { results = r; }, 60000);
+    QTRY_VERIFY(!results.isEmpty());
+
+    QString error;
+    gw.installPlugin(results.last().toMap().value("path").toString(),
+                     [&](ModuleGateway::InstallReply r) { error = r.value.value("error").toString(); },
+                     60000);
+    QTRY_VERIFY(!error.isEmpty());
+
+    // A reply slower than the caller's deadline is a transport failure.
+    StandInModuleGateway::Config slow = fastConfig();
+    slow.installMs = 50;
+    StandInModuleGateway slowGw(slow);
+    bool timedOut = false;
+    slowGw.installPlugin("/nonexistent.lgx",
+                         [&](ModuleGateway::InstallReply r) { timedOut = !r.ok; }, 5);
+    QTRY_VERIFY(timedOut);
+}
+
+void StandInGatewayTest::installGateApproves()
+{
+    StandInModuleGateway gw(fastConfig());
+    QJsonObject approved;
+    gw.onManagerEvent("installApproved", [&](const QVariantList& d) { approved = payload(d); });
+
+    bool accepted = false;
+    gw.requestInstall(kFresh, "1.1.5", "repo", "[]",
+                      [&](QVariantMap r) { accepted = r.value("success").toBool(); });
+    QTRY_VERIFY(accepted);
+    QTRY_COMPARE(approved.value("name").toString(), kFresh);
+    QCOMPARE(approved.value("releaseTag").toString(), QString("1.1.5"));
+    QCOMPARE(approved.value("repositoryUrl").toString(), QString("repo"));
+}
+
+void StandInGatewayTest::declinedGateCancels()
+{
+    StandInModuleGateway::Config c = fastConfig();
+    c.approveGates = false;
+    StandInModuleGateway gw(c);
+    QJsonObject cancelled;
+    bool approved = false;
+    gw.onManagerEvent("installCancelled", [&](const QVariantList& d) { cancelled = payload(d); });
+    gw.onManagerEvent("installApproved", [&](const QVariantList&) { approved = true; });
+
+    gw.requestInstall(kFresh, "1.1.5", QString(), "[]", [](QVariantMap) {});
+    QTRY_COMPARE(cancelled.value("name").toString(), kFresh);
+    QVERIFY(!cancelled.value("reason").toString().isEmpty());
+    QVERIFY(!approved);
+}
+
+void StandInGatewayTest::upgradeGateRemovesOldVersionFirst()
+{
+    StandInModuleGateway gw(fastConfig());
+    const QString installed = QStringLiteral("pkg_000004");   // every 4th is installed
+    QStringList order;
+    gw.onManagerEvent("corePluginUninstalled", [&](const QVariantList& d) {
+        order.append("uninstalled:" + d.value(0).toString());
+    });
+    gw.onManagerEvent("upgradeUninstallDone", [&](const QVariantList& d) {
+        order.append("done:" + payload(d).value("name").toString());
+    });
+
+    gw.requestUpgrade(installed, "1.1.4", 0, "[]", [](QVariantMap) {});
+    QTRY_COMPARE(order.size(), 2);
+    QCOMPARE(order, QStringList({"uninstalled:" + installed, "done:" + installed}));
+    for (const QVariant& v : gw.installedPackages())
+        QVERIFY(v.toMap().value("name").toString() != installed);
+}
+
+QTEST_GUILESS_MAIN(StandInGatewayTest)
+
+#include "standin_gateway_test.moc"
@@ -0,0 +1,48 @@
+// Inspector helpers shared by ui-tests.mjs and perf-tests.mjs.
+
+// Reload is the most stable mount signal — always present, always rendered.
+export async function waitForPmuiLoaded(app, timeout = 15000) {
+  await app.waitFor(
+    async () => { await app.expectTexts(["Reload"]); },
+    { timeout, interval: 500, description: "Package Manager UI to load" }
+  );
+}
+
+// findByType doesn't match QML-declared types (Qt mangles them as
+// <Type>_QMLTYPE_<n>). Anchor lookups on the QObject objectName instead —
+// BackendStore.qml sets objectName: "pmui.BackendStore".
+export async function storeProperty(app, propName) {
+  const res = await app.findByProperty("objectName", "pmui.BackendStore");
+  if (res.error || !res.matches || res.matches.length === 0) {
+    throw new Error('No object found with objectName "pmui.BackendStore"');
+  }
+  return propertyOf(app, res.matches[0].id, propName);
+}
+
+export async function propertyOf(app, objectId, propName) {
+  const res = await app.getProperties(objectId);
+  if (res.error) throw new Error(`getProperties failed: ${res.error}`);
+  const prop = res.properties.find((p) => p.name === propName);
+  if (!prop) throw new Error(`property "${propName}" not found`);
+  return prop.value;
+}
+
+// Reset the store's filter state so a test can rely on the full model
+// without inheriting whatever the previous test left behind (a type
+// pick, a category, a search string). Uses the store's own setters —
+// those go through push* over QtRO so the source-side proxy actually
+// resets, not just the replica.
+export async function resetStoreFilters(app) {
+  const store = await app.findByProperty("objectName", "pmui.BackendStore");
+  if (!store.matches || store.matches.length === 0) return;
+  const storeId = store.matches[0].id;
+  await app.inspector.send("evaluate", {
+    objectId: storeId,
+    expression: `(function() {
+      selectType(0);
+      selectCategory(0);
+      setSearchText("");
+      setInstallStateFilter(0);
+    })()`,
+  });
+}
@@ -5,39 +5,18 @@
 //   node tests/ui-tests.mjs <substring>       # filter tests by name
 //
 // Requires: nix build .#test-framework -o result-mcp
+//
+// Runs against whatever modules the app is wired to — the real ones
+// under --ci. The performance scenarios live in perf-tests.mjs and run
+// separately, against the stand-in modules.
 
 import { resolve } from "node:path";
 
+import { waitForPmuiLoaded, storeProperty, propertyOf, resetStoreFilters } from "./ui-helpers.mjs";
+
 const root = process.env.LOGOS_QT_MCP || new URL("../result-mcp", import.meta.url).pathname;
 const { test, run } = await import(resolve(root, "test-framework/framework.mjs"));
 
-// Reload is the most stable mount signal — always present, always rendered.
-async function waitForPmuiLoaded(app, timeout = 15000) {
-  await app.waitFor(
-    async () => { await app.expectTexts(["Reload"]); },
-    { timeout, interval: 500, description: "Package Manager UI to load" }
-  );
-}
-
-// findByType doesn't match QML-declared types (Qt mangles them as
-// <Type>_QMLTYPE_<n>). Anchor lookups on the QObject objectName instead —
-// BackendStore.qml sets objectName: "pmui.BackendStore".
-async function storeProperty(app, propName) {
-  const res = await app.findByProperty("objectName", "pmui.BackendStore");
-  if (res.error || !res.matches || res.matches.length === 0) {
-    throw new Error('No object found with objectName "pmui.BackendStore"');
-  }
-  return propertyOf(app, res.matches[0].id, propName);
-}
-
-async function propertyOf(app, objectId, propName) {
-  const res = await app.getProperties(objectId);
-  if (res.error) throw new Error(`getProperties failed: ${res.error}`);
-  const prop = res.properties.find((p) => p.name === propName);
-  if (!prop) throw new Error(`property "${propName}" not found`);
-  return prop.value;
-}
-
 test("smoke: PMUI loads and shows title", async (app) => {
   await waitForPmuiLoaded(app);
   await app.expectTexts(["Package Manager"]);
@@ -67,11 +46,49 @@ test("structure: install-local button is present and enabled", async (app) => {
   if (enabled !== true) {
     throw new Error(`install-local button should be enabled when idle, got ${enabled}`);
   }
-  // Deliberately NOT clicking: the click opens a native file dialog, and the
+  // Deliberately NOT clicking: the click leads to a native file/folder dialog, and the
   // install behind it routes through the package_manager gate, which needs a
   // host (basecamp) to acknowledge it. Neither is available here.
 });
 
+test("structure: local picker accepts several files for the batch install", async (app) => {
+  await waitForPmuiLoaded(app);
+
+  const res = await app.findByProperty("objectName", "pmui.installLocalDialog");
+  if (res.error || !res.matches || res.matches.length === 0) {
+    throw new Error('No object found with objectName "pmui.installLocalDialog"');
+  }
+  // FileDialog.OpenFiles — more than one pick routes to installLocalPackages.
+  const fileMode = await propertyOf(app, res.matches[0].id, "fileMode");
+  if (fileMode !== 1) {
+    throw new Error(`install-local dialog should be multi-select (OpenFiles = 1), got ${fileMode}`);
+  }
+});
+
+test("structure: a folder picker feeds the batch install", async (app) => {
+  await waitForPmuiLoaded(app);
+
+  const res = await app.findByProperty("objectName", "pmui.installLocalFolderDialog");
+  if (res.error || !res.matches || res.matches.length === 0) {
+    throw new Error('No object found with objectName "pmui.installLocalFolderDialog"');
+  }
+  // Not opened: like the file picker, it's a native dialog.
+});
+
+test("structure: interrupted-install prompt stays closed on a clean start", async (app) => {
+  await waitForPmuiLoaded(app);
+
+  const res = await app.findByProperty("objectName", "pmui.interruptedInstalls");
+  if (res.error || !res.matches || res.matches.length === 0) {
+    throw new Error('No object found with objectName "pmui.interruptedInstalls"');
+  }
+  // Nothing in the install journal → nothing to ask about.
+  const visible = await propertyOf(app, res.matches[0].id, "visible");
+  if (visible) {
+    throw new Error("interrupted-install prompt opened without an interrupted install");
+  }
+});
+
 test("structure: table headers render", async (app) => {
   await waitForPmuiLoaded(app);
   // The old single "Status" column was split into per-row "Version" + "Action".
@@ -479,6 +496,41 @@ test("row click: single click populates selectedPackageDetails", async (app) =>
   );
 });
 
+test("row click: details carry reverse dependencies from the local graph", async (app) => {
+  await waitForPmuiLoaded(app);
+  await app.waitFor(
+    async () => {
+      const loading = await storeProperty(app, "isLoading");
+      if (loading) throw new Error("still loading");
+    },
+    { timeout: 10000, interval: 500, description: "catalog to load" }
+  );
+
+  // The graph itself is covered by dependency_graph_test; this checks
+  // the details wiring, which needs a row — an empty catalog has none.
+  const label = await firstVisibleRowLabel(app);
+  if (!label) return;
+
+  await app.click(label, { exact: true });
+  await app.waitFor(
+    async () => {
+      const details = await storeProperty(app, "selectedPackageDetails");
+      if (!details || !details.name) throw new Error("no details yet");
+      if (!Array.isArray(details.dependents) || !Array.isArray(details.installedDependents)) {
+        throw new Error(`dependents missing: ${JSON.stringify(details)}`);
+      }
+      // Installed dependents are a subset of all dependents.
+      for (const d of details.installedDependents) {
+        if (!details.dependents.includes(d)) {
+          throw new Error(`installed dependent ${d} not in dependents`);
+        }
+      }
+    },
+    { timeout: 5000, interval: 250,
+      description: "details to include dependents / installedDependents" }
+  );
+});
+
 // ─── Categories sidebar scroll test ────────────────────────────────
 test("categories sidebar: scrollable when contents overflow", async (app) => {
   await waitForPmuiLoaded(app);
@@ -614,26 +666,6 @@ async function inspectPackagesModel(app, expression) {
   return res.result;
 }
 
-// Reset the store's filter state so a test can rely on the full model
-// without inheriting whatever the previous test left behind (a type
-// pick, a category, a search string). Uses the store's own setters —
-// those go through push* over QtRO so the source-side proxy actually
-// resets, not just the replica.
-async function resetStoreFilters(app) {
-  const store = await app.findByProperty("objectName", "pmui.BackendStore");
-  if (!store.matches || store.matches.length === 0) return;
-  const storeId = store.matches[0].id;
-  await app.inspector.send("evaluate", {
-    objectId: storeId,
-    expression: `(function() {
-      selectType(0);
-      selectCategory(0);
-      setSearchText("");
-      setInstallStateFilter(0);
-    })()`,
-  });
-}
-
 // Read the backend-exposed role name → int map for `packagesModel`. Must
 // go through `evaluate` + JSON — `getProperties` on a `property var` /
 // QVariantMap yields the string "<QJSValue>" instead of the map's
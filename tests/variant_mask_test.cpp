@@ -0,0 +1,126 @@
+// Variant availability as bits: VariantMask encodes the platform's valid
+// variants and their bases once, and buildPackageRow's
+// isVariantAvailable / notAvailableReason come out of the offered
+// variants' bits the way the QStringList / QSet scan decided them.
+
+#include <QtTest>
+
+#include "PackageRowBuilder.h"
+#include "PackageTypes.h"
+
+namespace {
+
+const QStringList kValidVariants{QStringLiteral("linux-x86_64"),
+                                 QStringLiteral("linux-amd64-dev")};
+
+QVariantMap catalogRow(const QStringList& offered, const QString& type = QStringLiteral("core"))
+{
+    QVariantMap main;
+    for (const QString& v : offered) main.insert(v, QStringLiteral("lib.so"));
+    const QVariantMap manifest{{"name", "pkg"}, {"version", "1.0.0"}, {"type", type},
+                               {"main", main}};
+    return {{"name", "pkg"}, {"repositoryUrl", "https://repo"},
+            {"versions", QVariantList{QVariantMap{{"manifest", manifest}}}}};
+}
+
+} // namespace
+
+class VariantMaskTest : public QObject {
+    Q_OBJECT
+
+private slots:
+    void availability_data();
+    void availability();
+    void unknownVariantsSetNoBits();
+    void variantsPastSixtyFourCompareAsStrings();
+};
+
+void VariantMaskTest::availability_data()
+{
+    QTest::addColumn<QStringList>("offered");
+    QTest::addColumn<QString>("type");
+    QTest::addColumn<bool>("available");
+    QTest::addColumn<int>("reason");
+
+    const QString core = QStringLiteral("core");
+    QTest::newRow("exact")          << QStringList{"darwin-arm64", "linux-x86_64"} << core
+                                    << true  << int(PackageTypes::Available);
+    QTest::newRow("flavored exact") << QStringList{"linux-amd64-dev"} << core
+                                    << true  << int(PackageTypes::Available);
+    QTest::newRow("other flavor")   << QStringList{"linux-x86_64-portable"} << core
+                                    << false << int(PackageTypes::BuildFlavorMismatch);
+    QTest::newRow("release of dev") << QStringList{"linux-amd64"} << core
+                                    << false << int(PackageTypes::BuildFlavorMismatch);
+    QTest::newRow("other platform") << QStringList{"darwin-arm64", "windows-x86_64"} << core
+                                    << false << int(PackageTypes::PlatformMismatch);
+    QTest::newRow("none")           << QStringList{} << core
+                                    << false << int(PackageTypes::NoVariantsPublished);
+    QTest::newRow("qml only")       << QStringList{} << QStringLiteral("ui_qml")
+                                    << true  << int(PackageTypes::Available);
+}
+
+void VariantMaskTest::availability()
+{
+    QFETCH(QStringList, offered);
+    QFETCH(QString, type);
+    QFETCH(bool, available);
+    QFETCH(int, reason);
+
+    const packagerows::VariantMask variants(kValidVariants);
+    // Twice through the same mask: the memoised encodings answer alike.
+    for (int pass = 0; pass < 2; ++pass) {
+        const QVariantMap row = packagerows::buildPackageRow(catalogRow(offered, type), {},
+                                                             variants);
+        QCOMPARE(row.value("isVariantAvailable").toBool(), available);
+        QCOMPARE(row.value("notAvailableReason").toInt(), reason);
+    }
+    // The QStringList overload builds its own mask and agrees.
+    const QVariantMap row = packagerows::buildPackageRow(catalogRow(offered, type), {},
+                                                         kValidVariants);
+    QCOMPARE(row.value("notAvailableReason").toInt(), reason);
+}
+
+void VariantMaskTest::unknownVariantsSetNoBits()
+{
+    const packagerows::VariantMask variants(kValidVariants);
+    QCOMPARE(variants.valid().variants, quint64(0b11));
+    QCOMPARE(variants.valid().bases, quint64(0b11));
+
+    const auto bits = variants.encode({{"freebsd-riscv64", "x"}, {"", "y"}});
+    QVERIFY(bits.offered);
+    QCOMPARE(bits.variants, quint64(0));
+    QCOMPARE(bits.bases, quint64(0));
+
+    QVERIFY(!variants.encode({{"", "y"}}).offered);
+}
+
+void VariantMaskTest::variantsPastSixtyFourCompareAsStrings()
+{
+    // 70 platforms, each with a "-dev" flavor: 140 variants, 70 bases.
+    QStringList valid;
+    for (int i = 0; i < 70; ++i) {
+        valid << QStringLiteral("os%1-arm64").arg(i)
+              << QStringLiteral("os%1-arm64-dev").arg(i);
+    }
+    const packagerows::VariantMask variants(valid);
+
+    const auto last = variants.encode({{"os69-arm64-dev", "x"}});
+    QCOMPARE(last.variants, quint64(0));
+    QVERIFY(last.extraVariant);
+    QVERIFY(variants.matchesVariant(last));
+
+    QVariantMap row = packagerows::buildPackageRow(catalogRow({"os69-arm64-dev"}), {},
+                                                   variants);
+    QVERIFY(row.value("isVariantAvailable").toBool());
+
+    row = packagerows::buildPackageRow(catalogRow({"os69-arm64-portable"}), {}, variants);
+    QVERIFY(!row.value("isVariantAvailable").toBool());
+    QCOMPARE(row.value("notAvailableReason").toInt(), int(PackageTypes::BuildFlavorMismatch));
+
+    row = packagerows::buildPackageRow(catalogRow({"os70-arm64"}), {}, variants);
+    QCOMPARE(row.value("notAvailableReason").toInt(), int(PackageTypes::PlatformMismatch));
+}
+
+QTEST_GUILESS_MAIN(VariantMaskTest)
+
+#include "variant_mask_test.moc"